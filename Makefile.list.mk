@@ -37,6 +37,18 @@
 ./build/ConjugateGradient.o: ./source/inverters/ConjugateGradient.h ./source/inverters/ConjugateGradient.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/ConjugateGradient.o ./source/inverters/ConjugateGradient.cpp
 
+./build/PipelinedConjugateGradient.o: ./source/inverters/PipelinedConjugateGradient.h ./source/inverters/PipelinedConjugateGradient.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/PipelinedConjugateGradient.o ./source/inverters/PipelinedConjugateGradient.cpp
+
+./build/MixedPrecisionSolver.o: ./source/inverters/MixedPrecisionSolver.h ./source/inverters/MixedPrecisionSolver.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/MixedPrecisionSolver.o ./source/inverters/MixedPrecisionSolver.cpp
+
+./build/Solver.o: ./source/inverters/Solver.h ./source/inverters/Solver.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/Solver.o ./source/inverters/Solver.cpp
+
+./build/NormalEquationSolver.o: ./source/inverters/NormalEquationSolver.h ./source/inverters/NormalEquationSolver.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/NormalEquationSolver.o ./source/inverters/NormalEquationSolver.cpp
+
 ./build/DiracOperator.o: ./source/dirac_operators/DiracOperator.h ./source/dirac_operators/DiracOperator.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/DiracOperator.o ./source/dirac_operators/DiracOperator.cpp
 
@@ -49,12 +61,24 @@
 ./build/BasicSquareDiracWilsonOperator.o: ./source/dirac_operators/BasicSquareDiracWilsonOperator.h ./source/dirac_operators/BasicSquareDiracWilsonOperator.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/BasicSquareDiracWilsonOperator.o ./source/dirac_operators/BasicSquareDiracWilsonOperator.cpp
 
+./build/AlignedDiracWilsonKernel.o: ./source/dirac_operators/AlignedDiracWilsonKernel.h ./source/dirac_operators/AlignedDiracWilsonKernel.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/AlignedDiracWilsonKernel.o ./source/dirac_operators/AlignedDiracWilsonKernel.cpp
+
 ./build/DiracWilsonOperator.o: ./source/dirac_operators/DiracWilsonOperator.h ./source/dirac_operators/DiracWilsonOperator.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/DiracWilsonOperator.o ./source/dirac_operators/DiracWilsonOperator.cpp
 
 ./build/SquareDiracWilsonOperator.o: ./source/dirac_operators/SquareDiracWilsonOperator.h ./source/dirac_operators/SquareDiracWilsonOperator.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/SquareDiracWilsonOperator.o ./source/dirac_operators/SquareDiracWilsonOperator.cpp
 
+./build/CompressedDiracWilsonOperator.o: ./source/dirac_operators/CompressedDiracWilsonOperator.h ./source/dirac_operators/CompressedDiracWilsonOperator.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/CompressedDiracWilsonOperator.o ./source/dirac_operators/CompressedDiracWilsonOperator.cpp
+
+./build/SquareCompressedDiracWilsonOperator.o: ./source/dirac_operators/SquareCompressedDiracWilsonOperator.h ./source/dirac_operators/SquareCompressedDiracWilsonOperator.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/SquareCompressedDiracWilsonOperator.o ./source/dirac_operators/SquareCompressedDiracWilsonOperator.cpp
+
+./build/SingleDiracWilsonOperator.o: ./source/dirac_operators/SingleDiracWilsonOperator.h ./source/dirac_operators/SingleDiracWilsonOperator.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/SingleDiracWilsonOperator.o ./source/dirac_operators/SingleDiracWilsonOperator.cpp
+
 ./build/OverlapOperator.o: ./source/dirac_operators/OverlapOperator.h ./source/dirac_operators/OverlapOperator.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/OverlapOperator.o ./source/dirac_operators/OverlapOperator.cpp
 
@@ -106,6 +130,12 @@
 ./build/SquareEvenOddImprovedDiracWilsonOperator.o: ./source/dirac_operators/SquareEvenOddImprovedDiracWilsonOperator.h ./source/dirac_operators/EvenOddImprovedDiracWilsonOperator.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/SquareEvenOddImprovedDiracWilsonOperator.o ./source/dirac_operators/SquareEvenOddImprovedDiracWilsonOperator.cpp
 
+./build/EvenOddDiracWilsonOperator.o: ./source/dirac_operators/EvenOddDiracWilsonOperator.h ./source/dirac_operators/EvenOddDiracWilsonOperator.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/EvenOddDiracWilsonOperator.o ./source/dirac_operators/EvenOddDiracWilsonOperator.cpp
+
+./build/SquareEvenOddDiracWilsonOperator.o: ./source/dirac_operators/SquareEvenOddDiracWilsonOperator.h ./source/dirac_operators/SquareEvenOddDiracWilsonOperator.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/SquareEvenOddDiracWilsonOperator.o ./source/dirac_operators/SquareEvenOddDiracWilsonOperator.cpp
+
 ./build/SquareImprovedDiracWilsonOperator.o: ./source/dirac_operators/SquareImprovedDiracWilsonOperator.h ./source/dirac_operators/SquareImprovedDiracWilsonOperator.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/SquareImprovedDiracWilsonOperator.o ./source/dirac_operators/SquareImprovedDiracWilsonOperator.cpp
 
@@ -121,6 +151,9 @@
 ./build/ChronologicalMultishiftSolver.o: ./source/inverters/ChronologicalMultishiftSolver.h ./source/inverters/ChronologicalMultishiftSolver.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/ChronologicalMultishiftSolver.o ./source/inverters/ChronologicalMultishiftSolver.cpp
 
+./build/SolutionHistory.o: ./source/inverters/SolutionHistory.h ./source/inverters/SolutionHistory.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/SolutionHistory.o ./source/inverters/SolutionHistory.cpp
+
 ./build/MultiGridMEMultishiftSolver.o: ./source/inverters/MultiGridMEMultishiftSolver.h ./source/inverters/MultiGridMEMultishiftSolver.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/MultiGridMEMultishiftSolver.o ./source/inverters/MultiGridMEMultishiftSolver.cpp
 
@@ -226,6 +259,9 @@
 ./build/RandomSeed.o: ./source/utils/RandomSeed.h ./source/utils/RandomSeed.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/RandomSeed.o ./source/utils/RandomSeed.cpp
 
+./build/CounterRandomGenerator.o: ./source/utils/CounterRandomGenerator.h ./source/utils/CounterRandomGenerator.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/CounterRandomGenerator.o ./source/utils/CounterRandomGenerator.cpp
+
 ./build/Plaquette.o: ./source/wilson_loops/Plaquette.h ./source/wilson_loops/Plaquette.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/Plaquette.o ./source/wilson_loops/Plaquette.cpp
 
@@ -244,6 +280,9 @@
 ./build/WilsonLoop.o: ./source/wilson_loops/WilsonLoop.h ./source/wilson_loops/WilsonLoop.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/WilsonLoop.o ./source/wilson_loops/WilsonLoop.cpp
 
+./build/WilsonLoopEngine.o: ./source/wilson_loops/WilsonLoopEngine.h ./source/wilson_loops/WilsonLoopEngine.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/WilsonLoopEngine.o ./source/wilson_loops/WilsonLoopEngine.cpp
+
 ./build/PureGaugeWilsonLoops.o: ./source/pure_gauge/PureGaugeWilsonLoops.h ./source/pure_gauge/PureGaugeWilsonLoops.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/PureGaugeWilsonLoops.o ./source/pure_gauge/PureGaugeWilsonLoops.cpp 
 
@@ -286,6 +325,9 @@
 ./build/DiracWilsonFermionForce.o: ./source/hmc_forces/DiracWilsonFermionForce.h ./source/hmc_forces/DiracWilsonFermionForce.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/DiracWilsonFermionForce.o ./source/hmc_forces/DiracWilsonFermionForce.cpp
 
+./build/EvenOddDiracWilsonFermionForce.o: ./source/hmc_forces/EvenOddDiracWilsonFermionForce.h ./source/hmc_forces/EvenOddDiracWilsonFermionForce.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/EvenOddDiracWilsonFermionForce.o ./source/hmc_forces/EvenOddDiracWilsonFermionForce.cpp
+
 ./build/OverlapFermionForce.o: ./source/hmc_forces/OverlapFermionForce.h ./source/hmc_forces/OverlapFermionForce.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/OverlapFermionForce.o ./source/hmc_forces/OverlapFermionForce.cpp
 
@@ -364,18 +406,27 @@
 ./build/OutputSweep.o: ./source/io/OutputSweep.h ./source/io/OutputSweep.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/OutputSweep.o ./source/io/OutputSweep.cpp
 
+./build/ParallelGaugeFile.o: ./source/io/ParallelGaugeFile.h ./source/io/ParallelGaugeFile.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/ParallelGaugeFile.o ./source/io/ParallelGaugeFile.cpp
+
 ./build/Glueball.o: ./source/correlators/Glueball.h ./source/correlators/Glueball.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/Glueball.o ./source/correlators/Glueball.cpp
 
 ./build/TestCommunication.o: ./source/tests/TestCommunication.h ./source/tests/TestCommunication.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/TestCommunication.o ./source/tests/TestCommunication.cpp
 
+./build/TestLayout.o: ./source/tests/TestLayout.h ./source/tests/TestLayout.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/TestLayout.o ./source/tests/TestLayout.cpp
+
 ./build/TestLinearAlgebra.o: ./source/tests/TestLinearAlgebra.h ./source/tests/TestLinearAlgebra.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/TestLinearAlgebra.o ./source/tests/TestLinearAlgebra.cpp
 
 ./build/TestSpeedDiracOperators.o: ./source/tests/TestSpeedDiracOperators.h ./source/tests/TestSpeedDiracOperators.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/TestSpeedDiracOperators.o ./source/tests/TestSpeedDiracOperators.cpp
 
+./build/TestSpeedPureGauge.o: ./source/tests/TestSpeedPureGauge.h ./source/tests/TestSpeedPureGauge.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/TestSpeedPureGauge.o ./source/tests/TestSpeedPureGauge.cpp
+
 ./build/StorageParameters.o: ./source/io/StorageParameters.h ./source/io/StorageParameters.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/StorageParameters.o ./source/io/StorageParameters.cpp
 
@@ -393,6 +444,9 @@
 
 ./build/SAPPreconditioner.o: ./source/dirac_operators/SAPPreconditioner.h ./source/dirac_operators/SAPPreconditioner.cpp
 	$(CPP) $(CPPFLAGS) -c -o ./build/SAPPreconditioner.o ./source/dirac_operators/SAPPreconditioner.cpp
+
+./build/LocalSAPPreconditioner.o: ./source/dirac_operators/LocalSAPPreconditioner.h ./source/dirac_operators/LocalSAPPreconditioner.cpp
+	$(CPP) $(CPPFLAGS) -c -o ./build/LocalSAPPreconditioner.o ./source/dirac_operators/LocalSAPPreconditioner.cpp
 	
 ./build/BlockBasis.o: ./source/multigrid/BlockBasis.cpp ./source/multigrid/BlockBasis.h
 	$(CPP) $(CPPFLAGS) -c -o ./build/BlockBasis.o ./source/multigrid/BlockBasis.cpp
@@ -418,4 +472,13 @@
 ./build/MultiGridStochasticEstimator.o: ./source/multigrid/MultiGridStochasticEstimator.cpp ./source/multigrid/MultiGridStochasticEstimator.h
 	$(CPP) $(CPPFLAGS) -c -o ./build/MultiGridStochasticEstimator.o ./source/multigrid/MultiGridStochasticEstimator.cpp
 
+./build/MultiGridCoarseLayout.o: ./source/multigrid/MultiGridCoarseLayout.cpp ./source/multigrid/MultiGridCoarseLayout.h
+	$(CPP) $(CPPFLAGS) -c -o ./build/MultiGridCoarseLayout.o ./source/multigrid/MultiGridCoarseLayout.cpp
+
+./build/MultiGridCoarseOperator.o: ./source/multigrid/MultiGridCoarseOperator.cpp ./source/multigrid/MultiGridCoarseOperator.h
+	$(CPP) $(CPPFLAGS) -c -o ./build/MultiGridCoarseOperator.o ./source/multigrid/MultiGridCoarseOperator.cpp
+
+./build/MultiGridHierarchy.o: ./source/multigrid/MultiGridHierarchy.cpp ./source/multigrid/MultiGridHierarchy.h
+	$(CPP) $(CPPFLAGS) -c -o ./build/MultiGridHierarchy.o ./source/multigrid/MultiGridHierarchy.cpp
+
 
@@ -1,9 +1,9 @@
 OBJECTS  = ./build/ReducedStencil.o ./build/StandardStencil.o ./build/ExtendedStencil.o ./build/LocalLayout.o \
 			./build/AlgebraUtils.o \
-			./build/BiConjugateGradient.o ./build/DeflationInverter.o ./build/ConjugateGradient.o ./build/MultishiftSolver.o ./build/ChronologicalMultishiftSolver.o ./build/MMMRMultishiftSolver.o ./build/MEMultishiftSolver.o ./build/MultiGridMEMultishiftSolver.o ./build/GMRESR.o ./build/PreconditionedBiCGStab.o \
+			./build/BiConjugateGradient.o ./build/DeflationInverter.o ./build/ConjugateGradient.o ./build/PipelinedConjugateGradient.o ./build/MixedPrecisionSolver.o ./build/Solver.o ./build/NormalEquationSolver.o ./build/MultishiftSolver.o ./build/ChronologicalMultishiftSolver.o ./build/SolutionHistory.o ./build/MMMRMultishiftSolver.o ./build/MEMultishiftSolver.o ./build/MultiGridMEMultishiftSolver.o ./build/GMRESR.o ./build/PreconditionedBiCGStab.o \
 			./build/AdjointScalarAction.o ./build/FundamentalScalarAction.o ./build/ScalarAction.o ./build/MultiScalarAction.o \
-			./build/DiracOperator.o ./build/Propagator.o ./build/BasicDiracWilsonOperator.o ./build/BasicSquareDiracWilsonOperator.o ./build/DiracWilsonOperator.o ./build/SquareDiracWilsonOperator.o ./build/BlockDiracWilsonOperator.o ./build/BlockImprovedDiracWilsonOperator.o ./build/BlockDiracOperator.o ./build/ComplementBlockDiracOperator.o ./build/OverlapOperator.o ./build/SquareOverlapOperator.o ./build/ExactOverlapOperator.o ./build/SquareComplementBlockDiracWilsonOperator.o ./build/SquareComplementBlockDiracOperator.o ./build/SquareBlockDiracWilsonOperator.o ./build/ImprovedDiracWilsonOperator.o ./build/SquareImprovedDiracWilsonOperator.o ./build/SquareTwistedDiracOperator.o ./build/TwistedDiracOperator.o ./build/SAPPreconditioner.o ./build/HoppingOperator.o ./build/GammaOperators.o ./build/EvenOddImprovedDiracWilsonOperator.o ./build/SquareEvenOddImprovedDiracWilsonOperator.o \
-			./build/BlockBasis.o ./build/MultiGridBiConjugateGradient.o ./build/MultiGridConjugateGradient.o ./build/MultiGridOperator.o ./build/MultiGridProjector.o ./build/MultiGridSolver.o ./build/MultiGridVectorLayout.o ./build/MultiGridStochasticEstimator.o \
+			./build/DiracOperator.o ./build/AlignedDiracWilsonKernel.o ./build/Propagator.o ./build/BasicDiracWilsonOperator.o ./build/BasicSquareDiracWilsonOperator.o ./build/DiracWilsonOperator.o ./build/SquareDiracWilsonOperator.o ./build/CompressedDiracWilsonOperator.o ./build/SquareCompressedDiracWilsonOperator.o ./build/SingleDiracWilsonOperator.o ./build/BlockDiracWilsonOperator.o ./build/BlockImprovedDiracWilsonOperator.o ./build/BlockDiracOperator.o ./build/ComplementBlockDiracOperator.o ./build/OverlapOperator.o ./build/SquareOverlapOperator.o ./build/ExactOverlapOperator.o ./build/SquareComplementBlockDiracWilsonOperator.o ./build/SquareComplementBlockDiracOperator.o ./build/SquareBlockDiracWilsonOperator.o ./build/ImprovedDiracWilsonOperator.o ./build/SquareImprovedDiracWilsonOperator.o ./build/SquareTwistedDiracOperator.o ./build/TwistedDiracOperator.o ./build/SAPPreconditioner.o ./build/LocalSAPPreconditioner.o ./build/HoppingOperator.o ./build/GammaOperators.o ./build/EvenOddImprovedDiracWilsonOperator.o ./build/SquareEvenOddImprovedDiracWilsonOperator.o ./build/EvenOddDiracWilsonOperator.o ./build/SquareEvenOddDiracWilsonOperator.o \
+			./build/BlockBasis.o ./build/MultiGridBiConjugateGradient.o ./build/MultiGridConjugateGradient.o ./build/MultiGridOperator.o ./build/MultiGridProjector.o ./build/MultiGridSolver.o ./build/MultiGridVectorLayout.o ./build/MultiGridStochasticEstimator.o ./build/MultiGridCoarseLayout.o ./build/MultiGridCoarseOperator.o ./build/MultiGridHierarchy.o \
 			./build/Polynomial.o ./build/RationalApproximation.o ./build/ChebyshevRecursion.o \
 			./build/Integrate.o ./build/LeapFrog.o ./build/FourthOrderLeapFrog.o ./build/SixthOrderLeapFrog.o ./build/OmelyanLeapFrog.o ./build/FourthOmelyanLeapFrog.o ./build/Energy.o ./build/Force.o \
 			./build/HMCUpdater.o ./build/FermionHMCUpdater.o \
@@ -11,18 +11,18 @@ OBJECTS  = ./build/ReducedStencil.o ./build/StandardStencil.o ./build/ExtendedSt
 			./build/FermionicAction.o \
 			./build/GaugeForce.o ./build/GaugeAction.o ./build/WilsonGaugeAction.o ./build/ImprovedGaugeAction.o \
 			./build/ReUnit.o ./build/StoutSmearing.o ./build/Gamma.o ./build/RandomGaugeTransformation.o \
-			./build/RandomSeed.o \
+			./build/RandomSeed.o ./build/CounterRandomGenerator.o \
 			./build/GaugeFixing.o ./build/LandauGaugeFixing.o ./build/MaximalAbelianGaugeFixing.o ./build/MaximalAbelianProjection.o ./build/LandauGluonPropagator.o ./build/LandauGhostPropagator.o \
 			./build/Glueball.o \
-			./build/Plaquette.o ./build/PolyakovLoop.o ./build/PolyakovLoopEigenvalues.o ./build/PolyakovLoopCorrelator.o ./build/AdjointPolyakovLoop.o ./build/WilsonLoop.o ./build/GaugeEnergy.o \
-			./build/GlobalOutput.o ./build/OutputSweep.o \
-			./build/FermionForce.o ./build/DiracWilsonFermionForce.o ./build/BlockDiracWilsonFermionForce.o ./build/ImprovedFermionForce.o ./build/TestForce.o ./build/SmearingForce.o ./build/OverlapFermionForce.o \
+			./build/Plaquette.o ./build/PolyakovLoop.o ./build/PolyakovLoopEigenvalues.o ./build/PolyakovLoopCorrelator.o ./build/AdjointPolyakovLoop.o ./build/WilsonLoop.o ./build/WilsonLoopEngine.o ./build/GaugeEnergy.o \
+			./build/GlobalOutput.o ./build/OutputSweep.o ./build/ParallelGaugeFile.o \
+			./build/FermionForce.o ./build/DiracWilsonFermionForce.o ./build/EvenOddDiracWilsonFermionForce.o ./build/BlockDiracWilsonFermionForce.o ./build/ImprovedFermionForce.o ./build/TestForce.o ./build/SmearingForce.o ./build/OverlapFermionForce.o \
 			./build/StochasticEstimator.o ./build/MesonCorrelator.o ./build/ChiralCondensate.o ./build/SingletOperators.o ./build/GluinoGlue.o ./build/NPRVertex.o ./build/XSpaceCorrelators.o ./build/OverlapChiralRotation.o \
 			./build/PureGaugeUpdater.o ./build/PureGaugeOverrelaxation.o ./build/PureGaugeHMCUpdater.o ./build/Checkerboard.o ./build/PureGaugeWilsonLoops.o \
 			./build/TwoFlavorFermionAction.o ./build/TwoFlavorQCDAction.o ./build/TwoFlavorHMCUpdater.o \
 			./build/NFlavorFermionAction.o ./build/NFlavorQCDAction.o ./build/MultiStepNFlavorUpdater.o \
 			./build/DiracEigenSolver.o ./build/Eigenvalues.o \
-			./build/TestCommunication.o ./build/TestLinearAlgebra.o ./build/TestSpeedDiracOperators.o \
+			./build/TestCommunication.o ./build/TestLayout.o ./build/TestLinearAlgebra.o ./build/TestSpeedDiracOperators.o ./build/TestSpeedPureGauge.o \
 			./build/StartGaugeConfiguration.o ./build/ReadStartGaugeConfiguration.o ./build/HotStartGaugeConfiguration.o ./build/ColdStartGaugeConfiguration.o \
 			./build/ReadGaugeConfiguration.o \
 			./build/LatticeSweep.o ./build/Simulation.o \
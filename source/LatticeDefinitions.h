@@ -33,6 +33,13 @@ typedef Lattice::Lattice<Update::FermionicGroup[4], Lattice::MpiLayout<Lattice::
 typedef Lattice::Lattice<Update::FermionicGroup[4], Lattice::MpiLayout<Lattice::StandardStencil> > standard_fermion_lattice_t;
 typedef Lattice::Lattice<Update::FermionicGroup[4], Lattice::MpiLayout<Lattice::ReducedStencil> > reduced_fermion_lattice_t;
 
+//Single precision copy of the links for the reduced layout
+typedef Lattice::Lattice<Update::single_FermionicGroup[4], Lattice::MpiLayout<Lattice::ReducedStencil> > single_reduced_fermion_lattice_t;
+
+//Compressed links interacting with fermions: the first N-1 rows of the SU(N) links and the real factors of the boundary conditions
+typedef Lattice::Lattice<Update::CompressedFundamentalGroup[4], Lattice::MpiLayout<Lattice::ReducedStencil> > reduced_compressed_fermion_lattice_t;
+typedef Lattice::Lattice<Update::real_t[4], Lattice::MpiLayout<Lattice::ReducedStencil> > reduced_link_factor_lattice_t;
+
 //Fermion force field
 typedef Lattice::Lattice<Update::FermionicForceMatrix[4], Lattice::MpiLayout<Lattice::ExtendedStencil> > extended_fermion_force_lattice_t;
 
@@ -41,6 +48,11 @@ typedef Lattice::Lattice<Update::GaugeVector[4], Lattice::MpiLayout<Lattice::Ext
 typedef Lattice::Lattice<Update::GaugeVector[4], Lattice::MpiLayout<Lattice::StandardStencil> > standard_dirac_vector_t;
 typedef Lattice::Lattice<Update::GaugeVector[4], Lattice::MpiLayout<Lattice::ReducedStencil> > reduced_dirac_vector_t;
 
+//Single precision (pseudo)fermion field configurations for different MPI layouts
+typedef Lattice::Lattice<Update::single_GaugeVector[4], Lattice::MpiLayout<Lattice::ExtendedStencil> > single_extended_dirac_vector_t;
+typedef Lattice::Lattice<Update::single_GaugeVector[4], Lattice::MpiLayout<Lattice::StandardStencil> > single_standard_dirac_vector_t;
+typedef Lattice::Lattice<Update::single_GaugeVector[4], Lattice::MpiLayout<Lattice::ReducedStencil> > single_reduced_dirac_vector_t;
+
 //Half spinors projections for reduced layouts
 typedef Lattice::Lattice<Update::GaugeVector[2], Lattice::MpiLayout<Lattice::ReducedUpStencil> > half_spinor_up_vector_t;
 typedef Lattice::Lattice<Update::GaugeVector[2], Lattice::MpiLayout<Lattice::ReducedDownStencil> > half_spinor_down_vector_t;
@@ -80,6 +92,14 @@ typedef Lattice::Lattice<int[4], Lattice::MpiLayout<Lattice::ExtendedStencil> >
 
 #ifdef ALIGNED_OPT
 typedef Lattice::ComplexVectorLattice<Update::real_t, Update::GaugeVector[4], Lattice::MpiLayout<Lattice::ReducedStencil>, 4, Update::diracVectorLength> reduced_soa_dirac_vector_t;
+//Split real/imaginary storage of the links and of the clover blocks for the vectorized Dirac operators
+#ifdef ADJOINT
+typedef Lattice::RealMatrixLattice<Update::real_t, Update::FermionicGroup[4], Lattice::MpiLayout<Lattice::ReducedStencil>, 4, Update::diracVectorLength, Update::diracVectorLength> reduced_soa_fermion_lattice_t;
+#endif
+#ifndef ADJOINT
+typedef Lattice::ComplexMatrixLattice<Update::real_t, Update::FermionicGroup[4], Lattice::MpiLayout<Lattice::ReducedStencil>, 4, Update::diracVectorLength, Update::diracVectorLength> reduced_soa_fermion_lattice_t;
+#endif
+typedef Lattice::ComplexMatrixLattice<Update::real_t, Update::FermionicForceMatrix[6], Lattice::MpiLayout<Lattice::ReducedStencil>, 6, Update::diracVectorLength, Update::diracVectorLength> reduced_soa_clover_lattice_t;
 #endif
 
 #endif
@@ -101,6 +121,12 @@ typedef Lattice::Lattice<Update::FermionicGroup[4], Lattice::LocalLayout > exten
 typedef Lattice::Lattice<Update::FermionicGroup[4], Lattice::LocalLayout > standard_fermion_lattice_t;
 typedef Lattice::Lattice<Update::FermionicGroup[4], Lattice::LocalLayout > reduced_fermion_lattice_t;
 
+typedef Lattice::Lattice<Update::single_FermionicGroup[4], Lattice::LocalLayout > single_reduced_fermion_lattice_t;
+
+//Compressed links interacting with fermions: the first N-1 rows of the SU(N) links and the real factors of the boundary conditions
+typedef Lattice::Lattice<Update::CompressedFundamentalGroup[4], Lattice::LocalLayout > reduced_compressed_fermion_lattice_t;
+typedef Lattice::Lattice<Update::real_t[4], Lattice::LocalLayout > reduced_link_factor_lattice_t;
+
 //Fermion force field
 typedef Lattice::Lattice<Update::FermionicForceMatrix[4], Lattice::LocalLayout > extended_fermion_force_lattice_t;
 
@@ -149,6 +175,14 @@ typedef Lattice::Lattice<int[4], Lattice::LocalLayout > extended_index_lattice_t
 
 #ifdef ALIGNED_OPT
 typedef Lattice::ComplexVectorLattice<Update::real_t, Update::GaugeVector[4], Lattice::LocalLayout, 4, Update::diracVectorLength> reduced_soa_dirac_vector_t;
+//Split real/imaginary storage of the links and of the clover blocks for the vectorized Dirac operators
+#ifdef ADJOINT
+typedef Lattice::RealMatrixLattice<Update::real_t, Update::FermionicGroup[4], Lattice::LocalLayout, 4, Update::diracVectorLength, Update::diracVectorLength> reduced_soa_fermion_lattice_t;
+#endif
+#ifndef ADJOINT
+typedef Lattice::ComplexMatrixLattice<Update::real_t, Update::FermionicGroup[4], Lattice::LocalLayout, 4, Update::diracVectorLength, Update::diracVectorLength> reduced_soa_fermion_lattice_t;
+#endif
+typedef Lattice::ComplexMatrixLattice<Update::real_t, Update::FermionicForceMatrix[6], Lattice::LocalLayout, 6, Update::diracVectorLength, Update::diracVectorLength> reduced_soa_clover_lattice_t;
 #endif
 
 #endif
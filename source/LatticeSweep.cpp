@@ -9,6 +9,7 @@
 #include "io/OutputSweep.h"
 #include "tests/TestLinearAlgebra.h"
 #include "tests/TestSpeedDiracOperators.h"
+#include "tests/TestSpeedPureGauge.h"
 #include "fermion_measurements/Eigenvalues.h"
 #include "correlators/MesonCorrelator.h"
 #include "fermion_measurements/ChiralCondensate.h"
@@ -27,6 +28,7 @@
 #include "gauge_fixing/LandauGluonPropagator.h"
 #include "pure_gauge/PureGaugeWilsonLoops.h"
 #include "tests/TestCommunication.h"
+#include "tests/TestLayout.h"
 #include "correlators/GluinoGlue.h"
 #include "wilson_loops/WilsonLoop.h"
 #include "io/ReadGaugeConfiguration.h"
@@ -68,6 +70,8 @@ LatticeSweep* LatticeSweep::getInstance(const std::string& name) {
 		return new TestLinearAlgebra();
 	} else if (name == "TestSpeedDiracOperators") {
 		return new TestSpeedDiracOperators();
+	} else if (name == "TestSpeedPureGauge") {
+		return new TestSpeedPureGauge();
 	} else if (name == "Eigenvalues") {
 		return new Eigenvalues();
 	} else if (name == "MesonCorrelator") {
@@ -96,6 +100,8 @@ LatticeSweep* LatticeSweep::getInstance(const std::string& name) {
 		return new WilsonLoop();
 	} else if (name == "TestCommunication") {
 		return new TestCommunication();
+	} else if (name == "TestLayout") {
+		return new TestLayout();
 	} else if (name == "ReadGaugeConfiguration") {
 		return new ReadGaugeConfiguration();
 	} else if (name == "WilsonFlow") {
@@ -219,6 +225,7 @@ void LatticeSweep::addParameters(po::options_description& desc) {
 	OutputSweep::registerParameters(desc);
 	TestLinearAlgebra::registerParameters(desc);
 	TestSpeedDiracOperators::registerParameters(desc);
+	TestSpeedPureGauge::registerParameters(desc);
 	Eigenvalues::registerParameters(desc);
 	MesonCorrelator::registerParameters(desc);
 	ChiralCondensate::registerParameters(desc);
@@ -233,6 +240,7 @@ void LatticeSweep::addParameters(po::options_description& desc) {
 	PureGaugeWilsonLoops::registerParameters(desc);
 	WilsonLoop::registerParameters(desc);
 	TestCommunication::registerParameters(desc);
+	TestLayout::registerParameters(desc);
 	ReadGaugeConfiguration::registerParameters(desc);
 	WilsonFlow::registerParameters(desc);
 	GaugeEnergy::registerParameters(desc);
@@ -267,6 +275,7 @@ void LatticeSweep::printSweepsName() {
 		<<  "Output" << std::endl
 		<<  "TestLinearAlgebra" << std::endl
 		<<  "TestSpeedDiracOperators" << std::endl
+		<<  "TestSpeedPureGauge" << std::endl
 		<<  "Eigenvalues" << std::endl
 		<<  "MesonCorrelator" << std::endl
 		<<  "OverlapChiralRotation" << std::endl
@@ -281,6 +290,7 @@ void LatticeSweep::printSweepsName() {
 		<<  "PureGaugeWilsonLoops" << std::endl
 		<<  "WilsonLoop" << std::endl
 		<<  "TestCommunication" << std::endl
+		<<  "TestLayout" << std::endl
 		<<  "ReadGaugeConfiguration" << std::endl
 		<<  "WilsonFlow" << std::endl
 		<<  "GaugeEnergy" << std::endl
@@ -0,0 +1,69 @@
+#ifndef HALOEXCHANGEPLAN_H
+#define HALOEXCHANGEPLAN_H
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#include <vector>
+#include "MPIType.h"
+#include "LatticeChunk.h"
+
+namespace Lattice {
+
+//A single message of the halo exchange: count elements of MpiType<T> starting from the site offset
+struct HaloMessage {
+	int offset;
+	int count;
+	int peer;
+	int tag;
+};
+
+//The list of messages needed to update the halo of a lattice, computed only once from the chunks of the layout
+//and shared by all the lattices with the same type T and the same layout TLayout
+template<typename T, typename TLayout> class HaloExchangePlan {
+	public:
+		static const HaloExchangePlan& getInstance() {
+			static HaloExchangePlan plan;
+			//The layout has been initialized again, the plan is recomputed
+			if (plan.generation != TLayout::generation) plan.initialize();
+			return plan;
+		}
+
+		//The messages sent from the chunks owned by this processor
+		std::vector<HaloMessage> sends;
+		//The messages received in the halo of this processor
+		std::vector<HaloMessage> receives;
+
+	private:
+		HaloExchangePlan() : generation(-1) { }
+
+		//The generation of the layout used to compute the plan
+		int generation;
+
+		void initialize() {
+			sends.clear();
+			receives.clear();
+			generation = TLayout::generation;
+			int packsize = sizeof(T)/MpiType<T>::size;
+			for (int i = 0; i < TLayout::numberChunks; ++i) {
+				const LatticeChunk& chunk = TLayout::latticeChunks[i];
+				for (unsigned int j = 0; j < chunk.sharers.size(); ++j) {
+					HaloMessage message;
+					message.offset = chunk.offset;
+					message.count = packsize*chunk.size;
+					message.tag = chunk.tags[j];
+					if (chunk.owner == TLayout::this_processor) {
+						message.peer = chunk.sharers[j];
+						sends.push_back(message);
+					}
+					else if (chunk.sharers[j] == TLayout::this_processor) {
+						message.peer = chunk.owner;
+						receives.push_back(message);
+					}
+				}
+			}
+		}
+};
+
+}
+
+#endif
+#endif
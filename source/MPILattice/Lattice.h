@@ -2,11 +2,13 @@
 #define LATTICE_H
 #include "Site.h"
 #include "MPIType.h"
+#include "LatticeMemoryPool.h"
 #ifdef ENABLE_MPI
 #include <mpi.h>
 #include <vector>
 #include <fstream>
 #include "utils/ToString.h"
+#include "HaloExchangePlan.h"
 #endif
 #include <iostream>
 #include <typeinfo>
@@ -15,19 +17,25 @@
 
 namespace Lattice {
 
+#ifdef DEBUG_MEMORY_ALLOCATION
+//Number of lattices allocated since the start of the program, for all the types and layouts
+class AllocationCounter {
+public:
+	static long int total;
+};
+#endif
+
 template<typename T, typename TLayout> class Lattice {
 	public:
 		Lattice() : localsize(TLayout::localsize), completesize(TLayout::completesize), sharedsize(TLayout::sharedsize) {
 #ifdef DEBUG_MEMORY_ALLOCATION
 			try {
 #endif
-#ifdef ALIGNED_OPT
-				posix_memalign(reinterpret_cast<void**>(&(localdata)), 64, TLayout::completesize*sizeof(T));
-#else
-				localdata = new T[TLayout::completesize];
-#endif
+				localdata = static_cast<T*>(LatticeMemoryPool::getInstance().allocate(sizeof(T), TLayout::completesize));
 #ifdef DEBUG_MEMORY_ALLOCATION
 				++allocationCounter;
+#pragma omp atomic
+				++AllocationCounter::total;
 				if (TLayout::this_processor == 0) std::cout << "Memory allocated in lattice constructor!" << std::endl;
 				if (TLayout::this_processor == 0) std::cout << "Number of allocations: " << allocationCounter << std::endl;
 				if (TLayout::this_processor == 0) std::cout << " for type: " << typeid(T).name() << std::endl;
@@ -41,11 +49,10 @@ template<typename T, typename TLayout> class Lattice {
 #endif
 		}
 		~Lattice() {
-#ifdef ALIGNED_OPT
-			free(localdata);
-#else
-			delete[] localdata;
+#ifdef ENABLE_MPI
+			this->destroyHaloRequests();
 #endif
+			LatticeMemoryPool::getInstance().release(localdata, sizeof(T), TLayout::completesize);
 #ifdef DEBUG_MEMORY_ALLOCATION
 			--allocationCounter;
 #endif
@@ -54,13 +61,12 @@ template<typename T, typename TLayout> class Lattice {
 #ifdef DEBUG_MEMORY_ALLOCATION
 			try {
 #endif
-#ifdef ALIGNED_OPT
-				posix_memalign(reinterpret_cast<void**>(&(localdata)), 64, TLayout::completesize*sizeof(T));
-#else
-				localdata = new T[TLayout::completesize];
-#endif
+				//All the sites are overwritten by the copy
+				localdata = static_cast<T*>(LatticeMemoryPool::getInstance().allocate(sizeof(T), TLayout::completesize, false));
 #ifdef DEBUG_MEMORY_ALLOCATION
 				++allocationCounter;
+#pragma omp atomic
+				++AllocationCounter::total;
 				if (TLayout::this_processor == 0) std::cout << "Memory allocated in lattice copy constructor!" << std::endl;
 				if (TLayout::this_processor == 0) std::cout << "Number of allocations: " << allocationCounter << std::endl;
 				if (TLayout::this_processor == 0) std::cout << " for type: " << typeid(T).name() << std::endl;
@@ -87,26 +93,29 @@ template<typename T, typename TLayout> class Lattice {
 		}
 		
 		template<typename ULayout> Lattice& operator=(const Lattice<T, ULayout>& copy) {
+			copyLocal(copy);
+			updateHalo();
+			return *this;
+		}
+
+		//Copy of the local sites from a lattice with a different layout, the halo is not updated
+		template<typename ULayout> void copyLocal(const Lattice<T, ULayout>& copy) {
 			int* map = layout.getMapIndex(copy.getLayout());
 #pragma omp parallel for
 			for (int site = 0; site < layout.localsize; ++site) {
 				memcpy(&localdata[site], &copy[map[site]], sizeof(T));
 			}
-			updateHalo();
-			return *this;
 		}
 		
 		template<typename ULayout> Lattice(const Lattice<T, ULayout>& copy) : localsize(TLayout::localsize), completesize(TLayout::completesize), sharedsize(TLayout::sharedsize) {
 #ifdef DEBUG_MEMORY_ALLOCATION
 			try {
 #endif
-#ifdef ALIGNED_OPT
-				posix_memalign(reinterpret_cast<void**>(&(localdata)), 64, TLayout::completesize*sizeof(T));
-#else
-				localdata = new T[TLayout::completesize];
-#endif
+				localdata = static_cast<T*>(LatticeMemoryPool::getInstance().allocate(sizeof(T), TLayout::completesize));
 #ifdef DEBUG_MEMORY_ALLOCATION
 				++allocationCounter;
+#pragma omp atomic
+				++AllocationCounter::total;
 				if (TLayout::this_processor == 0) std::cout << "Memory allocated in lattice template copy constructor!" << std::endl;
 				if (TLayout::this_processor == 0) std::cout << "Number of allocations: " << allocationCounter << std::endl;
 				if (TLayout::this_processor == 0) std::cout << " for type: " << typeid(T).name() << std::endl;
@@ -118,11 +127,7 @@ template<typename T, typename TLayout> class Lattice {
 				exit(7);
 			}
 #endif
-			int* map = layout.getMapIndex(copy.getLayout());
-#pragma omp parallel for
-			for (int site = 0; site < layout.localsize; ++site) {
-				memcpy(&localdata[site], &copy[map[site]], sizeof(T));
-			}
+			copyLocal(copy);
 			updateHalo();
 		}
 		
@@ -136,57 +141,15 @@ template<typename T, typename TLayout> class Lattice {
 
 		void communicateHalo() {
 #ifdef ENABLE_MPI
-			int packsize = sizeof(T)/MpiType<T>::size;
-			
-			//Update halo!
-			//First we initialize the send
-			for (int i = 0; i < layout.numberChunks; ++i) {
-				if (layout.latticeChunks[i].owner == layout.this_processor) {
-					for (unsigned int j = 0; j < layout.latticeChunks[i].sharers.size(); ++j) {
-						void* address = (void*)(&localdata[layout.latticeChunks[i].offset]);
-						int dimension = layout.latticeChunks[i].size;
-						int destination = layout.latticeChunks[i].sharers[j];
-						int tag = layout.latticeChunks[i].tags[j];
-						MPI_Request* send_request = new MPI_Request;
-						MPI_Isend(address,packsize*dimension,MpiType<T>::type,destination,tag,MPI_COMM_WORLD,send_request);
-						sendRequests.push_back(send_request);
-						//outputfile << "Processor " << layout.this_processor << " is sending data with tag " << tag  << " to processor " << destination << " reading from offset " << layout.latticeChunks[i].offset << std::endl;
-					}
-				}
-			}
-			//Then we receive
-			for (int i = 0; i < layout.numberChunks; ++i) {
-				if (layout.latticeChunks[i].owner != layout.this_processor) {
-					for (unsigned int j = 0; j < layout.latticeChunks[i].sharers.size(); ++j) {
-						if (layout.latticeChunks[i].sharers[j] == layout.this_processor) {
-							void* address = (void*)(&localdata[layout.latticeChunks[i].offset]);
-							int dimension = layout.latticeChunks[i].size;
-							int source = layout.latticeChunks[i].owner;
-							int tag = layout.latticeChunks[i].tags[j];
-							MPI_Request* recv_request = new MPI_Request;
-							MPI_Irecv(address,packsize*dimension,MpiType<T>::type,source,tag,MPI_COMM_WORLD,recv_request);
-							recvRequests.push_back(recv_request);
-							//outputfile << "Processor " << layout.this_processor << " is receving data with tag " << tag << " from processor " << source << " writing to offset " << layout.latticeChunks[i].offset << std::endl;
-						}
-					}
-				}
-			}
+			//The persistent requests are bound to the data of this lattice, they are created at the first exchange and then only restarted
+			if (haloRequests.empty()) this->initializeHaloRequests();
+			if (!haloRequests.empty()) MPI_Startall(haloRequests.size(), &haloRequests[0]);
 #endif
 		}
 
 		void waitHalo() {
 #ifdef ENABLE_MPI
-			//Then we wait
-			MPI_Status status;
-			for (unsigned int i = 0; i < sendRequests.size(); ++i) MPI_Wait(sendRequests[i],&status);
-			for (unsigned int i = 0; i < recvRequests.size(); ++i) MPI_Wait(recvRequests[i],&status);
-			
-			//delete everything
-			for (unsigned int i = 0; i < sendRequests.size(); ++i) delete sendRequests[i];
-			for (unsigned int i = 0; i < recvRequests.size(); ++i) delete recvRequests[i];
-
-			sendRequests.clear();
-			recvRequests.clear();
+			if (!haloRequests.empty()) MPI_Waitall(haloRequests.size(), &haloRequests[0], MPI_STATUSES_IGNORE);
 #endif
 		}
 		
@@ -234,8 +197,27 @@ template<typename T, typename TLayout> class Lattice {
 		T* localdata;
 		TLayout layout;
 #ifdef ENABLE_MPI
-		std::vector<MPI_Request*> sendRequests;
-		std::vector<MPI_Request*> recvRequests;
+		std::vector<MPI_Request> haloRequests;
+
+		void initializeHaloRequests() {
+			const HaloExchangePlan<T,TLayout>& plan = HaloExchangePlan<T,TLayout>::getInstance();
+			haloRequests.resize(plan.sends.size() + plan.receives.size());
+			for (unsigned int i = 0; i < plan.sends.size(); ++i) {
+				MPI_Send_init((void*)(&localdata[plan.sends[i].offset]),plan.sends[i].count,MpiType<T>::type,plan.sends[i].peer,plan.sends[i].tag,MPI_COMM_WORLD,&haloRequests[i]);
+			}
+			for (unsigned int i = 0; i < plan.receives.size(); ++i) {
+				MPI_Recv_init((void*)(&localdata[plan.receives[i].offset]),plan.receives[i].count,MpiType<T>::type,plan.receives[i].peer,plan.receives[i].tag,MPI_COMM_WORLD,&haloRequests[plan.sends.size() + i]);
+			}
+		}
+
+		void destroyHaloRequests() {
+			int finalized = 0;
+			MPI_Finalized(&finalized);
+			if (!finalized) {
+				for (unsigned int i = 0; i < haloRequests.size(); ++i) MPI_Request_free(&haloRequests[i]);
+			}
+			haloRequests.clear();
+		}
 #endif
 				
 	public:
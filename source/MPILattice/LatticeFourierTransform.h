@@ -0,0 +1,290 @@
+#ifndef LATTICEFOURIERTRANSFORM_H
+#define LATTICEFOURIERTRANSFORM_H
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+#include <complex>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+
+namespace Lattice {
+
+/**
+ * Fast Fourier transform of length n with the mixed radix Cooley-Tukey algorithm, every prime factor of n is done
+ * with a direct butterfly, so any lattice size is allowed. The transform is out of place and not normalized:
+ * out[k] = sum_j exp(sign*2*pi*i*j*k/n) in[j*stride].
+ */
+class FourierTransform {
+	public:
+		FourierTransform() : n(0), sign(1) { }
+
+		FourierTransform(int _n, int _sign) : n(_n), sign(_sign), twiddles(_n) {
+			for (int j = 0; j < n; ++j) {
+				double angle = sign*2.*3.14159265358979323846264338327950288*j/n;
+				twiddles[j] = std::complex<double>(cos(angle), sin(angle));
+			}
+			//The pairs (p, m) of the recursion, with n = p*m at every level
+			int m = n;
+			for (int p = 2; m > 1; ) {
+				while (m % p != 0) {
+					p = (p == 2) ? 3 : p + 2;
+					if (p*p > m) p = m;
+				}
+				m /= p;
+				factors.push_back(p);
+				factors.push_back(m);
+			}
+		}
+
+		int size() const {
+			return n;
+		}
+
+		//The scratch must have the size of the largest prime factor of n
+		void transform(std::complex<double>* out, const std::complex<double>* in, int stride, std::complex<double>* scratch) const {
+			if (n == 1) out[0] = in[0];
+			else this->work(out, in, 1, stride, 0, scratch);
+		}
+
+		int maximalFactor() const {
+			int result = 1;
+			for (unsigned int i = 0; i < factors.size(); i += 2) result = std::max(result, factors[i]);
+			return result;
+		}
+
+	private:
+		void work(std::complex<double>* out, const std::complex<double>* in, int fstride, int stride, int level, std::complex<double>* scratch) const {
+			const int p = factors[level], m = factors[level + 1];
+			if (m == 1) {
+				for (int j = 0; j < p; ++j) out[j] = in[j*fstride*stride];
+			}
+			else {
+				for (int j = 0; j < p; ++j) this->work(out + j*m, in + j*fstride*stride, fstride*p, stride, level + 2, scratch);
+			}
+			//Butterflies of radix p on the p transforms of length m
+			for (int u = 0; u < m; ++u) {
+				for (int q = 0; q < p; ++q) scratch[q] = out[u + q*m];
+				for (int q = 0; q < p; ++q) {
+					int k = u + q*m;
+					std::complex<double> sum = scratch[0];
+					int twiddle = 0;
+					for (int r = 1; r < p; ++r) {
+						twiddle = (twiddle + fstride*k) % n;
+						sum += scratch[r]*twiddles[twiddle];
+					}
+					out[k] = sum;
+				}
+			}
+		}
+
+		int n;
+		int sign;
+		std::vector< std::complex<double> > twiddles;
+		std::vector<int> factors;
+};
+
+/**
+ * Distributed Fourier transform of the fields with layout TLayout, with a pencil decomposition: the transform along a direction
+ * is done by the processors sharing the other coordinates of the grid, the lines along the direction are redistributed among
+ * them with a transposition (MPI_Alltoallv), transformed locally and sent back. The fields have numberComponents complex
+ * components per site, stored in data[site*numberComponents + c] for the local sites, all of them are transformed together.
+ * After the transform, the value of the momentum k_mu = 2 pi n_mu/glob_mu is stored on the local site of global coordinates n:
+ * F(k) = sum_x exp(sign*i*k.x) f(x), without normalization. The layout must be initialized before the construction.
+ */
+template<typename TLayout> class LatticeFourierTransform {
+	public:
+		/**
+		 * @param _numberComponents the number of complex components of a site
+		 * @param _dimensions 4 for the transform over all the lattice, 3 for the spatial transform on every time slice
+		 * @param timeSlice if not negative, the spatial transform is done only on this time slice, the other sites are left unchanged
+		 */
+		LatticeFourierTransform(int _numberComponents, int _dimensions = 4, int timeSlice = -1) : numberComponents(_numberComponents), dimensions(_dimensions) {
+			loc[0] = TLayout::glob_x/TLayout::pgrid_x;
+			loc[1] = TLayout::glob_y/TLayout::pgrid_y;
+			loc[2] = TLayout::glob_z/TLayout::pgrid_z;
+			loc[3] = TLayout::glob_t/TLayout::pgrid_t;
+			pgrid[0] = TLayout::pgrid_x;
+			pgrid[1] = TLayout::pgrid_y;
+			pgrid[2] = TLayout::pgrid_z;
+			pgrid[3] = TLayout::pgrid_t;
+
+			//The origin of the local box, the boxes of the processors do not wrap around the lattice
+			int origin[4] = {TLayout::glob_x, TLayout::glob_y, TLayout::glob_z, TLayout::glob_t};
+			for (int site = 0; site < TLayout::localsize; ++site) {
+				origin[0] = std::min(origin[0], TLayout::globalIndexX(site));
+				origin[1] = std::min(origin[1], TLayout::globalIndexY(site));
+				origin[2] = std::min(origin[2], TLayout::globalIndexZ(site));
+				origin[3] = std::min(origin[3], TLayout::globalIndexT(site));
+			}
+			//With a single time slice the box has one site in the time direction, it is empty on the processors without the slice
+			for (int mu = 0; mu < 4; ++mu) boxLoc[mu] = loc[mu];
+			if (timeSlice >= 0) boxLoc[3] = (timeSlice >= origin[3] && timeSlice < origin[3] + loc[3]) ? 1 : 0;
+			boxSite.resize(boxLoc[0]*boxLoc[1]*boxLoc[2]*boxLoc[3]);
+			for (int site = 0; site < TLayout::localsize; ++site) {
+				if (timeSlice >= 0 && TLayout::globalIndexT(site) != timeSlice) continue;
+				int box = ((TLayout::globalIndexX(site) - origin[0])*loc[1] + (TLayout::globalIndexY(site) - origin[1]))*loc[2] + (TLayout::globalIndexZ(site) - origin[2]);
+				if (timeSlice < 0) box = box*loc[3] + (TLayout::globalIndexT(site) - origin[3]);
+				boxSite[box] = site;
+			}
+			int coordinate[4];
+			for (int mu = 0; mu < 4; ++mu) coordinate[mu] = origin[mu]/loc[mu];
+
+			for (int mu = 0; mu < dimensions; ++mu) {
+				plans[2*mu] = FourierTransform(TLayout::glob[mu], 1);
+				plans[2*mu + 1] = FourierTransform(TLayout::glob[mu], -1);
+				groupRank[mu] = coordinate[mu];
+#ifdef ENABLE_MPI
+				//The processors with the same coordinates in the other directions, ordered with the coordinate in the direction mu
+				int color = 0;
+				for (int nu = 0; nu < 4; ++nu) {
+					if (nu != mu) color = color*pgrid[nu] + coordinate[nu];
+				}
+				MPI_Comm_split(MPI_COMM_WORLD, color, coordinate[mu], &communicators[mu]);
+#endif
+			}
+		}
+
+		~LatticeFourierTransform() {
+#ifdef ENABLE_MPI
+			int finalized = 0;
+			MPI_Finalized(&finalized);
+			if (!finalized) {
+				for (int mu = 0; mu < dimensions; ++mu) MPI_Comm_free(&communicators[mu]);
+			}
+#endif
+		}
+
+		/**
+		 * This function transforms in place the local data of the fields, it must be called by all the processors
+		 * @param data the components of the local sites, data[site*numberComponents + c]
+		 * @param sign the sign of the exponent, +1 or -1
+		 */
+		void transform(std::vector< std::complex<double> >& data, int sign) {
+			if (static_cast<int>(data.size()) != TLayout::localsize*numberComponents) {
+				std::cout << "LatticeFourierTransform::Fatal error, the data have size " << data.size() << " instead of " << TLayout::localsize*numberComponents << std::endl;
+				exit(17);
+			}
+			//The data in the lexicographic order of the local box, the order of the lines
+			const int boxVolume = boxSite.size();
+			if (boxVolume == 0) return;
+			std::vector< std::complex<double> > box(boxVolume*numberComponents);
+#pragma omp parallel for
+			for (int i = 0; i < boxVolume; ++i) {
+				for (int c = 0; c < numberComponents; ++c) box[i*numberComponents + c] = data[boxSite[i]*numberComponents + c];
+			}
+			for (int mu = 0; mu < dimensions; ++mu) this->transformDirection(box, mu, sign);
+#pragma omp parallel for
+			for (int i = 0; i < boxVolume; ++i) {
+				for (int c = 0; c < numberComponents; ++c) data[boxSite[i]*numberComponents + c] = box[i*numberComponents + c];
+			}
+		}
+
+		int getNumberComponents() const {
+			return numberComponents;
+		}
+
+	private:
+		void transformDirection(std::vector< std::complex<double> >& box, int mu, int sign) {
+			const int length = loc[mu], processors = pgrid[mu], globalLength = length*processors;
+			int stride = numberComponents;
+			for (int nu = 3; nu > mu; --nu) stride *= boxLoc[nu];
+			//The lines along mu are (outer, inner), the element j of a line is box[outer*length*stride + j*stride + inner]
+			const int inner = stride, outer = static_cast<int>(box.size())/(length*stride);
+			const int numberLines = inner*outer;
+			const FourierTransform& plan = plans[2*mu + (sign > 0 ? 0 : 1)];
+
+			//The lines are shared among the processors of the group, the processor j transforms the lines from start[j] to start[j + 1]
+			std::vector<int> start(processors + 1);
+			for (int j = 0; j <= processors; ++j) start[j] = (numberLines/processors)*j + std::min(j, numberLines % processors);
+			const int myLines = start[groupRank[mu] + 1] - start[groupRank[mu]];
+
+			std::vector< std::complex<double> > lines(myLines*globalLength);
+			std::vector< std::complex<double> > exchange(numberLines*length);
+			//Pieces of the lines of this processor sent to the processor j, in the order of the lines
+#pragma omp parallel for
+			for (int line = 0; line < numberLines; ++line) {
+				int base = (line/inner)*length*stride + (line % inner);
+				for (int j = 0; j < length; ++j) exchange[line*length + j] = box[base + j*stride];
+			}
+
+#ifdef ENABLE_MPI
+			if (processors > 1) {
+				std::vector<int> sendCounts(processors), sendOffsets(processors), receiveCounts(processors), receiveOffsets(processors);
+				for (int j = 0; j < processors; ++j) {
+					sendCounts[j] = 2*(start[j + 1] - start[j])*length;
+					sendOffsets[j] = 2*start[j]*length;
+					receiveCounts[j] = 2*myLines*length;
+					receiveOffsets[j] = 2*j*myLines*length;
+				}
+				//A processor can have no lines when the lines are less than the processors of the group
+				std::vector< std::complex<double> > received(std::max(1, myLines*globalLength));
+				MPI_Alltoallv(&exchange[0], &sendCounts[0], &sendOffsets[0], MPI_DOUBLE, &received[0], &receiveCounts[0], &receiveOffsets[0], MPI_DOUBLE, communicators[mu]);
+				//The piece of the processor j is the part j of the full line
+#pragma omp parallel for
+				for (int line = 0; line < myLines; ++line) {
+					for (int j = 0; j < processors; ++j) {
+						for (int i = 0; i < length; ++i) lines[line*globalLength + j*length + i] = received[(j*myLines + line)*length + i];
+					}
+				}
+				this->transformLines(lines, myLines, plan);
+#pragma omp parallel for
+				for (int line = 0; line < myLines; ++line) {
+					for (int j = 0; j < processors; ++j) {
+						for (int i = 0; i < length; ++i) received[(j*myLines + line)*length + i] = lines[line*globalLength + j*length + i];
+					}
+				}
+				//The inverse transposition, the counts are exchanged
+				MPI_Alltoallv(&received[0], &receiveCounts[0], &receiveOffsets[0], MPI_DOUBLE, &exchange[0], &sendCounts[0], &sendOffsets[0], MPI_DOUBLE, communicators[mu]);
+			}
+			else {
+				this->transformLines(exchange, numberLines, plan);
+			}
+#endif
+#ifndef ENABLE_MPI
+			this->transformLines(exchange, numberLines, plan);
+#endif
+
+#pragma omp parallel for
+			for (int line = 0; line < numberLines; ++line) {
+				int base = (line/inner)*length*stride + (line % inner);
+				for (int j = 0; j < length; ++j) box[base + j*stride] = exchange[line*length + j];
+			}
+		}
+
+		//Transforms in place the numberLines contiguous lines of lines
+		void transformLines(std::vector< std::complex<double> >& lines, int numberLines, const FourierTransform& plan) const {
+			const int n = plan.size();
+#pragma omp parallel
+			{
+				std::vector< std::complex<double> > result(n), scratch(plan.maximalFactor());
+#pragma omp for
+				for (int line = 0; line < numberLines; ++line) {
+					plan.transform(&result[0], &lines[line*n], 1, &scratch[0]);
+					for (int j = 0; j < n; ++j) lines[line*n + j] = result[j];
+				}
+			}
+		}
+
+		int numberComponents;
+		int dimensions;
+		int loc[4];
+		//The sizes of the local box, loc without time slice
+		int boxLoc[4];
+		int pgrid[4];
+		//The coordinate of this processor in the grid, its rank in the communicator of the direction
+		int groupRank[4];
+		//The local site of the position i of the lexicographic order of the local box
+		std::vector<int> boxSite;
+		//The transforms with positive and negative sign of every direction
+		FourierTransform plans[8];
+#ifdef ENABLE_MPI
+		MPI_Comm communicators[4];
+#endif
+};
+
+} /* namespace Lattice */
+
+#endif /* LATTICEFOURIERTRANSFORM_H */
@@ -0,0 +1,107 @@
+#ifndef LATTICEMEMORYPOOL_H
+#define LATTICEMEMORYPOOL_H
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <vector>
+
+namespace Lattice {
+
+//The storage of the lattices: the released buffers are kept in buckets of the same size and reused by the next lattice
+//with the same type and layout, so that the temporaries of the solvers and of the updaters do not go through the allocator.
+//A new buffer is first touched by the openmp threads with the static schedule of the loops on the sites,
+//in this way its pages are placed on the memory of the socket of the thread that processes them.
+class LatticeMemoryPool {
+	public:
+		static LatticeMemoryPool& getInstance() {
+			static LatticeMemoryPool pool;
+			return pool;
+		}
+
+		//Buffer of numberSites elements of siteSize bytes, aligned to 64 bytes. The buffer is set to zero,
+		//a reused buffer is left untouched if initialize == false (the caller overwrites all the sites)
+		void* allocate(std::size_t siteSize, int numberSites, bool initialize = true) {
+			const std::size_t size = siteSize*numberSites;
+			void* buffer = 0;
+#pragma omp critical(latticeMemoryPool)
+			{
+				std::map< std::size_t, std::vector<void*> >::iterator bucket = freeBuffers.find(size);
+				if (bucket != freeBuffers.end() && !bucket->second.empty()) {
+					buffer = bucket->second.back();
+					bucket->second.pop_back();
+					pooledMemory -= size;
+				}
+				currentUsage += size;
+				if (currentUsage > peakUsage) peakUsage = currentUsage;
+			}
+			if (buffer == 0) {
+				if (posix_memalign(&buffer, 64, size) != 0) {
+#pragma omp critical(latticeMemoryPool)
+					currentUsage -= size;
+					throw std::bad_alloc();
+				}
+				initialize = true;
+			}
+			if (initialize) {
+				char* data = static_cast<char*>(buffer);
+#pragma omp parallel for
+				for (int site = 0; site < numberSites; ++site) memset(&data[site*siteSize], 0, siteSize);
+			}
+			return buffer;
+		}
+
+		void release(void* buffer, std::size_t siteSize, int numberSites) {
+			const std::size_t size = siteSize*numberSites;
+#pragma omp critical(latticeMemoryPool)
+			{
+				freeBuffers[size].push_back(buffer);
+				currentUsage -= size;
+				pooledMemory += size;
+			}
+		}
+
+		//Frees the buffers kept for reuse, the lattices still alive are not affected
+		void clear() {
+#pragma omp critical(latticeMemoryPool)
+			{
+				for (std::map< std::size_t, std::vector<void*> >::iterator bucket = freeBuffers.begin(); bucket != freeBuffers.end(); ++bucket) {
+					for (unsigned int i = 0; i < bucket->second.size(); ++i) free(bucket->second[i]);
+				}
+				freeBuffers.clear();
+				pooledMemory = 0;
+			}
+		}
+
+		//Bytes used by the lattices alive
+		std::size_t getCurrentUsage() const {
+			return currentUsage;
+		}
+
+		//Maximum of the bytes used by the lattices alive at the same time
+		std::size_t getPeakUsage() const {
+			return peakUsage;
+		}
+
+		//Bytes kept for reuse
+		std::size_t getPooledMemory() const {
+			return pooledMemory;
+		}
+
+	private:
+		LatticeMemoryPool() : currentUsage(0), peakUsage(0), pooledMemory(0) { }
+		~LatticeMemoryPool() {
+			clear();
+		}
+		LatticeMemoryPool(const LatticeMemoryPool&);
+		LatticeMemoryPool& operator=(const LatticeMemoryPool&);
+
+		std::map< std::size_t, std::vector<void*> > freeBuffers;
+		std::size_t currentUsage;
+		std::size_t peakUsage;
+		std::size_t pooledMemory;
+};
+
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef LATTICEWORKSPACE_H
+#define LATTICEWORKSPACE_H
+
+namespace Lattice {
+
+/**
+ * Pool of N temporary lattices owned by an object, allocated at their first use and then reused.
+ * The buffers are never shared: a copy of the owner starts with an empty pool.
+ */
+template<typename TLattice, int N> class LatticeWorkspace {
+public:
+	LatticeWorkspace() {
+		for (int k = 0; k < N; ++k) buffers[k] = 0;
+	}
+	LatticeWorkspace(const LatticeWorkspace&) {
+		for (int k = 0; k < N; ++k) buffers[k] = 0;
+	}
+	~LatticeWorkspace() {
+		for (int k = 0; k < N; ++k) delete buffers[k];
+	}
+
+	LatticeWorkspace& operator=(const LatticeWorkspace&) {
+		return *this;
+	}
+
+	TLattice& operator[](int index) {
+		if (buffers[index] == 0) buffers[index] = new TLattice();
+		return *buffers[index];
+	}
+
+private:
+	TLattice* buffers[N];
+};
+
+}
+
+#endif
@@ -32,6 +32,4 @@ vect4* LocalLayout::sup_table = 0;
 vect4* LocalLayout::down_table = 0;
 Site* LocalLayout::globalCoordinate = 0;
 
-int* LocalLayout::localIndex = 0;
-
 }
@@ -104,9 +104,6 @@ class LocalLayout {
 				}
 			}
 
-			localIndex = new int[completesize];
-			for (int site = 0; site < completesize; ++site) localIndex[site] = site;
-			
 		}
 	
 		static int localsize;
@@ -120,7 +117,9 @@ class LocalLayout {
 		//The globalCoordinate of a local site
 		static Site* globalCoordinate;
 		//The local index of a global one, not needed, only for compatibility with mpi
-		static int* localIndex;
+		static int getLocalIndex(int globalIndex) {
+			return globalIndex;
+		}
 
 		static int globalIndexX(int site) {
 			return globalCoordinate[site].x;
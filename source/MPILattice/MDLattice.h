@@ -66,16 +66,27 @@ public:
 	}
 
 	void updateHalo() {
+		communicateHalo();
+		waitHalo();
+	}
+
+	//Split-phase halo exchange, as in Lattice
+	void communicateHalo() {
 		for (int k = 0; k < M*N; ++k) {
 			real_part[k].communicateHalo();
 			imag_part[k].communicateHalo();
 		}
+	}
+
+	void waitHalo() {
 		for (int k = 0; k < M*N; ++k) {
 			real_part[k].waitHalo();
 			imag_part[k].waitHalo();
 		}
 	}
 
+	typedef TLayout Layout;
+
 	Lattice<T, TLayout> real_part[M*N];
 	Lattice<T, TLayout> imag_part[M*N];
 
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <algorithm>
 #include <map>
+#include <vector>
 #include <fstream>
 #include <string>
 #include <utility>
@@ -60,10 +61,6 @@ template<typename Stencil> class MpiLayout {
 			}
 			
 			
-			//The processor number that is given to every site
-			int* processorNumberLattice = new int[globalVolume];
-			//The Site to every integer index
-			Site* globalMapSite = new Site[globalVolume];
 			loc_x = glob_x / pgrid_x;
 			loc_y = glob_y / pgrid_y;
 			loc_z = glob_z / pgrid_z;
@@ -86,279 +83,117 @@ template<typename Stencil> class MpiLayout {
 				std::cout << "The global size " << glob_t << " is not divisible in the grid size " << pgrid_t << std::endl;
 				exit(3);
 			}
-	
-			//First we partition the lattice in processor and we set the coordinate
-#pragma omp parallel for
-			for (int x = 0; x < glob_x; ++x) {
-				for (int y = 0; y < glob_y; ++y) {
-					for (int z = 0; z < glob_z; ++z) {
-						for (int t = 0; t < glob_t; ++t) {
-							int index = getGlobalCoordinate(x, y, z, t);
-							int processor = x/loc_x;
-							processor = pgrid_y*processor + y/loc_y;
-							processor = pgrid_z*processor + z/loc_z;
-							processor = pgrid_t*processor + t/loc_t;
-							processorNumberLattice[index] = processor;
-							globalMapSite[index] = Site(x,y,z,t);
-						}
-					}
-				}
-			}
 
-//#pragma omp parallel for
-//			for (int site = 0; site < globalVolume; ++site) if (processorNumberLattice[site] == -1 || processorNumberLattice[site] >= numberProcessors) std::cout << "Fatal Error!" << std::endl;
-			
-			//For every site we store the processor that want to read it, if it is not the same
-			std::vector<int>* exchangeTable = new std::vector<int>[globalVolume];
-			for (int x = 0; x < glob_x; ++x) {
-				for (int y = 0; y < glob_y; ++y) {
-					for (int z = 0; z < glob_z; ++z) {
-						for (int t = 0; t < glob_t; ++t) {
-							for (unsigned int i = 0; i < Stencil::neighbourSites.size(); ++i) {
-								Site site(x,y,z,t);
-								int index = getGlobalCoordinate(site);
-								int shiftedIndex = getGlobalCoordinate(site+Stencil::neighbourSites[i]);
-								if (index == shiftedIndex) std::cout << "Fatal error in exchangeTable calculations!" << std::endl;
-								if (processorNumberLattice[index] != processorNumberLattice[shiftedIndex]) exchangeTable[shiftedIndex].push_back(processorNumberLattice[index]);
-							}
-						}
+			MPI_Comm_rank(MPI_COMM_WORLD, &this_processor);
+			localsize = loc_x*loc_y*loc_z*loc_t;
+			setOrigin();
+			++generation;
+
+			//Every processor computes only its own sites and the sites of its halo, the halo being the sites of the other processors read by the stencil
+			std::vector<int> haloSites;
+#pragma omp parallel
+			{
+				std::vector<int> threadHaloSites;
+#pragma omp for
+				for (int site = 0; site < localsize; ++site) {
+					Site localSite = getBoxSite(site);
+					for (unsigned int i = 0; i < Stencil::neighbourSites.size(); ++i) {
+						Site shiftedSite = localSite + Stencil::neighbourSites[i];
+						if (getOwner(shiftedSite) != this_processor) threadHaloSites.push_back(getGlobalCoordinate(shiftedSite));
 					}
 				}
+#pragma omp critical
+				haloSites.insert(haloSites.end(), threadHaloSites.begin(), threadHaloSites.end());
 			}
+			std::sort(haloSites.begin(), haloSites.end());
+			haloSites.erase(std::unique(haloSites.begin(), haloSites.end()), haloSites.end());
+			completesize = localsize + haloSites.size();
 
-			//We sort and clean duplicates
+			//To every site it is associated the integer key (owner, sharers...), the sites with the same key form a chunk
+			std::vector< std::vector<int> > siteKeys(completesize);
+			std::vector<int> siteGlobalIndex(completesize);
 #pragma omp parallel for
-			for (int site = 0; site < globalVolume; ++site) {
-				std::sort(exchangeTable[site].begin(), exchangeTable[site].end());
-				exchangeTable[site].erase(std::unique(exchangeTable[site].begin(), exchangeTable[site].end()), exchangeTable[site].end());
-			}
-
-			/*int ll = 0;
-			for (int site = 0; site < globalVolume; ++site) {
-				if (processorNumberLattice[site] == this_processor) ++ll;
-			}
-			if (ll != loc_x*loc_y*loc_z*loc_t) std::cout << "Localsize mismatch" << std::endl;*/
-			
-			//Now we get the id; to every site it is associated an unique string depending on who would like to read it
-			int* idLattice = new int[globalVolume];
-			std::vector<std::string> ids;
-			for (int site = 0; site < globalVolume; ++site) {
-				std::string id = Update::toString(processorNumberLattice[site]);
-
-				for (unsigned int i = 0; i < exchangeTable[site].size(); ++i) {
-					id = id + "." + Update::toString(exchangeTable[site][i]);
-				}
-				
-				//Differences also for the size of sharers
-				id = id + "." + Update::toString(exchangeTable[site].size());
-				
-				bool found = false;
-				for (unsigned int i = 0; i < ids.size(); ++i) {
-					if (ids[i] == id) {
-						idLattice[site] = i;
-						found = true;
-					}
-				}
-				if (!found) {
-					idLattice[site] = ids.size();
-					ids.push_back(id);
-				}
-			}
-			
-			//Now we divide the lattice in chunk, every chunk has the same owner and the same sharers
-			numberChunks = ids.size();
-			latticeChunks = std::vector<LatticeChunk>(numberChunks);
-			for (int i = 0; i < numberChunks; ++i) {
-				latticeChunks[i].size = 0;
-				latticeChunks[i].id = i;
-				latticeChunks[i].owner = -1;
+			for (int site = 0; site < completesize; ++site) {
+				if (site < localsize) siteGlobalIndex[site] = getGlobalCoordinate(getBoxSite(site));
+				else siteGlobalIndex[site] = haloSites[site - localsize];
+				siteKeys[site] = getChunkKey(getSite(siteGlobalIndex[site]));
 			}
 
-			//Ensure
-			/*if (numberChunks > MPI_TAG_UB) {
-				std::cout << "MPI tag maximum number " << MPI_TAG_UB << " is too small for " << numberChunks << " chunks! " << std::endl;
-				exit(35);
-			}*/
-			
-			//We take the number of sites in every chunk
-			for (int site = 0; site < globalVolume; ++site) {
-				++latticeChunks[idLattice[site]].size;
-				if (latticeChunks[idLattice[site]].owner != -1 && latticeChunks[idLattice[site]].owner != processorNumberLattice[site]) std::cout << "Fatal error in reallocating numbers!" << latticeChunks[idLattice[site]].owner << " " << processorNumberLattice[site] << std::endl;
-				latticeChunks[idLattice[site]].owner = processorNumberLattice[site];
-				latticeChunks[idLattice[site]].sharers = exchangeTable[site];
-				if (idLattice[site] >= numberChunks) std::cout << "Fatal error in id too big" << std::endl;
-			}
-			
-			MPI_Comm_rank(MPI_COMM_WORLD, &this_processor);
-			
-			localsize = loc_x*loc_y*loc_z*loc_t;
-			completesize = localsize;
-			sharedsize = 0;
-			//Now we get the completesize (localsize + sharedsize)
-			for (int i = 0; i < numberChunks; ++i) {
-				for (unsigned int j = 0; j < latticeChunks[i].sharers.size(); ++j) {
-					if (latticeChunks[i].sharers[j] == this_processor) {
-						completesize += latticeChunks[i].size;
-					}
-				}
+			std::map< std::vector<int>, std::vector<int> > chunkSites;
+			for (int site = 0; site < completesize; ++site) {
+				chunkSites[siteKeys[site]].push_back(siteGlobalIndex[site]);
 			}
+			std::vector< std::vector<int> >().swap(siteKeys);
+			std::vector<int>().swap(siteGlobalIndex);
+			std::vector<int>().swap(haloSites);
 
-			//Now we create the tags for the mpi communications
+			//The tag of a chunk for the pair (owner, sharer) is its position among the chunks of the same pair,
+			//the key order is the same on both processors and they get the same tag without communications
 			std::map< std::pair<int, int> , int > bridgeCommunications;
-			for (int i = 0; i < numberChunks; ++i) {
-				for (unsigned int j = 0; j < latticeChunks[i].sharers.size(); ++j) {
-					std::pair<int, int> pr(latticeChunks[i].owner, latticeChunks[j].sharers[j]);
-					if (bridgeCommunications.count(pr)) {
-						latticeChunks[i].tags.push_back(bridgeCommunications[pr]+1);
-						++bridgeCommunications[pr];
-					}
-					else {
-						latticeChunks[i].tags.push_back(0);
-						bridgeCommunications[pr] = 0;
-					}
+			std::map< std::vector<int>, std::vector<int> > chunkTags;
+			for (std::map< std::vector<int>, std::vector<int> >::const_iterator it = chunkSites.begin(); it != chunkSites.end(); ++it) {
+				for (unsigned int j = 1; j < it->first.size(); ++j) {
+					std::pair<int, int> pr(it->first[0], it->first[j]);
+					chunkTags[it->first].push_back(bridgeCommunications[pr]++);
 				}
 			}
-			
-			
-			//We get the localIndex, for converting global index to local index, -1 if it is not present locally
-			localIndex = new int[globalVolume];
-#pragma omp parallel for
-			for (int site = 0; site < globalVolume; ++site) localIndex[site] = -1;
-			
-			int offset = 0;
+
+			//The local part that is shared comes first, then the local part not shared and finally the halo,
+			//inside a chunk the sites are ordered with the global index, the same order is used by the owner and by the sharers
+			latticeChunks.clear();
+			globalCoordinate = new Site[completesize];
+			sharedsize = 0;
 			int index = 0;
-			//We set now also where a chunk starts in the local array
-			//We start first with the local part that is shared
-			for (int i = 0; i < numberChunks; ++i) {
-				latticeChunks[i].offset = -1;
-				if (latticeChunks[i].owner == this_processor && latticeChunks[i].sharers.size() != 0) {
-					sharedsize += latticeChunks[i].size;
-					latticeChunks[i].offset = offset;
-					offset += latticeChunks[i].size;
-					for (int site = 0; site < globalVolume; ++site) {
-						if (idLattice[site] == latticeChunks[i].id) {
-							localIndex[site] = index;
-							++index;
-						}
-					}
-				}
-			}
-			
-			//Now we put the local part not shared
-			for (int i = 0; i < numberChunks; ++i) {
-				if (latticeChunks[i].owner == this_processor && latticeChunks[i].sharers.size() == 0) {
-					latticeChunks[i].offset = offset;
-					offset += latticeChunks[i].size;
-					for (int site = 0; site < globalVolume; ++site) {
-						if (idLattice[site] == latticeChunks[i].id) {
-							localIndex[site] = index;
-							++index;
-						}
+			for (int part = 0; part < 3; ++part) {
+				for (std::map< std::vector<int>, std::vector<int> >::iterator it = chunkSites.begin(); it != chunkSites.end(); ++it) {
+					int chunkPart = (it->first[0] != this_processor) ? 2 : ((it->first.size() > 1) ? 0 : 1);
+					if (chunkPart != part) continue;
+					LatticeChunk chunk;
+					chunk.id = latticeChunks.size();
+					chunk.owner = it->first[0];
+					chunk.size = it->second.size();
+					chunk.offset = index;
+					chunk.sharers = std::vector<int>(it->first.begin() + 1, it->first.end());
+					chunk.tags = chunkTags[it->first];
+					latticeChunks.push_back(chunk);
+					if (part == 0) sharedsize += chunk.size;
+
+					std::sort(it->second.begin(), it->second.end());
+					for (unsigned int i = 0; i < it->second.size(); ++i) {
+						globalCoordinate[index] = getSite(it->second[i]);
+						++index;
 					}
 				}
-			}
-			
-			//Now offset should be equal to localsize
-			if (offset != localsize && this_processor == 0) {
-				std::cout << "Estimated localsize is different: " << offset << " " << localsize << "!" << std::endl;
-				exit(7);
-			}
-			
-			//Now we put the part that belongs to other processes but that is accessed also by this process
-			for (int i = 0; i < numberChunks; ++i) {
-				for (unsigned int j = 0; j < latticeChunks[i].sharers.size(); ++j) {
-					if (latticeChunks[i].sharers[j] == this_processor) {
-						latticeChunks[i].offset = offset;
-						offset += latticeChunks[i].size;
-						for (int site = 0; site < globalVolume; ++site) {
-							if (idLattice[site] == latticeChunks[i].id) {
-								localIndex[site] = index;
-								++index;
-							}
-						}
-					}
+				//Now index should be equal to localsize
+				if (part == 1 && index != localsize) {
+					std::cout << "Estimated localsize is different: " << index << " " << localsize << "!" << std::endl;
+					exit(7);
 				}
 			}
-			
-			//Now offset should be equal to completesize
-			if (offset != completesize && this_processor == 0) {
-				std::cout << "Estimated completesize is different: " << offset << " " << completesize << "!" << std::endl;
+			numberChunks = latticeChunks.size();
+
+			//Now index should be equal to completesize
+			if (index != completesize) {
+				std::cout << "Estimated completesize is different: " << index << " " << completesize << "!" << std::endl;
 				exit(7);
 			}
-			
-			//Now we construct the global sup table
-			std::vector<Site> deltaPlus;
-			deltaPlus.push_back(Site(1,0,0,0));
-			deltaPlus.push_back(Site(0,1,0,0));
-			deltaPlus.push_back(Site(0,0,1,0));
-			deltaPlus.push_back(Site(0,0,0,1));
-	
-			vect4* global_sup_table = new vect4[globalVolume];
-#pragma omp parallel for
-			for (int x = 0; x < glob_x; ++x) {
-				for (int y = 0; y < glob_y; ++y) {
-					for (int z = 0; z < glob_z; ++z) {
-						for (int t = 0; t < glob_t; ++t) {
-							Site site(x,y,z,t);
-							int index = getGlobalCoordinate(site);
-							for (unsigned int i = 0; i < 4; ++i) {
-								global_sup_table[index][i] = getGlobalCoordinate(site + deltaPlus[i]);
-							}
-						}
-					}
-				}
-			}
-	
-			//Now we construct the global down table
-			std::vector<Site> deltaMinus;
-			deltaMinus.push_back(Site(-1,0,0,0));
-			deltaMinus.push_back(Site(0,-1,0,0));
-			deltaMinus.push_back(Site(0,0,-1,0));
-			deltaMinus.push_back(Site(0,0,0,-1));
-	
-			vect4* global_down_table = new vect4[globalVolume];
-#pragma omp parallel for
-			for (int x = 0; x < glob_x; ++x) {
-				for (int y = 0; y < glob_y; ++y) {
-					for (int z = 0; z < glob_z; ++z) {
-						for (int t = 0; t < glob_t; ++t) {
-							Site site(x,y,z,t);
-							int index = getGlobalCoordinate(site);
-							for (unsigned int i = 0; i < 4; ++i) {
-								global_down_table[index][i] = getGlobalCoordinate(site + deltaMinus[i]);
-							}
-						}
-					}
-				}
-			}
-	
+
+			initializeLocalIndex();
+
 			//Now we construct the local sup/down table
 			sup_table = new vect4[completesize];
 			down_table = new vect4[completesize];
-			globalCoordinate = new Site[completesize];
-			for (int i = 0; i < numberChunks; ++i) {
-				if (latticeChunks[i].offset != -1) {
-					for (int site = 0; site < globalVolume; ++site) {
-						if (idLattice[site] == latticeChunks[i].id) {
-							for (int k = 0; k < 4; ++k) {
-								if (localIndex[site] == -1 || localIndex[site] > completesize) std::cout << "Fatal error in localindex!" << localIndex[site] << " " << completesize << " " << localsize << std::endl;
-								if (global_sup_table[site][k] < 0 || global_sup_table[site][k] > globalVolume) std::cout << "Fatal error in global sup/down table!" << std::endl;
-								if (global_down_table[site][k] < 0 || global_down_table[site][k] > globalVolume) std::cout << "Fatal error in global sup/down table!" << std::endl;
-								sup_table[localIndex[site]][k] = localIndex[global_sup_table[site][k]];
-								down_table[localIndex[site]][k] = localIndex[global_down_table[site][k]];
-							}
-							globalCoordinate[localIndex[site]] = globalMapSite[site];
-						}
-					}
-				}
+#pragma omp parallel for
+			for (int site = 0; site < completesize; ++site) {
+				sup_table[site][0] = getLocalIndex(getGlobalCoordinate(globalCoordinate[site] + Site(1,0,0,0)));
+				sup_table[site][1] = getLocalIndex(getGlobalCoordinate(globalCoordinate[site] + Site(0,1,0,0)));
+				sup_table[site][2] = getLocalIndex(getGlobalCoordinate(globalCoordinate[site] + Site(0,0,1,0)));
+				sup_table[site][3] = getLocalIndex(getGlobalCoordinate(globalCoordinate[site] + Site(0,0,0,1)));
+				down_table[site][0] = getLocalIndex(getGlobalCoordinate(globalCoordinate[site] + Site(-1,0,0,0)));
+				down_table[site][1] = getLocalIndex(getGlobalCoordinate(globalCoordinate[site] + Site(0,-1,0,0)));
+				down_table[site][2] = getLocalIndex(getGlobalCoordinate(globalCoordinate[site] + Site(0,0,-1,0)));
+				down_table[site][3] = getLocalIndex(getGlobalCoordinate(globalCoordinate[site] + Site(0,0,0,-1)));
 			}
-	
-			delete[] processorNumberLattice;
-			delete[] globalMapSite;
-			delete[] exchangeTable;
-			delete[] idLattice;
-			delete[] global_sup_table;
-			delete[] global_down_table;
 #endif
 #ifndef ENABLE_MPI
 			std::cout << "MPI is not activated at compile time!" << std::endl;
@@ -371,13 +206,7 @@ template<typename Stencil> class MpiLayout {
 			else {
 				int* result = new int[localsize];
 #pragma omp parallel for
-				for (int site = 0; site < localsize; ++site) result[site] = -1;
-#pragma omp parallel for
-				for (int site = 0; site < globalVolume; ++site)	{
-					if (localIndex[site] != -1 && localIndex[site] < localsize) {
-						result[localIndex[site]] = layout.localIndex[site];
-					}
-				}
+				for (int site = 0; site < localsize; ++site) result[site] = layout.getLocalIndex(getGlobalCoordinate(globalCoordinate[site]));
 #pragma omp parallel for
 				for (int site = 0; site < localsize; ++site) if (result[site] == -1) std::cout << "Fatal error in exchangeTable conversions!" << std::endl;
 				coversion_map[T::id] = result;
@@ -391,10 +220,18 @@ template<typename Stencil> class MpiLayout {
 			for (std::map<int,int*>::iterator it = coversion_map.begin(); it != coversion_map.end(); ++it) {
 				delete[] it->second;
 			}
-			delete[] localIndex;
+			coversion_map.clear();
+			delete[] ownedIndex;
 			delete[] sup_table;
 			delete[] down_table;
 			delete[] globalCoordinate;
+			ownedIndex = 0;
+			sup_table = 0;
+			down_table = 0;
+			globalCoordinate = 0;
+			haloIndex.clear();
+			latticeChunks.clear();
+			numberChunks = 0;
 		}
 	
 		static std::vector<LatticeChunk> latticeChunks;
@@ -403,8 +240,28 @@ template<typename Stencil> class MpiLayout {
 		static int completesize;
 		static int sharedsize;
 		static int this_processor;
-		//To every global site it is associated a local site, -1 if it is not present locally
-		static int* localIndex;
+		//Incremented every time the layout is initialized or loaded
+		static int generation;
+		//The origin of the local box of this processor
+		static int origin[4];
+		//The local index of the sites of this processor, in the lexicographic order of the local box
+		static int* ownedIndex;
+		//The pairs (global index, local index) of the halo, sorted with the global index
+		static std::vector< std::pair<int,int> > haloIndex;
+
+		//The local index of a global site, -1 if it is not present locally
+		static int getLocalIndex(int globalIndex) {
+			int t = globalIndex % glob_t;
+			int z = (globalIndex / glob_t) % glob_z;
+			int y = (globalIndex / (glob_t*glob_z)) % glob_y;
+			int x = globalIndex / (glob_t*glob_z*glob_y);
+			if (rankTable(x,y,z,t) == this_processor) {
+				return ownedIndex[loc_t*(loc_z*(loc_y*(x - origin[0]) + (y - origin[1])) + (z - origin[2])) + (t - origin[3])];
+			}
+			std::vector< std::pair<int,int> >::const_iterator it = std::lower_bound(haloIndex.begin(), haloIndex.end(), std::make_pair(globalIndex, -1));
+			if (it != haloIndex.end() && it->first == globalIndex) return it->second;
+			else return -1;
+		}
 		//The sup table
 		static vect4* sup_table;
 		//The down table
@@ -552,25 +409,6 @@ template<typename Stencil> class MpiLayout {
 			xdr_destroy(&xout);
 			fclose(fout);
 
-			//Then we store the global index
-			output_file = basename + ".local_index_" + Update::toString(this_processor) + ".txt";
-
-			fout = fopen(output_file.c_str(), "w");
-			
-			if (!fout) {
-				std::cout << "File not writeble!" << std::endl;
-				return;
-			}
-
-			xdrstdio_create(&xout, fout, XDR_ENCODE);
-
-			for (int site = 0; site < globalVolume; ++site) {
-				xdr_int(&xout, &localIndex[site]);
-			}
-
-			xdr_destroy(&xout);
-			fclose(fout);
-
 			//Now we store the datas of the chunks
 			output_file = basename + ".chunk_" + Update::toString(this_processor) + ".txt";
 			std::fstream chunksfile;
@@ -683,30 +521,9 @@ template<typename Stencil> class MpiLayout {
 			}
 			chunksfile.close();
 
-			//Now we read the globalCoordinate
-			input_file = basename + ".local_index_" + Update::toString(this_processor) + ".txt";
-			
-			FILE* fin(NULL);
-			fin = fopen(input_file.c_str(), "r");
-
-			if (!fin) {
-				std::cout << "File not readble!" << std::endl;
-				return;
-			}
-
-			XDR xin;
-			xdrstdio_create(&xin, fin, XDR_DECODE);
-
-			localIndex = new int[globalVolume];
-			for (int site = 0; site < globalVolume; ++site) {
-				xdr_int(&xin, &localIndex[site]);
-			}
-
-			xdr_destroy(&xin);
-			fclose(fin);
-
 			//Now we read the global coordinate
 			input_file = basename + ".global_coordinate_" + Update::toString(this_processor) + ".txt";
+			FILE* fin(NULL);
 			fin = fopen(input_file.c_str(), "r");
 
 			if (!fin) {
@@ -714,6 +531,7 @@ template<typename Stencil> class MpiLayout {
 				return;
 			}
 
+			XDR xin;
 			xdrstdio_create(&xin, fin, XDR_DECODE);
 
 			globalCoordinate = new Site[completesize];
@@ -726,6 +544,10 @@ template<typename Stencil> class MpiLayout {
 
 			xdr_destroy(&xin);
 			fclose(fin);
+
+			setOrigin();
+			initializeLocalIndex();
+			++generation;
 			
 			//Now we read the downtable
 			input_file = basename + ".downtable_" + Update::toString(this_processor) + ".txt";
@@ -778,6 +600,70 @@ template<typename Stencil> class MpiLayout {
 		}
 		
 	private:
+		static void setOrigin() {
+			int processor = this_processor;
+			origin[3] = (processor % pgrid_t)*loc_t;
+			processor /= pgrid_t;
+			origin[2] = (processor % pgrid_z)*loc_z;
+			processor /= pgrid_z;
+			origin[1] = (processor % pgrid_y)*loc_y;
+			processor /= pgrid_y;
+			origin[0] = processor*loc_x;
+		}
+
+		//The site of the local box of this processor with lexicographic index boxIndex
+		static Site getBoxSite(int boxIndex) {
+			int t = boxIndex % loc_t;
+			int z = (boxIndex / loc_t) % loc_z;
+			int y = (boxIndex / (loc_t*loc_z)) % loc_y;
+			int x = boxIndex / (loc_t*loc_z*loc_y);
+			return Site(origin[0] + x, origin[1] + y, origin[2] + z, origin[3] + t);
+		}
+
+		static Site getSite(int globalIndex) {
+			int t = globalIndex % glob_t;
+			int z = (globalIndex / glob_t) % glob_z;
+			int y = (globalIndex / (glob_t*glob_z)) % glob_y;
+			int x = globalIndex / (glob_t*glob_z*glob_y);
+			return Site(x,y,z,t);
+		}
+
+		static int getOwner(const Site& site) {
+			return rankTable(modulus(site.x,glob_x), modulus(site.y,glob_y), modulus(site.z,glob_z), modulus(site.t,glob_t));
+		}
+
+		//The key (owner, sharers...) of a site, the sharers are the other processors that read the site with the stencil, sorted
+		static std::vector<int> getChunkKey(const Site& site) {
+			int owner = getOwner(site);
+			std::vector<int> sharers;
+			for (unsigned int i = 0; i < Stencil::neighbourSites.size(); ++i) {
+				int reader = getOwner(site - Stencil::neighbourSites[i]);
+				if (reader != owner) sharers.push_back(reader);
+			}
+			std::sort(sharers.begin(), sharers.end());
+			sharers.erase(std::unique(sharers.begin(), sharers.end()), sharers.end());
+			std::vector<int> key(1, owner);
+			key.insert(key.end(), sharers.begin(), sharers.end());
+			return key;
+		}
+
+		//Build the O(localsize) lookup tables used by getLocalIndex from the globalCoordinate of the local sites
+		static void initializeLocalIndex() {
+			delete[] ownedIndex;
+			ownedIndex = new int[localsize];
+#pragma omp parallel for
+			for (int site = 0; site < localsize; ++site) {
+				const Site& position = globalCoordinate[site];
+				ownedIndex[loc_t*(loc_z*(loc_y*(position.x - origin[0]) + (position.y - origin[1])) + (position.z - origin[2])) + (position.t - origin[3])] = site;
+			}
+			haloIndex.resize(completesize - localsize);
+#pragma omp parallel for
+			for (int site = localsize; site < completesize; ++site) {
+				haloIndex[site - localsize] = std::make_pair(getGlobalCoordinate(globalCoordinate[site]), site);
+			}
+			std::sort(haloIndex.begin(), haloIndex.end());
+		}
+
 		static int modulus(int value, int mod) {
 			int ris = value;
 			if (ris >= mod) return modulus(ris - mod, mod);
@@ -814,8 +700,11 @@ template<typename Stencil> int MpiLayout<Stencil>::localsize = 0;
 template<typename Stencil> int MpiLayout<Stencil>::completesize = 0;
 template<typename Stencil> int MpiLayout<Stencil>::sharedsize = 0;
 template<typename Stencil> int MpiLayout<Stencil>::this_processor = 0;
+template<typename Stencil> int MpiLayout<Stencil>::generation = 0;
 
-template<typename Stencil> int* MpiLayout<Stencil>::localIndex = 0;
+template<typename Stencil> int MpiLayout<Stencil>::origin[4];
+template<typename Stencil> int* MpiLayout<Stencil>::ownedIndex = 0;
+template<typename Stencil> std::vector< std::pair<int,int> > MpiLayout<Stencil>::haloIndex;
 template<typename Stencil> vect4* MpiLayout<Stencil>::sup_table = 0;
 template<typename Stencil> vect4* MpiLayout<Stencil>::down_table = 0;
 template<typename Stencil> Site* MpiLayout<Stencil>::globalCoordinate = 0;
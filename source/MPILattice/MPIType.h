@@ -62,6 +62,12 @@ template<> class MpiType<Update::AdjointGroup[6]> {
 		static MPI_Datatype type;
 };
 
+template<> class MpiType<Update::CompressedFundamentalGroup[4]> {
+	public:
+		static const int size = 8;
+		static MPI_Datatype type;
+};
+
 template<> class MpiType<Update::FundamentalVector[4]> {
 	public:
 		static const int size = 8;
@@ -74,13 +80,19 @@ template<> class MpiType<Update::FundamentalVector> {
                 static MPI_Datatype type;
 };
 
-template<> class MpiType<Update::AdjointVector> {
+template<> class MpiType<Update::AdjointComplexVector> {
+        public:
+                static const int size = 8;
+                static MPI_Datatype type;
+};
+
+template<> class MpiType<Update::AdjointRealVector> {
         public:
                 static const int size = 8;
                 static MPI_Datatype type;
 };
 
-template<> class MpiType<Update::AdjointVector[4]> {
+template<> class MpiType<Update::AdjointComplexVector[4]> {
 	public:
 		static const int size = 8;
 		static MPI_Datatype type;
@@ -98,6 +110,18 @@ template<> class MpiType<Update::single_AdjointVector[4]> {
 		static MPI_Datatype type;
 };
 
+template<> class MpiType<Update::single_FundamentalGroup[4]> {
+	public:
+		static const int size = sizeof(float);
+		static MPI_Datatype type;
+};
+
+template<> class MpiType<Update::single_AdjointGroup[4]> {
+	public:
+		static const int size = sizeof(float);
+		static MPI_Datatype type;
+};
+
 template<> class MpiType<Update::FundamentalGroup> {
 	public:
 		static const int size = 8;
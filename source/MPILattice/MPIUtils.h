@@ -49,11 +49,9 @@ inline void reduceAllSum(int&) { }
 
 #ifdef ENABLE_MPI
 inline void reduceAllSum(std::complex<double>& value) {
-	double reValue = real(value), reResult;
-	double imValue = imag(value), imResult;
-	MPI_Allreduce(&reValue, &reResult, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	MPI_Allreduce(&imValue, &imResult, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	value = std::complex<double>(reResult,imResult);
+	double values[2] = {real(value), imag(value)}, results[2];
+	MPI_Allreduce(values, results, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+	value = std::complex<double>(results[0],results[1]);
 }
 #endif
 #ifndef ENABLE_MPI
@@ -62,11 +60,9 @@ inline void reduceAllSum(std::complex<double>&) { }
 
 #ifdef ENABLE_MPI
 inline void reduceAllSum(std::complex<long double>& value) {
-        long double reValue = real(value), reResult;
-        long double imValue = imag(value), imResult;
-        MPI_Allreduce(&reValue, &reResult, 1, MPI_LONG_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-        MPI_Allreduce(&imValue, &imResult, 1, MPI_LONG_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-        value = std::complex<long double>(reResult,imResult);
+	long double values[2] = {real(value), imag(value)}, results[2];
+	MPI_Allreduce(values, results, 2, MPI_LONG_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+	value = std::complex<long double>(results[0],results[1]);
 }
 #endif
 #ifndef ENABLE_MPI
@@ -75,11 +71,9 @@ inline void reduceAllSum(std::complex<long double>&) { }
 
 #ifdef ENABLE_MPI
 inline void reduceAllSum(std::complex<float>& value) {
-	float reValue = real(value), reResult;
-        float imValue = imag(value), imResult;
-	MPI_Allreduce(&reValue, &reResult, 1, MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD);
-	MPI_Allreduce(&imValue, &imResult, 1, MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD);
-	value = std::complex<float>(reResult,imResult);
+	float values[2] = {real(value), imag(value)}, results[2];
+	MPI_Allreduce(values, results, 2, MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD);
+	value = std::complex<float>(results[0],results[1]);
 }
 #endif
 #ifndef ENABLE_MPI
@@ -97,5 +91,47 @@ inline void reduceAllSum(long double& value) {
 inline void reduceAllSum(long double&) { }
 #endif
 
+//Sum of several values with a single reduction
+#ifdef ENABLE_MPI
+inline void reduceAllSum(double* values, int size) {
+	MPI_Allreduce(MPI_IN_PLACE, values, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+}
+
+inline void reduceAllSum(long double* values, int size) {
+	MPI_Allreduce(MPI_IN_PLACE, values, size, MPI_LONG_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+}
+#endif
+#ifndef ENABLE_MPI
+inline void reduceAllSum(double*, int) { }
+
+inline void reduceAllSum(long double*, int) { }
+#endif
+
+//Non-blocking version of the sum of several values, the result is available in values after waitReduceAllSum
+#ifdef ENABLE_MPI
+typedef MPI_Request reduce_request_t;
+
+inline void startReduceAllSum(double* values, int size, reduce_request_t& request) {
+	MPI_Iallreduce(MPI_IN_PLACE, values, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &request);
+}
+
+inline void startReduceAllSum(long double* values, int size, reduce_request_t& request) {
+	MPI_Iallreduce(MPI_IN_PLACE, values, size, MPI_LONG_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &request);
+}
+
+inline void waitReduceAllSum(reduce_request_t& request) {
+	MPI_Wait(&request, MPI_STATUS_IGNORE);
+}
+#endif
+#ifndef ENABLE_MPI
+typedef int reduce_request_t;
+
+inline void startReduceAllSum(double*, int, reduce_request_t&) { }
+
+inline void startReduceAllSum(long double*, int, reduce_request_t&) { }
+
+inline void waitReduceAllSum(reduce_request_t&) { }
+#endif
+
 #endif
 
@@ -61,6 +61,12 @@ typedef Eigen::Matrix< single_complex, Eigen::Dynamic, Eigen::Dynamic > single_m
 typedef Eigen::Matrix< complex, numberColors, numberColors > FundamentalGroup;
 typedef Eigen::Matrix< real_t, numberColors*numberColors - 1, numberColors*numberColors - 1 > AdjointGroup;
 
+typedef Eigen::Matrix< single_complex, numberColors, numberColors > single_FundamentalGroup;
+typedef Eigen::Matrix< single_real_t, numberColors*numberColors - 1, numberColors*numberColors - 1 > single_AdjointGroup;
+
+//First N-1 rows of a SU(N) matrix, the last row is reconstructed from their cofactors
+typedef Eigen::Matrix< complex, numberColors - 1, numberColors > CompressedFundamentalGroup;
+
 typedef Eigen::Matrix< complex, numberColors, 1 > FundamentalVector;
 typedef Eigen::Matrix< complex, numberColors*numberColors - 1, 1 > AdjointComplexVector;
 typedef Eigen::Matrix< real_t, numberColors*numberColors - 1, 1 > AdjointRealVector;
@@ -72,6 +78,7 @@ typedef Eigen::Matrix< real_t, numberColors*numberColors - 1, 1 > ForceVector;
 #ifdef ADJOINT
 typedef Eigen::Matrix< complex, numberColors, numberColors > GaugeGroup;
 typedef Eigen::Matrix< real_t, numberColors*numberColors - 1, numberColors*numberColors - 1 > FermionicGroup;
+typedef Eigen::Matrix< single_real_t, numberColors*numberColors - 1, numberColors*numberColors - 1 > single_FermionicGroup;
 typedef Eigen::Matrix< complex, numberColors*numberColors - 1, numberColors*numberColors - 1 > FermionicForceMatrix;
 typedef Eigen::Matrix< complex, numberColors*numberColors - 1, 1 > GaugeVector;
 typedef Eigen::Matrix< single_complex, numberColors*numberColors - 1, 1 > single_GaugeVector;
@@ -81,6 +88,7 @@ const int diracVectorLength = numberColors*numberColors - 1;
 #ifndef ADJOINT
 typedef Eigen::Matrix< complex, numberColors, numberColors > GaugeGroup;
 typedef Eigen::Matrix< complex, numberColors, numberColors > FermionicGroup;
+typedef Eigen::Matrix< single_complex, numberColors, numberColors > single_FermionicGroup;
 typedef Eigen::Matrix< complex, numberColors, numberColors > FermionicForceMatrix;
 typedef Eigen::Matrix< complex, numberColors, 1 > GaugeVector;
 typedef Eigen::Matrix< single_complex, numberColors, 1 > single_GaugeVector;
@@ -170,8 +178,9 @@ namespace Update {
 const int numberColors = NUMCOLORS;
 typedef double real_t;
 typedef long double long_real_t;
+typedef float single_real_t;
 typedef std::complex<real_t> complex;
-typedef std::complex<float> single_complex;
+typedef std::complex<single_real_t> single_complex;
 
 typedef matrix_toolkit::Matrix< complex, 2 > matrix2x2_t;
 typedef matrix_toolkit::Matrix< complex, -1 > matrix_t;
@@ -186,6 +195,7 @@ typedef matrix_toolkit::Vector< complex, numberColors*numberColors - 1 > Adjoint
 #ifdef ADJOINT
 typedef matrix_toolkit::Matrix< complex, numberColors > GaugeGroup;
 typedef matrix_toolkit::Matrix< real_t, numberColors*numberColors - 1 > FermionicGroup;
+typedef matrix_toolkit::Matrix< single_real_t, numberColors*numberColors - 1 > single_FermionicGroup;
 typedef matrix_toolkit::Matrix< complex, numberColors*numberColors - 1 > FermionicForceMatrix;
 typedef matrix_toolkit::Vector< complex, numberColors*numberColors - 1 > GaugeVector;
 typedef matrix_toolkit::Vector< single_complex, numberColors*numberColors - 1 > single_GaugeVector;
@@ -195,6 +205,7 @@ const int diracVectorLength = numberColors*numberColors - 1;
 #ifndef ADJOINT
 typedef matrix_toolkit::Matrix< complex, numberColors > GaugeGroup;
 typedef matrix_toolkit::Matrix< complex, numberColors > FermionicGroup;
+typedef matrix_toolkit::Matrix< single_complex, numberColors > single_FermionicGroup;
 typedef matrix_toolkit::Matrix< complex, numberColors > FermionicForceMatrix;
 typedef matrix_toolkit::Vector< complex, numberColors > GaugeVector;
 typedef matrix_toolkit::Vector< single_complex, numberColors, 1 > single_GaugeVector;
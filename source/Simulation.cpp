@@ -42,6 +42,9 @@ void Simulation::warmUp() {
 	for (unsigned int i = 0; i < numberWarmUpSweeps; ++i) {
 		timeval start, stop, result;
 		gettimeofday(&start,NULL);
+#ifdef DEBUG_MEMORY_ALLOCATION
+		long int allocations = Lattice::AllocationCounter::total;
+#endif
 		std::list<LatticeSweep*>::iterator sweep;
 		for (sweep = listWarmUpSweeps.begin(); sweep != listWarmUpSweeps.end(); ++sweep) {
 			(*sweep)->call(environment);
@@ -49,6 +52,9 @@ void Simulation::warmUp() {
 		gettimeofday(&stop,NULL);
 		timersub(&stop,&start,&result);
 		if (isOutputProcess()) std::cout << "Sweep cicle " << i << " done in: " << (double)result.tv_sec + result.tv_usec/1000000.0 << " sec" << std::endl;
+#ifdef DEBUG_MEMORY_ALLOCATION
+		if (isOutputProcess()) std::cout << "Lattice allocations in the sweep cicle " << i << ": " << Lattice::AllocationCounter::total - allocations << std::endl;
+#endif
 		++environment.sweep;
 	}
 }
@@ -71,6 +77,9 @@ void Simulation::measurement() {
 	for (unsigned int i = 0; i < numberMeasurementSweeps; ++i) {
 		timeval start, stop, result;
 		gettimeofday(&start,NULL);
+#ifdef DEBUG_MEMORY_ALLOCATION
+		long int allocations = Lattice::AllocationCounter::total;
+#endif
 		std::list<LatticeSweep*>::iterator sweep;
 		for (sweep = listMeasurementSweeps.begin(); sweep != listMeasurementSweeps.end(); ++sweep) {
 			(*sweep)->call(environment);
@@ -79,6 +88,9 @@ void Simulation::measurement() {
 		timersub(&stop,&start,&result);
 		if (isOutputProcess()) {
 			std::cout << "Sweep cicle " << i << " done in: " << (double)result.tv_sec + result.tv_usec/1000000.0 << " sec" << std::endl;
+#ifdef DEBUG_MEMORY_ALLOCATION
+			std::cout << "Lattice allocations in the sweep cicle " << i << ": " << Lattice::AllocationCounter::total - allocations << std::endl;
+#endif
 			//Save the data
 			globalOutput->print();
 		}
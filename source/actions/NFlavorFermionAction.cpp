@@ -5,7 +5,7 @@
 #include "utils/ToString.h"
 namespace Update {
 
-NFlavorFermionAction::NFlavorFermionAction(DiracOperator* _squareDiracOperator, DiracOperator* _diracOperator, const std::vector<RationalApproximation>& _rationalApproximations) : FermionicAction(_diracOperator), squareDiracOperator(_squareDiracOperator), forcePrecision(0.00000000001), maxIterations(5000), rationalApproximations(_rationalApproximations), tmp_pseudofermion(0) {
+NFlavorFermionAction::NFlavorFermionAction(DiracOperator* _squareDiracOperator, DiracOperator* _diracOperator, const std::vector<RationalApproximation>& _rationalApproximations) : FermionicAction(_diracOperator), squareDiracOperator(_squareDiracOperator), forcePrecision(0.00000000001), maxIterations(5000), rationalApproximations(_rationalApproximations), historySize(0), tmp_pseudofermion(0) {
 	fermionForce = diracOperator->getForce();
 	//Allocate the memory for all the pseudofermions needed for the calculation of the force ( # of vectors = 2*sum(order(rationalApproximations[i]) )
 	if (Xs.size() != rationalApproximations.size() || Ys.size() != rationalApproximations.size()) {
@@ -83,8 +83,25 @@ void NFlavorFermionAction::updateForce(extended_gauge_lattice_t& forceLattice, c
 	std::vector<extended_dirac_vector_t*>::const_iterator pseudofermion = pseudofermions.begin();
 	std::vector<RationalApproximation>::iterator i;
 	for (i = rationalApproximations.begin(); i != rationalApproximations.end(); ++i) {
+		//The initial guesses of the shifts are extrapolated from the solutions of the previous steps
+		std::vector<SolutionHistory>::iterator history;
+		std::vector<extended_dirac_vector_t>::iterator guess;
+		if (historySize != 0) {
+			history = histories[i - rationalApproximations.begin()].begin();
+			for (guess = x->begin(); guess != x->end(); ++guess, ++history) {
+				history->guess(squareDiracOperator, *(*pseudofermion), *guess, i->getBetas()[guess - x->begin()]);
+			}
+		}
 		//Solve the dirac equation for all the shifts
+		i->getMultishiftSolver()->setPrecision(forcePrecision);
+		i->getMultishiftSolver()->setMaxSteps(maxIterations);
 		i->getMultishiftSolver()->solve(squareDiracOperator, *(*pseudofermion), *x, i->getBetas());
+		if (historySize != 0) {
+			history = histories[i - rationalApproximations.begin()].begin();
+			for (guess = x->begin(); guess != x->end(); ++guess, ++history) {
+				history->add(*guess);
+			}
+		}
 		std::vector<extended_dirac_vector_t>::const_iterator j;
 		std::vector<extended_dirac_vector_t>::iterator k;
 		for (j = x->begin(), k = y->begin(); j != x->end(); ++j, ++k) {
@@ -136,9 +153,10 @@ void NFlavorFermionAction::updateForce(extended_gauge_lattice_t& forceLattice, c
 	
 	try {
 		real_t rho = env.configurations.get<real_t>("stout_smearing_rho");
+		int levels = env.configurations.get<int>("stout_smearing_levels");
 		SmearingForce smearingForce;
 		
-		smearingForce.force(fermionForceLattice, env.gaugeLinkConfiguration, forceLattice, rho);
+		smearingForce.force(fermionForceLattice, env.gaugeLinkConfiguration, forceLattice, rho, levels);
 	}
 	catch (NotFoundOption& ex) {
 		//Calculate the force directly
@@ -229,4 +247,27 @@ void NFlavorFermionAction::setForceMaxIterations(int _maxIterations) {
 	maxIterations = _maxIterations;
 }
 
+void NFlavorFermionAction::setHistorySize(unsigned int size) {
+	if (size == historySize) return;
+	historySize = size;
+	histories.resize(rationalApproximations.size());
+	for (unsigned int i = 0; i < rationalApproximations.size(); ++i) {
+		histories[i].resize(rationalApproximations[i].getBetas().size());
+		std::vector<SolutionHistory>::iterator history;
+		for (history = histories[i].begin(); history != histories[i].end(); ++history) {
+			history->setSize(size);
+		}
+	}
+}
+
+void NFlavorFermionAction::clearHistory() {
+	std::vector< std::vector<SolutionHistory> >::iterator i;
+	std::vector<SolutionHistory>::iterator history;
+	for (i = histories.begin(); i != histories.end(); ++i) {
+		for (history = i->begin(); history != i->end(); ++history) {
+			history->clear();
+		}
+	}
+}
+
 } /* namespace Update */
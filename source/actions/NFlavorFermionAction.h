@@ -4,6 +4,7 @@
 #include "dirac_functions/RationalApproximation.h"
 #include "dirac_operators/DiracOperator.h"
 #include "FermionicAction.h"
+#include "inverters/SolutionHistory.h"
 
 #include <vector>
 
@@ -31,6 +32,11 @@ public:
 
 	int getForceMaxIterations() const;
 	void setForceMaxIterations(int iterations);
+
+	//The number of previous solutions used to extrapolate the initial guesses of the force inversions, it needs a chronological multishift solver
+	void setHistorySize(unsigned int size);
+	//The histories must be cleared when the pseudofermions change
+	void clearHistory();
 private:
 	NFlavorFermionAction(const NFlavorFermionAction& ) : FermionicAction(NULL) { }
 
@@ -48,6 +54,9 @@ private:
 	//Static vector of the dirac_vector needed for the calculation of the force
 	std::vector< std::vector<extended_dirac_vector_t> > Xs;
 	std::vector< std::vector<extended_dirac_vector_t> > Ys;
+	//The solutions of the previous steps of the trajectory for every rational approximation and every shift
+	std::vector< std::vector<SolutionHistory> > histories;
+	unsigned int historySize;
 	extended_dirac_vector_t* tmp_pseudofermion;
 	//The derivative of the whole action with respect to the link variables
 	extended_fermion_force_lattice_t fermionForceLattice;
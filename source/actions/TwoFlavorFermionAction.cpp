@@ -5,12 +5,13 @@
 
 namespace Update {
 
-TwoFlavorFermionAction::TwoFlavorFermionAction(DiracOperator* _diracOperator) : FermionicAction(_diracOperator) {
+TwoFlavorFermionAction::TwoFlavorFermionAction(DiracOperator* _diracOperator) : FermionicAction(_diracOperator), forceSolver(new BiConjugateGradient()) {
 	fermionForce = diracOperator->getForce();
 }
 
 TwoFlavorFermionAction::~TwoFlavorFermionAction() {
 	delete fermionForce;
+	delete forceSolver;
 }
 
 GaugeGroup TwoFlavorFermionAction::force(const environment_t& env, int site, int mu) const {
@@ -21,10 +22,25 @@ GaugeGroup TwoFlavorFermionAction::force(const environment_t& env, int site, int
 void TwoFlavorFermionAction::updateForce(extended_gauge_lattice_t& forceLattice, const environment_t& env) {
 	diracOperator->setLattice(env.getFermionLattice());
 	fermionForce->setLattice(env.getFermionLattice());
-	BiConjugateGradient* biConjugateGradient = new BiConjugateGradient();//TODO TODO TODO
-	biConjugateGradient->setPrecision(forcePrecision);
-	biConjugateGradient->solve(diracOperator,*pseudofermion,Y);
-	biConjugateGradient->solve(diracOperator,Y,X);
+	forceSolver->setPrecision(forcePrecision);
+	//The initial guesses are extrapolated from the solutions of the previous steps
+	if (forceSolver->requiresPositiveDefiniteOperator()) {
+		//X = (Q^2)^-1 phi is found with a single inversion and Y = Q X
+		DiracOperator* squareDiracOperator = DiracOperator::getSquare(diracOperator);
+		bool hasGuess = historyX.guess(squareDiracOperator, *pseudofermion, initialGuess);
+		forceSolver->solve(squareDiracOperator,*pseudofermion,X,hasGuess ? &initialGuess : 0);
+		historyX.add(X);
+		diracOperator->multiply(Y,X);
+		delete squareDiracOperator;
+	}
+	else {
+		bool hasGuess = historyY.guess(diracOperator, *pseudofermion, initialGuess);
+		forceSolver->solve(diracOperator,*pseudofermion,Y,hasGuess ? &initialGuess : 0);
+		historyY.add(Y);
+		hasGuess = historyX.guess(diracOperator, Y, initialGuess);
+		forceSolver->solve(diracOperator,Y,X,hasGuess ? &initialGuess : 0);
+		historyX.add(X);
+	}
 
 	//Calculate the force
 #pragma omp parallel for
@@ -35,8 +51,6 @@ void TwoFlavorFermionAction::updateForce(extended_gauge_lattice_t& forceLattice,
 	}
 
 	forceLattice.updateHalo();//TODO is needed?
-
-	delete biConjugateGradient;
 }
 
 long_real_t TwoFlavorFermionAction::energy(const environment_t& env) {
@@ -65,4 +79,21 @@ void TwoFlavorFermionAction::setForcePrecision(double precision) {
 	forcePrecision = precision;
 }
 
+void TwoFlavorFermionAction::setForceSolver(Solver* _forceSolver) {
+	delete forceSolver;
+	forceSolver = _forceSolver;
+}
+
+void TwoFlavorFermionAction::setHistorySize(unsigned int size) {
+	if (size != historyY.getSize()) {
+		historyY.setSize(size);
+		historyX.setSize(size);
+	}
+}
+
+void TwoFlavorFermionAction::clearHistory() {
+	historyY.clear();
+	historyX.clear();
+}
+
 } /* namespace Update */
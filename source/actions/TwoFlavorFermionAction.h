@@ -6,6 +6,8 @@
 #include "dirac_operators/DiracOperator.h"
 #include "Energy.h"
 #include "FermionicAction.h"
+#include "inverters/SolutionHistory.h"
+#include "inverters/Solver.h"
 
 namespace Update {
 
@@ -25,16 +27,30 @@ public:
 
 	double getForcePrecision() const;
 	void setForcePrecision(double precision);
+
+	//The solver of the force inversions, owned by the action. The solvers of hermitian positive definite operators invert the square of the Dirac operator
+	void setForceSolver(Solver* _forceSolver);
+
+	//The number of previous solutions used to extrapolate the initial guesses of the force inversions
+	void setHistorySize(unsigned int size);
+	//The history must be cleared when the pseudofermion changes
+	void clearHistory();
 private:
 	//The fermion force
 	FermionForce* fermionForce;
 	//The precision for the force
 	double forcePrecision;
+	//The solver for the force
+	Solver* forceSolver;
 	//The pseudofermion field
 	extended_dirac_vector_t* pseudofermion;
 	//The vector needed for the calculation of the force
 	extended_dirac_vector_t X;
 	extended_dirac_vector_t Y;
+	//The solutions of the previous steps of the trajectory for Y and X
+	SolutionHistory historyY;
+	SolutionHistory historyX;
+	extended_dirac_vector_t initialGuess;
 };
 
 } /* namespace Update */
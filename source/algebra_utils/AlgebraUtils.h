@@ -2,6 +2,8 @@
 #define ALGEBRAUTILS_H_
 #include "../Environment.h"
 #include "utils/RandomSeed.h"
+#include "utils/CounterRandomGenerator.h"
+#include <vector>
 
 namespace Update {
 
@@ -50,120 +52,57 @@ public:
 	 * This function generates a real random gaussian vector, normalized to exp(-x^2)
 	 */
 	template<typename dirac_vector_t> static void generateRandomGaussianVector(dirac_vector_t& vector) {
-#ifndef MULTITHREADING
-		random_generator_t rng(RandomSeed::randomSeed());
-		random_normal_generator_t randomNormal(RandomSeed::getNormalNumberGenerator(rng,1./sqrt(2.)));
-#endif
-#ifdef MULTITHREADING
-		random_generator_t** randomGenerator = new random_generator_t*[omp_get_max_threads()];
-		random_normal_generator_t** randomNormal = new random_normal_generator_t*[omp_get_max_threads()];
-		for (int i = 0; i < omp_get_max_threads(); ++i) {
-			randomGenerator[i] = new random_generator_t(RandomSeed::randomSeed());
-			randomNormal[i] = new random_normal_generator_t(RandomSeed::getNormalNumberGenerator(*randomGenerator[i],1./sqrt(2.)));
-		}
-#endif
+		//The numbers depend only on the global sites, not on the number of threads and processors
+		boost::uint32_t stream = CounterRandomGenerator::nextStream();
 #pragma omp parallel for
 		for (int site = 0; site < vector.localsize; ++site) {
+			CounterRandomGenerator generator(stream, CounterRandomGenerator::globalIndex<typename dirac_vector_t::Layout>(site));
 			for (unsigned int mu = 0; mu < 4; ++mu) {
 				for (int c = 0; c < diracVectorLength; ++c) {
-#ifndef MULTITHREADING
-					vector[site][mu][c] = std::complex<real_t>(randomNormal(), 0.);
-#endif
-#ifdef MULTITHREADING
-					vector[site][mu][c] = std::complex<real_t>((*randomNormal[omp_get_thread_num()])(), 0.);
-#endif
+					real_t realPart = sqrt(0.5)*generator.normal();
+					vector[site][mu][c] = std::complex<real_t>(realPart, 0.);
 				}
 			}
 		}
 		vector.updateHalo();
-#ifdef MULTITHREADING
-		for (int i = 0; i < omp_get_max_threads(); ++i) {
-			delete randomGenerator[i];
-			delete randomNormal[i];
-		}
-		delete[] randomGenerator;
-		delete[] randomNormal;
-#endif
 	}
 
 	/**
 	 * This function generates a complex random gaussian vector, normalized to exp(-x^2)
 	 */
 	template<typename dirac_vector_t> static void generateRandomComplexGaussianVector(dirac_vector_t& vector) {
-#ifndef MULTITHREADING
-		random_generator_t rng(RandomSeed::randomSeed());
-		random_normal_generator_t randomNormal(RandomSeed::getNormalNumberGenerator(rng,1./sqrt(2.)));
-#endif
-#ifdef MULTITHREADING
-		random_generator_t** randomGenerator = new random_generator_t*[omp_get_max_threads()];
-		random_normal_generator_t** randomNormal = new random_normal_generator_t*[omp_get_max_threads()];
-		for (int i = 0; i < omp_get_max_threads(); ++i) {
-			randomGenerator[i] = new random_generator_t(RandomSeed::randomSeed());
-			randomNormal[i] = new random_normal_generator_t(RandomSeed::getNormalNumberGenerator(*randomGenerator[i],1./sqrt(2.)));
-		}
-#endif
+		boost::uint32_t stream = CounterRandomGenerator::nextStream();
 #pragma omp parallel for
 		for (int site = 0; site < vector.localsize; ++site) {
+			CounterRandomGenerator generator(stream, CounterRandomGenerator::globalIndex<typename dirac_vector_t::Layout>(site));
 			for (unsigned int mu = 0; mu < 4; ++mu) {
 				for (int c = 0; c < diracVectorLength; ++c) {
-#ifndef MULTITHREADING
-					vector[site][mu][c] = std::complex<real_t>(randomNormal(), randomNormal());
-#endif
-#ifdef MULTITHREADING
-					vector[site][mu][c] = std::complex<real_t>((*randomNormal[omp_get_thread_num()])(), (*randomNormal[omp_get_thread_num()])());
-#endif
+					real_t realPart = sqrt(0.5)*generator.normal();
+					real_t imagPart = sqrt(0.5)*generator.normal();
+					vector[site][mu][c] = std::complex<real_t>(realPart, imagPart);
 				}
 			}
 		}
 		vector.updateHalo();
-#ifdef MULTITHREADING
-		for (int i = 0; i < omp_get_max_threads(); ++i) {
-			delete randomGenerator[i];
-			delete randomNormal[i];
-		}
-		delete[] randomGenerator;
-		delete[] randomNormal;
-#endif
 	}
 
 	/**
 	 * This function generates a random vector
 	 */
 	template<typename dirac_vector_t> static void generateRandomVector(dirac_vector_t& vector) {
-#ifndef MULTITHREADING
-		random_generator_t rng(RandomSeed::randomSeed());
-		random_uniform_generator_t randomUniform(RandomSeed::getRandomNumberGenerator(rng));
-#endif
-#ifdef MULTITHREADING
-		random_generator_t** randomGenerator = new random_generator_t*[omp_get_max_threads()];
-		random_uniform_generator_t** randomUniform = new random_uniform_generator_t*[omp_get_max_threads()];
-		for (int i = 0; i < omp_get_max_threads(); ++i) {
-			randomGenerator[i] = new random_generator_t(RandomSeed::randomSeed());
-			randomUniform[i] = new random_uniform_generator_t(RandomSeed::getRandomNumberGenerator(*randomGenerator[i]));
-		}
-#endif
+		boost::uint32_t stream = CounterRandomGenerator::nextStream();
 #pragma omp parallel for
 		for (int site = 0; site < vector.localsize; ++site) {
+			CounterRandomGenerator generator(stream, CounterRandomGenerator::globalIndex<typename dirac_vector_t::Layout>(site));
 			for (unsigned int mu = 0; mu < 4; ++mu) {
 				for (int c = 0; c < diracVectorLength; ++c) {
-#ifndef MULTITHREADING
-					vector[site][mu][c] = std::complex<real_t>(randomUniform(), randomUniform());
-#endif
-#ifdef MULTITHREADING
-					vector[site][mu][c] = std::complex<real_t>((*randomUniform[omp_get_thread_num()])(), (*randomUniform[omp_get_thread_num()])());
-#endif
+					real_t realPart = generator.uniform();
+					real_t imagPart = generator.uniform();
+					vector[site][mu][c] = std::complex<real_t>(realPart, imagPart);
 				}
 			}
 		}
 		vector.updateHalo();
-#ifdef MULTITHREADING
-		for (int i = 0; i < omp_get_max_threads(); ++i) {
-			delete randomGenerator[i];
-			delete randomUniform[i];
-		}
-		delete[] randomGenerator;
-		delete[] randomUniform;
-#endif
 	}
 
 	template<typename dirac_vector_t> static void conjugate(dirac_vector_t& output, const dirac_vector_t& input) {
@@ -190,9 +129,9 @@ public:
 				result_im += imag(partial);
 			}
 		}
-		reduceAllSum(result_re);
-		reduceAllSum(result_im);
-		return std::complex<long_real_t>(result_re, result_im);
+		long_real_t result[2] = {result_re, result_im};
+		reduceAllSum(result, 2);
+		return std::complex<long_real_t>(result[0], result[1]);
 	}
 
 	template<typename dirac_vector_t> static std::complex<long_real_t> real_dot(const dirac_vector_t& vector1, const dirac_vector_t& vector2) {
@@ -207,9 +146,9 @@ public:
 				result_im += imag(partial);
 			}
 		}
-		reduceAllSum(result_re);
-		reduceAllSum(result_im);
-		return std::complex<long_real_t>(result_re, result_im);
+		long_real_t result[2] = {result_re, result_im};
+		reduceAllSum(result, 2);
+		return std::complex<long_real_t>(result[0], result[1]);
 	}
 
 	/**
@@ -232,9 +171,9 @@ public:
 				result_im -= imag(partial);
 			}
 		}
-		reduceAllSum(result_re);
-		reduceAllSum(result_im);
-		return std::complex<long_real_t>(result_re, result_im);
+		long_real_t result[2] = {result_re, result_im};
+		reduceAllSum(result, 2);
+		return std::complex<long_real_t>(result[0], result[1]);
 	}
 
 	/**
@@ -253,6 +192,94 @@ public:
 		return result;
 	}
 
+	/**
+	 * This function computes y = y + alpha*x and returns back the squared norm of the new y with a single pass over the vectors
+	 * \return norm(y + alpha*x)
+	 */
+	template<typename dirac_vector_t> static long_real_t axpyNorm(dirac_vector_t& y, const std::complex<real_t>& alpha, const dirac_vector_t& x) {
+		long_real_t result = 0.;
+#pragma omp parallel for reduction(+:result)
+		for (int site = 0; site < y.localsize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				y[site][mu] += alpha*x[site][mu];
+				result += real(vector_dot(y[site][mu],y[site][mu]));
+			}
+		}
+		//The halo is updated without communications, as it is done in the solvers
+#pragma omp parallel for
+		for (int site = y.localsize; site < y.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				y[site][mu] += alpha*x[site][mu];
+			}
+		}
+		reduceAllSum(result);
+		return result;
+	}
+
+	/**
+	 * This function computes z = z + beta*w and y = y + alpha*x and returns back the squared norm of the new y with a single pass over the vectors
+	 * (update of the solution and of the residual of the conjugate gradient), the scalars must have the precision of the vectors
+	 * \return norm(y + alpha*x)
+	 */
+	template<typename dirac_vector_t, typename scalar_t> static long_real_t axpyNorm(dirac_vector_t& z, const scalar_t& beta, const dirac_vector_t& w, dirac_vector_t& y, const scalar_t& alpha, const dirac_vector_t& x) {
+		long_real_t result = 0.;
+#pragma omp parallel for reduction(+:result)
+		for (int site = 0; site < y.localsize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				z[site][mu] += beta*w[site][mu];
+				y[site][mu] += alpha*x[site][mu];
+				result += real(vector_dot(y[site][mu],y[site][mu]));
+			}
+		}
+#pragma omp parallel for
+		for (int site = y.localsize; site < y.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				z[site][mu] += beta*w[site][mu];
+				y[site][mu] += alpha*x[site][mu];
+			}
+		}
+		reduceAllSum(result);
+		return result;
+	}
+
+	/**
+	 * This function computes y = x + beta*y
+	 */
+	template<typename dirac_vector_t, typename scalar_t> static void xpay(dirac_vector_t& y, const scalar_t& beta, const dirac_vector_t& x) {
+#pragma omp parallel for
+		for (int site = 0; site < y.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				y[site][mu] = x[site][mu] + beta*y[site][mu];
+			}
+		}
+	}
+
+	/**
+	 * This function computes the dot products (vectors1[i],vectors2[i]) of number pairs of vectors with a single pass and a single reduction
+	 * @param result the array of the number dot products
+	 */
+	template<typename dirac_vector_t> static void dot(std::complex<long_real_t>* result, int number, const dirac_vector_t* const* vectors1, const dirac_vector_t* const* vectors2) {
+		std::vector<long_real_t> sum(2*number, 0.);
+#pragma omp parallel
+		{
+			std::vector<long_real_t> partial(2*number, 0.);
+#pragma omp for
+			for (int site = 0; site < vectors1[0]->localsize; ++site) {
+				for (int i = 0; i < number; ++i) {
+					for (unsigned int mu = 0; mu < 4; ++mu) {
+						complex product = vector_dot((*vectors1[i])[site][mu],(*vectors2[i])[site][mu]);
+						partial[2*i] += real(product);
+						partial[2*i+1] += imag(product);
+					}
+				}
+			}
+#pragma omp critical
+			for (int i = 0; i < 2*number; ++i) sum[i] += partial[i];
+		}
+		reduceAllSum(&sum[0], 2*number);
+		for (int i = 0; i < number; ++i) result[i] = std::complex<long_real_t>(sum[2*i], sum[2*i+1]);
+	}
+
 	template<typename dirac_vector_t> static void setToZero(dirac_vector_t& vector) {
 #pragma omp parallel for
 		for (int site = 0; site < vector.completesize; ++site) {
@@ -340,10 +367,73 @@ public:
 				}
 			}
 		}
-		reduceAllSum(result_re);
-		reduceAllSum(result_im);
+		real_t result[2] = {result_re, result_im};
+		reduceAllSum(result, 2);
+
+		return std::complex<real_t>(result[0],result[1]);
+	}
+
+	/**
+	 * This function computes z = z + beta*w and y = y + alpha*x and returns back the squared norm of the new y with a single pass over the vectors
+	 * \return norm(y + alpha*x)
+	 */
+	template<typename aligned_vector_t> static real_t axpyNorm(
+		aligned_vector_t& z,
+		const std::complex<real_t>& beta,
+		const aligned_vector_t& w,
+		aligned_vector_t& y,
+		const std::complex<real_t>& alpha,
+		const aligned_vector_t& x) {
+
+		real_t result = 0.;
+		const real_t beta_real = beta.real(), beta_imag = beta.imag();
+		const real_t alpha_real = alpha.real(), alpha_imag = alpha.imag();
+		const int localsize = y.real_part[0].localsize;
+		const int completesize = y.real_part[0].completesize;
 
-		return std::complex<real_t>(result_re,result_im);
+		//The halo is updated without communications, as it is done in the solvers
+#pragma vector aligned
+#pragma omp parallel for simd reduction(+:result)
+		for (int site = 0; site < completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				for (unsigned int c = 0; c < diracVectorLength; ++c) {
+					const int i = 4*c + mu;
+					const real_t z_real = z.real_part[i][site] + beta_real*w.real_part[i][site] - beta_imag*w.imag_part[i][site];
+					const real_t z_imag = z.imag_part[i][site] + beta_real*w.imag_part[i][site] + beta_imag*w.real_part[i][site];
+					const real_t y_real = y.real_part[i][site] + alpha_real*x.real_part[i][site] - alpha_imag*x.imag_part[i][site];
+					const real_t y_imag = y.imag_part[i][site] + alpha_real*x.imag_part[i][site] + alpha_imag*x.real_part[i][site];
+					z.real_part[i][site] = z_real;
+					z.imag_part[i][site] = z_imag;
+					y.real_part[i][site] = y_real;
+					y.imag_part[i][site] = y_imag;
+					if (site < localsize) result += y_real*y_real + y_imag*y_imag;
+				}
+			}
+		}
+		reduceAllSum(result);
+
+		return result;
+	}
+
+	/**
+	 * This function computes y = x + beta*y, halo included
+	 */
+	template<typename aligned_vector_t> static void xpay(aligned_vector_t& y, const std::complex<real_t>& beta, const aligned_vector_t& x) {
+		const real_t beta_real = beta.real(), beta_imag = beta.imag();
+		const int completesize = y.real_part[0].completesize;
+
+#pragma vector aligned
+#pragma omp parallel for simd
+		for (int site = 0; site < completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				for (unsigned int c = 0; c < diracVectorLength; ++c) {
+					const int i = 4*c + mu;
+					const real_t y_real = y.real_part[i][site], y_imag = y.imag_part[i][site];
+					y.real_part[i][site] = x.real_part[i][site] + beta_real*y_real - beta_imag*y_imag;
+					y.imag_part[i][site] = x.imag_part[i][site] + beta_real*y_imag + beta_imag*y_real;
+				}
+			}
+		}
 	}
 
 	template<typename aligned_vector_t> static void setToZero(aligned_vector_t& v) {
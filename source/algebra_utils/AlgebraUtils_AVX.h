@@ -2,6 +2,7 @@
 #define ALGEBRAUTILS_AVX_H_
 #include "Environment.h"
 #include "utils/RandomSeed.h"
+#include "utils/CounterRandomGenerator.h"
 
 #ifdef AVX
 //avxintrin.h
@@ -59,40 +60,20 @@ public:
 	 * This function generates a random vector
 	 */
 	template<typename dirac_vector_t> static void generateRandomVector(dirac_vector_t& vector) {
-#ifndef MULTITHREADING
-		random_generator_t rng(RandomSeed::randomSeed());
-		random_uniform_generator_t randomUniform(RandomSeed::getRandomNumberGenerator(rng));
-#endif
-#ifdef MULTITHREADING
-		random_generator_t** randomGenerator = new random_generator_t*[omp_get_max_threads()];
-		random_uniform_generator_t** randomUniform = new random_uniform_generator_t*[omp_get_max_threads()];
-		for (int i = 0; i < omp_get_max_threads(); ++i) {
-			randomGenerator[i] = new random_generator_t(RandomSeed::randomSeed());
-			randomUniform[i] = new random_uniform_generator_t(RandomSeed::getRandomNumberGenerator(*randomGenerator[i]));
-		}
-#endif
+		//The numbers depend only on the global sites, not on the number of threads and processors
+		boost::uint32_t stream = CounterRandomGenerator::nextStream();
 #pragma omp parallel for
 		for (int site = 0; site < vector.localsize; ++site) {
+			CounterRandomGenerator generator(stream, CounterRandomGenerator::globalIndex<typename dirac_vector_t::Layout>(site));
 			for (unsigned int mu = 0; mu < 4; ++mu) {
 				for (int c = 0; c < diracVectorLength; ++c) {
-#ifndef MULTITHREADING
-					vector[site][mu][c] = std::complex<real_t>(randomUniform(), randomUniform());
-#endif
-#ifdef MULTITHREADING
-					vector[site][mu][c] = std::complex<real_t>((*randomUniform[omp_get_thread_num()])(), (*randomUniform[omp_get_thread_num()])());
-#endif
+					real_t realPart = generator.uniform();
+					real_t imagPart = generator.uniform();
+					vector[site][mu][c] = std::complex<real_t>(realPart, imagPart);
 				}
 			}
 		}
 		vector.updateHalo();
-#ifdef MULTITHREADING
-		for (int i = 0; i < omp_get_max_threads(); ++i) {
-			delete randomGenerator[i];
-			delete randomUniform[i];
-		}
-		delete[] randomGenerator;
-		delete[] randomUniform;
-#endif
 	}
 
 	/**
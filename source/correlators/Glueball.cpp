@@ -3,6 +3,7 @@
 #include "utils/ToString.h"
 #include "utils/StoutSmearing.h"
 #include "utils/MultiThreadSummator.h"
+#include "MPILattice/LatticeFourierTransform.h"
 
 namespace Update {
 
@@ -71,14 +72,54 @@ void Glueball::execute(environment_t& environment) {
 		output->pop("glueball_two");
 	}
 
+	if (environment.configurations.get<std::string>("Glueball::correlator") == "true") {
+		std::vector<long_real_t> zero_operator(Layout::glob_t), two_operator(Layout::glob_t);
+		for (int t = 0; t < Layout::glob_t; ++t) {
+			zero_operator[t] = zero_glueball[t].getResult()/Layout::glob_spatial_volume;
+			two_operator[t] = two_glueball[t].getResult()/Layout::glob_spatial_volume;
+		}
+		std::vector<long_real_t> zero_correlator = this->timeCorrelator(zero_operator);
+		std::vector<long_real_t> two_correlator = this->timeCorrelator(two_operator);
+
+		if (environment.measurement && isOutputProcess()) {
+			GlobalOutput* output = GlobalOutput::getInstance();
+
+			output->push("glueball_zero_correlator");
+			output->push("glueball_two_correlator");
+			for (int t = 0; t <= Layout::glob_t/2; ++t) {
+				std::cout << "Glueball::0++ and 2++ correlators at t " << t << " are " << zero_correlator[t] << " " << two_correlator[t] << std::endl;
+
+				output->write("glueball_zero_correlator", zero_correlator[t]);
+				output->write("glueball_two_correlator", two_correlator[t]);
+			}
+			output->pop("glueball_zero_correlator");
+			output->pop("glueball_two_correlator");
+		}
+	}
+
 	delete[] zero_glueball;
 	delete[] two_glueball;
 }
 
+std::vector<long_real_t> Glueball::timeCorrelator(const std::vector<long_real_t>& values) const {
+	//C(t) = 1/T sum_s O(s) O(s + t) = 1/T^2 sum_k exp(i k t) |O(k)|^2, all the time separations from two transforms
+	const int n = values.size();
+	Lattice::FourierTransform forward(n, -1), backward(n, 1);
+	std::vector< std::complex<double> > series(values.begin(), values.end()), transformed(n), scratch(forward.maximalFactor());
+	forward.transform(&transformed[0], &series[0], 1, &scratch[0]);
+	for (int k = 0; k < n; ++k) transformed[k] = std::norm(transformed[k]);
+	backward.transform(&series[0], &transformed[0], 1, &scratch[0]);
+
+	std::vector<long_real_t> result(n);
+	for (int t = 0; t < n; ++t) result[t] = real(series[t])/(n*n);
+	return result;
+}
+
 void Glueball::registerParameters(po::options_description& desc) {
 	desc.add_options()
 		("Glueball::stout_smearing_rho", po::value<real_t>()->default_value(0.15), "set the stout smearing parameter")
 		("Glueball::stout_smearing_levels", po::value<unsigned int>()->default_value(10), "levels of stout smearing")
+		("Glueball::correlator", po::value<std::string>()->default_value("false"), "Compute the correlators of the zero momentum operators for all the time separations? (true/false)")
 	;
 }
 
@@ -1,6 +1,7 @@
 #ifndef GLUEBALL_H_
 #define GLUEBALL_H_
 #include "LatticeSweep.h"
+#include <vector>
 
 namespace Update {
 
@@ -12,6 +13,10 @@ public:
 	virtual void execute(environment_t& environment);
 
 	static void registerParameters(po::options_description& desc);
+
+private:
+	//The periodic correlator of the zero momentum projection of an operator, for all the time separations
+	std::vector<long_real_t> timeCorrelator(const std::vector<long_real_t>& values) const;
 };
 
 } /* namespace Update */
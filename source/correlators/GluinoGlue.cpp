@@ -70,6 +70,7 @@ void GluinoGlue::execute(environment_t& environment) {
 	
 
 		extended_dirac_vector_t tmp;
+		std::vector<reduced_dirac_vector_t> sources(4), solutions;
 
 		int inversionSteps = 0;
 
@@ -80,9 +81,9 @@ void GluinoGlue::execute(environment_t& environment) {
 
 		//Formulas and indexes as doi:10.1007/JHEP09(2012)108
 		for (unsigned int alpha = 0; alpha < 4; ++alpha) {
-			//First we generate the propagator
-			for (unsigned int rho = 0; rho < 4; ++rho) {
-				for (int b = 0; b < diracVectorLength; ++b) {	
+			//First we generate the propagator, the four spin sources of every color are solved together as a block
+			for (int b = 0; b < diracVectorLength; ++b) {
+				for (unsigned int rho = 0; rho < 4; ++rho) {
 					//First we generate the source
 #pragma omp parallel for
 					for (int site = 0; site < source.localsize; ++site) {
@@ -102,14 +103,18 @@ void GluinoGlue::execute(environment_t& environment) {
 					}
 
 					this->smearSource(source, smearedFermionLattice, source_smearing_levels, source_smearing_rho);
-	
-					biConjugateGradient->solve(diracOperator, source, tmp);
+					sources[rho] = source;
+				}
+
+				biConjugateGradient->solve(diracOperator, sources, solutions);
+				for (unsigned int rho = 0; rho < 4; ++rho) {
+					tmp = solutions[rho];
 					Propagator::constructPropagator(diracOperator, tmp, psi[diracVectorLength*rho+b]);
 
 					this->smearSource(psi[diracVectorLength*rho+b], smearedFermionLattice, source_smearing_levels, source_smearing_rho);
-
-					inversionSteps += biConjugateGradient->getLastSteps();
 				}
+
+				inversionSteps += biConjugateGradient->getLastSteps();
 			}
 	
 
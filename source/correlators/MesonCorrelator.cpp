@@ -3,7 +3,7 @@
 #include "algebra_utils/AlgebraUtils.h"
 #include "utils/StoutSmearing.h"
 #include "utils/Gamma.h"
-#include "inverters/PreconditionedBiCGStab.h"
+#include "inverters/NormalEquationSolver.h"
 #include "dirac_operators/Propagator.h"
 #include "utils/MultiThreadSummator.h"
 
@@ -70,7 +70,11 @@ void MesonCorrelator::execute(environment_t& environment) {
 	diracOperator->setLattice(lattice);
 	diracOperator->setGamma5(false);
 	
-	if (inverter == 0) inverter = new PreconditionedBiCGStab();
+	if (inverter == 0) {
+		inverter = Solver::getInstance(environment.configurations.get<std::string>("MesonCorrelator::inverter"));
+		//The solvers of hermitian positive definite operators invert the Dirac operator with the normal equations
+		if (inverter->requiresPositiveDefiniteOperator()) inverter = new NormalEquationSolver(inverter);
+	}
 	inverter->setPrecision(environment.configurations.get<double>("MesonCorrelator::inverter_precision"));
 	inverter->setMaximumSteps(environment.configurations.get<unsigned int>("MesonCorrelator::inverter_max_steps"));
 
@@ -89,14 +93,19 @@ void MesonCorrelator::execute(environment_t& environment) {
 
 	int inversionSteps = 0;
 	
-	for (unsigned int alpha = 0; alpha < 4; ++alpha) {
-		for (int c = 0; c < diracVectorLength; ++c) {
+	//The four spin sources of a color are solved together as a block
+	std::vector<reduced_dirac_vector_t> sources(4), solutions;
+	for (int c = 0; c < diracVectorLength; ++c) {
+		for (unsigned int alpha = 0; alpha < 4; ++alpha) {
 			this->generateSource(source, alpha, c);
-			inverter->solve(diracOperator, source, tmp);
-			Propagator::constructPropagator(diracOperator, tmp, propagator[c*4 + alpha]);
-
-			inversionSteps += inverter->getLastSteps();
+			sources[alpha] = source;
+		}
+		inverter->solve(diracOperator, sources, solutions);
+		for (unsigned int alpha = 0; alpha < 4; ++alpha) {
+			Propagator::constructPropagator(diracOperator, solutions[alpha], propagator[c*4 + alpha]);
 		}
+
+		inversionSteps += inverter->getLastSteps();
 	}
 	
 	if (isOutputProcess()) std::cout << "MesonCorrelator::Correlators computed with " << inversionSteps << " inversion steps" << std::endl;
@@ -287,6 +296,7 @@ void MesonCorrelator::execute(environment_t& environment) {
 void MesonCorrelator::registerParameters(po::options_description& desc) {
 	static bool single = true;
 	if (single) desc.add_options()
+		("MesonCorrelator::inverter", po::value<std::string>()->default_value("preconditioned_biconjugate_gradient"), "the inverter (preconditioned_biconjugate_gradient, biconjugate_gradient, mixed_precision_biconjugate_gradient, mixed_precision_conjugate_gradient, pipelined_conjugate_gradient)")
 		("MesonCorrelator::inverter_precision", po::value<real_t>()->default_value(0.00000000001), "set the inverter precision")
 		("MesonCorrelator::inverter_max_steps", po::value<unsigned int>()->default_value(10000), "maximum number of inverter steps")
 		("MesonCorrelator::t_source_origin", po::value<unsigned int>()->default_value(0), "T origin for the wall source")
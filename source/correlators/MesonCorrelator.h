@@ -21,7 +21,6 @@ public:
 private:
 	reduced_dirac_vector_t randomNoise;
 	reduced_dirac_vector_t propagator[4*diracVectorLength];
-	reduced_dirac_vector_t tmp;
 	DiracOperator* diracOperator;
 	Solver* inverter;
 };
@@ -0,0 +1,246 @@
+#include "AlignedDiracWilsonKernel.h"
+#include <algorithm>
+
+namespace Update {
+
+#ifdef ALIGNED_OPT
+
+namespace {
+//The projector (1 -+ gamma_mu) on the upper spin component s mixes it with the lower component partner[mu][s] with phase eta[mu][s],
+//the same projections of DiracWilsonOperator
+const int partner[4][2] = {{3,2},{3,2},{2,3},{2,3}};
+const real_t eta_re[4][2] = {{0.,0.},{-1.,1.},{0.,0.},{1.,1.}};
+const real_t eta_im[4][2] = {{-1.,-1.},{0.,0.},{-1.,1.},{0.,0.}};
+//Index of the block in the clover term and of the multiplied spin component for every row of the clover term
+const int cloverDiagonal[4] = {0, 0, 3, 3};
+const real_t cloverDiagonalSign[4] = {1., -1., 1., -1.};
+const int cloverOffDiagonal[4] = {1, 2, 4, 5};
+const int cloverPartner[4] = {1, 0, 3, 2};
+//Number of sites processed together, the innermost vectorized loop runs over them
+const int blockLength = 8;
+}
+
+void AlignedDiracWilsonKernel::multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t* vector2, const complex& alpha, const reduced_soa_fermion_lattice_t& links, const reduced_soa_clover_lattice_t* clover, real_t kappa, real_t csw, bool gamma5, bool overlapCommunication) {
+	//The sites [0, sharedsize) are read by the neighbouring processors, we process them first
+	//and we overlap the halo exchange of the output with the interior sites [sharedsize, localsize)
+	const int siteRange[3] = {0, output.real_part[0].sharedsize, output.real_part[0].localsize};
+	for (int region = 0; region < 2; ++region) {
+		multiplySites(output, vector1, vector2, alpha, links, clover, kappa, csw, gamma5, siteRange[region], siteRange[region+1]);
+		if (region == 0 && overlapCommunication) output.communicateHalo();
+	}
+	if (!overlapCommunication) output.communicateHalo();
+	output.waitHalo();
+}
+
+void AlignedDiracWilsonKernel::multiplySites(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t* vector2, const complex& alpha, const reduced_soa_fermion_lattice_t& links, const reduced_soa_clover_lattice_t* clover, real_t kappa, real_t csw, bool gamma5, int begin, int end) {
+	typedef reduced_dirac_vector_t Vector;
+	const int N = diracVectorLength;
+
+	//Raw pointers to the components, the spinor index k = 4*c + s, the link index d*4*N + c*4 + mu for U_mu(c,d)
+	real_t* out_re[4*N];
+	real_t* out_im[4*N];
+	const real_t* in_re[4*N];
+	const real_t* in_im[4*N];
+	const real_t* add_re[4*N];
+	const real_t* add_im[4*N];
+	for (int k = 0; k < 4*N; ++k) {
+		out_re[k] = output.real_part[k].getRawData();
+		out_im[k] = output.imag_part[k].getRawData();
+		in_re[k] = vector1.real_part[k].getRawData();
+		in_im[k] = vector1.imag_part[k].getRawData();
+		add_re[k] = (vector2 != 0) ? vector2->real_part[k].getRawData() : 0;
+		add_im[k] = (vector2 != 0) ? vector2->imag_part[k].getRawData() : 0;
+	}
+	const real_t* u_re[4*N*N];
+#ifndef ADJOINT
+	const real_t* u_im[4*N*N];
+#endif
+	for (int k = 0; k < 4*N*N; ++k) {
+		u_re[k] = links.real_part[k].getRawData();
+#ifndef ADJOINT
+		u_im[k] = links.imag_part[k].getRawData();
+#endif
+	}
+	const real_t* f_re[6*N*N];
+	const real_t* f_im[6*N*N];
+	for (int k = 0; k < 6*N*N; ++k) {
+		f_re[k] = (clover != 0) ? clover->real_part[k].getRawData() : 0;
+		f_im[k] = (clover != 0) ? clover->imag_part[k].getRawData() : 0;
+	}
+
+	const real_t alpha_re = real(alpha), alpha_im = imag(alpha);
+	const real_t kappa_csw = kappa*csw;
+	//Sign of the lower spin components, gamma5 is included in the clover term
+	const real_t lowerSign = gamma5 ? 1. : -1.;
+
+#pragma omp parallel for
+	for (int first = begin; first < end; first += blockLength) {
+		const int length = std::min(blockLength, end - first);
+
+		//The lanes beyond the end of the range repeat the first site, so that the loops of the hopping term have the full length
+		int site[blockLength];
+		for (int l = 0; l < blockLength; ++l) site[l] = (l < length) ? first + l : first;
+
+		//The hopping term
+		real_t h_re[4][N][blockLength], h_im[4][N][blockLength];
+		for (int s = 0; s < 4; ++s) {
+			for (int c = 0; c < N; ++c) {
+#pragma omp simd
+				for (int l = 0; l < blockLength; ++l) {
+					h_re[s][c][l] = 0.;
+					h_im[s][c][l] = 0.;
+				}
+			}
+		}
+		for (int mu = 0; mu < 4; ++mu) {
+			int site_down[blockLength], site_up[blockLength];
+			for (int l = 0; l < blockLength; ++l) {
+				site_down[l] = Vector::sdn(site[l],mu);
+				site_up[l] = Vector::sup(site[l],mu);
+			}
+			for (int s = 0; s < 2; ++s) {
+				const int t = partner[mu][s];
+				const real_t er = eta_re[mu][s], ei = eta_im[mu][s];
+				real_t pm_re[N][blockLength], pm_im[N][blockLength], pp_re[N][blockLength], pp_im[N][blockLength];
+				for (int n = 0; n < N; ++n) {
+#pragma omp simd
+					for (int l = 0; l < blockLength; ++l) {
+						const real_t dr = in_re[4*n+t][site_down[l]], di = in_im[4*n+t][site_down[l]];
+						pm_re[n][l] = in_re[4*n+s][site_down[l]] + er*dr - ei*di;
+						pm_im[n][l] = in_im[4*n+s][site_down[l]] + er*di + ei*dr;
+						const real_t ur = in_re[4*n+t][site_up[l]], ui = in_im[4*n+t][site_up[l]];
+						pp_re[n][l] = in_re[4*n+s][site_up[l]] - er*ur + ei*ui;
+						pp_im[n][l] = in_im[4*n+s][site_up[l]] - er*ui - ei*ur;
+					}
+				}
+				for (int i = 0; i < N; ++i) {
+					//tmp = U^dagger_mu(x-mu).projection_minus, tmm = U_mu(x).projection_plus
+					real_t tmp_re[blockLength], tmp_im[blockLength], tmm_re[blockLength], tmm_im[blockLength];
+#pragma omp simd
+					for (int l = 0; l < blockLength; ++l) {
+						tmp_re[l] = 0.;
+						tmp_im[l] = 0.;
+						tmm_re[l] = 0.;
+						tmm_im[l] = 0.;
+					}
+					for (int n = 0; n < N; ++n) {
+						const int kd = i*4*N + n*4 + mu;
+						const int ku = n*4*N + i*4 + mu;
+#pragma omp simd
+						for (int l = 0; l < blockLength; ++l) {
+							const real_t dr = u_re[kd][site_down[l]];
+#ifndef ADJOINT
+							const real_t di = u_im[kd][site_down[l]];
+#else
+							const real_t di = 0.;
+#endif
+							tmp_re[l] += pm_re[n][l]*dr + pm_im[n][l]*di;
+							tmp_im[l] += pm_im[n][l]*dr - pm_re[n][l]*di;
+							const real_t ur = u_re[ku][site[l]];
+#ifndef ADJOINT
+							const real_t ui = u_im[ku][site[l]];
+#else
+							const real_t ui = 0.;
+#endif
+							tmm_re[l] += ur*pp_re[n][l] - ui*pp_im[n][l];
+							tmm_im[l] += ur*pp_im[n][l] + ui*pp_re[n][l];
+						}
+					}
+#pragma omp simd
+					for (int l = 0; l < blockLength; ++l) {
+						h_re[s][i][l] += tmp_re[l] + tmm_re[l];
+						h_im[s][i][l] += tmp_im[l] + tmm_im[l];
+						const real_t d_re = tmp_re[l] - tmm_re[l], d_im = tmp_im[l] - tmm_im[l];
+						h_re[t][i][l] += er*d_re + ei*d_im;
+						h_im[t][i][l] += er*d_im - ei*d_re;
+					}
+				}
+			}
+		}
+
+		//gamma5*(1 - kappa*H)
+		for (int s = 0; s < 4; ++s) {
+			const real_t sign = (s < 2) ? 1. : -1.;
+			for (int c = 0; c < N; ++c) {
+#pragma omp simd
+				for (int l = 0; l < length; ++l) {
+					h_re[s][c][l] = sign*(in_re[4*c+s][first + l] - kappa*h_re[s][c][l]);
+					h_im[s][c][l] = sign*(in_im[4*c+s][first + l] - kappa*h_im[s][c][l]);
+				}
+			}
+		}
+
+		//The clover term, block diagonal in the chiral basis
+		if (clover != 0) {
+			for (int s = 0; s < 4; ++s) {
+				const int p = cloverPartner[s];
+				const real_t diagonalSign = cloverDiagonalSign[s];
+				for (int i = 0; i < N; ++i) {
+					for (int j = 0; j < N; ++j) {
+						const int kd = j*6*N + i*6 + cloverDiagonal[s];
+						const int ko = j*6*N + i*6 + cloverOffDiagonal[s];
+#pragma omp simd
+						for (int l = 0; l < length; ++l) {
+							const int site = first + l;
+							const real_t dr = diagonalSign*f_re[kd][site], di = diagonalSign*f_im[kd][site];
+							const real_t vr = in_re[4*j+s][site], vi = in_im[4*j+s][site];
+							const real_t wr = in_re[4*j+p][site], wi = in_im[4*j+p][site];
+							h_re[s][i][l] += kappa_csw*(dr*vr - di*vi + f_re[ko][site]*wr - f_im[ko][site]*wi);
+							h_im[s][i][l] += kappa_csw*(dr*vi + di*vr + f_re[ko][site]*wi + f_im[ko][site]*wr);
+						}
+					}
+				}
+			}
+		}
+
+		for (int s = 0; s < 4; ++s) {
+			const real_t sign = (s < 2) ? 1. : lowerSign;
+			for (int c = 0; c < N; ++c) {
+				if (vector2 != 0) {
+#pragma omp simd
+					for (int l = 0; l < length; ++l) {
+						const int site = first + l;
+						out_re[4*c+s][site] = sign*h_re[s][c][l] + alpha_re*add_re[4*c+s][site] - alpha_im*add_im[4*c+s][site];
+						out_im[4*c+s][site] = sign*h_im[s][c][l] + alpha_re*add_im[4*c+s][site] + alpha_im*add_re[4*c+s][site];
+					}
+				}
+				else {
+#pragma omp simd
+					for (int l = 0; l < length; ++l) {
+						out_re[4*c+s][first + l] = sign*h_re[s][c][l];
+						out_im[4*c+s][first + l] = sign*h_im[s][c][l];
+					}
+				}
+			}
+		}
+	}
+}
+
+void AlignedDiracWilsonKernel::setClover(reduced_soa_clover_lattice_t& clover, const reduced_field_strength_lattice_t& F) {
+	const int N = diracVectorLength;
+	const complex I(0.,1.);
+#pragma omp parallel for
+	for (int site = 0; site < F.completesize; ++site) {
+		for (int i = 0; i < N; ++i) {
+			for (int j = 0; j < N; ++j) {
+				complex f[6];
+				for (int k = 0; k < 6; ++k) f[k] = F[site][k].at(i,j);
+				complex blocks[6];
+				blocks[0] = I*(f[5] - f[0]);
+				blocks[1] = f[1] + f[4] + I*(f[2] - f[3]);
+				blocks[2] = - f[1] - f[4] + I*(f[2] - f[3]);
+				blocks[3] = I*(f[0] + f[5]);
+				blocks[4] = - f[1] + f[4] + I*(f[2] + f[3]);
+				blocks[5] = f[1] - f[4] + I*(f[2] + f[3]);
+				for (int k = 0; k < 6; ++k) {
+					clover.real_part[j*6*N + i*6 + k][site] = real(blocks[k]);
+					clover.imag_part[j*6*N + i*6 + k][site] = imag(blocks[k]);
+				}
+			}
+		}
+	}
+}
+
+#endif
+
+} /* namespace Update */
@@ -0,0 +1,35 @@
+#ifndef ALIGNEDDIRACWILSONKERNEL_H_
+#define ALIGNEDDIRACWILSONKERNEL_H_
+#include "Environment.h"
+
+namespace Update {
+
+#ifdef ALIGNED_OPT
+
+/**
+ * Wilson and clover kernels on the split real/imaginary (structure of arrays) storage.
+ * The site is the innermost index of every field, so that the loop over the sites is vectorized with omp simd.
+ */
+class AlignedDiracWilsonKernel {
+public:
+	/**
+	 * This routine computes output = D.vector1 + alpha*vector2, with D the Wilson (clover if clover != 0) operator,
+	 * multiplied by gamma5 if gamma5 == true. vector2 can be null.
+	 * The halo exchange of the output is overlapped with the interior sites if overlapCommunication == true.
+	 */
+	static void multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t* vector2, const complex& alpha, const reduced_soa_fermion_lattice_t& links, const reduced_soa_clover_lattice_t* clover, real_t kappa, real_t csw, bool gamma5, bool overlapCommunication);
+
+	/**
+	 * This routine stores the chiral blocks of the clover term i sigma_{mu,nu} F_{mu,nu} in the order M00, M01, M10, M22, M23, M32
+	 * (M11 = -M00, M33 = -M22, the other blocks vanish)
+	 */
+	static void setClover(reduced_soa_clover_lattice_t& clover, const reduced_field_strength_lattice_t& F);
+
+private:
+	static void multiplySites(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t* vector2, const complex& alpha, const reduced_soa_fermion_lattice_t& links, const reduced_soa_clover_lattice_t* clover, real_t kappa, real_t csw, bool gamma5, int begin, int end);
+};
+
+#endif
+
+} /* namespace Update */
+#endif /* ALIGNEDDIRACWILSONKERNEL_H_ */
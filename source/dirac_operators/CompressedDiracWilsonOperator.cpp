@@ -0,0 +1,349 @@
+#include "CompressedDiracWilsonOperator.h"
+#include "hmc_forces/DiracWilsonFermionForce.h"
+#include "utils/LieGenerators.h"
+#include <vector>
+
+namespace Update {
+
+namespace {
+//The projector (1 -+ gamma_mu) on the upper spin component s mixes it with the lower component partner[mu][s] with phase eta[mu][s],
+//the same projections of DiracWilsonOperator
+const int partner[4][2] = {{3,2},{3,2},{2,3},{2,3}};
+const real_t eta_re[4][2] = {{0.,0.},{-1.,1.},{0.,0.},{1.,1.}};
+const real_t eta_im[4][2] = {{-1.,-1.},{0.,0.},{-1.,1.},{0.,0.}};
+
+//conj(a*b - c*d) with explicit real arithmetic
+inline complex conjugateMinor(const complex& a, const complex& b, const complex& c, const complex& d) {
+	return complex(real(a)*real(b) - imag(a)*imag(b) - real(c)*real(d) + imag(c)*imag(d), - real(a)*imag(b) - imag(a)*real(b) + real(c)*imag(d) + imag(c)*real(d));
+}
+
+//Rebuild the full SU(N) matrix from its first N-1 rows, the last row is the complex conjugate of its cofactors
+inline void reconstruct(const CompressedFundamentalGroup& rows, complex link[numberColors][numberColors]) {
+	for (int i = 0; i < numberColors - 1; ++i) {
+		for (int j = 0; j < numberColors; ++j) {
+			link[i][j] = rows(i,j);
+		}
+	}
+#if NUMCOLORS == 2
+	link[1][0] = -std::conj(link[0][1]);
+	link[1][1] = std::conj(link[0][0]);
+#elif NUMCOLORS == 3
+	link[2][0] = conjugateMinor(link[0][1], link[1][2], link[0][2], link[1][1]);
+	link[2][1] = conjugateMinor(link[0][2], link[1][0], link[0][0], link[1][2]);
+	link[2][2] = conjugateMinor(link[0][0], link[1][1], link[0][1], link[1][0]);
+#else
+	for (int j = 0; j < numberColors; ++j) {
+		Eigen::Matrix< complex, numberColors - 1, numberColors - 1 > minor;
+		for (int i = 0; i < numberColors - 1; ++i) {
+			for (int k = 0, c = 0; k < numberColors; ++k) {
+				if (k != j) minor(i,c++) = rows(i,k);
+			}
+		}
+		const real_t sign = ((numberColors - 1 + j) % 2 == 0) ? 1. : -1.;
+		link[numberColors - 1][j] = std::conj(sign*minor.determinant());
+	}
+#endif
+}
+
+#ifdef ADJOINT
+//Non vanishing entries T^a(i,j) of the generators of the fundamental representation
+struct GeneratorEntry {
+	int a, i, j;
+	complex value;
+};
+
+const std::vector<GeneratorEntry>& generatorEntries() {
+	static std::vector<GeneratorEntry> entries;
+	if (entries.empty()) {
+		LieGenerator<GaugeGroup> generators;
+		for (int a = 0; a < numberColors*numberColors - 1; ++a) {
+			for (int i = 0; i < numberColors; ++i) {
+				for (int j = 0; j < numberColors; ++j) {
+					if (std::abs(generators.get(a).at(i,j)) > 0.0000000001) {
+						GeneratorEntry entry = {a, i, j, generators.get(a).at(i,j)};
+						entries.push_back(entry);
+					}
+				}
+			}
+		}
+	}
+	return entries;
+}
+
+//output = factor*Ad(U).input (or factor*Ad(U^dagger).input), computed as 2 tr(T^a U Psi U^dagger) with Psi = input^b T^b
+template<bool dagger> inline void applyLink(const complex link[numberColors][numberColors], real_t factor, const complex input[diracVectorLength], complex output[diracVectorLength], const std::vector<GeneratorEntry>& entries) {
+	//Explicit real arithmetic, the products of std::complex check for NaN at every call
+	real_t psi_re[numberColors][numberColors], psi_im[numberColors][numberColors], tmp_re[numberColors][numberColors], tmp_im[numberColors][numberColors];
+	real_t u_re[numberColors][numberColors], u_im[numberColors][numberColors];
+	for (int i = 0; i < numberColors; ++i) {
+		for (int j = 0; j < numberColors; ++j) {
+			psi_re[i][j] = 0.;
+			psi_im[i][j] = 0.;
+			//u = U^dagger for dagger == true
+			u_re[i][j] = dagger ? real(link[j][i]) : real(link[i][j]);
+			u_im[i][j] = dagger ? -imag(link[j][i]) : imag(link[i][j]);
+		}
+	}
+	const int numberEntries = entries.size();
+	for (int e = 0; e < numberEntries; ++e) {
+		const GeneratorEntry& entry = entries[e];
+		psi_re[entry.i][entry.j] += real(entry.value)*real(input[entry.a]) - imag(entry.value)*imag(input[entry.a]);
+		psi_im[entry.i][entry.j] += real(entry.value)*imag(input[entry.a]) + imag(entry.value)*real(input[entry.a]);
+	}
+	//tmp = u.Psi
+	for (int i = 0; i < numberColors; ++i) {
+		for (int j = 0; j < numberColors; ++j) {
+			real_t re = 0., im = 0.;
+			for (int k = 0; k < numberColors; ++k) {
+				re += u_re[i][k]*psi_re[k][j] - u_im[i][k]*psi_im[k][j];
+				im += u_re[i][k]*psi_im[k][j] + u_im[i][k]*psi_re[k][j];
+			}
+			tmp_re[i][j] = re;
+			tmp_im[i][j] = im;
+		}
+	}
+	//psi = tmp.u^dagger
+	for (int i = 0; i < numberColors; ++i) {
+		for (int j = 0; j < numberColors; ++j) {
+			real_t re = 0., im = 0.;
+			for (int k = 0; k < numberColors; ++k) {
+				re += tmp_re[i][k]*u_re[j][k] + tmp_im[i][k]*u_im[j][k];
+				im += tmp_im[i][k]*u_re[j][k] - tmp_re[i][k]*u_im[j][k];
+			}
+			psi_re[i][j] = re;
+			psi_im[i][j] = im;
+		}
+	}
+	real_t out_re[diracVectorLength], out_im[diracVectorLength];
+	for (int a = 0; a < diracVectorLength; ++a) {
+		out_re[a] = 0.;
+		out_im[a] = 0.;
+	}
+	for (int e = 0; e < numberEntries; ++e) {
+		const GeneratorEntry& entry = entries[e];
+		out_re[entry.a] += real(entry.value)*psi_re[entry.j][entry.i] - imag(entry.value)*psi_im[entry.j][entry.i];
+		out_im[entry.a] += real(entry.value)*psi_im[entry.j][entry.i] + imag(entry.value)*psi_re[entry.j][entry.i];
+	}
+	for (int a = 0; a < diracVectorLength; ++a) {
+		output[a] = complex(2.*factor*out_re[a], 2.*factor*out_im[a]);
+	}
+}
+
+//Find U in SU(N) and factor such that adjoint = factor*Ad(U), with Ad(U)(a,b) = 2 tr(T^a U T^b U^dagger)
+void compress(const FermionicGroup& adjoint, const LieGenerator<GaugeGroup>& generators, int structure[3], CompressedFundamentalGroup& rows, real_t& factor) {
+	const int numberGenerators = numberColors*numberColors - 1;
+	//X[b] = factor*U T^b U^dagger
+	GaugeGroup X[numberGenerators];
+	for (int b = 0; b < numberGenerators; ++b) {
+		X[b] = GaugeGroup::Zero();
+		for (int a = 0; a < numberGenerators; ++a) {
+			X[b] += adjoint(a,b)*generators.get(a);
+		}
+	}
+	//The commutators are preserved only for factor = 1, we read the sign from a non vanishing structure constant
+	const GaugeGroup& Ta = generators.get(structure[0]), & Tb = generators.get(structure[1]), & Tc = generators.get(structure[2]);
+	complex reference = trace((Ta*Tb - Tb*Ta)*Tc);
+	real_t sign = real(trace((X[structure[0]]*X[structure[1]] - X[structure[1]]*X[structure[0]])*X[structure[2]])/reference);
+	factor = (sign > 0.5) ? 1. : ((sign < -0.5) ? -1. : 0.);
+	if (factor == 0.) {
+		rows = GaugeGroup::Identity().topRows(numberColors - 1);
+		return;
+	}
+	//The projector U E_00 U^dagger = u_0 u_0^dagger gives the first column, U E_j0 U^dagger u_0 = u_j the other columns
+	GaugeGroup P = GaugeGroup::Identity()/static_cast<real_t>(numberColors);
+	for (int b = 0; b < numberGenerators; ++b) P += (2.*factor)*generators.get(b).at(0,0)*X[b];
+	int k = 0;
+	for (int i = 1; i < numberColors; ++i) {
+		if (real(P(i,i)) > real(P(k,k))) k = i;
+	}
+	GaugeGroup U;
+	U.col(0) = P.col(k)/sqrt(real(P(k,k)));
+	for (int j = 1; j < numberColors; ++j) {
+		GaugeGroup E = GaugeGroup::Zero();
+		for (int b = 0; b < numberGenerators; ++b) E += (2.*factor)*generators.get(b).at(0,j)*X[b];
+		U.col(j) = E*U.col(0);
+	}
+	//U is fixed up to a phase, we take it in SU(N), any center element gives the same adjoint matrix
+	U *= std::exp(complex(0.,-std::arg(U.determinant())/numberColors));
+	rows = U.topRows(numberColors - 1);
+}
+#endif
+
+#ifndef ADJOINT
+template<bool dagger> inline void applyLink(const complex link[numberColors][numberColors], real_t factor, const complex input[diracVectorLength], complex output[diracVectorLength]) {
+	for (int i = 0; i < numberColors; ++i) {
+		real_t re = 0., im = 0.;
+		for (int n = 0; n < numberColors; ++n) {
+			//Explicit real arithmetic, the products of std::complex check for NaN at every call
+			const real_t ur = dagger ? real(link[n][i]) : real(link[i][n]);
+			const real_t ui = dagger ? -imag(link[n][i]) : imag(link[i][n]);
+			re += ur*real(input[n]) - ui*imag(input[n]);
+			im += ur*imag(input[n]) + ui*real(input[n]);
+		}
+		output[i] = complex(factor*re, factor*im);
+	}
+}
+
+//Write the link as factor*U, U in SU(N), with the factor of the boundary conditions real
+void compress(const FermionicGroup& link, CompressedFundamentalGroup& rows, real_t& factor) {
+	const real_t determinant = real(link.determinant());
+	if (numberColors % 2 == 1) {
+		//det(factor*U) = factor
+		factor = (determinant > 0.5) ? 1. : ((determinant < -0.5) ? -1. : 0.);
+	}
+	else {
+		//-U is in SU(N) for N even
+		factor = (std::abs(determinant) > 0.5) ? 1. : 0.;
+	}
+	if (factor == 0.) rows = GaugeGroup::Identity().topRows(numberColors - 1);
+	else rows = link.topRows(numberColors - 1)/factor;
+}
+#endif
+}
+
+CompressedDiracWilsonOperator::CompressedDiracWilsonOperator() : DiracOperator() { }
+
+CompressedDiracWilsonOperator::CompressedDiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa, bool _gamma5) : DiracOperator(_lattice, _kappa, _gamma5) {
+	this->compressLattice();
+}
+
+CompressedDiracWilsonOperator::~CompressedDiracWilsonOperator() { }
+
+void CompressedDiracWilsonOperator::multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input) {
+	//The sites [0, sharedsize) are read by the neighbouring processors, we process them first
+	//and we overlap the halo exchange of the output with the interior sites [sharedsize, localsize)
+	const int siteRange[3] = {0, output.sharedsize, output.localsize};
+	for (int region = 0; region < 2; ++region) {
+		this->beginRegion();
+		this->multiplySites(output, input, 0, 0., siteRange[region], siteRange[region+1]);
+		this->endRegion(region);
+		if (region == 0 && overlapCommunication) output.communicateHalo();
+	}
+	if (!overlapCommunication) output.communicateHalo();
+	output.waitHalo();
+}
+
+void CompressedDiracWilsonOperator::multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha) {
+	const int siteRange[3] = {0, output.sharedsize, output.localsize};
+	for (int region = 0; region < 2; ++region) {
+		this->beginRegion();
+		this->multiplySites(output, vector1, &vector2, alpha, siteRange[region], siteRange[region+1]);
+		this->endRegion(region);
+		if (region == 0 && overlapCommunication) output.communicateHalo();
+	}
+	if (!overlapCommunication) output.communicateHalo();
+	output.waitHalo();
+}
+
+void CompressedDiracWilsonOperator::multiplySites(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t* vector2, const complex& alpha, int begin, int end) {
+	typedef reduced_dirac_vector_t Vector;
+#ifdef ADJOINT
+	const std::vector<GeneratorEntry>& entries = generatorEntries();
+#endif
+	//Sign of the lower spin components
+	const real_t lowerSign = gamma5 ? -1. : 1.;
+
+#pragma omp parallel for
+	for (int site = begin; site < end; ++site) {
+		complex h[4][diracVectorLength];
+		for (int s = 0; s < 4; ++s) {
+			for (int i = 0; i < diracVectorLength; ++i) {
+				h[s][i] = 0.;
+			}
+		}
+		for (int mu = 0; mu < 4; ++mu) {
+			const int site_down = Vector::sdn(site,mu);
+			const int site_up = Vector::sup(site,mu);
+			complex link_down[numberColors][numberColors], link_up[numberColors][numberColors];
+			reconstruct(compressedLattice[site_down][mu], link_down);
+			reconstruct(compressedLattice[site][mu], link_up);
+			const real_t factor_down = linkFactors[site_down][mu];
+			const real_t factor_up = linkFactors[site][mu];
+			for (int s = 0; s < 2; ++s) {
+				const int t = partner[mu][s];
+				const real_t er = eta_re[mu][s], ei = eta_im[mu][s];
+				complex projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmp[diracVectorLength], tmm[diracVectorLength];
+				for (int n = 0; n < diracVectorLength; ++n) {
+					const complex& down = vector1[site_down][t][n];
+					const complex& up = vector1[site_up][t][n];
+					projection_spinor_minus[n] = vector1[site_down][s][n] + complex(er*real(down) - ei*imag(down), er*imag(down) + ei*real(down));
+					projection_spinor_plus[n] = vector1[site_up][s][n] - complex(er*real(up) - ei*imag(up), er*imag(up) + ei*real(up));
+				}
+				//tmp = U^dagger_mu(x-mu).projection_minus, tmm = U_mu(x).projection_plus
+#ifdef ADJOINT
+				applyLink<true>(link_down, factor_down, projection_spinor_minus, tmp, entries);
+				applyLink<false>(link_up, factor_up, projection_spinor_plus, tmm, entries);
+#endif
+#ifndef ADJOINT
+				applyLink<true>(link_down, factor_down, projection_spinor_minus, tmp);
+				applyLink<false>(link_up, factor_up, projection_spinor_plus, tmm);
+#endif
+				for (int i = 0; i < diracVectorLength; ++i) {
+					h[s][i] += tmp[i] + tmm[i];
+					const complex difference = tmp[i] - tmm[i];
+					h[t][i] += complex(er*real(difference) + ei*imag(difference), er*imag(difference) - ei*real(difference));
+				}
+			}
+		}
+		for (int s = 0; s < 4; ++s) {
+			const real_t sign = (s < 2) ? 1. : lowerSign;
+			for (int i = 0; i < diracVectorLength; ++i) {
+				output[site][s][i] = sign*(vector1[site][s][i] - kappa*h[s][i]);
+				if (vector2 != 0) output[site][s][i] += alpha*(*vector2)[site][s][i];
+			}
+		}
+	}
+}
+
+FermionForce* CompressedDiracWilsonOperator::getForce() const {
+	return new DiracWilsonFermionForce(kappa);
+}
+
+void CompressedDiracWilsonOperator::setLattice(const extended_fermion_lattice_t& _lattice) {
+	lattice = _lattice;
+	this->compressLattice();
+}
+
+int CompressedDiracWilsonOperator::linkBytesPerSite() {
+	return 4*(sizeof(CompressedFundamentalGroup) + sizeof(real_t));
+}
+
+void CompressedDiracWilsonOperator::compressLattice() {
+	//The halo of lattice is already up to date, we compress all the sites without communications
+#ifdef ADJOINT
+	LieGenerator<GaugeGroup> generators;
+	generatorEntries();
+	//A triple of generators with non vanishing structure constant
+	int structure[3] = {0, 0, 0};
+	real_t largest = 0.;
+	for (int a = 0; a < numberColors*numberColors - 1; ++a) {
+		for (int b = 0; b < numberColors*numberColors - 1; ++b) {
+			for (int c = 0; c < numberColors*numberColors - 1; ++c) {
+				real_t value = std::abs(trace((generators.get(a)*generators.get(b) - generators.get(b)*generators.get(a))*generators.get(c)));
+				if (value > largest + 0.0000000001) {
+					largest = value;
+					structure[0] = a;
+					structure[1] = b;
+					structure[2] = c;
+				}
+			}
+		}
+	}
+#pragma omp parallel for
+	for (int site = 0; site < lattice.completesize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			compress(lattice[site][mu], generators, structure, compressedLattice[site][mu], linkFactors[site][mu]);
+		}
+	}
+#endif
+#ifndef ADJOINT
+#pragma omp parallel for
+	for (int site = 0; site < lattice.completesize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			compress(lattice[site][mu], compressedLattice[site][mu], linkFactors[site][mu]);
+		}
+	}
+#endif
+}
+
+} /* namespace Update */
@@ -0,0 +1,62 @@
+#ifndef COMPRESSEDDIRACWILSONOPERATOR_H_
+#define COMPRESSEDDIRACWILSONOPERATOR_H_
+#include "DiracOperator.h"
+
+namespace Update {
+
+/**
+ * Dirac Wilson operator reading compressed links: only the first N-1 rows of the SU(N) links and a real factor for the
+ * boundary conditions are stored, the last row is rebuilt from the cofactors on every hop (12 reals instead of 18 for SU(3)).
+ * In the adjoint representation the real links are built on the fly from the compressed fundamental links,
+ * instead of reading the (N^2-1)x(N^2-1) adjoint matrices.
+ * The links must be SU(N) matrices up to the boundary conditions (factors +1, -1 or 0).
+ */
+class CompressedDiracWilsonOperator : public DiracOperator {
+public:
+	CompressedDiracWilsonOperator();
+	CompressedDiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa = 0., bool _gamma5 = true);
+	virtual ~CompressedDiracWilsonOperator();
+
+	/**
+	 * This routine multiplies the DiracWilson operator to input and stores the result in output
+	 * @param output
+	 * @param input
+	 */
+	virtual void multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input);
+
+	/**
+	 * This routine multiplies the DiracWilson operator to vector1 and stores the result in output adding to it alpha*vector2
+	 * @param output
+	 * @param vector1
+	 * @param vector2
+	 * @param alpha
+	 */
+	virtual void multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha);
+
+	virtual FermionForce* getForce() const;
+
+	/**
+	 * This function sets the lattice and computes its compressed copy
+	 * @param lattice
+	 */
+	virtual void setLattice(const extended_fermion_lattice_t& _lattice);
+
+	/**
+	 * This function returns the bytes of link data read by the operator for every lattice site
+	 */
+	static int linkBytesPerSite();
+private:
+	void compressLattice();
+
+	void multiplySites(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t* vector2, const complex& alpha, int begin, int end);
+
+	//First N-1 rows of the links, normalized to SU(N)
+	reduced_compressed_fermion_lattice_t compressedLattice;
+	//The links are linkFactors*SU(N) in the fundamental representation, linkFactors*Ad(SU(N)) in the adjoint representation
+	reduced_link_factor_lattice_t linkFactors;
+
+	CompressedDiracWilsonOperator(const DiracOperator&) { }
+};
+
+} /* namespace Update */
+#endif /* COMPRESSEDDIRACWILSONOPERATOR_H_ */
@@ -8,12 +8,20 @@
 #include "SquareImprovedDiracWilsonOperator.h"
 #include "BasicDiracWilsonOperator.h"
 #include "BasicSquareDiracWilsonOperator.h"
+#include "CompressedDiracWilsonOperator.h"
+#include "SquareCompressedDiracWilsonOperator.h"
+#include "EvenOddDiracWilsonOperator.h"
+#include "SquareEvenOddDiracWilsonOperator.h"
 
 namespace Update {
 
-DiracOperator::DiracOperator() : kappa(0.), gamma5(true) { }
+DiracOperator::DiracOperator() : kappa(0.), gamma5(true), overlapCommunication(true), regionTiming(false) {
+	this->resetRegionTimes();
+}
 
-DiracOperator::DiracOperator(const extended_fermion_lattice_t& _lattice, double _kappa, bool _gamma5) : lattice(_lattice), kappa(_kappa), gamma5(_gamma5) { }
+DiracOperator::DiracOperator(const extended_fermion_lattice_t& _lattice, double _kappa, bool _gamma5) : lattice(_lattice), kappa(_kappa), gamma5(_gamma5), overlapCommunication(true), regionTiming(false) {
+	this->resetRegionTimes();
+}
 
 DiracOperator::~DiracOperator() { }
 
@@ -31,6 +39,20 @@ DiracOperator* DiracOperator::getInstance(const std::string& name, unsigned int
 			result->name = name;
 			return result;
 		}
+		else if (name == "CompressedDiracWilson") {
+			CompressedDiracWilsonOperator* result = new CompressedDiracWilsonOperator();
+			result->setKappa(parameters.get<double>(basename+"kappa"));
+			result->name = name;
+			return result;
+		}
+		else if (name == "EvenOddDiracWilson") {
+			checkEvenOddLattice();
+			EvenOddDiracWilsonOperator* result = new EvenOddDiracWilsonOperator();
+			result->setKappa(parameters.get<double>(basename+"kappa"));
+			result->setTwist(parameters.get<double>(basename+"twist"));
+			result->name = name;
+			return result;
+		}
 		else if (name == "Improved") {
 			ImprovedDiracWilsonOperator* result = new ImprovedDiracWilsonOperator();
 			result->setKappa(parameters.get<double>(basename+"kappa"));
@@ -92,6 +114,14 @@ DiracOperator* DiracOperator::getInstance(const std::string& name, unsigned int
 			result->name = name;
 			return result;
 		}
+		else if (name == "EvenOddDiracWilson") {
+			checkEvenOddLattice();
+			SquareEvenOddDiracWilsonOperator* result = new SquareEvenOddDiracWilsonOperator();
+			result->setKappa(parameters.get<double>(basename+"kappa"));
+			result->setTwist(parameters.get<double>(basename+"twist"));
+			result->name = name;
+			return result;
+		}
 		else if (name == "Improved") {
 			SquareImprovedDiracWilsonOperator* result = new SquareImprovedDiracWilsonOperator();
 			result->setKappa(parameters.get<double>(basename+"kappa"));
@@ -105,6 +135,12 @@ DiracOperator* DiracOperator::getInstance(const std::string& name, unsigned int
 			result->name = name;
 			return result;
 		}
+		else if (name == "CompressedDiracWilson") {
+			SquareCompressedDiracWilsonOperator* result = new SquareCompressedDiracWilsonOperator();
+			result->setKappa(parameters.get<double>(basename+"kappa"));
+			result->name = name;
+			return result;
+		}
 		else if (name == "Overlap") {
 			OverlapOperator* ov = new OverlapOperator();
 			SquareOverlapOperator* result = new SquareOverlapOperator();
@@ -170,6 +206,7 @@ void DiracOperator::registerParameters(po::options_description& desc, const std:
 		((basename+"kappa").c_str(), po::value<double>()->default_value(0.0), "set the value of the kappa for the Dirac Wilson operator")
 		((basename+"csw").c_str(), po::value<double>()->default_value(0.0), "set the value of the clover term for the Dirac Wilson operator")
 		((basename+"mass").c_str(), po::value<double>()->default_value(0.0), "set the value of the mass for the Overlap operator")
+		((basename+"twist").c_str(), po::value<double>()->default_value(0.0), "set the value of the twisted mass for the EvenOddDiracWilson operator")
 		((basename+"OverlapOperator::squareRootApproximation").c_str(), po::value<std::string>()->default_value(""), "Approximation of x^(1/2) used for the Overlap fermion sign function (syntax: {(scalingre,scalingim),(r1re,r1im), ..., (rnre,rnim)})")
 		((basename+"ExactOverlapOperator::squareRootApproximation").c_str(), po::value<std::string>()->default_value(""), "Approximation of x^(1/2) used for the Overlap fermion sign function (syntax: {(scalingre,scalingim),(r1re,r1im), ..., (rnre,rnim)})")
 		((basename+"ExactOverlapOperator::eigensolver::use_chebyshev").c_str(), po::value<std::string>()->default_value("false"), "Use Chebyshev acceleration? (true/false)")
@@ -197,6 +234,20 @@ DiracOperator* DiracOperator::getSquareRoot(DiracOperator* dirac) {
 			exit(1);
 		}
 	}
+	else if (dirac->name == "EvenOddDiracWilson") {
+		if (dynamic_cast<SquareEvenOddDiracWilsonOperator*>(dirac)) {
+			EvenOddDiracWilsonOperator* result = new EvenOddDiracWilsonOperator();
+			result->setKappa(dirac->getKappa());
+			result->setTwist(dynamic_cast<SquareEvenOddDiracWilsonOperator*>(dirac)->getTwist());
+			result->name = dirac->name;
+			result->lattice = dirac->lattice;
+			result->gamma5 = dirac->gamma5;
+			return result;
+		} else {
+			std::cout << "Power of the Dirac Wilson Operator not supported!" << std::endl;
+			exit(1);
+		}
+	}
 	else if (dirac->name == "Improved") {
 		if (dynamic_cast<SquareImprovedDiracWilsonOperator*>(dirac)) {
 			ImprovedDiracWilsonOperator* result = new ImprovedDiracWilsonOperator();
@@ -224,6 +275,19 @@ DiracOperator* DiracOperator::getSquareRoot(DiracOperator* dirac) {
 			exit(1);
 		}
 	}
+	else if (dirac->name == "CompressedDiracWilson") {
+		if (dynamic_cast<SquareCompressedDiracWilsonOperator*>(dirac)) {
+			CompressedDiracWilsonOperator* result = new CompressedDiracWilsonOperator();
+			result->setKappa(dirac->getKappa());
+			result->name = dirac->name;
+			result->setLattice(dirac->lattice);
+			result->gamma5 = dirac->gamma5;
+			return result;
+		} else {
+			std::cout << "Power of the Dirac Wilson Operator not supported!" << std::endl;
+			exit(1);
+		}
+	}
 	else {
 		std::cout << "Dirac Wilson Operator" << dirac->name << " not supported!" << std::endl;
 		exit(1);
@@ -244,6 +308,20 @@ DiracOperator* DiracOperator::getSquare(DiracOperator* dirac) {
 			exit(1);
 		}
 	}
+	else if (dirac->name == "EvenOddDiracWilson") {
+		if (dynamic_cast<EvenOddDiracWilsonOperator*>(dirac)) {
+			SquareEvenOddDiracWilsonOperator* result = new SquareEvenOddDiracWilsonOperator();
+			result->setKappa(dirac->getKappa());
+			result->setTwist(dynamic_cast<EvenOddDiracWilsonOperator*>(dirac)->getTwist());
+			result->name = dirac->name;
+			result->setLattice(dirac->lattice);
+			result->gamma5 = dirac->gamma5;
+			return result;
+		} else {
+			std::cout << "Power of the Dirac Wilson Operator not supported!" << std::endl;
+			exit(1);
+		}
+	}
 	else if (dirac->name == "Improved") {
 		if (dynamic_cast<ImprovedDiracWilsonOperator*>(dirac)) {
 			SquareImprovedDiracWilsonOperator* result = new SquareImprovedDiracWilsonOperator();
@@ -271,6 +349,19 @@ DiracOperator* DiracOperator::getSquare(DiracOperator* dirac) {
 			exit(1);
 		}
 	}
+	else if (dirac->name == "CompressedDiracWilson") {
+		if (dynamic_cast<CompressedDiracWilsonOperator*>(dirac)) {
+			SquareCompressedDiracWilsonOperator* result = new SquareCompressedDiracWilsonOperator();
+			result->setKappa(dirac->getKappa());
+			result->name = dirac->name;
+			result->setLattice(dirac->lattice);
+			result->gamma5 = dirac->gamma5;
+			return result;
+		} else {
+			std::cout << "Power of the Dirac Wilson Operator not supported!" << std::endl;
+			exit(1);
+		}
+	}
 	else if (dirac->name == "Overlap") {
 		if (dynamic_cast<OverlapOperator*>(dirac)) {
 			OverlapOperator* op = dynamic_cast<OverlapOperator*>(dirac);
@@ -311,6 +402,14 @@ DiracOperator* DiracOperator::getSquare(DiracOperator* dirac) {
 	}
 }
 
+void DiracOperator::checkEvenOddLattice() {
+	typedef reduced_dirac_vector_t::Layout Layout;
+	if ((Layout::glob_x % 2 != 0) || (Layout::glob_y % 2 != 0) || (Layout::glob_z % 2 != 0) || (Layout::glob_t % 2 != 0)) {
+		if (isOutputProcess()) std::cout << "DiracOperator::The even-odd operators need an even number of sites in every direction!" << std::endl;
+		exit(1);
+	}
+}
+
 void DiracOperator::setKappa(real_t _kappa) {
 	kappa = _kappa;
 }
@@ -327,6 +426,33 @@ bool DiracOperator::getGamma5() const {
 	return gamma5;
 }
 
+void DiracOperator::multiplyBlock(const std::vector<reduced_dirac_vector_t*>& outputs, const std::vector<const reduced_dirac_vector_t*>& inputs) {
+	for (unsigned int i = 0; i < inputs.size(); ++i) {
+		this->multiply(*outputs[i], *inputs[i]);
+	}
+}
+
+void DiracOperator::setOverlapCommunication(bool _overlapCommunication) {
+	overlapCommunication = _overlapCommunication;
+}
+
+bool DiracOperator::getOverlapCommunication() const {
+	return overlapCommunication;
+}
+
+void DiracOperator::setRegionTiming(bool _regionTiming) {
+	regionTiming = _regionTiming;
+}
+
+double DiracOperator::getRegionTime(int region) const {
+	return regionTimes[region];
+}
+
+void DiracOperator::resetRegionTimes() {
+	regionTimes[0] = 0.;
+	regionTimes[1] = 0.;
+}
+
 const reduced_fermion_lattice_t *DiracOperator::getLattice() const {
 	return &lattice;
 }
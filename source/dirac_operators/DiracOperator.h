@@ -3,8 +3,11 @@
 
 #include "Environment.h"
 #include "hmc_forces/FermionForce.h"
+#include "MPILattice/LatticeWorkspace.h"
 
 #include <string>
+#include <vector>
+#include <time.h>
 
 namespace po = boost::program_options;
 
@@ -22,37 +25,60 @@ public:
 	static void registerParameters(po::options_description& desc, const std::string& basename);
 	
 #ifdef ENABLE_MPI
-	void multiply(standard_dirac_vector_t& output, const standard_dirac_vector_t& input) {
-		reduced_dirac_vector_t _output, _input = input;
+	//The wrappers convert the vectors to the reduced layout in the cached buffers of the operator,
+	//the halo of the output is not updated if outputHalo == false (the caller reads only the local sites)
+	void multiply(standard_dirac_vector_t& output, const standard_dirac_vector_t& input, bool outputHalo = true) {
+		reduced_dirac_vector_t& _input = conversionBuffers[0];
+		reduced_dirac_vector_t& _output = conversionBuffers[1];
+		_input = input;
 		this->multiply(_output,_input);
-		output = _output;
+		if (outputHalo) output = _output;
+		else output.copyLocal(_output);
 	}
 
-	void multiply(extended_dirac_vector_t& output, const extended_dirac_vector_t& input) {
-		reduced_dirac_vector_t _output, _input = input;
+	void multiply(extended_dirac_vector_t& output, const extended_dirac_vector_t& input, bool outputHalo = true) {
+		reduced_dirac_vector_t& _input = conversionBuffers[0];
+		reduced_dirac_vector_t& _output = conversionBuffers[1];
+		_input = input;
 		this->multiply(_output,_input);
-		output = _output;
+		if (outputHalo) output = _output;
+		else output.copyLocal(_output);
 	}
 
-	virtual void multiplyAdd(standard_dirac_vector_t& output, const standard_dirac_vector_t& vector1, const standard_dirac_vector_t & vector2, const complex& alpha) {
-		reduced_dirac_vector_t _output, _vector1 = vector1, _vector2 = vector2;
-                this->multiplyAdd(_output, _vector1, _vector2, alpha);
-                output = _output;
+	virtual void multiplyAdd(standard_dirac_vector_t& output, const standard_dirac_vector_t& vector1, const standard_dirac_vector_t & vector2, const complex& alpha, bool outputHalo = true) {
+		reduced_dirac_vector_t& _vector1 = conversionBuffers[0];
+		reduced_dirac_vector_t& _output = conversionBuffers[1];
+		_vector1 = vector1;
+		if (&vector2 == &vector1) this->multiplyAdd(_output, _vector1, _vector1, alpha);
+		else {
+			reduced_dirac_vector_t& _vector2 = conversionBuffers[2];
+			_vector2 = vector2;
+			this->multiplyAdd(_output, _vector1, _vector2, alpha);
+		}
+		if (outputHalo) output = _output;
+		else output.copyLocal(_output);
 	}
 
-	virtual void multiplyAdd(extended_dirac_vector_t& output, const extended_dirac_vector_t& vector1, const extended_dirac_vector_t & vector2, const complex& alpha) {
-		reduced_dirac_vector_t _output, _vector1 = vector1, _vector2 = vector2;
-		//if (isOutputProcess()) std::cout << "Vai a sapere" << std::endl;
-		this->multiplyAdd(_output, _vector1, _vector2, alpha);
-		//if (isOutputProcess()) std::cout << "Vai a sapere" << std::endl;
-		output = _output;
-        }
+	virtual void multiplyAdd(extended_dirac_vector_t& output, const extended_dirac_vector_t& vector1, const extended_dirac_vector_t & vector2, const complex& alpha, bool outputHalo = true) {
+		reduced_dirac_vector_t& _vector1 = conversionBuffers[0];
+		reduced_dirac_vector_t& _output = conversionBuffers[1];
+		_vector1 = vector1;
+		if (&vector2 == &vector1) this->multiplyAdd(_output, _vector1, _vector1, alpha);
+		else {
+			reduced_dirac_vector_t& _vector2 = conversionBuffers[2];
+			_vector2 = vector2;
+			this->multiplyAdd(_output, _vector1, _vector2, alpha);
+		}
+		if (outputHalo) output = _output;
+		else output.copyLocal(_output);
+	}
 #endif
 
 #ifdef ALIGNED_OPT
 	//Dummy function to be overridden in the most relevant time-consuming cases
 	virtual void multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input) {
-		reduced_dirac_vector_t d_output, d_input;
+		reduced_dirac_vector_t& d_input = conversionBuffers[0];
+		reduced_dirac_vector_t& d_output = conversionBuffers[1];
 		input.copy_to(d_input);
 
 		this->multiply(d_output, d_input);
@@ -62,25 +88,19 @@ public:
 
 	//Dummy function to be overridden in the most relevant time-consuming cases
 	virtual void multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t & vector2, const complex& alpha) {
+		reduced_dirac_vector_t& d_vector1 = conversionBuffers[0];
+		reduced_dirac_vector_t& d_output = conversionBuffers[1];
+		vector1.copy_to(d_vector1);
 		if (vector1 == vector2) {
-			reduced_dirac_vector_t d_output, d_vector;
-			vector1.copy_to(d_vector);
-		
-
-			this->multiplyAdd(d_output, d_vector, d_vector, alpha);
-
-			output = d_output;
+			this->multiplyAdd(d_output, d_vector1, d_vector1, alpha);
 		} 
 		else {
-			reduced_dirac_vector_t d_output, d_vector1, d_vector2;
-			vector1.copy_to(d_vector1);
+			reduced_dirac_vector_t& d_vector2 = conversionBuffers[2];
 			vector2.copy_to(d_vector2);
-		
 
 			this->multiplyAdd(d_output, d_vector1, d_vector2, alpha);
-
-			output = d_output;
 		}
+		output = d_output;
 	}
 #endif
 	
@@ -100,6 +120,14 @@ public:
 	 */
     virtual void multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t & vector2, const complex& alpha) =0;
 
+    /**
+	 * This routine multiplies the Dirac operator to a block of vectors, *outputs[i] = D *inputs[i].
+	 * The default implementation calls multiply on every vector, the operators can override it to reuse the links for all the vectors
+	 * @param outputs
+	 * @param inputs
+	 */
+	virtual void multiplyBlock(const std::vector<reduced_dirac_vector_t*>& outputs, const std::vector<const reduced_dirac_vector_t*>& inputs);
+
     virtual FermionForce* getForce() const = 0;
 
 	/**
@@ -128,17 +156,57 @@ public:
 
 	void setGamma5(bool _gamma5);
 	bool getGamma5() const;
+
+	/**
+	 * This function enables the overlap of the halo exchange of the output with the computation on the interior sites
+	 * @param _overlapCommunication
+	 */
+	void setOverlapCommunication(bool _overlapCommunication);
+	bool getOverlapCommunication() const;
+
+	/**
+	 * This function enables the timing of the boundary sites [0, sharedsize) (region 0) and of the interior sites [sharedsize, localsize) (region 1)
+	 * by the operators that split their sites, the times are accumulated until resetRegionTimes()
+	 * @param _regionTiming
+	 */
+	void setRegionTiming(bool _regionTiming);
+	double getRegionTime(int region) const;
+	void resetRegionTimes();
 	
 	std::string getName() const;
 
 protected:
+	//The even and the odd sites are a checkerboard only if every direction has an even number of sites
+	static void checkEvenOddLattice();
+
 	reduced_fermion_lattice_t lattice;
 
 	real_t kappa;
 
 	bool gamma5;
 
+	bool overlapCommunication;
+
+	//The hooks around the loop on the sites of a region, they do nothing if the timing is not enabled
+	void beginRegion() {
+		if (regionTiming) clock_gettime(CLOCK_REALTIME, &regionStart);
+	}
+	void endRegion(int region) {
+		if (regionTiming) {
+			struct timespec finish;
+			clock_gettime(CLOCK_REALTIME, &finish);
+			regionTimes[region] += (finish.tv_sec - regionStart.tv_sec) + static_cast<double>(finish.tv_nsec - regionStart.tv_nsec)/1000000000.;
+		}
+	}
+
+	bool regionTiming;
+	double regionTimes[2];
+	struct timespec regionStart;
+
 	std::string name;
+
+	//Buffers for the conversions of the vectors to the reduced layout, allocated at their first use
+	::Lattice::LatticeWorkspace<reduced_dirac_vector_t, 3> conversionBuffers;
 };
 
 } /* namespace Update */
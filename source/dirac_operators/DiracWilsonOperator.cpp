@@ -1,11 +1,16 @@
 #include "DiracWilsonOperator.h"
 #include "hmc_forces/DiracWilsonFermionForce.h"
+#include "AlignedDiracWilsonKernel.h"
 
 namespace Update {
 
 DiracWilsonOperator::DiracWilsonOperator() : DiracOperator() { }
 
-DiracWilsonOperator::DiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa, bool _gamma5) : DiracOperator(_lattice, _kappa, _gamma5) { }
+DiracWilsonOperator::DiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa, bool _gamma5) : DiracOperator(_lattice, _kappa, _gamma5) {
+#ifdef ALIGNED_OPT
+	soaLattice = lattice;
+#endif
+}
 
 DiracWilsonOperator::~DiracWilsonOperator() { }
 
@@ -13,192 +18,231 @@ inline real_t conj(const real_t& t) {
 	return t;
 }
 
-void DiracWilsonOperator::multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input) {
+//The Wilson operator on a single site, shared by multiply and multiplyBlock
+inline void DiracWilsonOperator::multiplySite(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input, int site) const {
 	typedef reduced_fermion_lattice_t Lattice;
 	typedef reduced_dirac_vector_t Vector;
 	const reduced_fermion_lattice_t& linkconf = (lattice);
-	
-#pragma omp parallel for
-	for (int site = 0; site < lattice.localsize; ++site) {
-		//the best
-		std::complex<real_t> projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmm, tmp;
+
+	std::complex<real_t> projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmm, tmp;
+	{
 		{
-			{
-				const size_t site_down = Vector::sdn(site,0);
-				const size_t site_up = Vector::sup(site,0);
+			const size_t site_down = Vector::sdn(site,0);
+			const size_t site_up = Vector::sup(site,0);
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_minus[n] = std::complex<real_t>(input[site_down][0][n].real()+input[site_down][3][n].imag(),input[site_down][0][n].imag()-input[site_down][3][n].real());
+			}
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_plus[n] = std::complex<real_t>(input[site_up][0][n].real()-input[site_up][3][n].imag(),input[site_up][0][n].imag()+input[site_up][3][n].real());
+			}
+			for (int i = 0; i < diracVectorLength; ++i) {
+				tmp = 0;
+				tmm = 0;
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(input[site_down][0][n].real()+input[site_down][3][n].imag(),input[site_down][0][n].imag()-input[site_down][3][n].real());
+					tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
 				}
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(input[site_up][0][n].real()-input[site_up][3][n].imag(),input[site_up][0][n].imag()+input[site_up][3][n].real());
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
-					}
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
-					}
-					output[site][0][i] = input[site][0][i] - kappa*(tmp+tmm);
-					output[site][3][i] = -input[site][3][i] + kappa*std::complex<real_t>(tmm.imag() - tmp.imag(),tmp.real() - tmm.real());
+					tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
 				}
+				output[site][0][i] = input[site][0][i] - kappa*(tmp+tmm);
+				output[site][3][i] = -input[site][3][i] + kappa*std::complex<real_t>(tmm.imag() - tmp.imag(),tmp.real() - tmm.real());
+			}
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_minus[n] = std::complex<real_t>(input[site_down][1][n].real()+input[site_down][2][n].imag(), input[site_down][1][n].imag()-input[site_down][2][n].real());
+			}
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_plus[n] = std::complex<real_t>(input[site_up][1][n].real()-input[site_up][2][n].imag(),input[site_up][1][n].imag()+input[site_up][2][n].real());
+			}
+			for (int i = 0; i < diracVectorLength; ++i) {
+				tmp = 0;
+				tmm = 0;
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(input[site_down][1][n].real()+input[site_down][2][n].imag(), input[site_down][1][n].imag()-input[site_down][2][n].real());
+					tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
 				}
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(input[site_up][1][n].real()-input[site_up][2][n].imag(),input[site_up][1][n].imag()+input[site_up][2][n].real());
+					tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
-					}
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
-					}
 
-					output[site][1][i] = input[site][1][i]- kappa*(tmp+tmm);
-					output[site][2][i] = -input[site][2][i]+ kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real()-tmm.real());
-				}
+				output[site][1][i] = input[site][1][i]- kappa*(tmp+tmm);
+				output[site][2][i] = -input[site][2][i]+ kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real()-tmm.real());
+			}
+		}
+		{
+			const size_t site_down = Vector::sdn(site,1);
+			const size_t site_up = Vector::sup(site,1);
+			for(int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_minus[n] = input[site_down][0][n] - (input[site_down][3][n]);
 			}
-			{
-				const size_t site_down = Vector::sdn(site,1);
-				const size_t site_up = Vector::sup(site,1);
+			for(int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_plus[n] = input[site_up][0][n] + (input[site_up][3][n]);
+			}
+			for (int i = 0; i < diracVectorLength; ++i) {
+				tmp = 0;
+				tmm = 0;
 				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = input[site_down][0][n] - (input[site_down][3][n]);
+					tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
 				}
 				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = input[site_up][0][n] + (input[site_up][3][n]);
+					tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for(int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
-					}
-					for(int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
-					}
 
-					output[site][0][i] -= kappa*(tmp+tmm);
-					output[site][3][i] += kappa*(tmm-tmp);
-				}
+				output[site][0][i] -= kappa*(tmp+tmm);
+				output[site][3][i] += kappa*(tmm-tmp);
+			}
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][2][n]);
+			}
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][2][n]);
+			}
+			for (int i = 0; i < diracVectorLength; ++i) {
+				tmp = 0;
+				tmm = 0;
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][2][n]);
+					tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
 				}
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][2][n]);
+					tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
-					}
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
-					}
 
-					output[site][1][i] -= kappa*(tmp+tmm);
-					output[site][2][i] += kappa*(tmp-tmm);
-				}
+				output[site][1][i] -= kappa*(tmp+tmm);
+				output[site][2][i] += kappa*(tmp-tmm);
+			}
+		}
+		{
+			const size_t site_down = Vector::sdn(site,2);
+			const size_t site_up = Vector::sup(site,2);
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_minus[n] = std::complex<real_t>(input[site_down][0][n].real() + input[site_down][2][n].imag(), input[site_down][0][n].imag() - input[site_down][2][n].real());
+			}
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_plus[n] = std::complex<real_t>(input[site_up][0][n].real() - input[site_up][2][n].imag(), input[site_up][0][n].imag() + input[site_up][2][n].real());
 			}
-			{
-				const size_t site_down = Vector::sdn(site,2);
-				const size_t site_up = Vector::sup(site,2);
+			for (int i = 0; i < diracVectorLength; ++i) {
+				tmp = 0;
+				tmm = 0;
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(input[site_down][0][n].real() + input[site_down][2][n].imag(), input[site_down][0][n].imag() - input[site_down][2][n].real());
+					tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
 				}
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(input[site_up][0][n].real() - input[site_up][2][n].imag(), input[site_up][0][n].imag() + input[site_up][2][n].real());
+					tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
-					}
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
-					}
 
-					output[site][0][i] -= kappa*(tmp+tmm);
-					output[site][2][i] += kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real() - tmm.real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(input[site_down][1][n].real() - input[site_down][3][n].imag(), input[site_down][1][n].imag() + input[site_down][3][n].real());
+				output[site][0][i] -= kappa*(tmp+tmm);
+				output[site][2][i] += kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real() - tmm.real());
+			}
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_minus[n] = std::complex<real_t>(input[site_down][1][n].real() - input[site_down][3][n].imag(), input[site_down][1][n].imag() + input[site_down][3][n].real());
+			}
+			for(int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_plus[n] = std::complex<real_t>(input[site_up][1][n].real() + input[site_up][3][n].imag(), input[site_up][1][n].imag() - input[site_up][3][n].real());
+			}
+			for (int i = 0; i < diracVectorLength; ++i) {
+				tmp = 0;
+				tmm = 0;
+				for(int n = 0; n < diracVectorLength; ++n) {
+					tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
 				}
 				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(input[site_up][1][n].real() + input[site_up][3][n].imag(), input[site_up][1][n].imag() - input[site_up][3][n].real());
+					tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for(int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
-					}
-					for(int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
-					}
 
-					output[site][1][i] -= kappa*(tmp+tmm);
-					output[site][3][i] += kappa*std::complex<real_t>(tmp.imag() - tmm.imag(), tmm.real() - tmp.real());
-				}
+				output[site][1][i] -= kappa*(tmp+tmm);
+				output[site][3][i] += kappa*std::complex<real_t>(tmp.imag() - tmm.imag(), tmm.real() - tmp.real());
 			}
-			{
-				const size_t site_down = Vector::sdn(site,3);
-				const size_t site_up = Vector::sup(site,3);
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = input[site_down][0][n] + (input[site_down][2][n]);
+		}
+		{
+			const size_t site_down = Vector::sdn(site,3);
+			const size_t site_up = Vector::sup(site,3);
+			for(int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_minus[n] = input[site_down][0][n] + (input[site_down][2][n]);
+			}
+			for(int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_plus[n] = input[site_up][0][n] - (input[site_up][2][n]);
+			}
+			for (int i = 0; i < diracVectorLength; ++i) {
+				tmp = 0;
+				tmm = 0;
+				for (int n = 0; n < diracVectorLength; ++n) {
+					tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
 				}
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = input[site_up][0][n] - (input[site_up][2][n]);
+				for (int n = 0; n < diracVectorLength; ++n) {
+					tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
-					}
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
-					}
 
-					output[site][0][i] -= kappa*(tmp+tmm);
-					output[site][2][i] += kappa*(tmp-tmm);
-				}
+				output[site][0][i] -= kappa*(tmp+tmm);
+				output[site][2][i] += kappa*(tmp-tmm);
+			}
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][3][n]);
+			}
+			for (int n = 0; n < diracVectorLength; ++n) {
+				projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][3][n]);
+			}
+			for (int i = 0; i < diracVectorLength; ++i) {
+				tmp = 0;
+				tmm = 0;
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][3][n]);
+					tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
 				}
 				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][3][n]);
+					tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
-					}
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
-					}
 
-					output[site][1][i] -= kappa*(tmp+tmm);
-					output[site][3][i] += kappa*(tmp-tmm);
-				}
+				output[site][1][i] -= kappa*(tmp+tmm);
+				output[site][3][i] += kappa*(tmp-tmm);
 			}
 		}
-		if (!gamma5) {
-			for (int i = 0; i < diracVectorLength; ++i) {
-				output[site][2][i] = -output[site][2][i];
-				output[site][3][i] = -output[site][3][i];
+	}
+	if (!gamma5) {
+		for (int i = 0; i < diracVectorLength; ++i) {
+			output[site][2][i] = -output[site][2][i];
+			output[site][3][i] = -output[site][3][i];
+		}
+	}
+}
+
+void DiracWilsonOperator::multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input) {
+	//The sites [0, sharedsize) are read by the neighbouring processors, we process them first
+	//and we overlap the halo exchange of the output with the interior sites [sharedsize, localsize)
+	const int siteRange[3] = {0, output.sharedsize, output.localsize};
+	for (int region = 0; region < 2; ++region) {
+		this->beginRegion();
+#pragma omp parallel for
+		for (int site = siteRange[region]; site < siteRange[region+1]; ++site) {
+			this->multiplySite(output, input, site);
+		}
+		this->endRegion(region);
+		if (region == 0 && overlapCommunication) output.communicateHalo();
+	}
+	if (!overlapCommunication) output.communicateHalo();
+	output.waitHalo();
+}
+
+void DiracWilsonOperator::multiplyBlock(const std::vector<reduced_dirac_vector_t*>& outputs, const std::vector<const reduced_dirac_vector_t*>& inputs) {
+	//The sites are processed in chunks, every chunk is applied to all the vectors so that its links are loaded from memory once for the whole block
+	const int chunkSize = 1024;
+	const int siteRange[3] = {0, reduced_dirac_vector_t::Layout::sharedsize, reduced_dirac_vector_t::Layout::localsize};
+	for (int region = 0; region < 2; ++region) {
+		this->beginRegion();
+#pragma omp parallel for
+		for (int begin = siteRange[region]; begin < siteRange[region+1]; begin += chunkSize) {
+			const int end = std::min(begin + chunkSize, siteRange[region+1]);
+			for (unsigned int i = 0; i < inputs.size(); ++i) {
+				for (int site = begin; site < end; ++site) {
+					this->multiplySite(*outputs[i], *inputs[i], site);
+				}
 			}
 		}
+		this->endRegion(region);
+		if (region == 0 && overlapCommunication) {
+			for (unsigned int i = 0; i < outputs.size(); ++i) outputs[i]->communicateHalo();
+		}
 	}
-	output.updateHalo();
+	if (!overlapCommunication) {
+		for (unsigned int i = 0; i < outputs.size(); ++i) outputs[i]->communicateHalo();
+	}
+	for (unsigned int i = 0; i < outputs.size(); ++i) outputs[i]->waitHalo();
 }
 
  void DiracWilsonOperator::multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha) {
@@ -207,188 +251,212 @@ void DiracWilsonOperator::multiply(reduced_dirac_vector_t& output, const reduced
 
 	 const reduced_fermion_lattice_t& linkconf = (lattice);
 
+	 //The sites [0, sharedsize) are read by the neighbouring processors, we process them first
+	 //and we overlap the halo exchange of the output with the interior sites [sharedsize, localsize)
+	 const int siteRange[3] = {0, output.sharedsize, output.localsize};
+	 for (int region = 0; region < 2; ++region) {
+	 	this->beginRegion();
 #pragma omp parallel for
-	 for (int site = 0; site < lattice.localsize; ++site) {
-		 //the most efficient unrolling of the dirac operator
-		 std::complex<real_t> projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmm, tmp;
-		 {
+	 	for (int site = siteRange[region]; site < siteRange[region+1]; ++site) {
+			 //the most efficient unrolling of the dirac operator
+			 std::complex<real_t> projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmm, tmp;
 			 {
-				 const size_t site_down = Vector::sdn(site,0);
-				 const size_t site_up = Vector::sup(site,0);
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][0][n].real()+vector1[site_down][3][n].imag(),vector1[site_down][0][n].imag()-vector1[site_down][3][n].real());
-				 }
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][0][n].real()-vector1[site_up][3][n].imag(),vector1[site_up][0][n].imag()+vector1[site_up][3][n].real());
-				 }
-				 for (int i = 0; i < diracVectorLength; ++i) {
-					 tmp = 0;
-					 tmm = 0;
+				 {
+					 const size_t site_down = Vector::sdn(site,0);
+					 const size_t site_up = Vector::sup(site,0);
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						 projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][0][n].real()+vector1[site_down][3][n].imag(),vector1[site_down][0][n].imag()-vector1[site_down][3][n].real());
 					 }
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						 projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][0][n].real()-vector1[site_up][3][n].imag(),vector1[site_up][0][n].imag()+vector1[site_up][3][n].real());
+					 }
+					 for (int i = 0; i < diracVectorLength; ++i) {
+						 tmp = 0;
+						 tmm = 0;
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						 }
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						 }
+						 output[site][0][i] = alpha*vector2[site][0][i] + vector1[site][0][i] - kappa*(tmp+tmm);
+						 output[site][3][i] = alpha*vector2[site][3][i] - vector1[site][3][i] + kappa*std::complex<real_t>(tmm.imag() - tmp.imag(),tmp.real() - tmm.real());
 					 }
-					 output[site][0][i] = alpha*vector2[site][0][i] + vector1[site][0][i] - kappa*(tmp+tmm);
-					 output[site][3][i] = alpha*vector2[site][3][i] - vector1[site][3][i] + kappa*std::complex<real_t>(tmm.imag() - tmp.imag(),tmp.real() - tmm.real());
-				 }
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][1][n].real()+vector1[site_down][2][n].imag(), vector1[site_down][1][n].imag()-vector1[site_down][2][n].real());
-				 }
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][1][n].real()-vector1[site_up][2][n].imag(), vector1[site_up][1][n].imag()+vector1[site_up][2][n].real());
-				 }
-				 for (int i = 0; i < diracVectorLength; ++i) {
-					 tmp = 0;
-					 tmm = 0;
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						 projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][1][n].real()+vector1[site_down][2][n].imag(), vector1[site_down][1][n].imag()-vector1[site_down][2][n].real());
 					 }
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						 projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][1][n].real()-vector1[site_up][2][n].imag(), vector1[site_up][1][n].imag()+vector1[site_up][2][n].real());
 					 }
+					 for (int i = 0; i < diracVectorLength; ++i) {
+						 tmp = 0;
+						 tmm = 0;
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						 }
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						 }
 
-					 output[site][1][i] = alpha*vector2[site][1][i] + vector1[site][1][i]- kappa*(tmp+tmm);
-					 output[site][2][i] = alpha*vector2[site][2][i] - vector1[site][2][i]+ kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real()-tmm.real());
-				 }
-			 }
-			 {
-				 const size_t site_down = Vector::sdn(site,1);
-				 const size_t site_up = Vector::sup(site,1);
-				 for(int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_minus[n] = vector1[site_down][0][n] - (vector1[site_down][3][n]);
-				 }
-				 for(int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_plus[n] = vector1[site_up][0][n] + (vector1[site_up][3][n]);
+						 output[site][1][i] = alpha*vector2[site][1][i] + vector1[site][1][i]- kappa*(tmp+tmm);
+						 output[site][2][i] = alpha*vector2[site][2][i] - vector1[site][2][i]+ kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real()-tmm.real());
+					 }
 				 }
-				 for (int i = 0; i < diracVectorLength; ++i) {
-					 tmp = 0;
-					 tmm = 0;
+				 {
+					 const size_t site_down = Vector::sdn(site,1);
+					 const size_t site_up = Vector::sup(site,1);
 					 for(int n = 0; n < diracVectorLength; ++n) {
-						 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						 projection_spinor_minus[n] = vector1[site_down][0][n] - (vector1[site_down][3][n]);
 					 }
 					 for(int n = 0; n < diracVectorLength; ++n) {
-						 tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						 projection_spinor_plus[n] = vector1[site_up][0][n] + (vector1[site_up][3][n]);
 					 }
+					 for (int i = 0; i < diracVectorLength; ++i) {
+						 tmp = 0;
+						 tmm = 0;
+						 for(int n = 0; n < diracVectorLength; ++n) {
+							 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						 }
+						 for(int n = 0; n < diracVectorLength; ++n) {
+							 tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						 }
 
-					 output[site][0][i] -= kappa*(tmp+tmm);
-					 output[site][3][i] += kappa*(tmm-tmp);
-				 }
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_minus[n] = vector1[site_down][1][n] + (vector1[site_down][2][n]);
-				 }
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_plus[n] = vector1[site_up][1][n] - (vector1[site_up][2][n]);
-				 }
-				 for (int i = 0; i < diracVectorLength; ++i) {
-					 tmp = 0;
-					 tmm = 0;
+						 output[site][0][i] -= kappa*(tmp+tmm);
+						 output[site][3][i] += kappa*(tmm-tmp);
+					 }
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						 projection_spinor_minus[n] = vector1[site_down][1][n] + (vector1[site_down][2][n]);
 					 }
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						 projection_spinor_plus[n] = vector1[site_up][1][n] - (vector1[site_up][2][n]);
 					 }
+					 for (int i = 0; i < diracVectorLength; ++i) {
+						 tmp = 0;
+						 tmm = 0;
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						 }
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						 }
 
-					 output[site][1][i] -= kappa*(tmp+tmm);
-					 output[site][2][i] += kappa*(tmp-tmm);
-				 }
-			 }
-			 {
-				 const size_t site_down = Vector::sdn(site,2);
-				 const size_t site_up = Vector::sup(site,2);
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][0][n].real() + vector1[site_down][2][n].imag(), vector1[site_down][0][n].imag() - vector1[site_down][2][n].real());
-				 }
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][0][n].real() - vector1[site_up][2][n].imag(), vector1[site_up][0][n].imag() + vector1[site_up][2][n].real());
+						 output[site][1][i] -= kappa*(tmp+tmm);
+						 output[site][2][i] += kappa*(tmp-tmm);
+					 }
 				 }
-				 for (int i = 0; i < diracVectorLength; ++i) {
-					 tmp = 0;
-					 tmm = 0;
+				 {
+					 const size_t site_down = Vector::sdn(site,2);
+					 const size_t site_up = Vector::sup(site,2);
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						 projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][0][n].real() + vector1[site_down][2][n].imag(), vector1[site_down][0][n].imag() - vector1[site_down][2][n].real());
 					 }
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						 projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][0][n].real() - vector1[site_up][2][n].imag(), vector1[site_up][0][n].imag() + vector1[site_up][2][n].real());
 					 }
+					 for (int i = 0; i < diracVectorLength; ++i) {
+						 tmp = 0;
+						 tmm = 0;
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						 }
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						 }
 
-					 output[site][0][i] -= kappa*(tmp+tmm);
-					 output[site][2][i] += kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real() - tmm.real());
-				 }
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][1][n].real() - vector1[site_down][3][n].imag(), vector1[site_down][1][n].imag() + vector1[site_down][3][n].real());
-				 }
-				 for(int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][1][n].real() + vector1[site_up][3][n].imag(), vector1[site_up][1][n].imag() - vector1[site_up][3][n].real());
-				 }
-				 for (int i = 0; i < diracVectorLength; ++i) {
-					 tmp = 0;
-					 tmm = 0;
-					 for(int n = 0; n < diracVectorLength; ++n) {
-						 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						 output[site][0][i] -= kappa*(tmp+tmm);
+						 output[site][2][i] += kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real() - tmm.real());
+					 }
+					 for (int n = 0; n < diracVectorLength; ++n) {
+						 projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][1][n].real() - vector1[site_down][3][n].imag(), vector1[site_down][1][n].imag() + vector1[site_down][3][n].real());
 					 }
 					 for(int n = 0; n < diracVectorLength; ++n) {
-						 tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						 projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][1][n].real() + vector1[site_up][3][n].imag(), vector1[site_up][1][n].imag() - vector1[site_up][3][n].real());
 					 }
+					 for (int i = 0; i < diracVectorLength; ++i) {
+						 tmp = 0;
+						 tmm = 0;
+						 for(int n = 0; n < diracVectorLength; ++n) {
+							 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						 }
+						 for(int n = 0; n < diracVectorLength; ++n) {
+							 tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						 }
 
-					 output[site][1][i] -= kappa*(tmp+tmm);
-					 output[site][3][i] += kappa*std::complex<real_t>(tmp.imag() - tmm.imag(), tmm.real() - tmp.real());
-				 }
-			 }
-			 {
-				 const size_t site_down = Vector::sdn(site,3);
-				 const size_t site_up = Vector::sup(site,3);
-				 for(int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_minus[n] = vector1[site_down][0][n] + (vector1[site_down][2][n]);
-				 }
-				 for(int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_plus[n] = vector1[site_up][0][n] - (vector1[site_up][2][n]);
+						 output[site][1][i] -= kappa*(tmp+tmm);
+						 output[site][3][i] += kappa*std::complex<real_t>(tmp.imag() - tmm.imag(), tmm.real() - tmp.real());
+					 }
 				 }
-				 for (int i = 0; i < diracVectorLength; ++i) {
-					 tmp = 0;
-					 tmm = 0;
-					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+				 {
+					 const size_t site_down = Vector::sdn(site,3);
+					 const size_t site_up = Vector::sup(site,3);
+					 for(int n = 0; n < diracVectorLength; ++n) {
+						 projection_spinor_minus[n] = vector1[site_down][0][n] + (vector1[site_down][2][n]);
 					 }
-					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+					 for(int n = 0; n < diracVectorLength; ++n) {
+						 projection_spinor_plus[n] = vector1[site_up][0][n] - (vector1[site_up][2][n]);
 					 }
+					 for (int i = 0; i < diracVectorLength; ++i) {
+						 tmp = 0;
+						 tmm = 0;
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						 }
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						 }
 
-					 output[site][0][i] -= kappa*(tmp+tmm);
-					 output[site][2][i] += kappa*(tmp-tmm);
-				 }
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_minus[n] = vector1[site_down][1][n] + (vector1[site_down][3][n]);
-				 }
-				 for (int n = 0; n < diracVectorLength; ++n) {
-					 projection_spinor_plus[n] = vector1[site_up][1][n] - (vector1[site_up][3][n]);
-				 }
-				 for (int i = 0; i < diracVectorLength; ++i) {
-					 tmp = 0;
-					 tmm = 0;
+						 output[site][0][i] -= kappa*(tmp+tmm);
+						 output[site][2][i] += kappa*(tmp-tmm);
+					 }
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						 projection_spinor_minus[n] = vector1[site_down][1][n] + (vector1[site_down][3][n]);
 					 }
 					 for (int n = 0; n < diracVectorLength; ++n) {
-						 tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						 projection_spinor_plus[n] = vector1[site_up][1][n] - (vector1[site_up][3][n]);
 					 }
+					 for (int i = 0; i < diracVectorLength; ++i) {
+						 tmp = 0;
+						 tmm = 0;
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						 }
+						 for (int n = 0; n < diracVectorLength; ++n) {
+							 tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						 }
 
-					 output[site][1][i] -= kappa*(tmp+tmm);
-					 output[site][3][i] += kappa*(tmp-tmm);
+						 output[site][1][i] -= kappa*(tmp+tmm);
+						 output[site][3][i] += kappa*(tmp-tmm);
+					 }
 				 }
 			 }
-		 }
-		 if (!gamma5) {
-			for (int i = 0; i < diracVectorLength; ++i) {
-				output[site][2][i] = -output[site][2][i]+static_cast<real_t>(2)*alpha*vector2[site][2][i];
-				output[site][3][i] = -output[site][3][i]+static_cast<real_t>(2)*alpha*vector2[site][3][i];
+			 if (!gamma5) {
+				for (int i = 0; i < diracVectorLength; ++i) {
+					output[site][2][i] = -output[site][2][i]+static_cast<real_t>(2)*alpha*vector2[site][2][i];
+					output[site][3][i] = -output[site][3][i]+static_cast<real_t>(2)*alpha*vector2[site][3][i];
+				}
 			}
-		}
+	 	}
+	 	this->endRegion(region);
+	 	if (region == 0 && overlapCommunication) output.communicateHalo();
 	 }
-	 output.updateHalo();
+	 if (!overlapCommunication) output.communicateHalo();
+	 output.waitHalo();
+}
+
+#ifdef ALIGNED_OPT
+void DiracWilsonOperator::multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input) {
+	AlignedDiracWilsonKernel::multiply(output, input, 0, 0., soaLattice, 0, kappa, 0., gamma5, overlapCommunication);
+}
+
+void DiracWilsonOperator::multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t& vector2, const complex& alpha) {
+	AlignedDiracWilsonKernel::multiply(output, vector1, &vector2, alpha, soaLattice, 0, kappa, 0., gamma5, overlapCommunication);
+}
+
+void DiracWilsonOperator::setLattice(const extended_fermion_lattice_t& _lattice) {
+	lattice = _lattice;
+	soaLattice = lattice;
 }
+#endif
 
 FermionForce* DiracWilsonOperator::getForce() const {
 	return new DiracWilsonFermionForce(kappa);
@@ -26,8 +26,33 @@ public:
 	 */
 	virtual void multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha);
 
+	/**
+	 * This routine multiplies the DiracWilson operator to a block of vectors, the links of every site are loaded once for all the vectors
+	 * @param outputs
+	 * @param inputs
+	 */
+	virtual void multiplyBlock(const std::vector<reduced_dirac_vector_t*>& outputs, const std::vector<const reduced_dirac_vector_t*>& inputs);
+
+#ifdef ALIGNED_OPT
+	/**
+	 * Vectorized versions on the split real/imaginary storage
+	 */
+	virtual void multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input);
+	virtual void multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t& vector2, const complex& alpha);
+
+	virtual void setLattice(const extended_fermion_lattice_t& _lattice);
+#endif
+
 	virtual FermionForce* getForce() const;
 private:
+	inline void multiplySite(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input, int site) const;
+
+#ifdef ALIGNED_OPT
+	//Copy of the links with split real/imaginary storage
+	reduced_soa_fermion_lattice_t soaLattice;
+#endif
+
+
 	DiracWilsonOperator(const DiracOperator&) { }
 };
 
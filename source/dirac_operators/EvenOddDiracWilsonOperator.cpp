@@ -0,0 +1,192 @@
+#include "EvenOddDiracWilsonOperator.h"
+#include "hmc_forces/EvenOddDiracWilsonFermionForce.h"
+
+namespace Update {
+
+EvenOddDiracWilsonOperator::EvenOddDiracWilsonOperator() : DiracOperator(), twist(0.) { }
+
+EvenOddDiracWilsonOperator::EvenOddDiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa, real_t _twist, bool _gamma5) : DiracOperator(_lattice, _kappa, _gamma5), twist(_twist) { }
+
+EvenOddDiracWilsonOperator::~EvenOddDiracWilsonOperator() { }
+
+void EvenOddDiracWilsonOperator::multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input) {
+	typedef reduced_dirac_vector_t::Layout Layout;
+	//output_o = M_oe M_ee^-1 M_eo input_o
+	this->multiplyEvenOdd(output, input, EVEN);
+	this->multiplyDiagonalInverse(output, EVEN);
+	this->multiplyEvenOdd(output, output, ODD);
+
+	const std::complex<real_t> diagonalUp(1., twist), diagonalDown(1., -twist);
+#pragma omp parallel for
+	for (int site = 0; site < Layout::completesize; ++site) {
+		if ((Layout::globalIndexX(site) + Layout::globalIndexY(site) + Layout::globalIndexZ(site) + Layout::globalIndexT(site)) % 2 == 0) {
+			for (unsigned int mu = 0; mu < 4; ++mu) output[site][mu] = input[site][mu];
+		}
+		else {
+			for (unsigned int mu = 0; mu < 2; ++mu) output[site][mu] = diagonalUp*input[site][mu] - output[site][mu];
+			for (unsigned int mu = 2; mu < 4; ++mu) output[site][mu] = diagonalDown*input[site][mu] - output[site][mu];
+			if (gamma5) {
+				for (unsigned int mu = 2; mu < 4; ++mu) output[site][mu] = -output[site][mu];
+			}
+		}
+	}
+}
+
+void EvenOddDiracWilsonOperator::multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha) {
+	this->multiply(output, vector1);
+#pragma omp parallel for
+	for (int site = 0; site < output.completesize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) output[site][mu] += alpha*vector2[site][mu];
+	}
+}
+
+FermionForce* EvenOddDiracWilsonOperator::getForce() const {
+	return new EvenOddDiracWilsonFermionForce(kappa, twist);
+}
+
+void EvenOddDiracWilsonOperator::setTwist(real_t _twist) {
+	twist = _twist;
+}
+
+real_t EvenOddDiracWilsonOperator::getTwist() const {
+	return twist;
+}
+
+void EvenOddDiracWilsonOperator::prepareOddSource(reduced_dirac_vector_t& oddSource, const reduced_dirac_vector_t& source) {
+	typedef reduced_dirac_vector_t::Layout Layout;
+	//The source of M is gamma5 source when the operator is gamma5 M
+	const real_t sign = gamma5 ? -1. : 1.;
+#pragma omp parallel for
+	for (int site = 0; site < Layout::completesize; ++site) {
+		for (unsigned int mu = 0; mu < 2; ++mu) oddSource[site][mu] = source[site][mu];
+		for (unsigned int mu = 2; mu < 4; ++mu) oddSource[site][mu] = sign*source[site][mu];
+	}
+	this->multiplyDiagonalInverse(oddSource, EVEN);
+	this->multiplyEvenOdd(oddSource, oddSource, ODD);
+
+#pragma omp parallel for
+	for (int site = 0; site < Layout::completesize; ++site) {
+		if ((Layout::globalIndexX(site) + Layout::globalIndexY(site) + Layout::globalIndexZ(site) + Layout::globalIndexT(site)) % 2 == 0) {
+			for (unsigned int mu = 0; mu < 4; ++mu) set_to_zero(oddSource[site][mu]);
+		}
+		else {
+			for (unsigned int mu = 0; mu < 2; ++mu) oddSource[site][mu] = source[site][mu] - oddSource[site][mu];
+			for (unsigned int mu = 2; mu < 4; ++mu) oddSource[site][mu] = source[site][mu] - sign*oddSource[site][mu];
+		}
+	}
+}
+
+void EvenOddDiracWilsonOperator::reconstructSolution(reduced_dirac_vector_t& solution, const reduced_dirac_vector_t& oddSolution, const reduced_dirac_vector_t& source) {
+	typedef reduced_dirac_vector_t::Layout Layout;
+	const real_t sign = gamma5 ? -1. : 1.;
+	this->multiplyEvenOdd(solution, oddSolution, EVEN);
+
+#pragma omp parallel for
+	for (int site = 0; site < Layout::completesize; ++site) {
+		if ((Layout::globalIndexX(site) + Layout::globalIndexY(site) + Layout::globalIndexZ(site) + Layout::globalIndexT(site)) % 2 == 0) {
+			for (unsigned int mu = 0; mu < 2; ++mu) solution[site][mu] = source[site][mu] - solution[site][mu];
+			for (unsigned int mu = 2; mu < 4; ++mu) solution[site][mu] = sign*source[site][mu] - solution[site][mu];
+		}
+	}
+	this->multiplyDiagonalInverse(solution, EVEN);
+}
+
+void EvenOddDiracWilsonOperator::multiplyDiagonalInverse(reduced_dirac_vector_t& output, Part part) {
+	typedef reduced_dirac_vector_t::Layout Layout;
+	if (twist == 0.) return;
+	const std::complex<real_t> inverseUp = 1./std::complex<real_t>(1., twist), inverseDown = 1./std::complex<real_t>(1., -twist);
+#pragma omp parallel for
+	for (int site = 0; site < Layout::completesize; ++site) {
+		if ((Layout::globalIndexX(site) + Layout::globalIndexY(site) + Layout::globalIndexZ(site) + Layout::globalIndexT(site)) % 2 == part) {
+			for (unsigned int mu = 0; mu < 2; ++mu) output[site][mu] = inverseUp*output[site][mu];
+			for (unsigned int mu = 2; mu < 4; ++mu) output[site][mu] = inverseDown*output[site][mu];
+		}
+	}
+}
+
+void EvenOddDiracWilsonOperator::multiplyEvenOdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input, Part part) {
+	typedef reduced_fermion_lattice_t::Layout Layout;
+	typedef reduced_dirac_vector_t Vector;
+
+	//The sites [0, sharedsize) are read by the neighbouring processors, we process them first
+	//and we overlap the halo exchange of the output with the interior sites [sharedsize, localsize)
+	const int siteRange[3] = {0, output.sharedsize, output.localsize};
+	for (int region = 0; region < 2; ++region) {
+		this->beginRegion();
+#pragma omp parallel for
+		for (int site = siteRange[region]; site < siteRange[region+1]; ++site) {
+			if ((Layout::globalIndexX(site) + Layout::globalIndexY(site) + Layout::globalIndexZ(site) + Layout::globalIndexT(site)) % 2 == part) {
+				GaugeVector tmp_plus[4][2];
+				GaugeVector tmp_minus[4][2];
+
+				//We project the full spinor in an appropriate half-spinor
+				GaugeVector projection_spinor[4][2];
+
+				int site_sup_0 = Vector::sup(site,0);
+				int site_sup_1 = Vector::sup(site,1);
+				int site_sup_2 = Vector::sup(site,2);
+				int site_sup_3 = Vector::sup(site,3);
+
+				for (int n = 0; n < diracVectorLength; ++n) {
+					projection_spinor[0][0][n] = std::complex<real_t>(real(input[site_sup_0][0][n])-imag(input[site_sup_0][3][n]),imag(input[site_sup_0][0][n])+real(input[site_sup_0][3][n]));
+					projection_spinor[0][1][n] = std::complex<real_t>(real(input[site_sup_0][1][n])-imag(input[site_sup_0][2][n]),imag(input[site_sup_0][1][n])+real(input[site_sup_0][2][n]));
+					projection_spinor[1][0][n] = std::complex<real_t>(real(input[site_sup_1][0][n])+real(input[site_sup_1][3][n]),imag(input[site_sup_1][0][n])+imag(input[site_sup_1][3][n]));
+					projection_spinor[1][1][n] = std::complex<real_t>(real(input[site_sup_1][1][n])-real(input[site_sup_1][2][n]),imag(input[site_sup_1][1][n])-imag(input[site_sup_1][2][n]));
+					projection_spinor[2][0][n] = std::complex<real_t>(real(input[site_sup_2][0][n])-imag(input[site_sup_2][2][n]),imag(input[site_sup_2][0][n])+real(input[site_sup_2][2][n]));
+					projection_spinor[2][1][n] = std::complex<real_t>(real(input[site_sup_2][1][n])+imag(input[site_sup_2][3][n]),imag(input[site_sup_2][1][n])-real(input[site_sup_2][3][n]));
+					projection_spinor[3][0][n] = std::complex<real_t>(real(input[site_sup_3][0][n])-real(input[site_sup_3][2][n]),imag(input[site_sup_3][0][n])-imag(input[site_sup_3][2][n]));
+					projection_spinor[3][1][n] = std::complex<real_t>(real(input[site_sup_3][1][n])-real(input[site_sup_3][3][n]),imag(input[site_sup_3][1][n])-imag(input[site_sup_3][3][n]));
+				}
+
+				//Now we can put U(x,mu)*input(x+mu)
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					for (unsigned int nu = 0; nu < 2; ++nu) {
+						tmp_plus[mu][nu] = lattice[site][mu]*projection_spinor[mu][nu];
+					}
+				}
+
+				int site_down_0 = Vector::sdn(site,0);
+				int site_down_1 = Vector::sdn(site,1);
+				int site_down_2 = Vector::sdn(site,2);
+				int site_down_3 = Vector::sdn(site,3);
+
+				for (int n = 0; n < diracVectorLength; ++n) {
+					projection_spinor[0][0][n] = std::complex<real_t>(real(input[site_down_0][0][n])+imag(input[site_down_0][3][n]),imag(input[site_down_0][0][n])-real(input[site_down_0][3][n]));
+					projection_spinor[0][1][n] = std::complex<real_t>(real(input[site_down_0][1][n])+imag(input[site_down_0][2][n]),imag(input[site_down_0][1][n])-real(input[site_down_0][2][n]));
+					projection_spinor[1][0][n] = std::complex<real_t>(real(input[site_down_1][0][n])-real(input[site_down_1][3][n]),imag(input[site_down_1][0][n])-imag(input[site_down_1][3][n]));
+					projection_spinor[1][1][n] = std::complex<real_t>(real(input[site_down_1][1][n])+real(input[site_down_1][2][n]),imag(input[site_down_1][1][n])+imag(input[site_down_1][2][n]));
+					projection_spinor[2][0][n] = std::complex<real_t>(real(input[site_down_2][0][n])+imag(input[site_down_2][2][n]),imag(input[site_down_2][0][n])-real(input[site_down_2][2][n]));
+					projection_spinor[2][1][n] = std::complex<real_t>(real(input[site_down_2][1][n])-imag(input[site_down_2][3][n]),imag(input[site_down_2][1][n])+real(input[site_down_2][3][n]));
+					projection_spinor[3][0][n] = std::complex<real_t>(real(input[site_down_3][0][n])+real(input[site_down_3][2][n]),imag(input[site_down_3][0][n])+imag(input[site_down_3][2][n]));
+					projection_spinor[3][1][n] = std::complex<real_t>(real(input[site_down_3][1][n])+real(input[site_down_3][3][n]),imag(input[site_down_3][1][n])+imag(input[site_down_3][3][n]));
+				}
+
+				//Then we put U(x-mu,mu)*input(x-mu)
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					for (unsigned int nu = 0; nu < 2; ++nu) {
+						GaugeVector tmp = htrans(lattice[Vector::sdn(site,mu)][mu])*projection_spinor[mu][nu];
+						tmp_minus[mu][nu] = tmp_plus[mu][nu] - tmp;
+						tmp_plus[mu][nu] += tmp;
+					}
+				}
+
+				//The final result is - kappa*hopping, without gamma5
+				for (int n = 0; n < diracVectorLength; ++n) {
+					output[site][0][n] = std::complex<real_t>( - kappa*(real(tmp_plus[0][0][n])+real(tmp_plus[1][0][n])+real(tmp_plus[2][0][n])+real(tmp_plus[3][0][n])), - kappa*(imag(tmp_plus[0][0][n])+imag(tmp_plus[1][0][n])+imag(tmp_plus[2][0][n])+imag(tmp_plus[3][0][n])));
+					output[site][1][n] = std::complex<real_t>( - kappa*(real(tmp_plus[0][1][n])+real(tmp_plus[1][1][n])+real(tmp_plus[2][1][n])+real(tmp_plus[3][1][n])), - kappa*(imag(tmp_plus[0][1][n])+imag(tmp_plus[1][1][n])+imag(tmp_plus[2][1][n])+imag(tmp_plus[3][1][n])));
+					output[site][2][n] = std::complex<real_t>( + kappa*(real(tmp_minus[1][1][n]) + real(tmp_minus[3][0][n]) - imag(tmp_minus[0][1][n]) - imag(tmp_minus[2][0][n])), + kappa*(real(tmp_minus[0][1][n]) + real(tmp_minus[2][0][n]) + imag(tmp_minus[1][1][n]) + imag(tmp_minus[3][0][n])));
+					output[site][3][n] = std::complex<real_t>( + kappa*(imag(tmp_minus[2][1][n]) - imag(tmp_minus[0][0][n]) - real(tmp_minus[1][0][n]) + real(tmp_minus[3][1][n])), + kappa*(real(tmp_minus[0][0][n]) - real(tmp_minus[2][1][n]) - imag(tmp_minus[1][0][n]) + imag(tmp_minus[3][1][n])));
+				}
+			}
+			else {
+				for (unsigned int mu = 0; mu < 4; ++mu) output[site][mu] = input[site][mu];
+			}
+		}
+		this->endRegion(region);
+		if (region == 0 && overlapCommunication) output.communicateHalo();
+	}
+	if (!overlapCommunication) output.communicateHalo();
+	output.waitHalo();
+}
+
+} /* namespace Update */
@@ -0,0 +1,67 @@
+#ifndef EVENODDDIRACWILSONOPERATOR_H_
+#define EVENODDDIRACWILSONOPERATOR_H_
+#include "DiracOperator.h"
+#include "EvenOddImprovedDiracWilsonOperator.h"
+
+namespace Update {
+
+/**
+ * Schur complement on the odd sites of the twisted Wilson operator M = D + i twist gamma5,
+ * M_oo - M_oe M_ee^-1 M_eo with M_ee = M_oo = 1 + i twist gamma5. As for EvenOddImprovedDiracWilsonOperator
+ * the vectors live on the full lattice and the operator is the identity on the even sites, only the odd sites are computed.
+ */
+class EvenOddDiracWilsonOperator : public DiracOperator {
+public:
+	EvenOddDiracWilsonOperator();
+	EvenOddDiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa = 0., real_t _twist = 0., bool _gamma5 = true);
+	~EvenOddDiracWilsonOperator();
+
+	/**
+	 * This routine multiplies the Schur complement to input and stores the result in output
+	 * @param output
+	 * @param input
+	 */
+	virtual void multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input);
+
+	/**
+	 * This routine multiplies the Schur complement to vector1 and stores the result in output adding alpha*vector2
+	 * @param output
+	 * @param vector1
+	 * @param vector2
+	 * @param alpha
+	 */
+	virtual void multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha);
+
+	virtual FermionForce* getForce() const;
+
+	void setTwist(real_t _twist);
+	real_t getTwist() const;
+
+	/**
+	 * This function builds the source of the Schur complement from the source of the full operator,
+	 * oddSource_o = source_o - M_oe M_ee^-1 source_e and zero on the even sites
+	 * @param oddSource
+	 * @param source
+	 */
+	void prepareOddSource(reduced_dirac_vector_t& oddSource, const reduced_dirac_vector_t& source);
+
+	/**
+	 * This function reconstructs the solution of the full operator from the solution of the Schur complement,
+	 * solution_e = M_ee^-1 (source_e - M_eo oddSolution_o)
+	 * @param solution
+	 * @param oddSolution
+	 * @param source
+	 */
+	void reconstructSolution(reduced_dirac_vector_t& solution, const reduced_dirac_vector_t& oddSolution, const reduced_dirac_vector_t& source);
+
+	//The hopping term M_eo (part = EVEN) or M_oe (part = ODD) on the sites of the given parity, the other sites are copied from input
+	void multiplyEvenOdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input, Part part);
+	//M_ee^-1 or M_oo^-1 on the sites of the given parity
+	void multiplyDiagonalInverse(reduced_dirac_vector_t& output, Part part);
+
+private:
+	real_t twist;
+};
+
+} /* namespace Update */
+#endif /* EVENODDDIRACWILSONOPERATOR_H_ */
@@ -205,79 +205,88 @@ void EvenOddImprovedDiracWilsonOperator::multiplyEvenOdd(reduced_dirac_vector_t
 	typedef reduced_fermion_lattice_t::Layout Layout;
 	typedef reduced_dirac_vector_t Vector;
 
+	//The sites [0, sharedsize) are read by the neighbouring processors, we process them first
+	//and we overlap the halo exchange of the output with the interior sites [sharedsize, localsize)
+	const int siteRange[3] = {0, output.sharedsize, output.localsize};
+	for (int region = 0; region < 2; ++region) {
+		this->beginRegion();
 #pragma omp parallel for
-	for (int site = 0; site< Layout::localsize; ++site) {//Even part?
-		if ((Layout::globalIndexX(site) + Layout::globalIndexY(site) + Layout::globalIndexZ(site) + Layout::globalIndexT(site)) % 2 == part) {
-			//First we start the hopping parameter terms
-			GaugeVector tmp_plus[4][2];
-			GaugeVector tmp_minus[4][2];
-
-			//Then we project the full spinor in an appropriate half-spinor
-			GaugeVector projection_spinor[4][2];
-
-			int site_sup_0 = Vector::sup(site,0);
-			int site_sup_1 = Vector::sup(site,1);
-			int site_sup_2 = Vector::sup(site,2);
-			int site_sup_3 = Vector::sup(site,3);
-
-			for (int n = 0; n < diracVectorLength; ++n) {
-				projection_spinor[0][0][n] = std::complex<real_t>(real(input[site_sup_0][0][n])-imag(input[site_sup_0][3][n]),imag(input[site_sup_0][0][n])+real(input[site_sup_0][3][n]));
-				projection_spinor[0][1][n] = std::complex<real_t>(real(input[site_sup_0][1][n])-imag(input[site_sup_0][2][n]),imag(input[site_sup_0][1][n])+real(input[site_sup_0][2][n]));
-				projection_spinor[1][0][n] = std::complex<real_t>(real(input[site_sup_1][0][n])+real(input[site_sup_1][3][n]),imag(input[site_sup_1][0][n])+imag(input[site_sup_1][3][n]));
-				projection_spinor[1][1][n] = std::complex<real_t>(real(input[site_sup_1][1][n])-real(input[site_sup_1][2][n]),imag(input[site_sup_1][1][n])-imag(input[site_sup_1][2][n]));
-				projection_spinor[2][0][n] = std::complex<real_t>(real(input[site_sup_2][0][n])-imag(input[site_sup_2][2][n]),imag(input[site_sup_2][0][n])+real(input[site_sup_2][2][n]));
-				projection_spinor[2][1][n] = std::complex<real_t>(real(input[site_sup_2][1][n])+imag(input[site_sup_2][3][n]),imag(input[site_sup_2][1][n])-real(input[site_sup_2][3][n]));
-				projection_spinor[3][0][n] = std::complex<real_t>(real(input[site_sup_3][0][n])-real(input[site_sup_3][2][n]),imag(input[site_sup_3][0][n])-imag(input[site_sup_3][2][n]));
-				projection_spinor[3][1][n] = std::complex<real_t>(real(input[site_sup_3][1][n])-real(input[site_sup_3][3][n]),imag(input[site_sup_3][1][n])-imag(input[site_sup_3][3][n]));
-			}
-
-			//Now we can put U(x,mu)*input(x+mu)
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				for (unsigned int nu = 0; nu < 2; ++nu) {
-					tmp_plus[mu][nu] = lattice[site][mu]*projection_spinor[mu][nu];
+		for (int site = siteRange[region]; site < siteRange[region+1]; ++site) {//Even part?
+			if ((Layout::globalIndexX(site) + Layout::globalIndexY(site) + Layout::globalIndexZ(site) + Layout::globalIndexT(site)) % 2 == part) {
+				//First we start the hopping parameter terms
+				GaugeVector tmp_plus[4][2];
+				GaugeVector tmp_minus[4][2];
+
+				//Then we project the full spinor in an appropriate half-spinor
+				GaugeVector projection_spinor[4][2];
+
+				int site_sup_0 = Vector::sup(site,0);
+				int site_sup_1 = Vector::sup(site,1);
+				int site_sup_2 = Vector::sup(site,2);
+				int site_sup_3 = Vector::sup(site,3);
+
+				for (int n = 0; n < diracVectorLength; ++n) {
+					projection_spinor[0][0][n] = std::complex<real_t>(real(input[site_sup_0][0][n])-imag(input[site_sup_0][3][n]),imag(input[site_sup_0][0][n])+real(input[site_sup_0][3][n]));
+					projection_spinor[0][1][n] = std::complex<real_t>(real(input[site_sup_0][1][n])-imag(input[site_sup_0][2][n]),imag(input[site_sup_0][1][n])+real(input[site_sup_0][2][n]));
+					projection_spinor[1][0][n] = std::complex<real_t>(real(input[site_sup_1][0][n])+real(input[site_sup_1][3][n]),imag(input[site_sup_1][0][n])+imag(input[site_sup_1][3][n]));
+					projection_spinor[1][1][n] = std::complex<real_t>(real(input[site_sup_1][1][n])-real(input[site_sup_1][2][n]),imag(input[site_sup_1][1][n])-imag(input[site_sup_1][2][n]));
+					projection_spinor[2][0][n] = std::complex<real_t>(real(input[site_sup_2][0][n])-imag(input[site_sup_2][2][n]),imag(input[site_sup_2][0][n])+real(input[site_sup_2][2][n]));
+					projection_spinor[2][1][n] = std::complex<real_t>(real(input[site_sup_2][1][n])+imag(input[site_sup_2][3][n]),imag(input[site_sup_2][1][n])-real(input[site_sup_2][3][n]));
+					projection_spinor[3][0][n] = std::complex<real_t>(real(input[site_sup_3][0][n])-real(input[site_sup_3][2][n]),imag(input[site_sup_3][0][n])-imag(input[site_sup_3][2][n]));
+					projection_spinor[3][1][n] = std::complex<real_t>(real(input[site_sup_3][1][n])-real(input[site_sup_3][3][n]),imag(input[site_sup_3][1][n])-imag(input[site_sup_3][3][n]));
 				}
-			}
 
-			int site_down_0 = Vector::sdn(site,0);
-			int site_down_1 = Vector::sdn(site,1);
-			int site_down_2 = Vector::sdn(site,2);
-			int site_down_3 = Vector::sdn(site,3);
+				//Now we can put U(x,mu)*input(x+mu)
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					for (unsigned int nu = 0; nu < 2; ++nu) {
+						tmp_plus[mu][nu] = lattice[site][mu]*projection_spinor[mu][nu];
+					}
+				}
 
-			for (int n = 0; n < diracVectorLength; ++n) {
-				projection_spinor[0][0][n] = std::complex<real_t>(real(input[site_down_0][0][n])+imag(input[site_down_0][3][n]),imag(input[site_down_0][0][n])-real(input[site_down_0][3][n]));
-				projection_spinor[0][1][n] = std::complex<real_t>(real(input[site_down_0][1][n])+imag(input[site_down_0][2][n]),imag(input[site_down_0][1][n])-real(input[site_down_0][2][n]));
-				projection_spinor[1][0][n] = std::complex<real_t>(real(input[site_down_1][0][n])-real(input[site_down_1][3][n]),imag(input[site_down_1][0][n])-imag(input[site_down_1][3][n]));
-				projection_spinor[1][1][n] = std::complex<real_t>(real(input[site_down_1][1][n])+real(input[site_down_1][2][n]),imag(input[site_down_1][1][n])+imag(input[site_down_1][2][n]));
-				projection_spinor[2][0][n] = std::complex<real_t>(real(input[site_down_2][0][n])+imag(input[site_down_2][2][n]),imag(input[site_down_2][0][n])-real(input[site_down_2][2][n]));
-				projection_spinor[2][1][n] = std::complex<real_t>(real(input[site_down_2][1][n])-imag(input[site_down_2][3][n]),imag(input[site_down_2][1][n])+real(input[site_down_2][3][n]));
-				projection_spinor[3][0][n] = std::complex<real_t>(real(input[site_down_3][0][n])+real(input[site_down_3][2][n]),imag(input[site_down_3][0][n])+imag(input[site_down_3][2][n]));
-				projection_spinor[3][1][n] = std::complex<real_t>(real(input[site_down_3][1][n])+real(input[site_down_3][3][n]),imag(input[site_down_3][1][n])+imag(input[site_down_3][3][n]));
-			}
+				int site_down_0 = Vector::sdn(site,0);
+				int site_down_1 = Vector::sdn(site,1);
+				int site_down_2 = Vector::sdn(site,2);
+				int site_down_3 = Vector::sdn(site,3);
+
+				for (int n = 0; n < diracVectorLength; ++n) {
+					projection_spinor[0][0][n] = std::complex<real_t>(real(input[site_down_0][0][n])+imag(input[site_down_0][3][n]),imag(input[site_down_0][0][n])-real(input[site_down_0][3][n]));
+					projection_spinor[0][1][n] = std::complex<real_t>(real(input[site_down_0][1][n])+imag(input[site_down_0][2][n]),imag(input[site_down_0][1][n])-real(input[site_down_0][2][n]));
+					projection_spinor[1][0][n] = std::complex<real_t>(real(input[site_down_1][0][n])-real(input[site_down_1][3][n]),imag(input[site_down_1][0][n])-imag(input[site_down_1][3][n]));
+					projection_spinor[1][1][n] = std::complex<real_t>(real(input[site_down_1][1][n])+real(input[site_down_1][2][n]),imag(input[site_down_1][1][n])+imag(input[site_down_1][2][n]));
+					projection_spinor[2][0][n] = std::complex<real_t>(real(input[site_down_2][0][n])+imag(input[site_down_2][2][n]),imag(input[site_down_2][0][n])-real(input[site_down_2][2][n]));
+					projection_spinor[2][1][n] = std::complex<real_t>(real(input[site_down_2][1][n])-imag(input[site_down_2][3][n]),imag(input[site_down_2][1][n])+real(input[site_down_2][3][n]));
+					projection_spinor[3][0][n] = std::complex<real_t>(real(input[site_down_3][0][n])+real(input[site_down_3][2][n]),imag(input[site_down_3][0][n])+imag(input[site_down_3][2][n]));
+					projection_spinor[3][1][n] = std::complex<real_t>(real(input[site_down_3][1][n])+real(input[site_down_3][3][n]),imag(input[site_down_3][1][n])+imag(input[site_down_3][3][n]));
+				}
 
-			//Then we put U(x-mu,mu)*input(x-mu)
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				for (unsigned int nu = 0; nu < 2; ++nu) {
-					GaugeVector tmp = htrans(lattice[Vector::sdn(site,mu)][mu])*projection_spinor[mu][nu];
-					tmp_minus[mu][nu] = tmp_plus[mu][nu] - tmp;
-					tmp_plus[mu][nu] += tmp;
+				//Then we put U(x-mu,mu)*input(x-mu)
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					for (unsigned int nu = 0; nu < 2; ++nu) {
+						GaugeVector tmp = htrans(lattice[Vector::sdn(site,mu)][mu])*projection_spinor[mu][nu];
+						tmp_minus[mu][nu] = tmp_plus[mu][nu] - tmp;
+						tmp_plus[mu][nu] += tmp;
+					}
 				}
-			}
 
 		
 			
-				//The final result is - kappa*gamma5*hopping
-			for (int n = 0; n < diracVectorLength; ++n) {
-				output[site][0][n] = std::complex<real_t>( - kappa*(real(tmp_plus[0][0][n])+real(tmp_plus[1][0][n])+real(tmp_plus[2][0][n])+real(tmp_plus[3][0][n])), - kappa*(imag(tmp_plus[0][0][n])+imag(tmp_plus[1][0][n])+imag(tmp_plus[2][0][n])+imag(tmp_plus[3][0][n])));
-				output[site][1][n] = std::complex<real_t>( - kappa*(real(tmp_plus[0][1][n])+real(tmp_plus[1][1][n])+real(tmp_plus[2][1][n])+real(tmp_plus[3][1][n])), - kappa*(imag(tmp_plus[0][1][n])+imag(tmp_plus[1][1][n])+imag(tmp_plus[2][1][n])+imag(tmp_plus[3][1][n])));
-				output[site][2][n] = std::complex<real_t>( + kappa*(real(tmp_minus[1][1][n]) + real(tmp_minus[3][0][n]) - imag(tmp_minus[0][1][n]) - imag(tmp_minus[2][0][n])), + kappa*(real(tmp_minus[0][1][n]) + real(tmp_minus[2][0][n]) + imag(tmp_minus[1][1][n]) + imag(tmp_minus[3][0][n])));
-				output[site][3][n] = std::complex<real_t>( + kappa*(imag(tmp_minus[2][1][n]) - imag(tmp_minus[0][0][n]) - real(tmp_minus[1][0][n]) + real(tmp_minus[3][1][n])), + kappa*(real(tmp_minus[0][0][n]) - real(tmp_minus[2][1][n]) - imag(tmp_minus[1][0][n]) + imag(tmp_minus[3][1][n])));
+					//The final result is - kappa*gamma5*hopping
+				for (int n = 0; n < diracVectorLength; ++n) {
+					output[site][0][n] = std::complex<real_t>( - kappa*(real(tmp_plus[0][0][n])+real(tmp_plus[1][0][n])+real(tmp_plus[2][0][n])+real(tmp_plus[3][0][n])), - kappa*(imag(tmp_plus[0][0][n])+imag(tmp_plus[1][0][n])+imag(tmp_plus[2][0][n])+imag(tmp_plus[3][0][n])));
+					output[site][1][n] = std::complex<real_t>( - kappa*(real(tmp_plus[0][1][n])+real(tmp_plus[1][1][n])+real(tmp_plus[2][1][n])+real(tmp_plus[3][1][n])), - kappa*(imag(tmp_plus[0][1][n])+imag(tmp_plus[1][1][n])+imag(tmp_plus[2][1][n])+imag(tmp_plus[3][1][n])));
+					output[site][2][n] = std::complex<real_t>( + kappa*(real(tmp_minus[1][1][n]) + real(tmp_minus[3][0][n]) - imag(tmp_minus[0][1][n]) - imag(tmp_minus[2][0][n])), + kappa*(real(tmp_minus[0][1][n]) + real(tmp_minus[2][0][n]) + imag(tmp_minus[1][1][n]) + imag(tmp_minus[3][0][n])));
+					output[site][3][n] = std::complex<real_t>( + kappa*(imag(tmp_minus[2][1][n]) - imag(tmp_minus[0][0][n]) - real(tmp_minus[1][0][n]) + real(tmp_minus[3][1][n])), + kappa*(real(tmp_minus[0][0][n]) - real(tmp_minus[2][1][n]) - imag(tmp_minus[1][0][n]) + imag(tmp_minus[3][1][n])));
+				}
+			}
+			else {
+				for (unsigned int mu = 0; mu < 4; ++mu) output[site][mu] = input[site][mu];
 			}
 		}
-		else {
-			for (unsigned int mu = 0; mu < 4; ++mu) output[site][mu] = input[site][mu];
-		}
+		this->endRegion(region);
+		if (region == 0 && overlapCommunication) output.communicateHalo();
 	}
-	output.updateHalo();
+	if (!overlapCommunication) output.communicateHalo();
+	output.waitHalo();
 }
 
 
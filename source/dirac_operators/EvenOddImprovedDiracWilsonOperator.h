@@ -32,6 +32,16 @@ public:
 
 	virtual void setLattice(const extended_fermion_lattice_t& _lattice);
 
+#ifdef ALIGNED_OPT
+	//The vectorized kernels of ImprovedDiracWilsonOperator do not apply to the even-odd operator, we use the generic conversion
+	virtual void multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input) {
+		DiracOperator::multiply(output, input);
+	}
+	virtual void multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t& vector2, const complex& alpha) {
+		DiracOperator::multiplyAdd(output, vector1, vector2, alpha);
+	}
+#endif
+
 public:
 	void multiplyOddOdd(reduced_dirac_vector_t & output, Part part);
 	void multiplyOddOddMinusIdentity(reduced_dirac_vector_t & output, const reduced_dirac_vector_t & input, Part part);
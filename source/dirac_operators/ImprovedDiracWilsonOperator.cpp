@@ -1,5 +1,6 @@
 #include "ImprovedDiracWilsonOperator.h"
 #include "hmc_forces/ImprovedFermionForce.h"
+#include "AlignedDiracWilsonKernel.h"
 
 namespace Update {
 
@@ -24,232 +25,241 @@ void ImprovedDiracWilsonOperator::multiply(reduced_dirac_vector_t & output, cons
 	typedef reduced_dirac_vector_t Vector;
 	const reduced_fermion_lattice_t& linkconf = (lattice);
 
+	//The sites [0, sharedsize) are read by the neighbouring processors, we process them first
+	//and we overlap the halo exchange of the output with the interior sites [sharedsize, localsize)
+	const int siteRange[3] = {0, output.sharedsize, output.localsize};
+	for (int region = 0; region < 2; ++region) {
+		this->beginRegion();
 #pragma omp parallel for
-	for (int site = 0; site < lattice.localsize; ++site) {
-		//the best
-		std::complex<real_t> projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmm, tmp;
-		{
+		for (int site = siteRange[region]; site < siteRange[region+1]; ++site) {
+			//the best
+			std::complex<real_t> projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmm, tmp;
 			{
-				const size_t site_down = Vector::sdn(site,0);
-				const size_t site_up = Vector::sup(site,0);
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(input[site_down][0][n].real()+input[site_down][3][n].imag(),input[site_down][0][n].imag()-input[site_down][3][n].real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(input[site_up][0][n].real()-input[site_up][3][n].imag(),input[site_up][0][n].imag()+input[site_up][3][n].real());
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+				{
+					const size_t site_down = Vector::sdn(site,0);
+					const size_t site_up = Vector::sup(site,0);
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						projection_spinor_minus[n] = std::complex<real_t>(input[site_down][0][n].real()+input[site_down][3][n].imag(),input[site_down][0][n].imag()-input[site_down][3][n].real());
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						projection_spinor_plus[n] = std::complex<real_t>(input[site_up][0][n].real()-input[site_up][3][n].imag(),input[site_up][0][n].imag()+input[site_up][3][n].real());
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						}
+						output[site][0][i] = input[site][0][i] - kappa*(tmp+tmm);
+						output[site][3][i] = -input[site][3][i] + kappa*std::complex<real_t>(tmm.imag() - tmp.imag(),tmp.real() - tmm.real());
 					}
-					output[site][0][i] = input[site][0][i] - kappa*(tmp+tmm);
-					output[site][3][i] = -input[site][3][i] + kappa*std::complex<real_t>(tmm.imag() - tmp.imag(),tmp.real() - tmm.real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(input[site_down][1][n].real()+input[site_down][2][n].imag(), input[site_down][1][n].imag()-input[site_down][2][n].real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(input[site_up][1][n].real()-input[site_up][2][n].imag(),input[site_up][1][n].imag()+input[site_up][2][n].real());
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						projection_spinor_minus[n] = std::complex<real_t>(input[site_down][1][n].real()+input[site_down][2][n].imag(), input[site_down][1][n].imag()-input[site_down][2][n].real());
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						projection_spinor_plus[n] = std::complex<real_t>(input[site_up][1][n].real()-input[site_up][2][n].imag(),input[site_up][1][n].imag()+input[site_up][2][n].real());
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						}
 
-					output[site][1][i] = input[site][1][i]- kappa*(tmp+tmm);
-					output[site][2][i] = -input[site][2][i]+ kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real()-tmm.real());
-				}
-			}
-			{
-				const size_t site_down = Vector::sdn(site,1);
-				const size_t site_up = Vector::sup(site,1);
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = input[site_down][0][n] - (input[site_down][3][n]);
-				}
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = input[site_up][0][n] + (input[site_up][3][n]);
+						output[site][1][i] = input[site][1][i]- kappa*(tmp+tmm);
+						output[site][2][i] = -input[site][2][i]+ kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real()-tmm.real());
+					}
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+				{
+					const size_t site_down = Vector::sdn(site,1);
+					const size_t site_up = Vector::sup(site,1);
 					for(int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						projection_spinor_minus[n] = input[site_down][0][n] - (input[site_down][3][n]);
 					}
 					for(int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						projection_spinor_plus[n] = input[site_up][0][n] + (input[site_up][3][n]);
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						}
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						}
 
-					output[site][0][i] -= kappa*(tmp+tmm);
-					output[site][3][i] += kappa*(tmm-tmp);
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][2][n]);
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][2][n]);
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+						output[site][0][i] -= kappa*(tmp+tmm);
+						output[site][3][i] += kappa*(tmm-tmp);
+					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][2][n]);
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][2][n]);
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						}
 
-					output[site][1][i] -= kappa*(tmp+tmm);
-					output[site][2][i] += kappa*(tmp-tmm);
-				}
-			}
-			{
-				const size_t site_down = Vector::sdn(site,2);
-				const size_t site_up = Vector::sup(site,2);
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(input[site_down][0][n].real() + input[site_down][2][n].imag(), input[site_down][0][n].imag() - input[site_down][2][n].real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(input[site_up][0][n].real() - input[site_up][2][n].imag(), input[site_up][0][n].imag() + input[site_up][2][n].real());
+						output[site][1][i] -= kappa*(tmp+tmm);
+						output[site][2][i] += kappa*(tmp-tmm);
+					}
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+				{
+					const size_t site_down = Vector::sdn(site,2);
+					const size_t site_up = Vector::sup(site,2);
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						projection_spinor_minus[n] = std::complex<real_t>(input[site_down][0][n].real() + input[site_down][2][n].imag(), input[site_down][0][n].imag() - input[site_down][2][n].real());
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						projection_spinor_plus[n] = std::complex<real_t>(input[site_up][0][n].real() - input[site_up][2][n].imag(), input[site_up][0][n].imag() + input[site_up][2][n].real());
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						}
 
-					output[site][0][i] -= kappa*(tmp+tmm);
-					output[site][2][i] += kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real() - tmm.real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(input[site_down][1][n].real() - input[site_down][3][n].imag(), input[site_down][1][n].imag() + input[site_down][3][n].real());
-				}
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(input[site_up][1][n].real() + input[site_up][3][n].imag(), input[site_up][1][n].imag() - input[site_up][3][n].real());
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for(int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						output[site][0][i] -= kappa*(tmp+tmm);
+						output[site][2][i] += kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real() - tmm.real());
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = std::complex<real_t>(input[site_down][1][n].real() - input[site_down][3][n].imag(), input[site_down][1][n].imag() + input[site_down][3][n].real());
 					}
 					for(int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						projection_spinor_plus[n] = std::complex<real_t>(input[site_up][1][n].real() + input[site_up][3][n].imag(), input[site_up][1][n].imag() - input[site_up][3][n].real());
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						}
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						}
 
-					output[site][1][i] -= kappa*(tmp+tmm);
-					output[site][3][i] += kappa*std::complex<real_t>(tmp.imag() - tmm.imag(), tmm.real() - tmp.real());
-				}
-			}
-			{
-				const size_t site_down = Vector::sdn(site,3);
-				const size_t site_up = Vector::sup(site,3);
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = input[site_down][0][n] + (input[site_down][2][n]);
-				}
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = input[site_up][0][n] - (input[site_up][2][n]);
+						output[site][1][i] -= kappa*(tmp+tmm);
+						output[site][3][i] += kappa*std::complex<real_t>(tmp.imag() - tmm.imag(), tmm.real() - tmp.real());
+					}
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+				{
+					const size_t site_down = Vector::sdn(site,3);
+					const size_t site_up = Vector::sup(site,3);
+					for(int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = input[site_down][0][n] + (input[site_down][2][n]);
 					}
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+					for(int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = input[site_up][0][n] - (input[site_up][2][n]);
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						}
 
-					output[site][0][i] -= kappa*(tmp+tmm);
-					output[site][2][i] += kappa*(tmp-tmm);
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][3][n]);
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][3][n]);
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+						output[site][0][i] -= kappa*(tmp+tmm);
+						output[site][2][i] += kappa*(tmp-tmm);
+					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][3][n]);
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][3][n]);
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						}
 
-					output[site][1][i] -= kappa*(tmp+tmm);
-					output[site][3][i] += kappa*(tmp-tmm);
+						output[site][1][i] -= kappa*(tmp+tmm);
+						output[site][3][i] += kappa*(tmp-tmm);
+					}
 				}
-			}
 
-			//We store the result of the clover term in an intermediate vector
-			GaugeVector clover[4];
-			for (int i = 0; i < diracVectorLength; ++i) {
-				clover[0][i] = 0;
-				clover[1][i] = 0;
-				clover[2][i] = 0;
-				clover[3][i] = 0;
-				for (int j = 0; j < diracVectorLength; ++j) {
-					clover[0][i] += multiply_by_I((-F[site][0].at(i,j)+F[site][5].at(i,j))*input[site][0][j]);
-					clover[1][i] += multiply_by_I((+F[site][0].at(i,j)-F[site][5].at(i,j))*input[site][1][j]);
-					clover[2][i] += multiply_by_I((+F[site][0].at(i,j)+F[site][5].at(i,j))*input[site][2][j]);
-					clover[3][i] += multiply_by_I((-F[site][0].at(i,j)-F[site][5].at(i,j))*input[site][3][j]);
+				//We store the result of the clover term in an intermediate vector
+				GaugeVector clover[4];
+				for (int i = 0; i < diracVectorLength; ++i) {
+					clover[0][i] = 0;
+					clover[1][i] = 0;
+					clover[2][i] = 0;
+					clover[3][i] = 0;
+					for (int j = 0; j < diracVectorLength; ++j) {
+						clover[0][i] += multiply_by_I((-F[site][0].at(i,j)+F[site][5].at(i,j))*input[site][0][j]);
+						clover[1][i] += multiply_by_I((+F[site][0].at(i,j)-F[site][5].at(i,j))*input[site][1][j]);
+						clover[2][i] += multiply_by_I((+F[site][0].at(i,j)+F[site][5].at(i,j))*input[site][2][j]);
+						clover[3][i] += multiply_by_I((-F[site][0].at(i,j)-F[site][5].at(i,j))*input[site][3][j]);
+					}
 				}
-			}
 
 #ifdef ADJOINT
-			for (int i = 0; i < diracVectorLength; ++i) {
-				for (int j = 0; j < diracVectorLength; ++j) {
-					clover[0][i] += std::complex<real_t>(+F[site][1].at(i,j)+F[site][4].at(i,j),(+F[site][2].at(i,j)-F[site][3].at(i,j)))*input[site][1][j];
-					clover[1][i] += std::complex<real_t>(-F[site][1].at(i,j)-F[site][4].at(i,j),(+F[site][2].at(i,j)-F[site][3].at(i,j)))*input[site][0][j];
-					clover[2][i] += std::complex<real_t>(-F[site][1].at(i,j)+F[site][4].at(i,j),(+F[site][2].at(i,j)+F[site][3].at(i,j)))*input[site][3][j];
-					clover[3][i] += std::complex<real_t>(+F[site][1].at(i,j)-F[site][4].at(i,j),(+F[site][2].at(i,j)+F[site][3].at(i,j)))*input[site][2][j];
+				for (int i = 0; i < diracVectorLength; ++i) {
+					for (int j = 0; j < diracVectorLength; ++j) {
+						clover[0][i] += std::complex<real_t>(+F[site][1].at(i,j)+F[site][4].at(i,j),(+F[site][2].at(i,j)-F[site][3].at(i,j)))*input[site][1][j];
+						clover[1][i] += std::complex<real_t>(-F[site][1].at(i,j)-F[site][4].at(i,j),(+F[site][2].at(i,j)-F[site][3].at(i,j)))*input[site][0][j];
+						clover[2][i] += std::complex<real_t>(-F[site][1].at(i,j)+F[site][4].at(i,j),(+F[site][2].at(i,j)+F[site][3].at(i,j)))*input[site][3][j];
+						clover[3][i] += std::complex<real_t>(+F[site][1].at(i,j)-F[site][4].at(i,j),(+F[site][2].at(i,j)+F[site][3].at(i,j)))*input[site][2][j];
+					}
 				}
-			}
 #endif
 #ifndef ADJOINT
-			//We store the result of the clover term in an intermediate vector
-			//GaugeVector clover[4];
-			for (int i = 0; i < diracVectorLength; ++i) {
-				for (int j = 0; j < diracVectorLength; ++j) {
-					clover[0][i] += (+F[site][1].at(i,j)+F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)-F[site][3].at(i,j)))*input[site][1][j];
-					clover[1][i] += (-F[site][1].at(i,j)-F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)-F[site][3].at(i,j)))*input[site][0][j];
-					clover[2][i] += (-F[site][1].at(i,j)+F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)+F[site][3].at(i,j)))*input[site][3][j];
-					clover[3][i] += (+F[site][1].at(i,j)-F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)+F[site][3].at(i,j)))*input[site][2][j];
+				//We store the result of the clover term in an intermediate vector
+				//GaugeVector clover[4];
+				for (int i = 0; i < diracVectorLength; ++i) {
+					for (int j = 0; j < diracVectorLength; ++j) {
+						clover[0][i] += (+F[site][1].at(i,j)+F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)-F[site][3].at(i,j)))*input[site][1][j];
+						clover[1][i] += (-F[site][1].at(i,j)-F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)-F[site][3].at(i,j)))*input[site][0][j];
+						clover[2][i] += (-F[site][1].at(i,j)+F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)+F[site][3].at(i,j)))*input[site][3][j];
+						clover[3][i] += (+F[site][1].at(i,j)-F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)+F[site][3].at(i,j)))*input[site][2][j];
+					}
 				}
-			}
 #endif
 
-			for (int n = 0; n < diracVectorLength; ++n) {
-				output[site][0][n] += (kappa*csw)*clover[0][n];
-				output[site][1][n] += (kappa*csw)*clover[1][n];
-				output[site][2][n] += (kappa*csw)*clover[2][n];
-				output[site][3][n] += (kappa*csw)*clover[3][n];
+				for (int n = 0; n < diracVectorLength; ++n) {
+					output[site][0][n] += (kappa*csw)*clover[0][n];
+					output[site][1][n] += (kappa*csw)*clover[1][n];
+					output[site][2][n] += (kappa*csw)*clover[2][n];
+					output[site][3][n] += (kappa*csw)*clover[3][n];
+				}
 			}
-		}
-		if (!gamma5) {
-			for (int i = 0; i < diracVectorLength; ++i) {
-				output[site][2][i] = -output[site][2][i];
-				output[site][3][i] = -output[site][3][i];
+			if (!gamma5) {
+				for (int i = 0; i < diracVectorLength; ++i) {
+					output[site][2][i] = -output[site][2][i];
+					output[site][3][i] = -output[site][3][i];
+				}
 			}
 		}
+		this->endRegion(region);
+		if (region == 0 && overlapCommunication) output.communicateHalo();
 	}
-	output.updateHalo();
+	if (!overlapCommunication) output.communicateHalo();
+	output.waitHalo();
 }
 
 void ImprovedDiracWilsonOperator::multiplyAdd(reduced_dirac_vector_t & output, const reduced_dirac_vector_t & vector1, const reduced_dirac_vector_t & vector2, const complex& alpha) {
@@ -258,234 +268,253 @@ void ImprovedDiracWilsonOperator::multiplyAdd(reduced_dirac_vector_t & output, c
 
 	const reduced_fermion_lattice_t& linkconf = (lattice);
 
+	//The sites [0, sharedsize) are read by the neighbouring processors, we process them first
+	//and we overlap the halo exchange of the output with the interior sites [sharedsize, localsize)
+	const int siteRange[3] = {0, output.sharedsize, output.localsize};
+	for (int region = 0; region < 2; ++region) {
+		this->beginRegion();
 #pragma omp parallel for
-	for (int site = 0; site < lattice.localsize; ++site) {
-		//the best
-		std::complex<real_t> projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmm, tmp;
-		{
+		for (int site = siteRange[region]; site < siteRange[region+1]; ++site) {
+			//the best
+			std::complex<real_t> projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmm, tmp;
 			{
-				const size_t site_down = Vector::sdn(site,0);
-				const size_t site_up = Vector::sup(site,0);
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][0][n].real()+vector1[site_down][3][n].imag(),vector1[site_down][0][n].imag()-vector1[site_down][3][n].real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][0][n].real()-vector1[site_up][3][n].imag(),vector1[site_up][0][n].imag()+vector1[site_up][3][n].real());
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+				{
+					const size_t site_down = Vector::sdn(site,0);
+					const size_t site_up = Vector::sup(site,0);
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][0][n].real()+vector1[site_down][3][n].imag(),vector1[site_down][0][n].imag()-vector1[site_down][3][n].real());
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][0][n].real()-vector1[site_up][3][n].imag(),vector1[site_up][0][n].imag()+vector1[site_up][3][n].real());
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						}
+						output[site][0][i] = alpha*vector2[site][0][i] + vector1[site][0][i] - kappa*(tmp+tmm);
+						output[site][3][i] = alpha*vector2[site][3][i] - vector1[site][3][i] + kappa*std::complex<real_t>(tmm.imag() - tmp.imag(),tmp.real() - tmm.real());
 					}
-					output[site][0][i] = alpha*vector2[site][0][i] + vector1[site][0][i] - kappa*(tmp+tmm);
-					output[site][3][i] = alpha*vector2[site][3][i] - vector1[site][3][i] + kappa*std::complex<real_t>(tmm.imag() - tmp.imag(),tmp.real() - tmm.real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][1][n].real()+vector1[site_down][2][n].imag(), vector1[site_down][1][n].imag()-vector1[site_down][2][n].real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][1][n].real()-vector1[site_up][2][n].imag(), vector1[site_up][1][n].imag()+vector1[site_up][2][n].real());
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][1][n].real()+vector1[site_down][2][n].imag(), vector1[site_down][1][n].imag()-vector1[site_down][2][n].real());
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][1][n].real()-vector1[site_up][2][n].imag(), vector1[site_up][1][n].imag()+vector1[site_up][2][n].real());
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						}
 
-					output[site][1][i] = alpha*vector2[site][1][i] + vector1[site][1][i]- kappa*(tmp+tmm);
-					output[site][2][i] = alpha*vector2[site][2][i] - vector1[site][2][i]+ kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real()-tmm.real());
-				}
-			}
-			{
-				const size_t site_down = Vector::sdn(site,1);
-				const size_t site_up = Vector::sup(site,1);
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = vector1[site_down][0][n] - (vector1[site_down][3][n]);
-				}
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = vector1[site_up][0][n] + (vector1[site_up][3][n]);
+						output[site][1][i] = alpha*vector2[site][1][i] + vector1[site][1][i]- kappa*(tmp+tmm);
+						output[site][2][i] = alpha*vector2[site][2][i] - vector1[site][2][i]+ kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real()-tmm.real());
+					}
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+				{
+					const size_t site_down = Vector::sdn(site,1);
+					const size_t site_up = Vector::sup(site,1);
 					for(int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						projection_spinor_minus[n] = vector1[site_down][0][n] - (vector1[site_down][3][n]);
 					}
 					for(int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						projection_spinor_plus[n] = vector1[site_up][0][n] + (vector1[site_up][3][n]);
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						}
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						}
 
-					output[site][0][i] -= kappa*(tmp+tmm);
-					output[site][3][i] += kappa*(tmm-tmp);
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = vector1[site_down][1][n] + (vector1[site_down][2][n]);
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = vector1[site_up][1][n] - (vector1[site_up][2][n]);
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+						output[site][0][i] -= kappa*(tmp+tmm);
+						output[site][3][i] += kappa*(tmm-tmp);
+					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						projection_spinor_minus[n] = vector1[site_down][1][n] + (vector1[site_down][2][n]);
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						projection_spinor_plus[n] = vector1[site_up][1][n] - (vector1[site_up][2][n]);
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						}
 
-					output[site][1][i] -= kappa*(tmp+tmm);
-					output[site][2][i] += kappa*(tmp-tmm);
-				}
-			}
-			{
-				const size_t site_down = Vector::sdn(site,2);
-				const size_t site_up = Vector::sup(site,2);
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][0][n].real() + vector1[site_down][2][n].imag(), vector1[site_down][0][n].imag() - vector1[site_down][2][n].real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][0][n].real() - vector1[site_up][2][n].imag(), vector1[site_up][0][n].imag() + vector1[site_up][2][n].real());
+						output[site][1][i] -= kappa*(tmp+tmm);
+						output[site][2][i] += kappa*(tmp-tmm);
+					}
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+				{
+					const size_t site_down = Vector::sdn(site,2);
+					const size_t site_up = Vector::sup(site,2);
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][0][n].real() + vector1[site_down][2][n].imag(), vector1[site_down][0][n].imag() - vector1[site_down][2][n].real());
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][0][n].real() - vector1[site_up][2][n].imag(), vector1[site_up][0][n].imag() + vector1[site_up][2][n].real());
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						}
 
-					output[site][0][i] -= kappa*(tmp+tmm);
-					output[site][2][i] += kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real() - tmm.real());
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][1][n].real() - vector1[site_down][3][n].imag(), vector1[site_down][1][n].imag() + vector1[site_down][3][n].real());
-				}
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][1][n].real() + vector1[site_up][3][n].imag(), vector1[site_up][1][n].imag() - vector1[site_up][3][n].real());
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for(int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						output[site][0][i] -= kappa*(tmp+tmm);
+						output[site][2][i] += kappa*std::complex<real_t>(tmm.imag()-tmp.imag(),tmp.real() - tmm.real());
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = std::complex<real_t>(vector1[site_down][1][n].real() - vector1[site_down][3][n].imag(), vector1[site_down][1][n].imag() + vector1[site_down][3][n].real());
 					}
 					for(int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						projection_spinor_plus[n] = std::complex<real_t>(vector1[site_up][1][n].real() + vector1[site_up][3][n].imag(), vector1[site_up][1][n].imag() - vector1[site_up][3][n].real());
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						}
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						}
 
-					output[site][1][i] -= kappa*(tmp+tmm);
-					output[site][3][i] += kappa*std::complex<real_t>(tmp.imag() - tmm.imag(), tmm.real() - tmp.real());
-				}
-			}
-			{
-				const size_t site_down = Vector::sdn(site,3);
-				const size_t site_up = Vector::sup(site,3);
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = vector1[site_down][0][n] + (vector1[site_down][2][n]);
-				}
-				for(int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = vector1[site_up][0][n] - (vector1[site_up][2][n]);
+						output[site][1][i] -= kappa*(tmp+tmm);
+						output[site][3][i] += kappa*std::complex<real_t>(tmp.imag() - tmm.imag(), tmm.real() - tmp.real());
+					}
 				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+				{
+					const size_t site_down = Vector::sdn(site,3);
+					const size_t site_up = Vector::sup(site,3);
+					for(int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = vector1[site_down][0][n] + (vector1[site_down][2][n]);
 					}
-					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+					for(int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = vector1[site_up][0][n] - (vector1[site_up][2][n]);
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						}
 
-					output[site][0][i] -= kappa*(tmp+tmm);
-					output[site][2][i] += kappa*(tmp-tmm);
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_minus[n] = vector1[site_down][1][n] + (vector1[site_down][3][n]);
-				}
-				for (int n = 0; n < diracVectorLength; ++n) {
-					projection_spinor_plus[n] = vector1[site_up][1][n] - (vector1[site_up][3][n]);
-				}
-				for (int i = 0; i < diracVectorLength; ++i) {
-					tmp = 0;
-					tmm = 0;
+						output[site][0][i] -= kappa*(tmp+tmm);
+						output[site][2][i] += kappa*(tmp-tmm);
+					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						projection_spinor_minus[n] = vector1[site_down][1][n] + (vector1[site_down][3][n]);
 					}
 					for (int n = 0; n < diracVectorLength; ++n) {
-						tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						projection_spinor_plus[n] = vector1[site_up][1][n] - (vector1[site_up][3][n]);
 					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						}
 
-					output[site][1][i] -= kappa*(tmp+tmm);
-					output[site][3][i] += kappa*(tmp-tmm);
+						output[site][1][i] -= kappa*(tmp+tmm);
+						output[site][3][i] += kappa*(tmp-tmm);
+					}
 				}
-			}
 
-			//We store the result of the clover term in an intermediate vector
-			GaugeVector clover[4];
-			for (int i = 0; i < diracVectorLength; ++i) {
-				clover[0][i] = 0;
-				clover[1][i] = 0;
-				clover[2][i] = 0;
-				clover[3][i] = 0;
-				for (int j = 0; j < diracVectorLength; ++j) {
-					clover[0][i] += multiply_by_I((-F[site][0].at(i,j)+F[site][5].at(i,j))*vector1[site][0][j]);
-					clover[1][i] += multiply_by_I((+F[site][0].at(i,j)-F[site][5].at(i,j))*vector1[site][1][j]);
-					clover[2][i] += multiply_by_I((+F[site][0].at(i,j)+F[site][5].at(i,j))*vector1[site][2][j]);
-					clover[3][i] += multiply_by_I((-F[site][0].at(i,j)-F[site][5].at(i,j))*vector1[site][3][j]);
+				//We store the result of the clover term in an intermediate vector
+				GaugeVector clover[4];
+				for (int i = 0; i < diracVectorLength; ++i) {
+					clover[0][i] = 0;
+					clover[1][i] = 0;
+					clover[2][i] = 0;
+					clover[3][i] = 0;
+					for (int j = 0; j < diracVectorLength; ++j) {
+						clover[0][i] += multiply_by_I((-F[site][0].at(i,j)+F[site][5].at(i,j))*vector1[site][0][j]);
+						clover[1][i] += multiply_by_I((+F[site][0].at(i,j)-F[site][5].at(i,j))*vector1[site][1][j]);
+						clover[2][i] += multiply_by_I((+F[site][0].at(i,j)+F[site][5].at(i,j))*vector1[site][2][j]);
+						clover[3][i] += multiply_by_I((-F[site][0].at(i,j)-F[site][5].at(i,j))*vector1[site][3][j]);
+					}
 				}
-			}
 
 #ifdef ADJOINT
-			for (int i = 0; i < diracVectorLength; ++i) {
-				for (int j = 0; j < diracVectorLength; ++j) {
-					clover[0][i] += std::complex<real_t>(+F[site][1].at(i,j)+F[site][4].at(i,j),(+F[site][2].at(i,j)-F[site][3].at(i,j)))*vector1[site][1][j];
-					clover[1][i] += std::complex<real_t>(-F[site][1].at(i,j)-F[site][4].at(i,j),(+F[site][2].at(i,j)-F[site][3].at(i,j)))*vector1[site][0][j];
-					clover[2][i] += std::complex<real_t>(-F[site][1].at(i,j)+F[site][4].at(i,j),(+F[site][2].at(i,j)+F[site][3].at(i,j)))*vector1[site][3][j];
-					clover[3][i] += std::complex<real_t>(+F[site][1].at(i,j)-F[site][4].at(i,j),(+F[site][2].at(i,j)+F[site][3].at(i,j)))*vector1[site][2][j];
+				for (int i = 0; i < diracVectorLength; ++i) {
+					for (int j = 0; j < diracVectorLength; ++j) {
+						clover[0][i] += std::complex<real_t>(+F[site][1].at(i,j)+F[site][4].at(i,j),(+F[site][2].at(i,j)-F[site][3].at(i,j)))*vector1[site][1][j];
+						clover[1][i] += std::complex<real_t>(-F[site][1].at(i,j)-F[site][4].at(i,j),(+F[site][2].at(i,j)-F[site][3].at(i,j)))*vector1[site][0][j];
+						clover[2][i] += std::complex<real_t>(-F[site][1].at(i,j)+F[site][4].at(i,j),(+F[site][2].at(i,j)+F[site][3].at(i,j)))*vector1[site][3][j];
+						clover[3][i] += std::complex<real_t>(+F[site][1].at(i,j)-F[site][4].at(i,j),(+F[site][2].at(i,j)+F[site][3].at(i,j)))*vector1[site][2][j];
+					}
 				}
-			}
 #endif
 #ifndef ADJOINT
-//We store the result of the clover term in an intermediate vector
-//GaugeVector clover[4];
-			for (int i = 0; i < diracVectorLength; ++i) {
-				for (int j = 0; j < diracVectorLength; ++j) {
-					clover[0][i] += (+F[site][1].at(i,j)+F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)-F[site][3].at(i,j)))*vector1[site][1][j];
-					clover[1][i] += (-F[site][1].at(i,j)-F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)-F[site][3].at(i,j)))*vector1[site][0][j];
-					clover[2][i] += (-F[site][1].at(i,j)+F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)+F[site][3].at(i,j)))*vector1[site][3][j];
-					clover[3][i] += (+F[site][1].at(i,j)-F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)+F[site][3].at(i,j)))*vector1[site][2][j];
+	//We store the result of the clover term in an intermediate vector
+	//GaugeVector clover[4];
+				for (int i = 0; i < diracVectorLength; ++i) {
+					for (int j = 0; j < diracVectorLength; ++j) {
+						clover[0][i] += (+F[site][1].at(i,j)+F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)-F[site][3].at(i,j)))*vector1[site][1][j];
+						clover[1][i] += (-F[site][1].at(i,j)-F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)-F[site][3].at(i,j)))*vector1[site][0][j];
+						clover[2][i] += (-F[site][1].at(i,j)+F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)+F[site][3].at(i,j)))*vector1[site][3][j];
+						clover[3][i] += (+F[site][1].at(i,j)-F[site][4].at(i,j)+multiply_by_I(+F[site][2].at(i,j)+F[site][3].at(i,j)))*vector1[site][2][j];
+					}
 				}
-			}
 #endif
 
-			for (int n = 0; n < diracVectorLength; ++n) {
-				output[site][0][n] += (kappa*csw)*clover[0][n];
-				output[site][1][n] += (kappa*csw)*clover[1][n];
-				output[site][2][n] += (kappa*csw)*clover[2][n];
-				output[site][3][n] += (kappa*csw)*clover[3][n];
+				for (int n = 0; n < diracVectorLength; ++n) {
+					output[site][0][n] += (kappa*csw)*clover[0][n];
+					output[site][1][n] += (kappa*csw)*clover[1][n];
+					output[site][2][n] += (kappa*csw)*clover[2][n];
+					output[site][3][n] += (kappa*csw)*clover[3][n];
+				}
 			}
-		}
-		if (!gamma5) {
-			for (int i = 0; i < diracVectorLength; ++i) {
-				output[site][2][i] = -output[site][2][i]+static_cast<real_t>(2)*alpha*vector2[site][2][i];
-				output[site][3][i] = -output[site][3][i]+static_cast<real_t>(2)*alpha*vector2[site][3][i];
+			if (!gamma5) {
+				for (int i = 0; i < diracVectorLength; ++i) {
+					output[site][2][i] = -output[site][2][i]+static_cast<real_t>(2)*alpha*vector2[site][2][i];
+					output[site][3][i] = -output[site][3][i]+static_cast<real_t>(2)*alpha*vector2[site][3][i];
+				}
 			}
 		}
+		this->endRegion(region);
+		if (region == 0 && overlapCommunication) output.communicateHalo();
 	}
-	output.updateHalo();
+	if (!overlapCommunication) output.communicateHalo();
+	output.waitHalo();
+}
+
+#ifdef ALIGNED_OPT
+void ImprovedDiracWilsonOperator::multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input) {
+	AlignedDiracWilsonKernel::multiply(output, input, 0, 0., soaLattice, &soaClover, kappa, csw, gamma5, overlapCommunication);
 }
 
+void ImprovedDiracWilsonOperator::multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t& vector2, const complex& alpha) {
+	AlignedDiracWilsonKernel::multiply(output, vector1, &vector2, alpha, soaLattice, &soaClover, kappa, csw, gamma5, overlapCommunication);
+}
+#endif
+
 void ImprovedDiracWilsonOperator::setLattice(const extended_fermion_lattice_t& _lattice) {
 	lattice = _lattice;
 	this->updateFieldStrength(_lattice);
@@ -499,6 +528,10 @@ void ImprovedDiracWilsonOperator::setCSW(real_t _csw) {
 	csw = _csw;
 }
 
+const reduced_field_strength_lattice_t& ImprovedDiracWilsonOperator::getFieldStrength() const {
+	return F;
+}
+
 void ImprovedDiracWilsonOperator::updateFieldStrength(const extended_fermion_lattice_t& _lattice) {
 	typedef extended_fermion_lattice_t LT;
 	extended_field_strength_lattice_t tmpF;
@@ -520,6 +553,10 @@ void ImprovedDiracWilsonOperator::updateFieldStrength(const extended_fermion_lat
 	tmpF.updateHalo();
 	//Now we get the reduced lattice
 	F = tmpF;
+#ifdef ALIGNED_OPT
+	soaLattice = lattice;
+	AlignedDiracWilsonKernel::setClover(soaClover, F);
+#endif
 }
 
 FermionForce* ImprovedDiracWilsonOperator::getForce() const {
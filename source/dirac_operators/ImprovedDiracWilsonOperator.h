@@ -26,6 +26,14 @@ public:
 	 */
 	virtual void multiplyAdd(reduced_dirac_vector_t & output, const reduced_dirac_vector_t & vector1, const reduced_dirac_vector_t & vector2, const complex& alpha);
 
+#ifdef ALIGNED_OPT
+	/**
+	 * Vectorized versions on the split real/imaginary storage
+	 */
+	virtual void multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input);
+	virtual void multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t& vector2, const complex& alpha);
+#endif
+
 	virtual void setLattice(const extended_fermion_lattice_t& _lattice);
 
 	virtual FermionForce* getForce() const;
@@ -33,11 +41,19 @@ public:
 	real_t getCSW() const;
 	void setCSW(real_t _csw);
 
+	//The field strength of the clover term
+	const reduced_field_strength_lattice_t& getFieldStrength() const;
+
 protected:
 	//The clover term
 	real_t csw;
 	//The field strength
 	reduced_field_strength_lattice_t F;
+#ifdef ALIGNED_OPT
+	//Copy of the links and chiral blocks of the clover term with split real/imaginary storage
+	reduced_soa_fermion_lattice_t soaLattice;
+	reduced_soa_clover_lattice_t soaClover;
+#endif
 
 	void updateFieldStrength(const extended_fermion_lattice_t& _lattice);
 };
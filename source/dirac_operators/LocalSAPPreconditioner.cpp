@@ -0,0 +1,350 @@
+#include "LocalSAPPreconditioner.h"
+#include "DiracWilsonOperator.h"
+#include "BasicDiracWilsonOperator.h"
+#include "CompressedDiracWilsonOperator.h"
+#include "ImprovedDiracWilsonOperator.h"
+#include "EvenOddImprovedDiracWilsonOperator.h"
+#include "TwistedDiracOperator.h"
+#include "algebra_utils/AlgebraUtils.h"
+#include <map>
+
+namespace Update {
+
+inline std::complex<real_t> multiply_by_I(const std::complex<real_t>& a) {
+	return std::complex<real_t>(-imag(a),real(a));
+}
+
+//The projection of the spinor s for the hopping in the direction mu is (s[nu] + phase*s[partner]) for the two half spinors nu,
+//with the opposite phase for the backward hopping
+static const int projectionPartner[4][2] = {{3,2},{3,2},{2,3},{2,3}};
+static const std::complex<real_t> projectionPhase[4][2] = {
+	{std::complex<real_t>(0.,1.), std::complex<real_t>(0.,1.)},
+	{std::complex<real_t>(1.,0.), std::complex<real_t>(-1.,0.)},
+	{std::complex<real_t>(0.,1.), std::complex<real_t>(0.,-1.)},
+	{std::complex<real_t>(-1.,0.), std::complex<real_t>(-1.,0.)}
+};
+
+LocalSAPPreconditioner::LocalSAPPreconditioner(DiracOperator* _diracOperator) : DiracOperator(), diracOperator(_diracOperator), steps(7), blockSteps(5), precision(0.00001), blocksInitialized(false), operatorInitialized(false), csw(0.), twisted(false) {
+	for (unsigned int mu = 0; mu < 4; ++mu) blockSize[mu] = 4;
+}
+
+LocalSAPPreconditioner::~LocalSAPPreconditioner() { }
+
+void LocalSAPPreconditioner::multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input) {
+	if (!blocksInitialized) this->initializeBlocks();
+	if (!operatorInitialized) this->initializeBlockOperator();
+
+	//The twist can change between the solves without a new lattice. TwistedDiracOperator adds i twist gamma5 to the kernel operator,
+	//that is i twist gamma5 to D, or i twist to D when the kernel operator is gamma5 D
+	TwistedDiracOperator* twistedDiracOperator = dynamic_cast<TwistedDiracOperator*>(diracOperator);
+	twisted = (twistedDiracOperator != 0 && twistedDiracOperator->getTwist() != 0.);
+	if (twisted) {
+		const real_t twist = twistedDiracOperator->getTwist();
+		twistTerm[0] = std::complex<real_t>(0.,twist);
+		twistTerm[1] = std::complex<real_t>(0.,twist);
+		twistTerm[2] = std::complex<real_t>(0.,gamma5 ? twist : -twist);
+		twistTerm[3] = std::complex<real_t>(0.,gamma5 ? twist : -twist);
+	}
+
+	AlgebraUtils::setToZero(output);
+	residual = input;
+	for (int i = 0; i < steps; ++i) {
+		for (int color = 0; color < 2; ++color) {
+			//The residual is updated with the global operator, the only communication of the cycle
+			if (i != 0 || color != 0) {
+				diracOperator->multiply(residual, output);
+#pragma omp parallel for
+				for (int site = 0; site < residual.localsize; ++site) {
+					for (unsigned int mu = 0; mu < 4; ++mu) residual[site][mu] = input[site][mu] - residual[site][mu];
+				}
+			}
+			//The blocks of the same color are decoupled, one thread for each block
+#pragma omp parallel for schedule(dynamic)
+			for (int k = 0; k < static_cast<int>(colorBlocks[color].size()); ++k) {
+				this->blockSolve(output, residual, colorBlocks[color][k]);
+			}
+			output.updateHalo();
+		}
+	}
+}
+
+void LocalSAPPreconditioner::multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const std::complex<real_t>& alpha) {
+	reduced_dirac_vector_t& product = productBuffer[0];
+	this->multiply(product, vector1);
+#pragma omp parallel for
+	for (int site = 0; site < output.completesize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) output[site][mu] = product[site][mu] + alpha*vector2[site][mu];
+	}
+}
+
+FermionForce* LocalSAPPreconditioner::getForce() const {
+	return diracOperator->getForce();
+}
+
+void LocalSAPPreconditioner::setKappa(real_t _kappa) {
+	kappa = _kappa;
+	diracOperator->setKappa(_kappa);
+	operatorInitialized = false;
+}
+
+void LocalSAPPreconditioner::setLattice(const extended_fermion_lattice_t& _lattice) {
+	this->lattice = _lattice;
+	diracOperator->setLattice(_lattice);
+	operatorInitialized = false;
+}
+
+void LocalSAPPreconditioner::setDiracOperator(DiracOperator* _diracOperator) {
+	diracOperator = _diracOperator;
+	if (operatorInitialized && this->isNewOperator()) operatorInitialized = false;
+}
+
+void LocalSAPPreconditioner::setBlockSize(const std::vector<unsigned int>& _blockSize) {
+	for (unsigned int mu = 0; mu < 4; ++mu) blockSize[mu] = _blockSize[mu];
+	blocksInitialized = false;
+	operatorInitialized = false;
+}
+
+void LocalSAPPreconditioner::setSteps(int _steps) {
+	steps = _steps;
+}
+
+void LocalSAPPreconditioner::setBlockSteps(int _blockSteps) {
+	blockSteps = _blockSteps;
+}
+
+void LocalSAPPreconditioner::setPrecision(double _precision) {
+	precision = _precision;
+}
+
+void LocalSAPPreconditioner::initializeBlocks() {
+	typedef reduced_dirac_vector_t::Layout Layout;
+	typedef reduced_dirac_vector_t LT;
+	const int numberBlocks[4] = {(Layout::glob_x + blockSize[0] - 1)/blockSize[0], (Layout::glob_y + blockSize[1] - 1)/blockSize[1], (Layout::glob_z + blockSize[2] - 1)/blockSize[2], (Layout::glob_t + blockSize[3] - 1)/blockSize[3]};
+
+	//The global block of every local site, numbered by their order of appearance
+	std::map<long int, int> blockIndex;
+	std::vector<int> siteBlock(residual.localsize);
+	std::vector< std::vector<int> > sites;
+	colorBlocks[0].clear();
+	colorBlocks[1].clear();
+	for (int site = 0; site < residual.localsize; ++site) {
+		const int coordinate[4] = {Layout::globalIndexX(site)/blockSize[0], Layout::globalIndexY(site)/blockSize[1], Layout::globalIndexZ(site)/blockSize[2], Layout::globalIndexT(site)/blockSize[3]};
+		const long int key = ((static_cast<long int>(coordinate[3])*numberBlocks[2] + coordinate[2])*numberBlocks[1] + coordinate[1])*numberBlocks[0] + coordinate[0];
+		std::map<long int, int>::iterator block = blockIndex.find(key);
+		if (block == blockIndex.end()) {
+			block = blockIndex.insert(std::make_pair(key, static_cast<int>(sites.size()))).first;
+			sites.push_back(std::vector<int>());
+			//Same coloring of BlockDiracOperator
+			colorBlocks[(coordinate[0] + coordinate[1] + coordinate[2] + coordinate[3]) % 2].push_back(block->second);
+		}
+		siteBlock[site] = block->second;
+		sites[block->second].push_back(site);
+	}
+	blockSites.clear();
+	blockOffsets.assign(1, 0);
+	std::vector<int> siteIndex(residual.localsize);
+	for (unsigned int block = 0; block < sites.size(); ++block) {
+		for (unsigned int i = 0; i < sites[block].size(); ++i) {
+			siteIndex[sites[block][i]] = blockSites.size();
+			blockSites.push_back(sites[block][i]);
+		}
+		blockOffsets.push_back(blockSites.size());
+	}
+
+	//The neighbours in the halo or in other blocks are set to -1, Dirichlet boundary conditions for the block operator
+	blockNeighbours.resize(8*blockSites.size());
+	for (unsigned int k = 0; k < blockSites.size(); ++k) {
+		const int site = blockSites[k];
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			const int up = LT::sup(site,mu);
+			const int down = LT::sdn(site,mu);
+			blockNeighbours[8*k + mu] = (up < residual.localsize && siteBlock[up] == siteBlock[site]) ? siteIndex[up] : -1;
+			blockNeighbours[8*k + 4 + mu] = (down < residual.localsize && siteBlock[down] == siteBlock[site]) ? siteIndex[down] : -1;
+		}
+	}
+	blocksInitialized = true;
+}
+
+bool LocalSAPPreconditioner::isSupported(DiracOperator* dirac) {
+	DiracOperator* kernelOperator = getKernelOperator(dirac);
+	if (dynamic_cast<ImprovedDiracWilsonOperator*>(kernelOperator) != 0) return dynamic_cast<EvenOddImprovedDiracWilsonOperator*>(kernelOperator) == 0;
+	return dynamic_cast<DiracWilsonOperator*>(kernelOperator) != 0 || dynamic_cast<BasicDiracWilsonOperator*>(kernelOperator) != 0 || dynamic_cast<CompressedDiracWilsonOperator*>(kernelOperator) != 0;
+}
+
+DiracOperator* LocalSAPPreconditioner::getKernelOperator(DiracOperator* dirac) {
+	TwistedDiracOperator* twistedDiracOperator = dynamic_cast<TwistedDiracOperator*>(dirac);
+	if (twistedDiracOperator != 0) return twistedDiracOperator->getDiracOperator();
+	else return dirac;
+}
+
+void LocalSAPPreconditioner::initializeBlockOperator() {
+	if (!isSupported(diracOperator)) {
+		std::cout << "LocalSAPPreconditioner::Dirac operator " << diracOperator->getName() << " not supported by the local block solver!" << std::endl;
+		exit(1);
+	}
+	//The links, the clover term and gamma5 are those of the operator without the twist
+	DiracOperator* kernelOperator = getKernelOperator(diracOperator);
+	const reduced_fermion_lattice_t& links = *kernelOperator->getLattice();
+	ImprovedDiracWilsonOperator* improvedDiracWilsonOperator = dynamic_cast<ImprovedDiracWilsonOperator*>(kernelOperator);
+	if (improvedDiracWilsonOperator != 0) csw = improvedDiracWilsonOperator->getCSW();
+	else csw = 0.;
+	kappa = kernelOperator->getKappa();
+	gamma5 = kernelOperator->getGamma5();
+
+#pragma omp parallel for
+	for (int k = 0; k < static_cast<int>(blockSites.size()); ++k) {
+		for (unsigned int mu = 0; mu < 4; ++mu) blockLinks[k][mu] = links[blockSites[k]][mu];
+	}
+	if (csw != 0.) {
+		const reduced_field_strength_lattice_t& F = improvedDiracWilsonOperator->getFieldStrength();
+		reduced_field_strength_lattice_t& blockF = blockFieldStrength[0];
+#pragma omp parallel for
+		for (int k = 0; k < static_cast<int>(blockSites.size()); ++k) {
+			for (unsigned int i = 0; i < 6; ++i) blockF[k][i] = F[blockSites[k]][i];
+		}
+	}
+	operatorInitialized = true;
+}
+
+bool LocalSAPPreconditioner::isNewOperator() {
+	if (!isSupported(diracOperator)) return true;
+	DiracOperator* kernelOperator = getKernelOperator(diracOperator);
+	const reduced_fermion_lattice_t& links = *kernelOperator->getLattice();
+	ImprovedDiracWilsonOperator* improvedDiracWilsonOperator = dynamic_cast<ImprovedDiracWilsonOperator*>(kernelOperator);
+	real_t kernelCSW = (improvedDiracWilsonOperator != 0) ? improvedDiracWilsonOperator->getCSW() : 0.;
+	int changed = (kernelOperator->getKappa() != kappa || kernelOperator->getGamma5() != gamma5 || kernelCSW != csw) ? 1 : 0;
+#pragma omp parallel for reduction(+:changed)
+	for (int k = 0; k < static_cast<int>(blockSites.size()); ++k) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			for (int i = 0; i < diracVectorLength; ++i) {
+				for (int j = 0; j < diracVectorLength; ++j) {
+					if (links[blockSites[k]][mu].at(i,j) != blockLinks[k][mu].at(i,j)) changed += 1;
+				}
+			}
+		}
+	}
+	reduceAllSum(changed);
+	return changed != 0;
+}
+
+void LocalSAPPreconditioner::blockMultiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input, int begin, int end) {
+	const std::complex<real_t> I(0.,1.);
+	for (int k = begin; k < end; ++k) {
+		//The hopping terms on the half spinors, U(x,mu) P input(x+mu) +- U(x-mu,mu)^dagger P input(x-mu)
+		GaugeVector tmp_plus[4][2];
+		GaugeVector tmp_minus[4][2];
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			const int up = blockNeighbours[8*k + mu];
+			const int down = blockNeighbours[8*k + 4 + mu];
+			for (unsigned int nu = 0; nu < 2; ++nu) {
+				if (up >= 0) tmp_plus[mu][nu] = blockLinks[k][mu]*(input[up][nu] + projectionPhase[mu][nu]*input[up][projectionPartner[mu][nu]]);
+				else set_to_zero(tmp_plus[mu][nu]);
+				if (down >= 0) {
+					GaugeVector tmp = htrans(blockLinks[down][mu])*(input[down][nu] - projectionPhase[mu][nu]*input[down][projectionPartner[mu][nu]]);
+					tmp_minus[mu][nu] = tmp_plus[mu][nu] - tmp;
+					tmp_plus[mu][nu] += tmp;
+				}
+				else {
+					tmp_minus[mu][nu] = tmp_plus[mu][nu];
+				}
+			}
+		}
+
+		//The result is input - kappa*hopping, as in BlockDiracWilsonOperator
+		output[k][0] = input[k][0] - kappa*(tmp_plus[0][0] + tmp_plus[1][0] + tmp_plus[2][0] + tmp_plus[3][0]);
+		output[k][1] = input[k][1] - kappa*(tmp_plus[0][1] + tmp_plus[1][1] + tmp_plus[2][1] + tmp_plus[3][1]);
+		output[k][2] = input[k][2] + kappa*(tmp_minus[1][1] + tmp_minus[3][0] + I*(tmp_minus[0][1] + tmp_minus[2][0]));
+		output[k][3] = input[k][3] + kappa*(tmp_minus[3][1] - tmp_minus[1][0] + I*(tmp_minus[0][0] - tmp_minus[2][1]));
+
+		if (csw != 0.) {
+			//The clover term of ImprovedDiracWilsonOperator, it is local to the site
+			const reduced_field_strength_lattice_t& F = blockFieldStrength[0];
+			GaugeVector clover[4];
+			for (int i = 0; i < diracVectorLength; ++i) {
+				clover[0][i] = 0;
+				clover[1][i] = 0;
+				clover[2][i] = 0;
+				clover[3][i] = 0;
+				for (int j = 0; j < diracVectorLength; ++j) {
+					clover[0][i] += multiply_by_I((-F[k][0].at(i,j)+F[k][5].at(i,j))*input[k][0][j]);
+					clover[1][i] += multiply_by_I((+F[k][0].at(i,j)-F[k][5].at(i,j))*input[k][1][j]);
+					clover[2][i] += multiply_by_I((+F[k][0].at(i,j)+F[k][5].at(i,j))*input[k][2][j]);
+					clover[3][i] += multiply_by_I((-F[k][0].at(i,j)-F[k][5].at(i,j))*input[k][3][j]);
+#ifdef ADJOINT
+					clover[0][i] += std::complex<real_t>(+F[k][1].at(i,j)+F[k][4].at(i,j),(+F[k][2].at(i,j)-F[k][3].at(i,j)))*input[k][1][j];
+					clover[1][i] += std::complex<real_t>(-F[k][1].at(i,j)-F[k][4].at(i,j),(+F[k][2].at(i,j)-F[k][3].at(i,j)))*input[k][0][j];
+					clover[2][i] += std::complex<real_t>(-F[k][1].at(i,j)+F[k][4].at(i,j),(+F[k][2].at(i,j)+F[k][3].at(i,j)))*input[k][3][j];
+					clover[3][i] += std::complex<real_t>(+F[k][1].at(i,j)-F[k][4].at(i,j),(+F[k][2].at(i,j)+F[k][3].at(i,j)))*input[k][2][j];
+#endif
+#ifndef ADJOINT
+					clover[0][i] += (+F[k][1].at(i,j)+F[k][4].at(i,j)+multiply_by_I(+F[k][2].at(i,j)-F[k][3].at(i,j)))*input[k][1][j];
+					clover[1][i] += (-F[k][1].at(i,j)-F[k][4].at(i,j)+multiply_by_I(+F[k][2].at(i,j)-F[k][3].at(i,j)))*input[k][0][j];
+					clover[2][i] += (-F[k][1].at(i,j)+F[k][4].at(i,j)+multiply_by_I(+F[k][2].at(i,j)+F[k][3].at(i,j)))*input[k][3][j];
+					clover[3][i] += (+F[k][1].at(i,j)-F[k][4].at(i,j)+multiply_by_I(+F[k][2].at(i,j)+F[k][3].at(i,j)))*input[k][2][j];
+#endif
+				}
+			}
+			//ImprovedDiracWilsonOperator computes gamma5 D, the lower components change sign
+			output[k][0] += (kappa*csw)*clover[0];
+			output[k][1] += (kappa*csw)*clover[1];
+			output[k][2] -= (kappa*csw)*clover[2];
+			output[k][3] -= (kappa*csw)*clover[3];
+		}
+
+		if (twisted) {
+			for (unsigned int mu = 0; mu < 4; ++mu) output[k][mu] += twistTerm[mu]*input[k][mu];
+		}
+
+	}
+}
+
+void LocalSAPPreconditioner::blockSolve(reduced_dirac_vector_t& solution, const reduced_dirac_vector_t& source, int block) {
+	const int begin = blockOffsets[block];
+	const int end = blockOffsets[block + 1];
+
+	//The residual of the block is gathered in the contiguous storage of the block ordering,
+	//gamma5 D x = source is solved as D x = gamma5 source since the minimal residual does not converge for indefinite operators
+	const real_t sign[4] = {1., 1., gamma5 ? -1. : 1., gamma5 ? -1. : 1.};
+	long_real_t initialNorm = 0.;
+	for (int k = begin; k < end; ++k) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			blockResidual[k][mu] = sign[mu]*source[blockSites[k]][mu];
+			set_to_zero(blockCorrection[k][mu]);
+			initialNorm += blockResidual[k][mu].squaredNorm();
+		}
+	}
+	if (initialNorm == 0.) return;
+
+	//Minimal residual iterations, correction += alpha r and r -= alpha D r with alpha = <D r, r>/<D r, D r>
+	for (int step = 0; step < blockSteps; ++step) {
+		this->blockMultiply(blockProduct, blockResidual, begin, end);
+		std::complex<long_real_t> overlap = 0.;
+		long_real_t productNorm = 0.;
+		for (int k = begin; k < end; ++k) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				overlap += static_cast< std::complex<long_real_t> >(blockProduct[k][mu].dot(blockResidual[k][mu]));
+				productNorm += blockProduct[k][mu].squaredNorm();
+			}
+		}
+		if (productNorm == 0.) break;
+		const std::complex<real_t> alpha = static_cast< std::complex<real_t> >(overlap/productNorm);
+		long_real_t norm = 0.;
+		for (int k = begin; k < end; ++k) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				blockCorrection[k][mu] += alpha*blockResidual[k][mu];
+				blockResidual[k][mu] -= alpha*blockProduct[k][mu];
+				norm += blockResidual[k][mu].squaredNorm();
+			}
+		}
+		if (norm < precision*initialNorm) break;
+	}
+
+	//Scatter of the correction, the sites of different blocks are disjoint
+	for (int k = begin; k < end; ++k) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			solution[blockSites[k]][mu] += blockCorrection[k][mu];
+		}
+	}
+}
+
+} /* namespace Update */
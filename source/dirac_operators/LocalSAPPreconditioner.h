@@ -0,0 +1,95 @@
+#ifndef LOCALSAPPRECONDITIONER_H_
+#define LOCALSAPPRECONDITIONER_H_
+#include "DiracOperator.h"
+#include <vector>
+
+namespace Update {
+
+/**
+ * Schwarz alternating procedure with domain-local block solves. The local sites are divided in the blocks
+ * given by setBlockSize, colored as a checkerboard, and every block is stored contiguously in the block ordering.
+ * The block solves use the operator with Dirichlet boundary conditions and a few minimal residual iterations
+ * on a single thread, in the cache and without communications; the blocks are cut at the boundaries of the processors.
+ * The operator approximates the inverse of a Wilson or clover Dirac operator, also with the twisted mass of TwistedDiracOperator.
+ */
+class LocalSAPPreconditioner : public DiracOperator {
+public:
+	LocalSAPPreconditioner(DiracOperator* _diracOperator);
+	~LocalSAPPreconditioner();
+
+	virtual void multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input);
+
+	virtual void multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const std::complex<real_t>& alpha);
+
+	virtual FermionForce* getForce() const;
+
+	virtual void setKappa(real_t _kappa);
+
+	virtual void setLattice(const extended_fermion_lattice_t& _lattice);
+
+	//The block operator is copied again only if the links, kappa, csw or gamma5 are not the ones of the last copy
+	void setDiracOperator(DiracOperator* _diracOperator);
+
+	void setBlockSize(const std::vector<unsigned int>& _blockSize);
+
+	//Number of Schwarz cycles, every cycle updates first the black and then the red blocks
+	void setSteps(int _steps);
+
+	//Maximum number of minimal residual iterations of the block solves
+	void setBlockSteps(int _blockSteps);
+
+	//The block solves stop when the squared norm of their residual is reduced by this factor
+	void setPrecision(double _precision);
+
+	//True if the block kernel can represent the operator, the other operators need SAPPreconditioner
+	static bool isSupported(DiracOperator* dirac);
+private:
+	//The operator of the block kernel, the Dirac operator of a TwistedDiracOperator
+	static DiracOperator* getKernelOperator(DiracOperator* dirac);
+
+	//Divides the local sites in blocks and builds the neighbours in the block ordering
+	void initializeBlocks();
+	//Copies the links and the clover term of diracOperator in the block ordering
+	void initializeBlockOperator();
+	//True if the operator of the block kernel differs from the copy in blockLinks
+	bool isNewOperator();
+
+	//output = D input on the sites [begin, end) of a block, in the block ordering with Dirichlet boundary conditions, without the gamma5 of diracOperator
+	void blockMultiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input, int begin, int end);
+	//Adds to solution the approximate solution of D x = source on a block
+	void blockSolve(reduced_dirac_vector_t& solution, const reduced_dirac_vector_t& source, int block);
+
+	DiracOperator* diracOperator;
+	int blockSize[4];
+	int steps;
+	int blockSteps;
+	real_t precision;
+
+	bool blocksInitialized;
+	bool operatorInitialized;
+
+	//Sites of the blocks in the block ordering, the block b has the indices [blockOffsets[b], blockOffsets[b+1])
+	std::vector<int> blockSites;
+	std::vector<int> blockOffsets;
+	std::vector<int> colorBlocks[2];
+	//Index of the forward (0-3) and backward (4-7) neighbours in the block ordering, -1 for the neighbours outside of the block
+	std::vector<int> blockNeighbours;
+
+	//Links and clover term in the block ordering
+	reduced_fermion_lattice_t blockLinks;
+	::Lattice::LatticeWorkspace<reduced_field_strength_lattice_t, 1> blockFieldStrength;
+	real_t csw;
+	//The twisted mass term of the block diagonal for the four spinor components
+	bool twisted;
+	std::complex<real_t> twistTerm[4];
+
+	//Residual, correction and product of the block solves in the block ordering
+	reduced_dirac_vector_t blockResidual;
+	reduced_dirac_vector_t blockCorrection;
+	reduced_dirac_vector_t blockProduct;
+	reduced_dirac_vector_t residual;
+	::Lattice::LatticeWorkspace<reduced_dirac_vector_t, 1> productBuffer;
+};
+
+} /* namespace Update */
+#endif /* LOCALSAPPRECONDITIONER_H_ */
@@ -0,0 +1,231 @@
+#include "SingleDiracWilsonOperator.h"
+
+namespace Update {
+
+SingleDiracWilsonOperator::SingleDiracWilsonOperator() : kappa(0.), gamma5(true), squared(false) { }
+
+SingleDiracWilsonOperator::~SingleDiracWilsonOperator() { }
+
+inline single_real_t conj(const single_real_t& t) {
+	return t;
+}
+
+void SingleDiracWilsonOperator::setOperator(DiracOperator* dirac, bool _squared) {
+	//Only the links changed since the previous call are written, the halo is included and no communication is needed
+	const reduced_fermion_lattice_t& links = *dirac->getLattice();
+#pragma omp parallel for
+	for (int site = 0; site < lattice.completesize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			single_FermionicGroup link = links[site][mu].cast<single_FermionicGroup::Scalar>();
+			if (link != lattice[site][mu]) lattice[site][mu] = link;
+		}
+	}
+	kappa = static_cast<single_real_t>(dirac->getKappa());
+	gamma5 = dirac->getGamma5();
+	squared = _squared;
+}
+
+void SingleDiracWilsonOperator::multiply(single_reduced_dirac_vector_t& output, const single_reduced_dirac_vector_t& input) {
+	if (squared) {
+		this->multiplyWilson(tmp, input);
+		this->multiplyWilson(output, tmp);
+	}
+	else {
+		this->multiplyWilson(output, input);
+	}
+}
+
+void SingleDiracWilsonOperator::multiplyWilson(single_reduced_dirac_vector_t& output, const single_reduced_dirac_vector_t& input) {
+	typedef single_reduced_fermion_lattice_t Lattice;
+	typedef single_reduced_dirac_vector_t Vector;
+	const single_reduced_fermion_lattice_t& linkconf = (lattice);
+	
+	//The sites [0, sharedsize) are read by the neighbouring processors, we process them first
+	//and we overlap the halo exchange of the output with the interior sites [sharedsize, localsize)
+	const int siteRange[3] = {0, output.sharedsize, output.localsize};
+	for (int region = 0; region < 2; ++region) {
+#pragma omp parallel for
+		for (int site = siteRange[region]; site < siteRange[region+1]; ++site) {
+			std::complex<single_real_t> projection_spinor_minus[diracVectorLength], projection_spinor_plus[diracVectorLength], tmm, tmp;
+			{
+				{
+					const size_t site_down = Vector::sdn(site,0);
+					const size_t site_up = Vector::sup(site,0);
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = std::complex<single_real_t>(input[site_down][0][n].real()+input[site_down][3][n].imag(),input[site_down][0][n].imag()-input[site_down][3][n].real());
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = std::complex<single_real_t>(input[site_up][0][n].real()-input[site_up][3][n].imag(),input[site_up][0][n].imag()+input[site_up][3][n].real());
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						}
+						output[site][0][i] = input[site][0][i] - kappa*(tmp+tmm);
+						output[site][3][i] = -input[site][3][i] + kappa*std::complex<single_real_t>(tmm.imag() - tmp.imag(),tmp.real() - tmm.real());
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = std::complex<single_real_t>(input[site_down][1][n].real()+input[site_down][2][n].imag(), input[site_down][1][n].imag()-input[site_down][2][n].real());
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = std::complex<single_real_t>(input[site_up][1][n].real()-input[site_up][2][n].imag(),input[site_up][1][n].imag()+input[site_up][2][n].real());
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,0)][0](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][0](i,n);
+						}
+
+						output[site][1][i] = input[site][1][i]- kappa*(tmp+tmm);
+						output[site][2][i] = -input[site][2][i]+ kappa*std::complex<single_real_t>(tmm.imag()-tmp.imag(),tmp.real()-tmm.real());
+					}
+				}
+				{
+					const size_t site_down = Vector::sdn(site,1);
+					const size_t site_up = Vector::sup(site,1);
+					for(int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = input[site_down][0][n] - (input[site_down][3][n]);
+					}
+					for(int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = input[site_up][0][n] + (input[site_up][3][n]);
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						}
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						}
+
+						output[site][0][i] -= kappa*(tmp+tmm);
+						output[site][3][i] += kappa*(tmm-tmp);
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][2][n]);
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][2][n]);
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,1)][1](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][1](i,n);
+						}
+
+						output[site][1][i] -= kappa*(tmp+tmm);
+						output[site][2][i] += kappa*(tmp-tmm);
+					}
+				}
+				{
+					const size_t site_down = Vector::sdn(site,2);
+					const size_t site_up = Vector::sup(site,2);
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = std::complex<single_real_t>(input[site_down][0][n].real() + input[site_down][2][n].imag(), input[site_down][0][n].imag() - input[site_down][2][n].real());
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = std::complex<single_real_t>(input[site_up][0][n].real() - input[site_up][2][n].imag(), input[site_up][0][n].imag() + input[site_up][2][n].real());
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						}
+
+						output[site][0][i] -= kappa*(tmp+tmm);
+						output[site][2][i] += kappa*std::complex<single_real_t>(tmm.imag()-tmp.imag(),tmp.real() - tmm.real());
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = std::complex<single_real_t>(input[site_down][1][n].real() - input[site_down][3][n].imag(), input[site_down][1][n].imag() + input[site_down][3][n].real());
+					}
+					for(int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = std::complex<single_real_t>(input[site_up][1][n].real() + input[site_up][3][n].imag(), input[site_up][1][n].imag() - input[site_up][3][n].real());
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,2)][2](n,i));
+						}
+						for(int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][2](i,n);
+						}
+
+						output[site][1][i] -= kappa*(tmp+tmm);
+						output[site][3][i] += kappa*std::complex<single_real_t>(tmp.imag() - tmm.imag(), tmm.real() - tmp.real());
+					}
+				}
+				{
+					const size_t site_down = Vector::sdn(site,3);
+					const size_t site_up = Vector::sup(site,3);
+					for(int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = input[site_down][0][n] + (input[site_down][2][n]);
+					}
+					for(int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = input[site_up][0][n] - (input[site_up][2][n]);
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						}
+
+						output[site][0][i] -= kappa*(tmp+tmm);
+						output[site][2][i] += kappa*(tmp-tmm);
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_minus[n] = input[site_down][1][n] + (input[site_down][3][n]);
+					}
+					for (int n = 0; n < diracVectorLength; ++n) {
+						projection_spinor_plus[n] = input[site_up][1][n] - (input[site_up][3][n]);
+					}
+					for (int i = 0; i < diracVectorLength; ++i) {
+						tmp = 0;
+						tmm = 0;
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmp += projection_spinor_minus[n] * conj(linkconf[Lattice::sdn(site,3)][3](n,i));
+						}
+						for (int n = 0; n < diracVectorLength; ++n) {
+							tmm += projection_spinor_plus[n] * linkconf[site][3](i,n);
+						}
+
+						output[site][1][i] -= kappa*(tmp+tmm);
+						output[site][3][i] += kappa*(tmp-tmm);
+					}
+				}
+			}
+			if (!gamma5) {
+				for (int i = 0; i < diracVectorLength; ++i) {
+					output[site][2][i] = -output[site][2][i];
+					output[site][3][i] = -output[site][3][i];
+				}
+			}
+		}
+		if (region == 0) output.communicateHalo();
+	}
+	output.waitHalo();
+}
+
+} /* namespace Update */
@@ -0,0 +1,47 @@
+#ifndef SINGLEDIRACWILSONOPERATOR_H_
+#define SINGLEDIRACWILSONOPERATOR_H_
+#include "DiracOperator.h"
+
+namespace Update {
+
+/**
+ * Single precision copy of the Wilson operator (or of its square), used for the inner iterations of the mixed precision solver.
+ * The kernel is the same as that of DiracWilsonOperator, the halo exchange of the output is always overlapped with the interior sites.
+ */
+class SingleDiracWilsonOperator {
+public:
+	SingleDiracWilsonOperator();
+	~SingleDiracWilsonOperator();
+
+	/**
+	 * This function copies in single precision the links, kappa and gamma5 of dirac. The links are cached: they are
+	 * converted again only where they differ from those of the previous call, the solves on the same configuration reuse them
+	 * @param dirac a DiracWilsonOperator or a SquareDiracWilsonOperator
+	 * @param _squared true if dirac is the square of the Wilson operator
+	 */
+	void setOperator(DiracOperator* dirac, bool _squared);
+
+	/**
+	 * This routine multiplies the operator (Wilson or square Wilson) to input and stores the result in output
+	 * @param output
+	 * @param input
+	 */
+	void multiply(single_reduced_dirac_vector_t& output, const single_reduced_dirac_vector_t& input);
+
+private:
+	//The DiracWilson operator
+	void multiplyWilson(single_reduced_dirac_vector_t& output, const single_reduced_dirac_vector_t& input);
+
+	single_reduced_fermion_lattice_t lattice;
+
+	single_real_t kappa;
+
+	bool gamma5;
+
+	bool squared;
+
+	single_reduced_dirac_vector_t tmp;
+};
+
+} /* namespace Update */
+#endif /* SINGLEDIRACWILSONOPERATOR_H_ */
@@ -0,0 +1,39 @@
+#include "SquareCompressedDiracWilsonOperator.h"
+#include "hmc_forces/DiracWilsonFermionForce.h"
+
+namespace Update {
+
+SquareCompressedDiracWilsonOperator::SquareCompressedDiracWilsonOperator() : DiracOperator(), compressedDiracWilsonOperator() { }
+
+SquareCompressedDiracWilsonOperator::SquareCompressedDiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa, bool _gamma5) : DiracOperator(_lattice, _kappa, _gamma5), compressedDiracWilsonOperator(_lattice, _kappa, _gamma5) { }
+
+SquareCompressedDiracWilsonOperator::~SquareCompressedDiracWilsonOperator() { }
+
+void SquareCompressedDiracWilsonOperator::multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input) {
+	compressedDiracWilsonOperator.setGamma5(gamma5);
+	compressedDiracWilsonOperator.multiply(tmp, input);
+	compressedDiracWilsonOperator.multiply(output, tmp);
+}
+
+void SquareCompressedDiracWilsonOperator::multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha) {
+	compressedDiracWilsonOperator.setGamma5(gamma5);
+	compressedDiracWilsonOperator.multiply(tmp, vector1);
+	compressedDiracWilsonOperator.multiplyAdd(output, tmp, vector2, alpha);
+}
+
+void SquareCompressedDiracWilsonOperator::setKappa(real_t _kappa) {
+	kappa = _kappa;
+	compressedDiracWilsonOperator.setKappa(_kappa);
+}
+
+void SquareCompressedDiracWilsonOperator::setLattice(const extended_fermion_lattice_t& _lattice) {
+	lattice = _lattice;
+	compressedDiracWilsonOperator.setLattice(_lattice);
+}
+
+FermionForce* SquareCompressedDiracWilsonOperator::getForce() const {
+	std::cout << "Gauge force not implemented for SquareCompressedDiracWilsonOperator, return that for DiracWilsonOperator" << std::endl;
+	return new DiracWilsonFermionForce(kappa);
+}
+
+} /* namespace Update */
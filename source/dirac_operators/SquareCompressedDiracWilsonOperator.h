@@ -0,0 +1,43 @@
+#ifndef SQUARECOMPRESSEDDIRACWILSONOPERATOR_H_
+#define SQUARECOMPRESSEDDIRACWILSONOPERATOR_H_
+
+#include "DiracOperator.h"
+#include "CompressedDiracWilsonOperator.h"
+
+namespace Update {
+
+class SquareCompressedDiracWilsonOperator : public Update::DiracOperator {
+public:
+	SquareCompressedDiracWilsonOperator();
+	SquareCompressedDiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa = 0., bool _gamma5 = true);
+	~SquareCompressedDiracWilsonOperator();
+
+	/**
+	 * This routine multiplies the compressed DiracWilson operator two times to input and stores the result in output
+	 * @param output
+	 * @param input
+	 */
+	virtual void multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input);
+
+	/**
+	 * This routine multiplies the compressed DiracWilson operator two times to vector1 and stores the result in output adding to it alpha*vector2
+	 * @param output
+	 * @param vector1
+	 * @param vector2
+	 * @param alpha
+	 */
+	virtual void multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha);
+
+	virtual FermionForce* getForce() const;
+
+	virtual void setKappa(real_t _kappa);
+
+	virtual void setLattice(const extended_fermion_lattice_t& _lattice);
+private:
+	CompressedDiracWilsonOperator compressedDiracWilsonOperator;
+
+	reduced_dirac_vector_t tmp;
+};
+
+} /* namespace Update */
+#endif /* SQUARECOMPRESSEDDIRACWILSONOPERATOR_H_ */
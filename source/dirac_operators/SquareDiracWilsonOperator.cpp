@@ -21,6 +21,33 @@ void SquareDiracWilsonOperator::multiplyAdd(reduced_dirac_vector_t& output, cons
 	diracWilsonOperator.multiplyAdd(output, tmp, vector2, alpha);
 }
 
+void SquareDiracWilsonOperator::multiplyBlock(const std::vector<reduced_dirac_vector_t*>& outputs, const std::vector<const reduced_dirac_vector_t*>& inputs) {
+	if (blockTmp.size() < inputs.size()) blockTmp.resize(inputs.size());
+	std::vector<reduced_dirac_vector_t*> tmpOutputs(inputs.size());
+	std::vector<const reduced_dirac_vector_t*> tmpInputs(inputs.size());
+	for (unsigned int i = 0; i < inputs.size(); ++i) {
+		tmpOutputs[i] = &blockTmp[i];
+		tmpInputs[i] = &blockTmp[i];
+	}
+	diracWilsonOperator.setGamma5(gamma5);
+	diracWilsonOperator.multiplyBlock(tmpOutputs, inputs);
+	diracWilsonOperator.multiplyBlock(outputs, tmpInputs);
+}
+
+#ifdef ALIGNED_OPT
+void SquareDiracWilsonOperator::multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input) {
+	diracWilsonOperator.setGamma5(gamma5);
+	diracWilsonOperator.multiply(soa_tmp, input);
+	diracWilsonOperator.multiply(output, soa_tmp);
+}
+
+void SquareDiracWilsonOperator::multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t& vector2, const complex& alpha) {
+	diracWilsonOperator.setGamma5(gamma5);
+	diracWilsonOperator.multiply(soa_tmp, vector1);
+	diracWilsonOperator.multiplyAdd(output, soa_tmp, vector2, alpha);
+}
+#endif
+
 void SquareDiracWilsonOperator::setKappa(real_t _kappa) {
 	kappa = _kappa;
 	diracWilsonOperator.setKappa(_kappa);
@@ -28,6 +28,21 @@ public:
 	 */
 	virtual void multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha);
 
+	/**
+	 * This routine multiplies the DiracWilson operator two times to a block of vectors
+	 * @param outputs
+	 * @param inputs
+	 */
+	virtual void multiplyBlock(const std::vector<reduced_dirac_vector_t*>& outputs, const std::vector<const reduced_dirac_vector_t*>& inputs);
+
+#ifdef ALIGNED_OPT
+	/**
+	 * Vectorized versions on the split real/imaginary storage
+	 */
+	virtual void multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input);
+	virtual void multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t& vector2, const complex& alpha);
+#endif
+
 	virtual FermionForce* getForce() const;
 
 	virtual void setKappa(real_t _kappa);
@@ -37,6 +52,10 @@ private:
 	DiracWilsonOperator diracWilsonOperator;
 	
 	reduced_dirac_vector_t tmp;
+	std::vector<reduced_dirac_vector_t> blockTmp;
+#ifdef ALIGNED_OPT
+	reduced_soa_dirac_vector_t soa_tmp;
+#endif
 };
 
 } /* namespace Update */
@@ -0,0 +1,52 @@
+#include "SquareEvenOddDiracWilsonOperator.h"
+#include "hmc_forces/EvenOddDiracWilsonFermionForce.h"
+
+namespace Update {
+
+SquareEvenOddDiracWilsonOperator::SquareEvenOddDiracWilsonOperator() : DiracOperator(), evenOddDiracWilsonOperator(), twist(0.) { }
+
+SquareEvenOddDiracWilsonOperator::SquareEvenOddDiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa, real_t _twist, bool _gamma5) : DiracOperator(_lattice, _kappa, _gamma5), evenOddDiracWilsonOperator(_lattice, _kappa, _twist, true), twist(_twist) { }
+
+SquareEvenOddDiracWilsonOperator::~SquareEvenOddDiracWilsonOperator() { }
+
+void SquareEvenOddDiracWilsonOperator::multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input) {
+	//Q(twist)^dagger = Q(-twist), the operator is hermitian also with the twist
+	evenOddDiracWilsonOperator.setGamma5(true);
+	evenOddDiracWilsonOperator.setTwist(twist);
+	evenOddDiracWilsonOperator.multiply(tmp, input);
+	evenOddDiracWilsonOperator.setTwist(-twist);
+	evenOddDiracWilsonOperator.multiply(output, tmp);
+}
+
+void SquareEvenOddDiracWilsonOperator::multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha) {
+	evenOddDiracWilsonOperator.setGamma5(true);
+	evenOddDiracWilsonOperator.setTwist(twist);
+	evenOddDiracWilsonOperator.multiply(tmp, vector1);
+	evenOddDiracWilsonOperator.setTwist(-twist);
+	evenOddDiracWilsonOperator.multiplyAdd(output, tmp, vector2, alpha);
+}
+
+FermionForce* SquareEvenOddDiracWilsonOperator::getForce() const {
+	std::cout << "Gauge force not implemented for SquareEvenOddDiracWilsonOperator, return that for EvenOddDiracWilsonOperator" << std::endl;
+	return new EvenOddDiracWilsonFermionForce(kappa, twist);
+}
+
+void SquareEvenOddDiracWilsonOperator::setKappa(real_t _kappa) {
+	kappa = _kappa;
+	evenOddDiracWilsonOperator.setKappa(_kappa);
+}
+
+void SquareEvenOddDiracWilsonOperator::setLattice(const extended_fermion_lattice_t& _lattice) {
+	lattice = _lattice;
+	evenOddDiracWilsonOperator.setLattice(_lattice);
+}
+
+void SquareEvenOddDiracWilsonOperator::setTwist(real_t _twist) {
+	twist = _twist;
+}
+
+real_t SquareEvenOddDiracWilsonOperator::getTwist() const {
+	return twist;
+}
+
+} /* namespace Update */
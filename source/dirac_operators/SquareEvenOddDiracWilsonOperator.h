@@ -0,0 +1,49 @@
+#ifndef SQUAREEVENODDDIRACWILSONOPERATOR_H_
+#define SQUAREEVENODDDIRACWILSONOPERATOR_H_
+#include "DiracOperator.h"
+#include "EvenOddDiracWilsonOperator.h"
+
+namespace Update {
+
+/**
+ * Square of the Schur complement of the twisted Wilson operator, Q^dagger Q with Q = gamma5 (M_oo - M_oe M_ee^-1 M_eo).
+ * It is the identity on the even sites, for twist = 0 its determinant is the one of the square of the DiracWilson operator.
+ */
+class SquareEvenOddDiracWilsonOperator : public Update::DiracOperator {
+public:
+	SquareEvenOddDiracWilsonOperator();
+	SquareEvenOddDiracWilsonOperator(const extended_fermion_lattice_t& _lattice, real_t _kappa = 0., real_t _twist = 0., bool _gamma5 = true);
+	~SquareEvenOddDiracWilsonOperator();
+
+	/**
+	 * This routine multiplies the square of the Schur complement to input and stores the result in output
+	 * @param output
+	 * @param input
+	 */
+	virtual void multiply(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input);
+
+	/**
+	 * This routine multiplies the square of the Schur complement to vector1 and stores the result in output adding to it alpha*vector2
+	 * @param output
+	 * @param vector1
+	 * @param vector2
+	 * @param alpha
+	 */
+	virtual void multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha);
+
+	virtual FermionForce* getForce() const;
+
+	virtual void setKappa(real_t _kappa);
+
+	virtual void setLattice(const extended_fermion_lattice_t& _lattice);
+
+	void setTwist(real_t _twist);
+	real_t getTwist() const;
+private:
+	EvenOddDiracWilsonOperator evenOddDiracWilsonOperator;
+	reduced_dirac_vector_t tmp;
+	real_t twist;
+};
+
+} /* namespace Update */
+#endif /* SQUAREEVENODDDIRACWILSONOPERATOR_H_ */
@@ -22,6 +22,20 @@ void SquareImprovedDiracWilsonOperator::multiplyAdd(reduced_dirac_vector_t& outp
 	improvedDiracWilsonOperator.multiplyAdd(output, tmp, vector2, alpha);
 }
 
+#ifdef ALIGNED_OPT
+void SquareImprovedDiracWilsonOperator::multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input) {
+	improvedDiracWilsonOperator.setGamma5(gamma5);
+	improvedDiracWilsonOperator.multiply(soa_tmp, input);
+	improvedDiracWilsonOperator.multiply(output, soa_tmp);
+}
+
+void SquareImprovedDiracWilsonOperator::multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t& vector2, const complex& alpha) {
+	improvedDiracWilsonOperator.setGamma5(gamma5);
+	improvedDiracWilsonOperator.multiply(soa_tmp, vector1);
+	improvedDiracWilsonOperator.multiplyAdd(output, soa_tmp, vector2, alpha);
+}
+#endif
+
 void SquareImprovedDiracWilsonOperator::setLattice(const extended_fermion_lattice_t& _lattice) {
 	lattice = _lattice;//TODO
 	improvedDiracWilsonOperator.setLattice(_lattice);
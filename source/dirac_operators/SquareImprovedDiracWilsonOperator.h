@@ -27,6 +27,14 @@ public:
 	 */
 	virtual void multiplyAdd(reduced_dirac_vector_t& output, const reduced_dirac_vector_t& vector1, const reduced_dirac_vector_t& vector2, const complex& alpha);
 
+#ifdef ALIGNED_OPT
+	/**
+	 * Vectorized versions on the split real/imaginary storage
+	 */
+	virtual void multiply(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& input);
+	virtual void multiplyAdd(reduced_soa_dirac_vector_t& output, const reduced_soa_dirac_vector_t& vector1, const reduced_soa_dirac_vector_t& vector2, const complex& alpha);
+#endif
+
 	virtual void setLattice(const extended_fermion_lattice_t& _lattice);
 
 	virtual FermionForce* getForce() const;
@@ -38,6 +46,9 @@ public:
 private:
 	ImprovedDiracWilsonOperator improvedDiracWilsonOperator;
 	reduced_dirac_vector_t tmp;
+#ifdef ALIGNED_OPT
+	reduced_soa_dirac_vector_t soa_tmp;
+#endif
 	real_t csw;
 };
 
@@ -1,6 +1,7 @@
 #include "ChiralCondensate.h"
 #include "algebra_utils/AlgebraUtils.h"
 #include "inverters/PreconditionedBiCGStab.h"
+#include "inverters/NormalEquationSolver.h"
 #include "io/GlobalOutput.h"
 #include "utils/StoutSmearing.h"
 #include "dirac_operators/Propagator.h"
@@ -48,11 +49,13 @@ void ChiralCondensate::execute(environment_t& environment) {
 	long_real_t volume = environment.gaugeLinkConfiguration.getLayout().globalVolume;
 
 	if (inverter == 0) {
-		PreconditionedBiCGStab* p_inverter = new PreconditionedBiCGStab();
-		if (environment.configurations.get<std::string>("ChiralCondensate::use_even_odd_preconditioning") != "true") {
+		inverter = Solver::getInstance(environment.configurations.get<std::string>("ChiralCondensate::inverter"));
+		PreconditionedBiCGStab* p_inverter = dynamic_cast<PreconditionedBiCGStab*>(inverter);
+		if (p_inverter != 0 && environment.configurations.get<std::string>("ChiralCondensate::use_even_odd_preconditioning") != "true") {
                         p_inverter->setUseEvenOddPreconditioning(false);
                 }
-		inverter = p_inverter;
+		//The solvers of hermitian positive definite operators invert the Dirac operator with the normal equations
+		if (inverter->requiresPositiveDefiniteOperator()) inverter = new NormalEquationSolver(inverter);
 		inverter->setMaximumSteps(environment.configurations.get<unsigned int>("ChiralCondensate::inverter_max_steps"));
 		inverter->setPrecision(environment.configurations.get<real_t>("ChiralCondensate::inverter_precision"));
 	}
@@ -163,6 +166,7 @@ void ChiralCondensate::execute(environment_t& environment) {
 void ChiralCondensate::registerParameters(po::options_description& desc) {
 	desc.add_options()
 		("ChiralCondensate::number_stochastic_estimators", po::value<unsigned int>()->default_value(20), "The number of stochastic estimators to be used")
+		("ChiralCondensate::inverter", po::value<std::string>()->default_value("preconditioned_biconjugate_gradient"), "set the inverter (preconditioned_biconjugate_gradient, biconjugate_gradient, mixed_precision_biconjugate_gradient, mixed_precision_conjugate_gradient, pipelined_conjugate_gradient)")
 		("ChiralCondensate::inverter_precision", po::value<double>()->default_value(0.0000000001), "set the precision used by the inverter")
 		("ChiralCondensate::inverter_max_steps", po::value<unsigned int>()->default_value(5000), "set the maximum steps used by the inverter")
 		("ChiralCondensate::measure_condensate_connected", po::value<std::string>()->default_value("false"), "Should we measure the connected part of the condensate?")
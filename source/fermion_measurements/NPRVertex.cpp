@@ -84,19 +84,26 @@ void NPRVertex::execute(environment_t& environment) {
 	momentum[2] = momentum[2]*2.*PI/Layout::glob_z;
 	momentum[3] = momentum[3]*2.*PI/Layout::glob_t;
 	
-	for (unsigned int alpha = 0; alpha < 4; ++alpha) {
-		for (int c = 0; c < diracVectorLength; ++c) {
+	//The four spin sources of a color are solved together as a block
+	std::vector<reduced_dirac_vector_t> sources(4), solutions;
+	for (int c = 0; c < diracVectorLength; ++c) {
+		for (unsigned int alpha = 0; alpha < 4; ++alpha) {
 			this->generateMomentumSource(source[c*4 + alpha], momentum, alpha, c);
 			//this->generateSource(source, alpha, c);
-			inverter->solve(diracOperator, source[c*4 + alpha], inverse_source[c*4 + alpha]);
-			
+			sources[alpha] = source[c*4 + alpha];
+		}
+		inverter->solve(diracOperator, sources, solutions);
+		
+		for (unsigned int alpha = 0; alpha < 4; ++alpha) {
+			inverse_source[c*4 + alpha] = solutions[alpha];
+
 			extended_dirac_vector_t test;
-			diracOperator->multiply(test,inverse_source[c*4 + alpha]);
+			diracOperator->multiply(test,inverse_source[c*4 + alpha],false);
 			long_real_t dtest = AlgebraUtils::differenceNorm(test, source[c*4 + alpha]);
 			if (isOutputProcess()) std::cout << "NPRVertex::Convergence test of the inverter : " << dtest << std::endl;
-
-			inversionSteps += inverter->getLastSteps();
 		}
+
+		inversionSteps += inverter->getLastSteps();
 	}
 	
 	if (isOutputProcess()) std::cout << "NPRVertex::Vertex computed with " << inversionSteps << " inversion steps" << std::endl;
@@ -1,7 +1,7 @@
 #ifndef STOCHASTICESTIMATOR_H_
 #define STOCHASTICESTIMATOR_H_
 #include "Environment.h"
-#include "utils/RandomSeed.h"
+#include "utils/CounterRandomGenerator.h"
 
 
 namespace Update {
@@ -13,17 +13,15 @@ public:
 	~StochasticEstimator();
 
 protected:
+	//Z2 noise, drawn from the counter based generator so that it does not depend on the number of threads and processors
 	template<typename TVector> void generateRandomNoise(TVector& vector) {
+		boost::uint32_t stream = CounterRandomGenerator::nextStream();
 #pragma omp parallel for
 		for (int site = 0; site < vector.localsize; ++site) {
+			CounterRandomGenerator generator(stream, CounterRandomGenerator::globalIndex<typename TVector::Layout>(site));
 			for (unsigned int mu = 0; mu < 4; ++mu) {
 				for (int i = 0; i < diracVectorLength; ++i) {
-#ifndef MULTITHREADING
-					real_t realPart = (randomInteger() == 0 ? -1 : 1);
-#endif
-#ifdef MULTITHREADING
-					real_t realPart = ((*randomInteger[omp_get_thread_num()])() == 0 ? -1 : 1);
-#endif
+					real_t realPart = generator.z2();
 					vector[site][mu][i] = std::complex<real_t>(realPart,0.);
 				}
 			}
@@ -59,19 +57,6 @@ protected:
 		}
 		return sqrt(res/static_cast<T>(v.size()-1));
 	}
-
-#ifndef MULTITHREADING
-	//The generator of random numbers
-	random_generator_t randomGenerator;
-	//The random integer generator
-	random_integer_generator_t randomInteger;
-#endif
-#ifdef MULTITHREADING
-	//The generator of random numbers
-	random_generator_t** randomGenerator;
-	//The random integer generator
-	random_integer_generator_t** randomInteger;
-#endif
 };
 
 } /* namespace Update */
@@ -94,7 +94,7 @@ void XSpaceCorrelators::execute(environment_t& environment) {
 		this->generateRandomNoise(randomNoise[step]);
 		tmp = randomNoise[step];
 		AlgebraUtils::gamma5(tmp);
-		diracOperator->multiply(source, tmp);
+		diracOperator->multiply(source, tmp, false);
 		biConjugateGradient->solve(squareDiracOperator, source, inverseRandomNoise[step]);
 		
 		inversionSteps += biConjugateGradient->getLastSteps();
@@ -319,22 +319,23 @@ void XSpaceCorrelators::execute(environment_t& environment) {
 	extended_dirac_vector_t source, eta;
 	extended_dirac_vector_t inverseFull[diracVectorLength*4];
 	
-	for (unsigned int alpha = 0; alpha < 4; ++alpha) {
-		for (int c = 0; c < diracVectorLength; ++c) {
+	//The four spin sources of a color are solved together as a block
+	std::vector<reduced_dirac_vector_t> sources(4), solutions;
+	for (int c = 0; c < diracVectorLength; ++c) {
+		for (unsigned int alpha = 0; alpha < 4; ++alpha) {
 			this->generateSource(source, alpha, c);
 			tmp = source;
 			AlgebraUtils::gamma5(tmp);
-			diracOperator->multiply(source, tmp);
-			biConjugateGradient->solve(squareDiracOperator, source, inverseFull[c*4 + alpha]);
-			
-
-			//diracOperator->multiply(eta,source);
-			//biConjugateGradient->solve(squareDiracOperator, eta, inverseFull[c*4 + alpha]);
-			//AlgebraUtils::gamma5(inverseFull[c*4 + alpha]);
-			//diracOperator->multiply(inverseFull[c*4 + alpha],eta);
-			if (isOutputProcess()) std::cout << "XSpaceCorrelators::Inversion " << c*4 + alpha << " done in " << biConjugateGradient->getLastSteps() << " steps." << std::endl;
-			inversionSteps += biConjugateGradient->getLastSteps();
+			diracOperator->multiply(source, tmp, false);
+			sources[alpha] = source;
 		}
+		biConjugateGradient->solve(squareDiracOperator, sources, solutions);
+		for (unsigned int alpha = 0; alpha < 4; ++alpha) {
+			inverseFull[c*4 + alpha] = solutions[alpha];
+		}
+
+		if (isOutputProcess()) std::cout << "XSpaceCorrelators::Inversions " << c*4 << "-" << c*4 + 3 << " done in " << biConjugateGradient->getLastSteps() << " steps." << std::endl;
+		inversionSteps += biConjugateGradient->getLastSteps();
 	}
 	
 	if (environment.measurement && isOutputProcess()) {
@@ -362,7 +363,7 @@ void XSpaceCorrelators::execute(environment_t& environment) {
 					//translate(inverseFull[c*4 + alpha], inverseFullTranslated, coord[0], coord[1], coord[2], coord[3]);
 					typedef extended_dirac_vector_t::Layout LT;
 				
-					int site = LT::localIndex[LT::getGlobalCoordinate(coord[0], coord[1], coord[2], coord[3])];
+					int site = LT::getLocalIndex(LT::getGlobalCoordinate(coord[0], coord[1], coord[2], coord[3]));
 					//Dot
 					if (site != -1) {
 						for (unsigned int alpha = 0; alpha < 4; ++alpha) {
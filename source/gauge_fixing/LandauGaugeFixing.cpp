@@ -1,11 +1,13 @@
 #include "LandauGaugeFixing.h"
 #include "utils/ToString.h"
+#include "utils/ExpMap.h"
+#include <limits>
 
 namespace Update {
 
-LandauGaugeFixing::LandauGaugeFixing() : LatticeSweep(), GaugeFixing() { }
+LandauGaugeFixing::LandauGaugeFixing() : LatticeSweep(), GaugeFixing(), fourierAcceleration(false), fourierAlpha(0.08) { }
 
-LandauGaugeFixing::LandauGaugeFixing(const LandauGaugeFixing& toCopy) : LatticeSweep(toCopy), GaugeFixing(toCopy) { }
+LandauGaugeFixing::LandauGaugeFixing(const LandauGaugeFixing& toCopy) : LatticeSweep(toCopy), GaugeFixing(toCopy), fourierAcceleration(toCopy.fourierAcceleration), fourierAlpha(toCopy.fourierAlpha) { }
 
 LandauGaugeFixing::~LandauGaugeFixing() { }
 
@@ -64,6 +66,65 @@ void LandauGaugeFixing::generateOverrelaxationTransformation(extended_matrix_lat
 	gauge_transformation.updateHalo();
 }
 
+void LandauGaugeFixing::generateFourierAcceleratedTransformation(extended_matrix_lattice_t& gauge_transformation, const extended_gauge_lattice_t& lattice, Lattice::LatticeFourierTransform<extended_matrix_lattice_t::Layout>& fourierTransform, real_t alpha) {
+	typedef extended_matrix_lattice_t LT;
+	typedef extended_matrix_lattice_t::Layout Layout;
+
+	extended_gauge_lattice_t Afield;
+	this->getLieAlgebraField(Afield, lattice);
+
+	const int numberComponents = numberColors*numberColors;
+	std::vector< std::complex<real_t> > gradient(Afield.localsize*numberComponents);
+#pragma omp parallel for
+	for (int site = 0; site < Afield.localsize; ++site) {
+		GaugeGroup delta;
+		set_to_zero(delta);
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			delta += Afield[LT::sdn(site,mu)][mu] - Afield[site][mu];
+		}
+		for (int i = 0; i < numberColors; ++i) {
+			for (int j = 0; j < numberColors; ++j) gradient[site*numberComponents + i*numberColors + j] = delta.at(i,j);
+		}
+	}
+
+	//The gradient is multiplied by p_max^2/p^2 in momentum space, the zero mode of a divergence vanishes
+	real_t maximalMomentum = 0.;
+	for (unsigned int mu = 0; mu < 4; ++mu) {
+		real_t sine = sin(PI*(Layout::glob[mu]/2)/Layout::glob[mu]);
+		maximalMomentum += 4.*sine*sine;
+	}
+	fourierTransform.transform(gradient, 1);
+#pragma omp parallel for
+	for (int site = 0; site < Afield.localsize; ++site) {
+		int n[4] = {Layout::globalIndexX(site), Layout::globalIndexY(site), Layout::globalIndexZ(site), Layout::globalIndexT(site)};
+		real_t momentum = 0.;
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			real_t sine = sin(PI*n[mu]/Layout::glob[mu]);
+			momentum += 4.*sine*sine;
+		}
+		real_t factor = (momentum > 0.) ? maximalMomentum/(momentum*Layout::globalVolume) : 0.;
+		for (int c = 0; c < numberComponents; ++c) gradient[site*numberComponents + c] *= factor;
+	}
+	fourierTransform.transform(gradient, -1);
+
+	ExponentialMap expMap;
+#pragma omp parallel for
+	for (int site = 0; site < gauge_transformation.localsize; ++site) {
+		GaugeGroup delta;
+		for (int i = 0; i < numberColors; ++i) {
+			for (int j = 0; j < numberColors; ++j) delta.at(i,j) = gradient[site*numberComponents + i*numberColors + j];
+		}
+		//Hermitian traceless projection, against the rounding errors of the transform
+		delta = (delta + htrans(delta))/2.;
+		std::complex<real_t> tr = trace(delta);
+		for (int i = 0; i < numberColors; ++i) delta.at(i,i) -= tr/static_cast<real_t>(numberColors);
+		GaugeGroup generator = std::complex<real_t>(0.,alpha/2.)*delta;
+		gauge_transformation[site] = expMap.exp(generator);
+	}
+
+	gauge_transformation.updateHalo();
+}
+
 void LandauGaugeFixing::execute(environment_t& environment) {
 	real_t epsilon1 = environment.configurations.get<real_t>("LandauGaugeFixing::epsilon1");
 	real_t epsilon2 = environment.configurations.get<real_t>("LandauGaugeFixing::epsilon2");
@@ -83,6 +144,9 @@ void LandauGaugeFixing::execute(environment_t& environment) {
 
 	unsigned int output_steps = environment.configurations.get<unsigned int>("LandauGaugeFixing::output_steps");
 
+	fourierAcceleration = (environment.configurations.get<std::string>("LandauGaugeFixing::local_algorithm") == "fourier_accelerated");
+	fourierAlpha = environment.configurations.get<real_t>("LandauGaugeFixing::fourier_alpha");
+
 	std::vector<long_real_t> maximal_values(number_copies);
 	std::vector<extended_gauge_lattice_t> maximals(number_copies);
 	for (unsigned int i = 0; i < number_copies; ++i) {
@@ -215,17 +279,29 @@ long_real_t LandauGaugeFixing::gaugeFixing(extended_gauge_lattice_t& lattice, co
 	acceptance1 = 0., acceptance2 = 0., acceptance3 = 0., acceptancept = 0.;
 
 	long_real_t convergence = 0;
+	//The Fourier accelerated step is a function of the maximum only, a rejected step is done again with a smaller alpha
+	real_t alpha = fourierAlpha;
+	//The increase of the functional is measured only on the accepted steps of the interval
+	bool accepted = false, converged = false;
+
+	Lattice::LatticeFourierTransform<Layout>* fourierTransform = 0;
+	if (fourierAcceleration) fourierTransform = new Lattice::LatticeFourierTransform<Layout>(numberColors*numberColors);
 
 	for (unsigned int i = 0; i < local_steps; ++i) {
 		if ((i) % static_cast<int>(local_steps/output_steps) == 0) {
 			if (isOutputProcess()) std::cout << "LandauGaugeFixing::Maximal functional at step " << i  << ": " << maximalFunctionalValue << std::endl;
 			if (i > 0 && isOutputProcess()) std::cout << "LandauGaugeFixing::   convergence: " << convergence << std::endl;
-			if (fabs(convergence) < precision && i > 0) break;
+			if (fabs(convergence) < precision && i > 0 && (accepted || !fourierAcceleration)) {
+				converged = true;
+				break;
+			}
 			convergence = 0;
+			accepted = false;
 		}
 		
 		tmp = maximum;
-		this->generateOverrelaxationTransformation(gauge_transformation, tmp, i);
+		if (fourierAcceleration) this->generateFourierAcceleratedTransformation(gauge_transformation, tmp, *fourierTransform, alpha);
+		else this->generateOverrelaxationTransformation(gauge_transformation, tmp, i);
 		this->transform(tmp, gauge_transformation);
 		long_real_t newFunctional = functional(tmp);
 		
@@ -233,8 +309,27 @@ long_real_t LandauGaugeFixing::gaugeFixing(extended_gauge_lattice_t& lattice, co
 			convergence += newFunctional - maximalFunctionalValue;
 			maximalFunctionalValue = newFunctional;
 			maximum = tmp;
+			accepted = true;
+			if (fourierAcceleration) alpha = std::min(fourierAlpha, static_cast<real_t>(1.1*alpha));
+		}
+		else if (fourierAcceleration) {
+			//A decrease at the level of the roundoff of the functional means that the maximum is reached
+			if (maximalFunctionalValue - newFunctional < 100.*std::numeric_limits<real_t>::epsilon()*fabs(maximalFunctionalValue)) {
+				converged = true;
+				break;
+			}
+			alpha = alpha/2.;
+			if (alpha < 1e-6*fourierAlpha) {
+				//The accepted steps of the interval may have already reached the precision
+				converged = accepted && fabs(convergence) < precision;
+				if (!converged && isOutputProcess()) std::cout << "LandauGaugeFixing::Fourier accelerated gauge fixing not converged, no increase of the functional at step " << i << std::endl;
+				break;
+			}
 		}
 	}
+	if (converged && isOutputProcess()) std::cout << "LandauGaugeFixing::Gauge fixing converged with the maximal functional " << maximalFunctionalValue << std::endl;
+
+	delete fourierTransform;
 
 	lattice = maximum;
 	return maximalFunctionalValue;
@@ -293,6 +388,8 @@ void LandauGaugeFixing::registerParameters(po::options_description& desc) {
 		("LandauGaugeFixing::precision", po::value<real_t>()->default_value(0.000000000001), "Set the covergence precision")
 		("LandauGaugeFixing::output_steps", po::value<unsigned int>()->default_value(100), "Set the step to monitor the output")
 		("LandauGaugeFixing::number_copies", po::value<unsigned int>()->default_value(5), "Set the of copies of maxima to use to search the global maximum")
+		("LandauGaugeFixing::local_algorithm", po::value<std::string>()->default_value("overrelaxation"), "The algorithm of the local phase (overrelaxation/fourier_accelerated)")
+		("LandauGaugeFixing::fourier_alpha", po::value<real_t>()->default_value(0.08), "The step of the Fourier accelerated steepest ascent")
 		;
 }
 
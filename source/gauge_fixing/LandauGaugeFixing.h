@@ -4,6 +4,7 @@
 #include "LatticeSweep.h"
 #include "utils/RandomSeed.h"
 #include "gauge_fixing/GaugeFixing.h"
+#include "MPILattice/LatticeFourierTransform.h"
 
 namespace Update {
 
@@ -17,6 +18,13 @@ public:
 
 	void generateOverrelaxationTransformation(extended_matrix_lattice_t& gauge_transformation, const extended_gauge_lattice_t& lattice, int d);
 
+	/**
+	 * This function generates the Fourier accelerated steepest ascent transformation g = exp(i alpha/2 F^-1[p_max^2/p^2 F[Delta]]),
+	 * Delta(x) = sum_mu A_mu(x-mu) - A_mu(x) being the gradient of the functional, of Davies et al., Phys. Rev. D 37 (1988) 1581
+	 * @param fourierTransform the transform of the N*N components of the matrices of extended_matrix_lattice_t
+	 */
+	void generateFourierAcceleratedTransformation(extended_matrix_lattice_t& gauge_transformation, const extended_gauge_lattice_t& lattice, Lattice::LatticeFourierTransform<extended_matrix_lattice_t::Layout>& fourierTransform, real_t alpha);
+
 	static void registerParameters(po::options_description&);
 protected:
 	long_real_t functional(const extended_gauge_lattice_t& lattice);
@@ -24,6 +32,10 @@ protected:
 	long_real_t deviation(const extended_gauge_lattice_t& lattice) const;
 
 	long_real_t gaugeFixing(extended_gauge_lattice_t& lattice, const real_t& epsilon1, const real_t& beta1, const real_t& epsilon2, const real_t& beta2, const real_t& epsilon3, const real_t& beta3, unsigned int steps, unsigned int local_steps, const real_t& precision, unsigned int output_steps);
+
+	//The local phase uses the Fourier accelerated steepest ascent instead of the overrelaxation
+	bool fourierAcceleration;
+	real_t fourierAlpha;
 };
 
 }
@@ -2,6 +2,7 @@
 #include "utils/ToString.h"
 #include "io/GlobalOutput.h"
 #include "utils/LieGenerators.h"
+#include "MPILattice/LatticeFourierTransform.h"
 
 namespace Update {
 
@@ -47,20 +48,6 @@ void LandauGluonPropagator::execute(environment_t& environment) {
 		}
 	}
 
-	std::vector< std::vector<real_t> > delta(4);
-	for (int mu = 0; mu < 4; ++mu) {
-		std::vector<real_t> delta_mu(4);
-		for (int nu = 0; nu < 4; ++nu) {
-			if (mu == nu) {
-				delta_mu[nu] = 1./2.;
-			} 
-			else {
-				delta_mu[nu] = 0.;
-			}
-		}
-		delta[mu] = delta_mu;
-	}
-
 	real_t convergence = this->deviation(environment.gaugeLinkConfiguration);
 
 	if (isOutputProcess()) std::cout << "LandauGluonPropagator::Deviation from the Landau gauge: " << convergence << std::endl;
@@ -72,65 +59,50 @@ void LandauGluonPropagator::execute(environment_t& environment) {
 
 
 	LieGenerator<GaugeGroup> lieGenerators;
+	const int numberGenerators = lieGenerators.numberGenerators();
 
-	std::complex<real_t> Azero[4][lieGenerators.numberGenerators()];
-
-	std::vector< std::vector<real_t> > data;
-
-	for (unsigned int i = 0; i < momenta.size(); ++i) {
-		std::vector<real_t> momentum = momenta[i];
-
-		std::complex<real_t> resultAk[4][lieGenerators.numberGenerators()], resultAmk[4][lieGenerators.numberGenerators()];
+	//All the momenta are computed with a single Fourier transform of the components A^c_mu(x) = tr(A_mu(x) T^c)
+	std::vector< std::complex<real_t> > Ax(Afield.localsize*4*numberGenerators);
+#pragma omp parallel for
+	for (int site = 0; site < Afield.localsize; ++site) {
 		for (unsigned int mu = 0; mu < 4; ++mu) {
-			for (unsigned int c = 0; c < lieGenerators.numberGenerators(); ++c) {
-				resultAk[mu][c] = 0.;
-				resultAmk[mu][c] = 0.;
+			for (int c = 0; c < numberGenerators; ++c) {
+				Ax[(site*4 + mu)*numberGenerators + c] = trace(Afield[site][mu]*lieGenerators.get(c));
 			}
 		}
+	}
+	Lattice::LatticeFourierTransform<Layout> fourierTransform(4*numberGenerators);
+	fourierTransform.transform(Ax, 1);
 
-#ifdef MULTITHREADING
-		std::complex<real_t> Ak[omp_get_max_threads()][4][lieGenerators.numberGenerators()], Amk[omp_get_max_threads()][4][lieGenerators.numberGenerators()];
-		for (int k = 0; k < omp_get_max_threads(); ++k) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				for (unsigned int c = 0; c < lieGenerators.numberGenerators(); ++c) {
-					Ak[k][mu][c] = 0.;
-					Amk[k][mu][c] = 0.;
-				}
+	//The momenta of the list are collected from the processors owning them, the link A_mu lives in x + mu/2
+	std::vector<real_t> Ak(2*momenta.size()*4*numberGenerators, 0.);
+	for (unsigned int i = 0; i < momenta.size(); ++i) {
+		int site = Layout::getLocalIndex(Layout::getGlobalCoordinate(static_cast<int>(pn[i][0]), static_cast<int>(pn[i][1]), static_cast<int>(pn[i][2]), static_cast<int>(pn[i][3])));
+		if (site < 0 || site >= Afield.localsize) continue;
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			std::complex<real_t> phase(cos(momenta[i][mu]/2.), sin(momenta[i][mu]/2.));
+			for (int c = 0; c < numberGenerators; ++c) {
+				std::complex<real_t> value = phase*Ax[(site*4 + mu)*numberGenerators + c];
+				Ak[2*((i*4 + mu)*numberGenerators + c)] = real(value);
+				Ak[2*((i*4 + mu)*numberGenerators + c) + 1] = imag(value);
 			}
 		}
-#endif
+	}
+	reduceAllSum(&Ak[0], Ak.size());
 
-#pragma omp parallel for
-		for (int site = 0; site < Afield.localsize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				real_t phase = 
-					   (Layout::globalIndexX(site) + delta[mu][0])*momentum[0]
-					+ (Layout::globalIndexY(site) + delta[mu][1])*momentum[1] 
-					+ (Layout::globalIndexZ(site) + delta[mu][2])*momentum[2] 
-					+ (Layout::globalIndexT(site) + delta[mu][3])*momentum[3] ;
-				for (unsigned int c = 0; c < lieGenerators.numberGenerators(); ++c) {
-#ifndef MULTITHREADING
-					resultAk[mu][c] += std::complex<real_t>(cos(phase),sin(phase))*trace(Afield[site][mu]*lieGenerators.get(c));
-					resultAmk[mu][c] += std::complex<real_t>(cos(phase),-sin(phase))*trace(Afield[site][mu]*lieGenerators.get(c));
-#endif
-#ifdef MULTITHREADING
-					Ak[omp_get_thread_num()][mu][c] += std::complex<real_t>(cos(phase),sin(phase))*trace(Afield[site][mu]*lieGenerators.get(c));
-					Amk[omp_get_thread_num()][mu][c] += std::complex<real_t>(cos(phase),-sin(phase))*trace(Afield[site][mu]*lieGenerators.get(c));
-#endif
-				}
-			}
-		}
+	std::complex<real_t> Azero[4][lieGenerators.numberGenerators()];
+
+	std::vector< std::vector<real_t> > data;
 
+	for (unsigned int i = 0; i < momenta.size(); ++i) {
+		std::vector<real_t> momentum = momenta[i];
+
+		//The field is real, A(-p) is the conjugate of A(p)
+		std::complex<real_t> resultAk[4][lieGenerators.numberGenerators()], resultAmk[4][lieGenerators.numberGenerators()];
 		for (unsigned int mu = 0; mu < 4; ++mu) {
-			for (unsigned int c = 0; c < lieGenerators.numberGenerators(); ++c) {
-#ifdef MULTITHREADING
-				for (int k = 0; k < omp_get_max_threads(); ++k) {
-					resultAk[mu][c] += Ak[k][mu][c];
-					resultAmk[mu][c] += Amk[k][mu][c];
-				}
-#endif
-				reduceAllSum(resultAk[mu][c]);
-				reduceAllSum(resultAmk[mu][c]);
+			for (int c = 0; c < numberGenerators; ++c) {
+				resultAk[mu][c] = std::complex<real_t>(Ak[2*((i*4 + mu)*numberGenerators + c)], Ak[2*((i*4 + mu)*numberGenerators + c) + 1]);
+				resultAmk[mu][c] = conj(resultAk[mu][c]);
 			}
 		}
 
@@ -0,0 +1,37 @@
+#include "EvenOddDiracWilsonFermionForce.h"
+
+namespace Update {
+
+EvenOddDiracWilsonFermionForce::EvenOddDiracWilsonFermionForce(real_t _kappa, real_t _twist) : DiracWilsonFermionForce(_kappa), evenOddDiracWilsonOperator(), twist(_twist) {
+	evenOddDiracWilsonOperator.setKappa(_kappa);
+}
+
+EvenOddDiracWilsonFermionForce::~EvenOddDiracWilsonFermionForce() { }
+
+void EvenOddDiracWilsonFermionForce::derivative(extended_fermion_force_lattice_t& fermionForce, const extended_fermion_lattice_t& lattice, const extended_dirac_vector_t& X, const extended_dirac_vector_t& Y, real_t weight) {
+	//M_ee(twist)^-dagger = M_ee(-twist)^-1
+	this->extendToEven(extendedX, X, twist);
+	this->extendToEven(extendedY, Y, -twist);
+	FermionForce::derivative(fermionForce, lattice, extendedX, extendedY, weight);
+}
+
+void EvenOddDiracWilsonFermionForce::setLattice(const extended_fermion_lattice_t& _lattice) {
+	evenOddDiracWilsonOperator.setLattice(_lattice);
+}
+
+void EvenOddDiracWilsonFermionForce::extendToEven(extended_dirac_vector_t& output, const extended_dirac_vector_t& input, real_t _twist) {
+	typedef reduced_dirac_vector_t::Layout Layout;
+	oddVector = input;
+	evenOddDiracWilsonOperator.setTwist(_twist);
+	evenOddDiracWilsonOperator.multiplyEvenOdd(evenVector, oddVector, EVEN);
+	evenOddDiracWilsonOperator.multiplyDiagonalInverse(evenVector, EVEN);
+#pragma omp parallel for
+	for (int site = 0; site < Layout::completesize; ++site) {
+		if ((Layout::globalIndexX(site) + Layout::globalIndexY(site) + Layout::globalIndexZ(site) + Layout::globalIndexT(site)) % 2 == 0) {
+			for (unsigned int mu = 0; mu < 4; ++mu) evenVector[site][mu] = -evenVector[site][mu];
+		}
+	}
+	output = evenVector;
+}
+
+} /* namespace Update */
@@ -0,0 +1,38 @@
+#ifndef EVENODDDIRACWILSONFERMIONFORCE_H_
+#define EVENODDDIRACWILSONFERMIONFORCE_H_
+
+#include "DiracWilsonFermionForce.h"
+#include "dirac_operators/EvenOddDiracWilsonOperator.h"
+
+namespace Update {
+
+/**
+ * Force of the square of the Schur complement of EvenOddDiracWilsonOperator. The vectors X and Y, defined on the odd sites,
+ * are extended to the even sites with X_e = -M_ee^-1 M_eo X_o and Y_e = -M_ee^-dagger M_eo Y_o, so that the derivative of
+ * Y^dagger gamma5 (M_oo - M_oe M_ee^-1 M_eo) X is the one of the DiracWilson operator between the extended vectors.
+ */
+class EvenOddDiracWilsonFermionForce : public DiracWilsonFermionForce {
+public:
+	EvenOddDiracWilsonFermionForce(real_t _kappa, real_t _twist = 0.);
+	~EvenOddDiracWilsonFermionForce();
+
+	using DiracWilsonFermionForce::derivative;
+
+	virtual void derivative(extended_fermion_force_lattice_t& fermionForce, const extended_fermion_lattice_t& lattice, const extended_dirac_vector_t& X, const extended_dirac_vector_t& Y, real_t weight);
+
+	virtual void setLattice(const extended_fermion_lattice_t& _lattice);
+private:
+	//Extends the odd vector input to the even sites with -M_ee(twist)^-1 M_eo input_o
+	void extendToEven(extended_dirac_vector_t& output, const extended_dirac_vector_t& input, real_t twist);
+
+	EvenOddDiracWilsonOperator evenOddDiracWilsonOperator;
+	real_t twist;
+
+	reduced_dirac_vector_t oddVector;
+	reduced_dirac_vector_t evenVector;
+	extended_dirac_vector_t extendedX;
+	extended_dirac_vector_t extendedY;
+};
+
+} /* namespace Update */
+#endif /* EVENODDDIRACWILSONFERMIONFORCE_H_ */
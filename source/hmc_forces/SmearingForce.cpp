@@ -1,192 +1,115 @@
 #include "SmearingForce.h"
-#define REDUCTION 1.3
-#define MAXSIZE 25
+#include "utils/MatrixExponential.h"
+#include <vector>
 
 namespace Update {
 
-SmearingForce::SmearingForce() : StoutSmearing(), expMap() { }
+SmearingForce::SmearingForce() : StoutSmearing() { }
 
 SmearingForce::~SmearingForce() { }
 
-void SmearingForce::force(const extended_fermion_force_lattice_t& actionDerivative, const extended_gauge_lattice_t& originalUnsmearedLattice, extended_gauge_lattice_t& unsmearedDerivative, real_t rho) {
-	typedef extended_gauge_lattice_t LT;
-	
-#ifndef MULTITHREADING
-	extended_gauge_lattice_t unsmearedLattice = originalUnsmearedLattice;
-	for (int site = 0; site < unsmearedLattice.localsize; ++site) {
-#endif
-#ifdef MULTITHREADING
-	extended_gauge_lattice_t thUnsmearedLattice[omp_get_max_threads()];
-	for (int i = 0; i < omp_get_max_threads(); ++i) thUnsmearedLattice[i] = originalUnsmearedLattice;
+void SmearingForce::force(const extended_fermion_force_lattice_t& actionDerivative, const extended_gauge_lattice_t& unsmearedLattice, extended_gauge_lattice_t& unsmearedDerivative, real_t rho, int levels) {
+	//The links of all the levels are needed by the chain rule, smearedLattices[level] is smeared level + 1 times
+	std::vector<extended_gauge_lattice_t> smearedLattices(levels);
+	for (int level = 0; level < levels; ++level) {
+		this->smearing((level == 0) ? unsmearedLattice : smearedLattices[level - 1], smearedLattices[level], rho);
+	}
+
+	const extended_gauge_lattice_t& smearedLattice = (levels > 0) ? smearedLattices[levels - 1] : unsmearedLattice;
 #pragma omp parallel for
-	for (int site = 0; site < originalUnsmearedLattice.localsize; ++site) {
-		extended_gauge_lattice_t& unsmearedLattice = thUnsmearedLattice[omp_get_thread_num()];
-#endif
+	for (int site = 0; site < unsmearedLattice.localsize; ++site) {
 		for (unsigned int mu = 0; mu < 4; ++mu) {
-			set_to_zero(unsmearedDerivative[site][mu]);
-			//First term
-			for (int color = 0; color < numberColors*numberColors - 1; ++color) {
-				unsmearedDerivative[site][mu] += std::complex<real_t>(0,this->ridder(actionDerivative, unsmearedLattice, site, mu, color, site, mu, rho))*gaugeLieGenerators.get(color);
-			}
-
-			//Second term
-			for (unsigned int nu = 0; nu < 4; ++nu) {
-				if (nu != mu) {
-					for (int color = 0; color < numberColors*numberColors - 1; ++color) {
-						unsmearedDerivative[site][mu] += std::complex<real_t>(0,this->ridder(actionDerivative, unsmearedLattice, site, mu, color, LT::sup(site,mu), nu, rho))*gaugeLieGenerators.get(color);
-					}
-				}
-			}
-
-			//Third term
-			for (unsigned int nu = 0; nu < 4; ++nu) {
-				if (nu != mu) {
-					for (int color = 0; color < numberColors*numberColors - 1; ++color) {
-						unsmearedDerivative[site][mu] += std::complex<real_t>(0,this->ridder(actionDerivative, unsmearedLattice, site, mu, color, LT::sup(site,nu), mu, rho))*gaugeLieGenerators.get(color);
-					}
-				}
-			}
-
-			//Fourth term
-			for (unsigned int nu = 0; nu < 4; ++nu) {
-				if (nu != mu) {
-					for (int color = 0; color < numberColors*numberColors - 1; ++color) {
-						unsmearedDerivative[site][mu] += std::complex<real_t>(0,this->ridder(actionDerivative, unsmearedLattice, site, mu, color, site, nu, rho))*gaugeLieGenerators.get(color);
-					}
-				}
-			}
-
-			//Fifth term
-			for (unsigned int nu = 0; nu < 4; ++nu) {
-				if (nu != mu) {
-					for (int color = 0; color < numberColors*numberColors - 1; ++color) {
-						unsmearedDerivative[site][mu] += std::complex<real_t>(0,this->ridder(actionDerivative, unsmearedLattice, site, mu, color, LT::sup(LT::sdn(site,nu),mu), nu, rho))*gaugeLieGenerators.get(color);
-					}
-				}
-			}
+			unsmearedDerivative[site][mu] = this->linkDerivative(actionDerivative[site][mu], smearedLattice[site][mu]);
+		}
+	}
 
-			//Sixth term
-			for (unsigned int nu = 0; nu < 4; ++nu) {
-				if (nu != mu) {
-					for (int color = 0; color < numberColors*numberColors - 1; ++color) {
-						unsmearedDerivative[site][mu] += std::complex<real_t>(0,this->ridder(actionDerivative, unsmearedLattice, site, mu, color, LT::sdn(site,nu), mu, rho))*gaugeLieGenerators.get(color);
-					}
-				}
-			}
+	for (int level = levels - 1; level >= 0; --level) {
+		this->stoutDerivative((level == 0) ? unsmearedLattice : smearedLattices[level - 1], unsmearedDerivative, rho);
+	}
 
-			//Seventh term
-			for (unsigned int nu = 0; nu < 4; ++nu) {
-				if (nu != mu) {
-					for (int color = 0; color < numberColors*numberColors - 1; ++color) {
-						unsmearedDerivative[site][mu] += std::complex<real_t>(0,this->ridder(actionDerivative, unsmearedLattice, site, mu, color, LT::sdn(site,nu), nu, rho))*gaugeLieGenerators.get(color);
-					}
-				}
+	//The force is sum_a i T^a d/dw_a S(exp(i w T^a) U) = -(W - W^dagger)/4 + traces, with W = U Sigma
+#pragma omp parallel for
+	for (int site = 0; site < unsmearedLattice.localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			GaugeGroup W = unsmearedLattice[site][mu]*unsmearedDerivative[site][mu];
+			GaugeGroup force = -0.25*(W - htrans(W));
+			std::complex<real_t> trc = trace(force);
+			for (int i = 0; i < numberColors; ++i) {
+				force.at(i,i) -= trc/static_cast<real_t>(numberColors);
 			}
-
+			unsmearedDerivative[site][mu] = force;
 		}
 	}
 
 	unsmearedDerivative.updateHalo();
 }
 
-
-
-real_t SmearingForce::ridder(const extended_fermion_force_lattice_t& actionDerivative, extended_gauge_lattice_t& unsmearedLattice, int sited, unsigned int mud, int color, int site, unsigned int mu, real_t rho, real_t h) {
-	real_t a[MAXSIZE][MAXSIZE];
-	for (int m = 0; m < MAXSIZE; ++m) {
-		for (int n = 0; n < MAXSIZE; ++n) {
-			a[m][n] = 0;
+#ifdef ADJOINT
+GaugeGroup SmearingForce::linkDerivative(const FermionicForceMatrix& actionDerivative, const GaugeGroup& smearedLink) const {
+	//The adjoint link is V_ab = 2 Re tr(T^a V T^b V^dagger), so that Sigma = 4 sum_ab Re(D_ba) T^b V^dagger T^a
+	GaugeGroup result;
+	set_to_zero(result);
+	for (int b = 0; b < numberColors*numberColors - 1; ++b) {
+		GaugeGroup generatorSum;
+		set_to_zero(generatorSum);
+		for (int a = 0; a < numberColors*numberColors - 1; ++a) {
+			generatorSum += real(actionDerivative.at(b,a))*gaugeLieGenerators.get(a);
 		}
+		result += 4.*gaugeLieGenerators.get(b)*htrans(smearedLink)*generatorSum;
 	}
-
-	real_t err = 1000000.;
-	real_t factor = REDUCTION*REDUCTION;
-
-	GaugeGroup swap = unsmearedLattice[sited][mud];
-	
-	ForceVector tmp;
-	set_to_zero(tmp);
-	tmp[color] = h;
-	expMap.exp(tmp, unsmearedLattice[sited][mud]);
-	unsmearedLattice[sited][mud] = unsmearedLattice[sited][mud]*swap;
-#ifdef ADJOINT
-	FermionicGroup link;
-	ConvertLattice<extended_fermion_lattice_t,extended_gauge_lattice_t>::toAdjoint(this->smearLink(unsmearedLattice,site,mu,rho),link);
-	real_t plus = real(trace(actionDerivative[site][mu]*link));
-#endif
-#ifndef ADJOINT
-	real_t plus = real(trace(actionDerivative[site][mu]*this->smearLink(unsmearedLattice,site,mu,rho)));
-#endif
-	tmp[color] = -h;
-	expMap.exp(tmp, unsmearedLattice[sited][mud]);
-	unsmearedLattice[sited][mud] = unsmearedLattice[sited][mud]*swap;
-#ifdef ADJOINT
-	ConvertLattice<extended_fermion_lattice_t,extended_gauge_lattice_t>::toAdjoint(this->smearLink(unsmearedLattice,site,mu,rho),link);
-	real_t minus = real(trace(actionDerivative[site][mu]*link));
+	return result;
+}
 #endif
 #ifndef ADJOINT
-	real_t minus = real(trace(actionDerivative[site][mu]*this->smearLink(unsmearedLattice,site,mu,rho)));
+GaugeGroup SmearingForce::linkDerivative(const FermionicForceMatrix& actionDerivative, const GaugeGroup&) const {
+	return actionDerivative;
+}
 #endif
-	unsmearedLattice[sited][mud] = swap;
-	
-	a[0][0] = (plus - minus)/(2.*h);
 
+void SmearingForce::stoutDerivative(const extended_gauge_lattice_t& lattice, extended_gauge_lattice_t& derivative, real_t rho) {
+	typedef extended_gauge_lattice_t LT;
+	//Lambda is the traceless anti-hermitian part of the derivative of the exponential, staplesDerivative = rho Lambda^dagger U is the derivative of the action with respect to the staples
+	extended_gauge_lattice_t staplesDerivative, linkTerm;
 
-	real_t result = a[0][0];
-	
-	for (int m = 1; m < MAXSIZE; ++m) {
-		h = h/REDUCTION;
-		
-		swap = unsmearedLattice[sited][mud];
-		
-		tmp[color] = h;
-		expMap.exp(tmp, unsmearedLattice[sited][mud]);
-		unsmearedLattice[sited][mud] = unsmearedLattice[sited][mud]*swap;
-#ifdef ADJOINT
-		ConvertLattice<extended_fermion_lattice_t,extended_gauge_lattice_t>::toAdjoint(this->smearLink(unsmearedLattice,site,mu,rho),link);
-		plus = real(trace(actionDerivative[site][mu]*link));
-#endif
-#ifndef ADJOINT
-		plus = real(trace(actionDerivative[site][mu]*this->smearLink(unsmearedLattice,site,mu,rho)));
-#endif
-		tmp[color] = -h;
-		expMap.exp(tmp, unsmearedLattice[sited][mud]);
-		unsmearedLattice[sited][mud] = unsmearedLattice[sited][mud]*swap;
-#ifdef ADJOINT
-		ConvertLattice<extended_fermion_lattice_t,extended_gauge_lattice_t>::toAdjoint(this->smearLink(unsmearedLattice,site,mu,rho),link);
-		minus = real(trace(actionDerivative[site][mu]*link));
-#endif
-#ifndef ADJOINT
-		minus = real(trace(actionDerivative[site][mu]*this->smearLink(unsmearedLattice,site,mu,rho)));
-#endif
-		unsmearedLattice[sited][mud] = swap;
-		a[0][m] = (plus - minus)/(2.*h);
+#pragma omp parallel for
+	for (int site = 0; site < lattice.localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			GaugeGroup staple = wga.staple(lattice, site, mu);
+			GaugeGroup omega = rho*htrans(staple)*htrans(lattice[site][mu]);
+			GaugeGroup toExp = 0.5*(omega - htrans(omega));
+			toExp -= (trace(toExp)/static_cast<real_t>(numberColors))*identity;
 
-		factor = REDUCTION*REDUCTION;
+			GaugeGroup Gamma = exponentialDerivative<GaugeGroup, numberColors>(toExp, lattice[site][mu]*derivative[site][mu]);
+			GaugeGroup Lambda = 0.5*(Gamma - htrans(Gamma));
+			Lambda -= (trace(Lambda)/static_cast<real_t>(numberColors))*identity;
 
-		for (int n = 1; n <= m; ++n) {
-			a[n][m] = (a[n-1][m]*factor - a[n-1][m-1])/(factor-1.);
-			factor = REDUCTION*REDUCTION*factor;
-			real_t errt = std::max(std::abs(a[n][m] - a[n-1][m]),std::abs(a[n][m] - a[n-1][m-1]));
-			if (errt < err) {
-				err = errt;
-				result = a[n][m];
-			}
+			staplesDerivative[site][mu] = rho*htrans(Lambda)*lattice[site][mu];
+			linkTerm[site][mu] = derivative[site][mu]*exponential(toExp) - rho*staple*Lambda;
 		}
-	
-		if (std::abs(a[m][m] - a[m-1][m-1]) > 2*err) {
-			if (err > 0.0000001) {
-				std::cout << "SmearingForce::Bad convergence in " << m << " steps and error " << err << std::endl;
+	}
+	staplesDerivative.updateHalo();
+
+	//Every link enters in six terms of the staples of the neighbouring links
+#pragma omp parallel for
+	for (int site = 0; site < lattice.localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			GaugeGroup result = linkTerm[site][mu];
+			for (unsigned int nu = 0; nu < 4; ++nu) {
+				if (nu != mu) {
+					int down = LT::sdn(site,nu);
+					int upDown = LT::sup(down,mu);
+					result += htrans(lattice[upDown][nu])*htrans(lattice[down][mu])*staplesDerivative[down][nu];
+					result += htrans(lattice[upDown][nu])*htrans(staplesDerivative[down][mu])*lattice[down][nu];
+					result += lattice[LT::sup(site,mu)][nu]*htrans(lattice[LT::sup(site,nu)][mu])*htrans(staplesDerivative[site][nu]);
+					result += htrans(staplesDerivative[upDown][nu])*htrans(lattice[down][mu])*lattice[down][nu];
+					result += lattice[LT::sup(site,mu)][nu]*htrans(staplesDerivative[LT::sup(site,nu)][mu])*htrans(lattice[site][nu]);
+					result += staplesDerivative[LT::sup(site,mu)][nu]*htrans(lattice[LT::sup(site,nu)][mu])*htrans(lattice[site][nu]);
+				}
 			}
-			return result;
+			derivative[site][mu] = result;
 		}
 	}
-
-	if (err > 0.0000001) std::cout << "SmearingForce::Bad convergence in " << MAXSIZE << " steps and error " << err << std::endl;
-
-	
-	return result;
+	derivative.updateHalo();
 }
 
-
 } /* namespace Update */
@@ -1,21 +1,36 @@
 #ifndef SMEARINGFORCE_H_
 #define SMEARINGFORCE_H_
 #include "utils/StoutSmearing.h"
-#include "utils/EigenTraits.h"
-#include "utils/ExpMap.h"
+#include "utils/LieGenerators.h"
 
 namespace Update {
 
+/**
+ * Force of an action of the stout smeared links: the derivative with respect to the smeared links is
+ * carried back to the unsmeared links level by level with the analytic chain rule of Morningstar and Peardon.
+ */
 class SmearingForce : public StoutSmearing {
 public:
 	SmearingForce();
 	~SmearingForce();
 
-	void force(const extended_fermion_force_lattice_t& actionDerivative, const extended_gauge_lattice_t& unsmearedLattice, extended_gauge_lattice_t& unsmearedDerivative, real_t rho);
+	/**
+	 * This function computes the force on unsmearedLattice of the action Re tr(actionDerivative V),
+	 * where V are the links smeared levels times with parameter rho
+	 * @param actionDerivative the derivative of the action with respect to the smeared links
+	 * @param unsmearedLattice
+	 * @param unsmearedDerivative the resulting force
+	 * @param rho
+	 * @param levels
+	 */
+	void force(const extended_fermion_force_lattice_t& actionDerivative, const extended_gauge_lattice_t& unsmearedLattice, extended_gauge_lattice_t& unsmearedDerivative, real_t rho, int levels = 1);
 private:
-	real_t ridder(const extended_fermion_force_lattice_t& actionDerivative, extended_gauge_lattice_t& unsmearedLattice, int sited, unsigned int mud, int color, int site, unsigned int mu, real_t rho, real_t h = 0.05);
+	//Derivative Sigma of the action with respect to the fundamental smeared link, delta S = Re tr(Sigma delta V)
+	GaugeGroup linkDerivative(const FermionicForceMatrix& actionDerivative, const GaugeGroup& smearedLink) const;
+
+	//One level of the chain rule: derivative holds Sigma of the links smeared from lattice and it is replaced by Sigma of lattice
+	void stoutDerivative(const extended_gauge_lattice_t& lattice, extended_gauge_lattice_t& derivative, real_t rho);
 
-	ExponentialMap expMap;
 	LieGenerator<GaugeGroup> gaugeLieGenerators;
 };
 
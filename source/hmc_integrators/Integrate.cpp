@@ -4,12 +4,7 @@
 #include "SixthOrderLeapFrog.h"
 #include "OmelyanLeapFrog.h"
 #include "FourthOmelyanLeapFrog.h"
-#ifdef EIGEN
-#include <Eigen/Eigenvalues>
-#endif
-#ifdef ARMADILLO
-
-#endif
+#include "utils/MatrixExponential.h"
 
 namespace Update {
 
@@ -21,31 +16,7 @@ void Integrate::updateLinkConfiguration(extended_gauge_lattice_t& linkConfigurat
 #pragma omp parallel for
 	for (int site = 0; site < linkConfiguration.localsize; ++site) {
 		for (unsigned int mu = 0; mu < 4; ++mu) {
-#ifdef EIGEN
-			Eigen::ComplexEigenSolver<GaugeGroup> es(momenta[site][mu]);
-			GaugeGroup update;
-			update.zeros();
-			for (int i = 0; i < numberColors; ++i) {
-				update.at(i,i) = exp(epsilon*es.eigenvalues()[i]);
-			}
-			GaugeGroup m = es.eigenvectors();
-			GaugeGroup updatenew = m * update * htrans(m);
-#endif
-#ifdef ARMADILLO
-			FundamentalVector eigval;
-			GaugeGroup eigvec;
-			arma::eig_gen(eigval, eigvec, momenta[site][mu]);
-			GaugeGroup update;
-			set_to_zero(update);
-			for (int i = 0; i < numberColors; ++i) {
-				update.at(i,i) = exp(epsilon*eigval[i]);
-			}
-			GaugeGroup updatenew = eigvec * update * htrans(eigvec);
-			//std::cout << updatenew << std::endl << std::endl;
-#endif
-#ifdef MATRIXTOOLKIT
-			GaugeGroup updatenew = matrix_exp(epsilon*momenta[site][mu]);
-#endif
+			GaugeGroup updatenew = exponential(epsilon*momenta[site][mu]);
 			linkConfiguration[site][mu] = updatenew*linkConfiguration[site][mu];
 		}
 	}
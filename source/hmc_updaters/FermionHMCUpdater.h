@@ -10,21 +10,8 @@ public:
 	FermionHMCUpdater();
 	~FermionHMCUpdater();
 
+	//Gaussian vector normalized to exp(-|x|^2), independent on the number of threads and processors
 	void generateGaussianDiracVector(extended_dirac_vector_t& vector);
-
-private:
-#ifndef MULTITHREADING
-	//The generator of random numbers
-	random_generator_t randomGenerator;
-	//The generator of normal random numbers
-	random_normal_generator_t randomNormal;
-#endif
-#ifdef MULTITHREADING
-	//The generators of random numbers
-	random_generator_t** randomGenerator;
-	//The generators of normal random numbers
-	random_normal_generator_t** randomNormal;
-#endif
 };
 
 } /* namespace Update */
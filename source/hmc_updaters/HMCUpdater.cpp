@@ -3,48 +3,24 @@
 
 namespace Update {
 
-HMCUpdater::HMCUpdater()
-#ifndef MULTITHREADING
-	: randomGenerator(RandomSeed::randomSeed()), randomNormal(RandomSeed::getNormalNumberGenerator(randomGenerator)), randomUniform(RandomSeed::getRandomNumberGenerator(randomGenerator)), acceptance(0), counter(0) { }
-#endif
-#ifdef MULTITHREADING
-	: singleRandomGenerator(RandomSeed::randomSeed()), randomUniform(RandomSeed::getRandomNumberGenerator(singleRandomGenerator)), acceptance(0), counter(0) {
-		randomGenerator = new random_generator_t*[omp_get_max_threads()];
-		randomNormal = new random_normal_generator_t*[omp_get_max_threads()];
-		for (int i = 0; i < omp_get_max_threads(); ++i) {
-			randomGenerator[i] = new random_generator_t(RandomSeed::randomSeed());
-			randomNormal[i] = new random_normal_generator_t(RandomSeed::getNormalNumberGenerator(*randomGenerator[i]));
-		}
-	}
-#endif
+HMCUpdater::HMCUpdater() : acceptance(0), counter(0) { }
 
 HMCUpdater::~HMCUpdater() {
 	if (isOutputProcess()) std::cout << "Acceptance rate: " << static_cast<double>(acceptance)/counter << std::endl;
-#ifdef MULTITHREADING
-	for (int i = 0; i < omp_get_max_threads(); ++i) {
-		delete randomGenerator[i];
-		delete randomNormal[i];
-	}
-	delete[] randomGenerator;
-	delete[] randomNormal;
-#endif
 }
 
 void HMCUpdater::randomMomenta(extended_gauge_lattice_t& momenta) {
+	//The momenta depend only on the global sites, not on the number of threads and processors
+	boost::uint32_t stream = CounterRandomGenerator::nextStream();
 #pragma omp parallel for
 	for (int position = 0; position < momenta.localsize; ++position) {
+		CounterRandomGenerator generator(stream, CounterRandomGenerator::globalIndex<extended_gauge_lattice_t::Layout>(position));
 		for (unsigned int mu = 0; mu < 4; ++mu) {
 			//Antihermitian part
 			for (int i = 0; i < numberColors; ++i) {
 				for (int j = i+1; j < numberColors; ++j) {
-#ifndef MULTITHREADING
-					real_t realPart = randomNormal()/2.;
-					real_t imagPart = randomNormal()/2.;
-#endif
-#ifdef MULTITHREADING
-					real_t realPart = (*randomNormal[omp_get_thread_num()])()/2.;
-					real_t imagPart = (*randomNormal[omp_get_thread_num()])()/2.;
-#endif
+					real_t realPart = generator.normal()/2.;
+					real_t imagPart = generator.normal()/2.;
 					momenta[position][mu].at(i,j) = std::complex<real_t>(realPart,imagPart);
 					momenta[position][mu].at(j,i) = std::complex<real_t>(-realPart,imagPart);
 				}
@@ -54,12 +30,7 @@ void HMCUpdater::randomMomenta(extended_gauge_lattice_t& momenta) {
 			}
 			//Antihermitian Traceless part
 			for (int i = 1; i < numberColors; ++i) {
-#ifndef MULTITHREADING
-				real_t imagPart = randomNormal()/2.;
-#endif
-#ifdef MULTITHREADING
-				real_t imagPart = (*randomNormal[omp_get_thread_num()])()/2.;
-#endif
+				real_t imagPart = generator.normal()/2.;
 				for (int j = 0; j < i; ++j) {
 					momenta[position][mu].at(j,j) += std::complex<real_t>( 0, imagPart/sqrt(static_cast<real_t>(i*(i+1)/2.)) );
 				}
@@ -72,6 +43,8 @@ void HMCUpdater::randomMomenta(extended_gauge_lattice_t& momenta) {
 
 bool HMCUpdater::metropolis(long_real_t energyOld, long_real_t energyNew) {
 	int decision = 0;
+	//Every processor takes the stream, only the output process draws the number
+	CounterRandomGenerator generator(CounterRandomGenerator::nextStream(), 0);
 	if (isOutputProcess()) {
 		++counter;
 		long_real_t delta = energyNew - energyOld;
@@ -80,7 +53,7 @@ bool HMCUpdater::metropolis(long_real_t energyOld, long_real_t energyNew) {
 			++acceptance;
 			decision = 1;
 		}
-		else if (randomUniform() < exp(-delta)) {
+		else if (generator.uniform() < exp(-delta)) {
 			++acceptance;
 			decision = 1;
 		}
@@ -101,6 +74,7 @@ bool HMCUpdater::metropolis(long_real_t energyOld, long_real_t energyNew) {
 
 bool HMCUpdater::metropolis(long_real_t value) {
 	int decision = 0;
+	CounterRandomGenerator generator(CounterRandomGenerator::nextStream(), 0);
 	if (isOutputProcess()) {
 		++counter;
 		std::cout << "Metropolis distribution: min(1," << value << ") ";
@@ -108,7 +82,7 @@ bool HMCUpdater::metropolis(long_real_t value) {
 			++acceptance;
 			decision = 1;
 		}
-		else if (randomUniform() < value) {
+		else if (generator.uniform() < value) {
 			++acceptance;
 			decision = 1;
 		}
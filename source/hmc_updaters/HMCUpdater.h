@@ -1,7 +1,7 @@
 #ifndef HMCUPDATER_H_
 #define HMCUPDATER_H_
 #include "Environment.h"
-#include "utils/RandomSeed.h"
+#include "utils/CounterRandomGenerator.h"
 
 namespace Update {
 
@@ -36,22 +36,6 @@ public:
 	
 	bool metropolis(long_real_t value);
 private:
-#ifndef MULTITHREADING
-	//The generator of random numbers
-	random_generator_t randomGenerator;
-	//The generator of normal random numbers
-	random_normal_generator_t randomNormal;
-#endif
-#ifdef MULTITHREADING
-	//The generators of random numbers
-	random_generator_t** randomGenerator;
-	//The generators of normal random numbers
-	random_normal_generator_t** randomNormal;
-	//The generator of random numbers
-	random_generator_t singleRandomGenerator;
-#endif
-	//The generator of uniform random numbers
-	random_uniform_generator_t randomUniform;
 	//Acceptance for the metropolis steps
 	unsigned int acceptance;
 	//Global counter for the metropolis steps
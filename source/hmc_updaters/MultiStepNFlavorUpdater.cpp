@@ -24,13 +24,14 @@
 
 namespace Update {
 
-MultiStepNFlavorUpdater::MultiStepNFlavorUpdater() : LatticeSweep(), nFlavorAction(0), gaugeAction(0), fermionAction(0), squareDiracOperatorMetropolis(0), diracOperatorMetropolis(0), squareDiracOperatorForce(0), diracOperatorForce(0), multishiftSolver(0), blackBlockDiracOperator(0), redBlockDiracOperator(0) { }
+MultiStepNFlavorUpdater::MultiStepNFlavorUpdater() : LatticeSweep(), nFlavorAction(0), gaugeAction(0), fermionAction(0), squareDiracOperatorMetropolis(0), diracOperatorMetropolis(0), squareDiracOperatorForce(0), diracOperatorForce(0), multishiftSolver(0), forceMultishiftSolver(0), blackBlockDiracOperator(0), redBlockDiracOperator(0) { }
 
-MultiStepNFlavorUpdater::MultiStepNFlavorUpdater(const MultiStepNFlavorUpdater& toCopy) : LatticeSweep(toCopy), nFlavorAction(0), gaugeAction(0), fermionAction(0), squareDiracOperatorMetropolis(0), diracOperatorMetropolis(0), squareDiracOperatorForce(0), diracOperatorForce(0), multishiftSolver(0) { }
+MultiStepNFlavorUpdater::MultiStepNFlavorUpdater(const MultiStepNFlavorUpdater& toCopy) : LatticeSweep(toCopy), nFlavorAction(0), gaugeAction(0), fermionAction(0), squareDiracOperatorMetropolis(0), diracOperatorMetropolis(0), squareDiracOperatorForce(0), diracOperatorForce(0), multishiftSolver(0), forceMultishiftSolver(0), blackBlockDiracOperator(0), redBlockDiracOperator(0) { }
 
 MultiStepNFlavorUpdater::~MultiStepNFlavorUpdater() {
 	if (nFlavorAction != 0) delete nFlavorAction;
 	if (multishiftSolver != 0) delete multishiftSolver;
+	if (forceMultishiftSolver != 0) delete forceMultishiftSolver;
 	if (blackBlockDiracOperator != 0) delete blackBlockDiracOperator;
 	if (redBlockDiracOperator != 0) delete redBlockDiracOperator;
 }
@@ -61,6 +62,15 @@ void MultiStepNFlavorUpdater::initializeApproximations(environment_t& environmen
 			multishiftMultiGridSolver->setSAPPrecision(environment.configurations.get<real_t>("MultiStepNFlavorUpdater::sap_inverter_precision"));
 			multishiftMultiGridSolver->setGMRESIterations(environment.configurations.get<unsigned int>("MultiStepNFlavorUpdater::gmres_inverter_max_steps"));
 			multishiftMultiGridSolver->setGMRESPrecision(environment.configurations.get<real_t>("MultiStepNFlavorUpdater::gmres_inverter_precision"));
+			multishiftMultiGridSolver->setBasisUpdateIterations(environment.configurations.get<unsigned int>("MultiStepNFlavorUpdater::multigrid_basis_update_steps"));
+			multishiftMultiGridSolver->setRebuildThreshold(environment.configurations.get<real_t>("MultiStepNFlavorUpdater::multigrid_rebuild_threshold"));
+			multishiftMultiGridSolver->setNumberLevels(environment.configurations.get<unsigned int>("MultiStepNFlavorUpdater::multigrid_levels"));
+			multishiftMultiGridSolver->getHierarchy()->setBlockSize(environment.configurations.get< std::vector<unsigned int> >("MultiStepNFlavorUpdater::multigrid_coarse_block_size"));
+			multishiftMultiGridSolver->getHierarchy()->setBasisDimension(environment.configurations.get<unsigned int>("MultiStepNFlavorUpdater::multigrid_coarse_basis_dimension"));
+			multishiftMultiGridSolver->getHierarchy()->setSteps(environment.configurations.get<unsigned int>("MultiStepNFlavorUpdater::multigrid_coarse_steps"));
+			multishiftMultiGridSolver->getHierarchy()->setPrecision(environment.configurations.get<real_t>("MultiStepNFlavorUpdater::multigrid_coarse_precision"));
+			multishiftMultiGridSolver->getHierarchy()->setCoarsestSteps(environment.configurations.get<unsigned int>("MultiStepNFlavorUpdater::multigrid_coarsest_steps"));
+			multishiftMultiGridSolver->getHierarchy()->setAgglomerationSize(environment.configurations.get<unsigned int>("MultiStepNFlavorUpdater::multigrid_agglomeration_size"));
 
 			multishiftMultiGridSolver->initializeBasis(diracOperator);			
 			multishiftSolver = multishiftMultiGridSolver;
@@ -74,8 +84,18 @@ void MultiStepNFlavorUpdater::initializeApproximations(environment_t& environmen
 	}
 	else {
 		if (environment.configurations.get<std::string>("MultiStepNFlavorUpdater::multigrid") == "true") {
+			//The basis of the previous trajectory is smoothed on the new configuration, it is built again only when the inversions degrade
+			DiracOperator* diracOperator = DiracOperator::getInstance(environment.configurations.get<std::string>("dirac_operator"), 1, environment.configurations);
+			diracOperator->setLattice(environment.getFermionLattice());
+			diracOperator->setGamma5(false);
+			blackBlockDiracOperator->setLattice(environment.getFermionLattice());
+			redBlockDiracOperator->setLattice(environment.getFermionLattice());
+
 			MultiGridMEMultishiftSolver* multishiftMultiGridSolver = dynamic_cast<MultiGridMEMultishiftSolver*>(multishiftSolver);
-			multishiftMultiGridSolver->initializeBasis(diracOperatorMetropolis);
+			if (environment.configurations.get<unsigned int>("MultiStepNFlavorUpdater::multigrid_basis_update_steps") == 0) multishiftMultiGridSolver->initializeBasis(diracOperator);
+			else multishiftMultiGridSolver->refreshBasis(diracOperator);
+
+			delete diracOperator;
 		}
 	}
 	//First take the rational function approximation for the heatbath step
@@ -129,6 +149,16 @@ void MultiStepNFlavorUpdater::initializeApproximations(environment_t& environmen
 		if (isOutputProcess()) std::cout << "MultiStepNFlavorUpdater::Warning, a single precision is provided for all the level of the force!" << std::endl;
 	}
 
+	//The initial guesses extrapolated from the previous steps need a multishift solver that starts from its input solutions
+	if (forceMultishiftSolver == 0 && environment.configurations.get<unsigned int>("force_inverter_history") != 0) {
+		if (environment.configurations.get<std::string>("MultiStepNFlavorUpdater::multigrid") == "true") {
+			if (isOutputProcess()) std::cout << "MultiStepNFlavorUpdater::Warning, the history of the force inversions is not used by the multigrid inverter!" << std::endl;
+		}
+		else {
+			forceMultishiftSolver = MultishiftSolver::getInstance("chronological_mass_estrapolation");
+		}
+	}
+
 	//Then take the rational function approximation for the force step
 	if (rationalApproximationsForce.empty()) {
 
@@ -137,7 +167,7 @@ void MultiStepNFlavorUpdater::initializeApproximations(environment_t& environmen
 			std::vector<RationalApproximation> levelRationaApproximationForce;
 			for (int j = 1; j <= numberPseudofermions; ++j) {
 				std::vector<real_t> rat = environment.configurations.get< std::vector<real_t> >(std::string("force_rational_fraction_")+toString(j)+"_level_"+toString(i));
-				RationalApproximation rational(multishiftSolver);
+				RationalApproximation rational(forceMultishiftSolver != 0 ? forceMultishiftSolver : multishiftSolver);
 				rational.setAlphas(std::vector<real_t>(rat.begin(), rat.begin() + rat.size()/2));
 				rational.setBetas(std::vector<real_t>(rat.begin() + rat.size()/2, rat.end()));
 				//We apply the twist
@@ -285,6 +315,15 @@ void MultiStepNFlavorUpdater::execute(environment_t& environment) {
 		}
 	}
 
+	//The pseudofermions are new, the solutions of the previous trajectory cannot be used as initial guesses
+	if (forceMultishiftSolver != 0) {
+		int numberLevels = environment.configurations.get< unsigned int >("number_force_levels");
+		for (int j = 0; j < numberLevels; ++j) {
+			fermionAction[j]->setHistorySize(environment.configurations.get<unsigned int>("force_inverter_history"));
+			fermionAction[j]->clearHistory();
+		}
+	}
+
 
 	//Take the global action
 	if (nFlavorAction == 0) nFlavorAction = new NFlavorAction(gaugeAction, fermionAction[0]);//Here we skip the other forces
@@ -408,6 +447,15 @@ void MultiStepNFlavorUpdater::registerParameters(po::options_description& desc)
 		("MultiStepNFlavorUpdater::multigrid", po::value<std::string>()->default_value("false"), "Should we use the multigrid inverter? true/false")
 		("MultiStepNFlavorUpdater::multigrid_basis_dimension", po::value<unsigned int>()->default_value(20), "The dimension of the basis for multigrid")
 		("MultiStepNFlavorUpdater::multigrid_block_size", po::value<std::string>()->default_value("{4,4,4,4}"), "Block size for Multigrid (syntax: {bx,by,bz,bt})")
+		("MultiStepNFlavorUpdater::multigrid_basis_update_steps", po::value<unsigned int>()->default_value(20), "The GMRES steps used to smooth the multigrid basis of the previous trajectory on the new configuration (0 builds the basis from scratch at every trajectory)")
+		("MultiStepNFlavorUpdater::multigrid_rebuild_threshold", po::value<double>()->default_value(1.5), "The basis is built from scratch when the average multigrid iterations grow by this factor since the last full setup")
+		("MultiStepNFlavorUpdater::multigrid_levels", po::value<unsigned int>()->default_value(2), "The number of levels of the multigrid, the fine one included (more than two requires a nearest neighbour dirac operator)")
+		("MultiStepNFlavorUpdater::multigrid_coarse_block_size", po::value<std::string>()->default_value("{2,2,2,2}"), "The sites of a coarse level aggregated in a site of the next one (syntax: {bx,by,bz,bt})")
+		("MultiStepNFlavorUpdater::multigrid_coarse_basis_dimension", po::value<unsigned int>()->default_value(24), "The dimension of the basis of the coarse levels")
+		("MultiStepNFlavorUpdater::multigrid_coarse_steps", po::value<unsigned int>()->default_value(10), "The maximum number of GCR steps on the intermediate coarse levels")
+		("MultiStepNFlavorUpdater::multigrid_coarse_precision", po::value<double>()->default_value(0.1), "The relative precision of the coarse level solves")
+		("MultiStepNFlavorUpdater::multigrid_coarsest_steps", po::value<unsigned int>()->default_value(50), "The maximum number of GCR steps on the coarsest level")
+		("MultiStepNFlavorUpdater::multigrid_agglomeration_size", po::value<unsigned int>()->default_value(16), "The coarsest level is agglomerated on fewer processors when it has less local sites than this")
 
 		("MultiStepNFlavorUpdater::sap_block_size", po::value<std::string>()->default_value("{4,4,4,4}"), "Block size for SAP (syntax: {bx,by,bz,bt})")
 		("MultiStepNFlavorUpdater::sap_iterations", po::value<unsigned int>()->default_value(5), "The number of sap iterations")
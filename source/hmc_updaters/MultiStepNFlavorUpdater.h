@@ -53,6 +53,8 @@ protected:
 	DiracOperator* diracOperatorForce;
 
 	MultishiftSolver* multishiftSolver;
+	//The chronological solver of the force, used when the solutions of the previous steps are stored
+	MultishiftSolver* forceMultishiftSolver;
 	BlockDiracOperator* blackBlockDiracOperator;
 	BlockDiracOperator* redBlockDiracOperator;
 };
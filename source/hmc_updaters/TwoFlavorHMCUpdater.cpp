@@ -37,8 +37,8 @@ void TwoFlavorHMCUpdater::execute(environment_t& environment) {
 	if (diracOperator == 0) diracOperator = DiracOperator::getInstance(environment.configurations.get<std::string>("dirac_operator"), 1, environment.configurations);
 	diracOperator->setLattice(environment.getFermionLattice());
 
-	//Heat bath by multiply the tmp_pseudofermion with the dirac operator
-	diracOperator->multiply(pseudofermion, tmp_pseudofermion);
+	//Heat bath by multiply the tmp_pseudofermion with the dirac operator, the pseudofermion is read only on the local sites
+	diracOperator->multiply(pseudofermion, tmp_pseudofermion, false);
 
 	//Get the gauge action
 	if (gaugeAction == 0) gaugeAction = GaugeAction::getInstance(environment.configurations.get<std::string>("name_action"),environment.configurations.get<double>("beta"));
@@ -48,6 +48,7 @@ void TwoFlavorHMCUpdater::execute(environment_t& environment) {
 	//Get the fermion action
 	if (fermionAction == 0) {
 		fermionAction = new TwoFlavorFermionAction(diracOperator);
+		fermionAction->setForceSolver(Solver::getInstance(environment.configurations.get<std::string>("force_inverter")));
 	}
 	else {
 		fermionAction->setDiracOperator(diracOperator);
@@ -55,6 +56,9 @@ void TwoFlavorHMCUpdater::execute(environment_t& environment) {
 
 	fermionAction->setPseudoFermion(&pseudofermion);
 	fermionAction->setForcePrecision(environment.configurations.get<double>("force_inverter_precision"));
+	//The pseudofermion is new, the solutions of the previous trajectory cannot be used as initial guesses
+	fermionAction->setHistorySize(environment.configurations.get<unsigned int>("force_inverter_history"));
+	fermionAction->clearHistory();
 
 	//Get the global action
 	if (action == 0) {
@@ -347,6 +347,43 @@ bool BiConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector
 	//residual.updateHalo();
 	//residual_hat.updateHalo();
 
+	long_real_t error;
+	bool result = iterate<real_t>(dirac, source, solution, residual, residual_hat, p, nu, s, t, precision, maxSteps, lastSteps, error);
+	lastError = error;
+	if (!result && isOutputProcess()) std::cout << "BiConjugateGradient::Failure in finding convergence after " << maxSteps << " cicles, last error: " << lastError << std::endl;
+	return result;
+}
+
+
+bool BiConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, const std::complex<real_t>& shift, reduced_dirac_vector_t const* initial_guess) {
+	//First set the initial solution
+	if (initial_guess == 0) {
+		long_real_t normSource = AlgebraUtils::squaredNorm(source);
+		if (normSource > precision) {
+			solution = source;
+		}
+		else {
+			AlgebraUtils::generateRandomVector(solution);
+		}
+	} else {
+		solution = *initial_guess;
+	}
+	
+	//Use p as temporary vector
+	dirac->multiplyAdd(p,solution,solution,shift);
+
+	//Set the initial residual to source-A.solution and residual_hat accordingly
+#pragma omp parallel for
+	for (int site = 0; site < solution.localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			residual[site][mu] = source[site][mu] - p[site][mu];
+			residual_hat[site][mu] = source[site][mu] + p[site][mu];
+		}
+	}
+
+	residual.updateHalo();
+	residual_hat.updateHalo();
+
 	//Set nu and p to zero
 #pragma omp parallel for
 	for (int site = 0; site < solution.completesize; ++site) {
@@ -380,7 +417,7 @@ bool BiConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector
 
 		if (norm(rho_next) == 0.) {
 			if (isOutputProcess()) std::cout << "BiConjugateGradient::Fatal error in norm " << rho_next << " at step " << step << std::endl;
-			return false;
+			return false;//TODO
 		}
 
 		std::complex<real_t> beta = static_cast< std::complex<real_t> >((rho_next/rho))*(alpha/omega);
@@ -394,7 +431,7 @@ bool BiConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector
 		//p.updateHalo();
 
 		//nu = A.p[[k]]
-		dirac->multiply(nu,p);
+		dirac->multiplyAdd(nu,p,p,shift);
 
 		//alpha = rho[[k]]/(rhat[[1]].nu[[k]]);
 		long_real_t alphatmp_re = 0.;
@@ -423,7 +460,7 @@ bool BiConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector
 		//s.updateHalo();
 
 		//t = A.s;
-		dirac->multiply(t,s);
+		dirac->multiplyAdd(t,s,s,shift);
 
 		//omega = (t.s)/(t.t)
 		long_real_t tmp1_re = 0., tmp1_im = 0., tmp2_re = 0., tmp2_im = 0.;
@@ -477,13 +514,7 @@ bool BiConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector
 			}
 		}
 		reduceAllSum(norm);
-		//residual.updateHalo();//TODO maybe not needed
-#pragma omp parallel for
-		for (int site = solution.localsize; site < solution.completesize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				residual[site][mu] = s[site][mu] - omega*(t[site][mu]);
-			}
-		}
+		residual.updateHalo();
 
 
 		if (norm < precision) {
@@ -506,187 +537,232 @@ bool BiConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector
 	return false;
 }
 
+bool BiConjugateGradient::solve(DiracOperator* dirac, const std::vector<reduced_dirac_vector_t>& sources, std::vector<reduced_dirac_vector_t>& solutions) {
+	const int size = sources.size();
+	solutions.resize(size);
+	if (static_cast<int>(blockResidual.size()) < size) {
+		blockResidual.resize(size);
+		blockResidualHat.resize(size);
+		blockP.resize(size);
+		blockNu.resize(size);
+		blockT.resize(size);
+	}
 
-bool BiConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, const std::complex<real_t>& shift, reduced_dirac_vector_t const* initial_guess) {
-	//First set the initial solution
-	if (initial_guess == 0) {
-		long_real_t normSource = AlgebraUtils::squaredNorm(source);
-		if (normSource > precision) {
-			solution = source;
+	//The local parts of the dot products of all the systems, summed with a single reduction
+	std::vector<long_real_t> reductions(3*size + 1);
+
+	//First set the initial solutions
+	for (int i = 0; i < size; ++i) {
+		long_real_t normSource = 0.;
+#pragma omp parallel for reduction(+:normSource)
+		for (int site = 0; site < sources[i].localsize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				normSource += real(vector_dot(sources[i][site][mu],sources[i][site][mu]));
+			}
+		}
+		reductions[i] = normSource;
+	}
+	reduceAllSum(&reductions[0], size);
+	for (int i = 0; i < size; ++i) {
+		if (reductions[i] > precision) {
+			solutions[i] = sources[i];
 		}
 		else {
-			AlgebraUtils::generateRandomVector(solution);
+			AlgebraUtils::generateRandomVector(solutions[i]);
 		}
-	} else {
-		solution = *initial_guess;
 	}
-	
-	//Use p as temporary vector
-	dirac->multiplyAdd(p,solution,solution,shift);
 
-	//Set the initial residual to source-A.solution and residual_hat accordingly
-#pragma omp parallel for
-	for (int site = 0; site < solution.localsize; ++site) {
-		for (unsigned int mu = 0; mu < 4; ++mu) {
-			residual[site][mu] = source[site][mu] - p[site][mu];
-			residual_hat[site][mu] = source[site][mu] + p[site][mu];
-		}
+	//The systems not yet converged and the vectors given to multiplyBlock
+	std::vector<int> active(size);
+	std::vector<reduced_dirac_vector_t*> outputs(size);
+	std::vector<const reduced_dirac_vector_t*> inputs(size);
+	for (int i = 0; i < size; ++i) {
+		active[i] = i;
+		outputs[i] = &blockP[i];
+		inputs[i] = &solutions[i];
 	}
 
-	residual.updateHalo();
-	residual_hat.updateHalo();
+	//Use p as temporary vector
+	dirac->multiplyBlock(outputs, inputs);
 
-	//Set nu and p to zero
+	//Set the initial residual to source-A.solution and residual_hat accordingly, nu and p to zero
+	for (int i = 0; i < size; ++i) {
 #pragma omp parallel for
-	for (int site = 0; site < solution.completesize; ++site) {
-		for (unsigned int mu = 0; mu < 4; ++mu) {
-			set_to_zero(p[site][mu]);
-			set_to_zero(nu[site][mu]);
+		for (int site = 0; site < sources[i].completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				blockResidual[i][site][mu] = sources[i][site][mu] - blockP[i][site][mu];
+				blockResidualHat[i][site][mu] = sources[i][site][mu] + blockP[i][site][mu];
+				set_to_zero(blockP[i][site][mu]);
+				set_to_zero(blockNu[i][site][mu]);
+			}
 		}
-	}
-
-	//Set the initial parameter of the program
-	std::complex<real_t> alpha = 1., omega = 1.;
-	std::complex<long_real_t> rho = 1.;
-	unsigned int step = 0;
-
-	while (step < maxSteps) {
-		//rho[k] = rhat.r[k-1]
-		long_real_t rho_next_re = 0.;
-		long_real_t rho_next_im = 0.;
+		//rho[k] = rhat.r[k-1], the real and the imaginary parts are stored in reductions[2*i] and reductions[2*i+1]
+		long_real_t rho_next_re = 0., rho_next_im = 0.;
 #pragma omp parallel for reduction(+:rho_next_re, rho_next_im)
-		for (int site = 0; site < solution.localsize; ++site) {
+		for (int site = 0; site < sources[i].localsize; ++site) {
 			for (unsigned int mu = 0; mu < 4; ++mu) {
-				complex partial = vector_dot(residual_hat[site][mu],residual[site][mu]);
+				complex partial = vector_dot(blockResidualHat[i][site][mu],blockResidual[i][site][mu]);
 				rho_next_re += real(partial);
 				rho_next_im += imag(partial);
 			}
 		}
-		reduceAllSum(rho_next_re);
-		reduceAllSum(rho_next_im);
+		reductions[2*i] = rho_next_re;
+		reductions[2*i+1] = rho_next_im;
+	}
+	reduceAllSum(&reductions[0], 2*size);
 
-		std::complex<long_real_t> rho_next(rho_next_re,rho_next_im);
+	//Set the initial parameter of the program
+	std::vector< std::complex<real_t> > alpha(size, 1.), omega(size, 1.);
+	std::vector< std::complex<long_real_t> > rho(size, 1.);
+	unsigned int step = 0;
+	lastError = 0.;
+	lastSteps = 0;
 
-		if (norm(rho_next) == 0.) {
-			if (isOutputProcess()) std::cout << "BiConjugateGradient::Fatal error in norm " << rho_next << " at step " << step << std::endl;
-			return false;//TODO
-		}
+	while (step < maxSteps && !active.empty()) {
+		const int activeSize = active.size();
+		outputs.resize(activeSize);
+		inputs.resize(activeSize);
 
-		std::complex<real_t> beta = static_cast< std::complex<real_t> >((rho_next/rho))*(alpha/omega);
-		//p = r[[k - 1]] + beta*(p[[k - 1]] - omega[[k - 1]]*nu[[k - 1]])
+		for (int k = 0; k < activeSize; ++k) {
+			const int i = active[k];
+			std::complex<long_real_t> rho_next(reductions[2*k],reductions[2*k+1]);
+			if (norm(rho_next) == 0.) {
+				if (isOutputProcess()) std::cout << "BiConjugateGradient::Fatal error in norm " << rho_next << " at step " << step << " of the system " << i << std::endl;
+				return false;
+			}
+
+			std::complex<real_t> beta = static_cast< std::complex<real_t> >((rho_next/rho[i]))*(alpha[i]/omega[i]);
+			rho[i] = rho_next;
+			//p = r[[k - 1]] + beta*(p[[k - 1]] - omega[[k - 1]]*nu[[k - 1]])
 #pragma omp parallel for
-		for (int site = 0; site < solution.completesize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				p[site][mu] = residual[site][mu] + beta*(p[site][mu] - omega*nu[site][mu]);
+			for (int site = 0; site < solutions[i].completesize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					blockP[i][site][mu] = blockResidual[i][site][mu] + beta*(blockP[i][site][mu] - omega[i]*blockNu[i][site][mu]);
+				}
 			}
+			outputs[k] = &blockNu[i];
+			inputs[k] = &blockP[i];
 		}
-		//p.updateHalo();
 
 		//nu = A.p[[k]]
-		dirac->multiplyAdd(nu,p,p,shift);
+		dirac->multiplyBlock(outputs, inputs);
 
 		//alpha = rho[[k]]/(rhat[[1]].nu[[k]]);
-		long_real_t alphatmp_re = 0.;
-		long_real_t alphatmp_im = 0.;
+		for (int k = 0; k < activeSize; ++k) {
+			const int i = active[k];
+			long_real_t alphatmp_re = 0., alphatmp_im = 0.;
 #pragma omp parallel for reduction(+:alphatmp_re, alphatmp_im)
-		for (int site = 0; site < solution.localsize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				complex partial = vector_dot(residual_hat[site][mu],nu[site][mu]);
-				alphatmp_re += real(partial);
-				alphatmp_im += imag(partial);
+			for (int site = 0; site < solutions[i].localsize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					complex partial = vector_dot(blockResidualHat[i][site][mu],blockNu[i][site][mu]);
+					alphatmp_re += real(partial);
+					alphatmp_im += imag(partial);
+				}
 			}
+			reductions[2*k] = alphatmp_re;
+			reductions[2*k+1] = alphatmp_im;
 		}
-		reduceAllSum(alphatmp_re);
-		reduceAllSum(alphatmp_im);
+		reduceAllSum(&reductions[0], 2*activeSize);
 
-		std::complex<long_real_t> alphatmp(alphatmp_re,alphatmp_im);
-		alpha = static_cast< std::complex<real_t> >(rho_next/alphatmp);
+		for (int k = 0; k < activeSize; ++k) {
+			const int i = active[k];
+			std::complex<long_real_t> alphatmp(reductions[2*k],reductions[2*k+1]);
+			alpha[i] = static_cast< std::complex<real_t> >(rho[i]/alphatmp);
 
-		//s = r[[k - 1]] - alpha*nu[[k]]
+			//s = r[[k - 1]] - alpha*nu[[k]], stored in the residual
 #pragma omp parallel for
-		for (int site = 0; site < solution.completesize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				s[site][mu] = residual[site][mu] - alpha *(nu[site][mu]);
+			for (int site = 0; site < solutions[i].completesize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					blockResidual[i][site][mu] -= alpha[i]*(blockNu[i][site][mu]);
+				}
 			}
+			outputs[k] = &blockT[i];
+			inputs[k] = &blockResidual[i];
 		}
-		//s.updateHalo();
 
 		//t = A.s;
-		dirac->multiplyAdd(t,s,s,shift);
+		dirac->multiplyBlock(outputs, inputs);
 
 		//omega = (t.s)/(t.t)
-		long_real_t tmp1_re = 0., tmp1_im = 0., tmp2_re = 0., tmp2_im = 0.;
-#pragma omp parallel for reduction(+:tmp1_re, tmp1_im, tmp2_re, tmp2_im)
-		for (int site = 0; site < solution.localsize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				complex partial1 = vector_dot(t[site][mu],s[site][mu]);
-				tmp1_re += real(partial1);
-				tmp1_im += imag(partial1);
-				complex partial2 = vector_dot(t[site][mu],t[site][mu]);
-				tmp2_re += real(partial2);
-				tmp2_im += imag(partial2);
+		for (int k = 0; k < activeSize; ++k) {
+			const int i = active[k];
+			long_real_t tmp1_re = 0., tmp1_im = 0., tmp2 = 0.;
+#pragma omp parallel for reduction(+:tmp1_re, tmp1_im, tmp2)
+			for (int site = 0; site < solutions[i].localsize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					complex partial = vector_dot(blockT[i][site][mu],blockResidual[i][site][mu]);
+					tmp1_re += real(partial);
+					tmp1_im += imag(partial);
+					tmp2 += real(vector_dot(blockT[i][site][mu],blockT[i][site][mu]));
+				}
 			}
+			reductions[3*k] = tmp1_re;
+			reductions[3*k+1] = tmp1_im;
+			reductions[3*k+2] = tmp2;
 		}
-		reduceAllSum(tmp1_re);
-		reduceAllSum(tmp1_im);
-		reduceAllSum(tmp2_re);
-		reduceAllSum(tmp2_im);
+		reduceAllSum(&reductions[0], 3*activeSize);
 
-		std::complex<long_real_t> tmp1(tmp1_re, tmp1_im), tmp2(tmp2_re, tmp2_im);
-		omega = static_cast< std::complex<real_t> >(tmp1/tmp2);
+		for (int k = 0; k < activeSize; ++k) {
+			const int i = active[k];
+			//t = 0 only if s = 0, the system is then solved by the update with p alone
+			std::complex<long_real_t> tmp1(reductions[3*k], reductions[3*k+1]);
+			omega[i] = (reductions[3*k+2] == 0.) ? std::complex<real_t>(0.) : static_cast< std::complex<real_t> >(tmp1/reductions[3*k+2]);
 
-		if (real(tmp2) == 0) {
+			//solution[[k]] = solution[[k - 1]] + alpha*p[[k]] + omega[[k]]*s
+			//residual[[k]] = s - omega[[k]]*t
 #pragma omp parallel for
-			for (int site = 0; site < solution.completesize; ++site) {
+			for (int site = 0; site < solutions[i].completesize; ++site) {
 				for (unsigned int mu = 0; mu < 4; ++mu) {
-					solution[site][mu] = source[site][mu];
+					solutions[i][site][mu] += alpha[i]*(blockP[i][site][mu]) + omega[i]*(blockResidual[i][site][mu]);
+					blockResidual[i][site][mu] -= omega[i]*(blockT[i][site][mu]);
 				}
 			}
-			//solution.updateHalo();
-			return true;//TODO, identity only?
-		}
 
-		//solution[[k]] = solution[[k - 1]] + alpha*p[[k]] + omega[[k]]*s
-#pragma omp parallel for
-		for (int site = 0; site < solution.completesize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				solution[site][mu] += alpha*(p[site][mu]) + omega*(s[site][mu]);
+			//norm = residual[[k]].residual[[k]] together with rho for the next step
+			long_real_t norm = 0., rho_next_re = 0., rho_next_im = 0.;
+#pragma omp parallel for reduction(+:norm, rho_next_re, rho_next_im)
+			for (int site = 0; site < solutions[i].localsize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					norm += real(vector_dot(blockResidual[i][site][mu],blockResidual[i][site][mu]));
+					complex partial = vector_dot(blockResidualHat[i][site][mu],blockResidual[i][site][mu]);
+					rho_next_re += real(partial);
+					rho_next_im += imag(partial);
+				}
 			}
+			reductions[3*k] = norm;
+			reductions[3*k+1] = rho_next_re;
+			reductions[3*k+2] = rho_next_im;
 		}
-		//solution.updateHalo();
+		reduceAllSum(&reductions[0], 3*activeSize);
 
-		//residual[[k]] = s - omega[[k]]*t
-		//norm = residual[[k]].residual[[k]]
-		long_real_t norm = 0.;
-#pragma omp parallel for reduction(+:norm)
-		for (int site = 0; site < solution.localsize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				residual[site][mu] = s[site][mu] - omega*(t[site][mu]);
-				norm += real(vector_dot(residual[site][mu],residual[site][mu]));
+		//The converged systems are removed from the block
+		int next = 0;
+		for (int k = 0; k < activeSize; ++k) {
+			if (reductions[3*k] < precision) {
+				lastSteps += step;
+				if (reductions[3*k] > lastError) lastError = reductions[3*k];
+			}
+			else {
+				active[next] = active[k];
+				reductions[2*next] = reductions[3*k+1];
+				reductions[2*next+1] = reductions[3*k+2];
+				++next;
 			}
 		}
-		reduceAllSum(norm);
-		residual.updateHalo();
-
-
-		if (norm < precision) {
-			lastSteps = step;
-#ifdef BICGLOG
-			if (isOutputProcess()) std::cout << "BiCGStab steps: " << step << " - final error norm: " << real(norm) << std::endl;
-#endif
-			return true;
-		}
-
-		rho = rho_next;
+		active.resize(next);
 
-		lastError = norm;
 		++step;
 	}
 
-	lastSteps = maxSteps;
-	if (isOutputProcess()) std::cout << "Failure in finding convergence after " << maxSteps << " cicles, last error: " << lastError << std::endl;
-	
-	return false;
+	if (!active.empty()) {
+		lastSteps += active.size()*maxSteps;
+		if (isOutputProcess()) std::cout << "BiConjugateGradient::Failure in finding convergence of " << active.size() << " systems after " << maxSteps << " cicles" << std::endl;
+		return false;
+	}
+#ifdef BICGLOG
+	if (isOutputProcess()) std::cout << "BiCGStab block steps: " << step << " - final error norm: " << lastError << std::endl;
+#endif
+	return true;
 }
 
 } /* namespace Update */
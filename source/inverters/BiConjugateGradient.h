@@ -2,6 +2,8 @@
 #define BICONJUGATEGRADIENT_H_
 #include "dirac_operators/DiracOperator.h"
 #include "Solver.h"
+#include "algebra_utils/AlgebraUtils.h"
+#include <vector>
 
 namespace Update {
 
@@ -27,6 +29,181 @@ public:
 	bool solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, const std::complex<real_t>& alpha, reduced_dirac_vector_t const* initial_guess = 0);
 	bool solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, int l, reduced_dirac_vector_t const* initial_guess = 0);
 
+	/**
+	 * BiCGStab for several right hand sides at the same time: the Dirac operator is applied to the whole block with multiplyBlock
+	 * and the dot products of all the systems are summed over the processors with a single reduction.
+	 * The converged systems are removed from the block, lastSteps is the sum of the steps of all the systems.
+	 */
+	virtual bool solve(DiracOperator* dirac, const std::vector<reduced_dirac_vector_t>& sources, std::vector<reduced_dirac_vector_t>& solutions);
+
+	/**
+	 * The BiCGStab iterations on vectors of any precision real_type, shared by solve and by the single precision inner solves of MixedPrecisionSolver.
+	 * residual and residual_hat must contain the initial residual and the shadow residual, p, nu, s and t are workspace.
+	 * @return true if the squared norm of the residual is smaller than target within maxSteps steps, steps and error are those of the last iteration
+	 */
+	template<typename real_type, typename Operator, typename dirac_vector_t> static bool iterate(Operator* dirac, const dirac_vector_t& source, dirac_vector_t& solution, dirac_vector_t& residual, dirac_vector_t& residual_hat, dirac_vector_t& p, dirac_vector_t& nu, dirac_vector_t& s, dirac_vector_t& t, long_real_t target, unsigned int maxSteps, unsigned int& steps, long_real_t& error) {
+		//Set nu and p to zero
+#pragma omp parallel for
+		for (int site = 0; site < solution.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				set_to_zero(p[site][mu]);
+				set_to_zero(nu[site][mu]);
+			}
+		}
+
+		//Set the initial parameter of the program
+		std::complex<real_type> alpha = 1., omega = 1.;
+		std::complex<long_real_t> rho = 1.;
+		steps = 0;
+
+		while (steps < maxSteps) {
+			//rho[k] = rhat.r[k-1]
+			long_real_t rho_next_re = 0.;
+			long_real_t rho_next_im = 0.;
+#pragma omp parallel for reduction(+:rho_next_re, rho_next_im)
+			for (int site = 0; site < solution.localsize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					complex partial = vector_dot(residual_hat[site][mu],residual[site][mu]);
+					rho_next_re += real(partial);
+					rho_next_im += imag(partial);
+				}
+			}
+			reduceAllSum(rho_next_re);
+			reduceAllSum(rho_next_im);
+
+			std::complex<long_real_t> rho_next(rho_next_re,rho_next_im);
+
+			if (norm(rho_next) == 0.) {
+				if (isOutputProcess()) std::cout << "BiConjugateGradient::Fatal error in norm " << rho_next << " at step " << steps << std::endl;
+				return false;
+			}
+
+			std::complex<real_type> beta = static_cast< std::complex<real_type> >((rho_next/rho))*(alpha/omega);
+			//p = r[[k - 1]] + beta*(p[[k - 1]] - omega[[k - 1]]*nu[[k - 1]])
+#pragma omp parallel for
+			for (int site = 0; site < solution.completesize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					p[site][mu] = residual[site][mu] + beta*(p[site][mu] - omega*nu[site][mu]);
+				}
+			}
+			//p.updateHalo();
+
+			//nu = A.p[[k]]
+			dirac->multiply(nu,p);
+
+			//alpha = rho[[k]]/(rhat[[1]].nu[[k]]);
+			long_real_t alphatmp_re = 0.;
+			long_real_t alphatmp_im = 0.;
+#pragma omp parallel for reduction(+:alphatmp_re, alphatmp_im)
+			for (int site = 0; site < solution.localsize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					complex partial = vector_dot(residual_hat[site][mu],nu[site][mu]);
+					alphatmp_re += real(partial);
+					alphatmp_im += imag(partial);
+				}
+			}
+			reduceAllSum(alphatmp_re);
+			reduceAllSum(alphatmp_im);
+
+			std::complex<long_real_t> alphatmp(alphatmp_re,alphatmp_im);
+			alpha = static_cast< std::complex<real_type> >(rho_next/alphatmp);
+
+			//s = r[[k - 1]] - alpha*nu[[k]]
+#pragma omp parallel for
+			for (int site = 0; site < solution.completesize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					s[site][mu] = residual[site][mu] - alpha *(nu[site][mu]);
+				}
+			}
+			//s.updateHalo();
+
+			//t = A.s;
+			dirac->multiply(t,s);
+
+			//omega = (t.s)/(t.t)
+			long_real_t tmp1_re = 0., tmp1_im = 0., tmp2_re = 0., tmp2_im = 0.;
+#pragma omp parallel for reduction(+:tmp1_re, tmp1_im, tmp2_re, tmp2_im)
+			for (int site = 0; site < solution.localsize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					complex partial1 = vector_dot(t[site][mu],s[site][mu]);
+					tmp1_re += real(partial1);
+					tmp1_im += imag(partial1);
+					complex partial2 = vector_dot(t[site][mu],t[site][mu]);
+					tmp2_re += real(partial2);
+					tmp2_im += imag(partial2);
+				}
+			}
+			reduceAllSum(tmp1_re);
+			reduceAllSum(tmp1_im);
+			reduceAllSum(tmp2_re);
+			reduceAllSum(tmp2_im);
+
+			std::complex<long_real_t> tmp1(tmp1_re, tmp1_im), tmp2(tmp2_re, tmp2_im);
+			omega = static_cast< std::complex<real_type> >(tmp1/tmp2);
+
+			if (real(tmp2) == 0) {
+#pragma omp parallel for
+				for (int site = 0; site < solution.completesize; ++site) {
+					for (unsigned int mu = 0; mu < 4; ++mu) {
+						solution[site][mu] = source[site][mu];
+					}
+				}
+				//solution.updateHalo();
+				return true;//TODO, identity only?
+			}
+
+			//solution[[k]] = solution[[k - 1]] + alpha*p[[k]] + omega[[k]]*s
+#pragma omp parallel for
+			for (int site = 0; site < solution.completesize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					solution[site][mu] += alpha*(p[site][mu]) + omega*(s[site][mu]);
+				}
+			}
+			//solution.updateHalo();
+
+			//residual[[k]] = s - omega[[k]]*t
+			//norm = residual[[k]].residual[[k]]
+			long_real_t norm = 0.;
+#pragma omp parallel for reduction(+:norm)
+			for (int site = 0; site < solution.localsize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					residual[site][mu] = s[site][mu] - omega*(t[site][mu]);
+					norm += real(vector_dot(residual[site][mu],residual[site][mu]));
+				}
+			}
+			reduceAllSum(norm);
+			//residual.updateHalo();//TODO maybe not needed
+#pragma omp parallel for
+			for (int site = solution.localsize; site < solution.completesize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					residual[site][mu] = s[site][mu] - omega*(t[site][mu]);
+				}
+			}
+
+
+			error = norm;
+			if (norm < target) {
+#ifdef BICGLOG
+				if (isOutputProcess()) std::cout << "BiCGStab steps: " << steps << " - final error norm: " << real(norm) << std::endl;
+#endif
+				return true;
+			}
+
+			rho = rho_next;
+			++steps;
+		}
+
+		return false;
+	}
+
+private:
+	//Vectors of the block solver, allocated at its first use
+	std::vector<reduced_dirac_vector_t> blockResidual;
+	std::vector<reduced_dirac_vector_t> blockResidualHat;
+	std::vector<reduced_dirac_vector_t> blockP;
+	std::vector<reduced_dirac_vector_t> blockNu;
+	std::vector<reduced_dirac_vector_t> blockT;
+
 };
 
 } /* namespace Update */
@@ -11,28 +11,46 @@ ChronologicalMultishiftSolver::~ChronologicalMultishiftSolver() { }
 bool ChronologicalMultishiftSolver::solve(DiracOperator* dirac, const extended_dirac_vector_t& original_source, std::vector<extended_dirac_vector_t>& original_solutions, const std::vector<real_t>& shifts) {
 	//We work with reduced halos
 	reduced_dirac_vector_t source = original_source;
+	//The input solutions are the old solutions, used as initial guesses
 	std::vector<reduced_dirac_vector_t> solutions(original_solutions.size());
+	for (unsigned int index = 0; index < original_solutions.size(); ++index) {
+		solutions[index] = original_solutions[index];
+	}
 
-	
 	//First solve the linear system of the first shift (supposed to be the easiest, i.e. s[0] > s[i])
 	std::vector<reduced_dirac_vector_t>::iterator solution = solutions.begin();
 	std::vector<real_t>::const_iterator shift = shifts.begin();
 	//The flag for the errors
 	bool noproblem = true;
-	//First set the initial residual and p to source, result to zero
+	//First set the initial residual and p to source - A solution, the old solution is used only if it is better than zero
+	dirac->multiplyAdd(tmp, *solution, *solution, *shift);
 #pragma omp parallel for
 	for (int site = 0; site < residual.localsize; ++site) {
 		for (unsigned int mu = 0; mu < 4; ++mu) {
-			set_to_zero((*solution)[site][mu]);
-			p[site][mu] = source[site][mu];
-			residual[site][mu] = source[site][mu];
+			residual[site][mu] = source[site][mu] - tmp[site][mu];
+		}
+	}
+	real_t normResidual = AlgebraUtils::squaredNorm(residual);
+	if (!(normResidual < AlgebraUtils::squaredNorm(source))) {
+#pragma omp parallel for
+		for (int site = 0; site < residual.localsize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				set_to_zero((*solution)[site][mu]);
+				residual[site][mu] = source[site][mu];
+			}
+		}
+		normResidual = AlgebraUtils::squaredNorm(residual);
+	}
+#pragma omp parallel for
+	for (int site = 0; site < residual.localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			p[site][mu] = residual[site][mu];
 		}
 	}
 	solution->updateHalo();
 	p.updateHalo();
 	residual.updateHalo();
 
-	real_t normResidual = AlgebraUtils::squaredNorm(residual);
 	for (unsigned int i = 0; i < maxSteps; ++i) {
 		dirac->multiplyAdd(tmp, p, p, *shift);
 		real_t alpha = normResidual/real(AlgebraUtils::dot(p,tmp));
@@ -1,5 +1,6 @@
 #include "ConjugateGradient.h"
 #include "algebra_utils/AlgebraUtils.h"
+#include "dirac_operators/SquareEvenOddDiracWilsonOperator.h"
 
 namespace Update {
 
@@ -8,6 +9,8 @@ ConjugateGradient::ConjugateGradient() : epsilon(0.00000000001), maxSteps(3000)
 ConjugateGradient::~ConjugateGradient() { }
 
 bool ConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector_t& original_source, reduced_dirac_vector_t& original_solution, reduced_dirac_vector_t const* initial_guess) {
+	if (dynamic_cast<EvenOddDiracWilsonOperator*>(dirac)) return this->solveEvenOdd(dynamic_cast<EvenOddDiracWilsonOperator*>(dirac), original_source, original_solution, initial_guess);
+
 	reduced_dirac_vector_t source = original_source;
 	reduced_dirac_vector_t solution;
 	if (initial_guess == 0) {
@@ -22,56 +25,82 @@ bool ConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector_t
 	for (int site = 0; site < source.completesize; ++site) {
 		for (unsigned int mu = 0; mu < 4; ++mu) {
 			r[site][mu] = source[site][mu] - tmp[site][mu];
-			p[site][mu] = r[site][mu];
 		}
 	}
 
-	long_real_t norm = AlgebraUtils::squaredNorm(r);
-	
-	long_real_t norm_next = norm;
+	long_real_t error;
+	bool result = iterate<real_t>(dirac, solution, r, p, tmp, epsilon, maxSteps, lastSteps, error);
+	lastError = error;
+	original_solution = solution;
+	if (!result && isOutputProcess()) std::cout << "ConjugateGradient::Failure in finding convergence, last error: " << lastError << std::endl;
+	return result;
+}
+
+bool ConjugateGradient::solveEvenOdd(EvenOddDiracWilsonOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess) {
+	//Q = gamma5 (M_oo - M_oe M_ee^-1 M_eo) is solved with Q^dagger Q x_o = Q^dagger b_o, where Q^dagger is Q with the opposite twist
+	bool gamma5 = dirac->getGamma5();
+	real_t twist = dirac->getTwist();
+	reduced_dirac_vector_t gamma5Source = source, oddSource, oddSolution;
+	if (!gamma5) AlgebraUtils::gamma5(gamma5Source);
+	dirac->setGamma5(true);
+
+	dirac->prepareOddSource(oddSolution, gamma5Source);
+	dirac->setTwist(-twist);
+	dirac->multiply(oddSource, oddSolution);
+	dirac->setTwist(twist);
+
+	SquareEvenOddDiracWilsonOperator squareDirac(*dirac->getLattice(), dirac->getKappa(), twist);
+	bool result = this->solve(&squareDirac, oddSource, oddSolution, initial_guess);
+
+	dirac->reconstructSolution(solution, oddSolution, gamma5Source);
+	dirac->setGamma5(gamma5);
+	return result;
+}
+
+#ifdef ALIGNED_OPT
+bool ConjugateGradient::solve(DiracOperator* dirac, const reduced_soa_dirac_vector_t& source, reduced_soa_dirac_vector_t& solution, reduced_soa_dirac_vector_t const* initial_guess) {
+	if (initial_guess == 0) {
+		solution = source;
+	} else {
+		solution = *initial_guess;
+	}
+
+	dirac->multiply(soa_tmp,solution);
+
+	AlignedAlgebraUtils::vector_plus_scalar_times_vector(soa_r, source, -1., soa_tmp);
+	soa_r.updateHalo();
+	soa_p = soa_r;
+
+	real_t norm = AlignedAlgebraUtils::squaredNorm(soa_r);
+
+	real_t norm_next = norm;
 
 	for (unsigned int step = 0; step < maxSteps; ++step) {
-		dirac->multiply(tmp,p);
+		dirac->multiply(soa_tmp,soa_p);
 		norm = norm_next;
-		std::complex<real_t> alpha = static_cast< std::complex<real_t> >(norm/AlgebraUtils::dot(p,tmp));
+		std::complex<real_t> alpha = norm/AlignedAlgebraUtils::dot(soa_p,soa_tmp);
 
+		//solution = solution + alpha*p and r = r - alpha*tmp, with the norm of r in the same pass
+		norm_next = AlignedAlgebraUtils::axpyNorm(solution, alpha, soa_p, soa_r, -alpha, soa_tmp);
 
-#pragma omp parallel for
-		for (int site = 0; site < source.completesize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				solution[site][mu] = solution[site][mu] + alpha * p[site][mu];
-				r[site][mu] = r[site][mu] - alpha * tmp[site][mu];
-			}
-		}
-		//solution.updateHalo();
-		//r.updateHalo();//TODO maybe not needed
-
-		norm_next = AlgebraUtils::squaredNorm(r);
 		if (norm_next < epsilon) {
 			lastSteps = step;
-			original_solution = solution;
+			lastError = norm_next;
 			return true;
 		}
-		else {
-			//std::cout << "ConjugateGradient::Residual norm at step " << step << ": " << norm_next << std::endl;
-		}
 
-		real_t beta = static_cast<real_t>(norm_next/norm);
+		real_t beta = norm_next/norm;
 
-#pragma omp parallel for
-		for (int site = 0; site < source.completesize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				p[site][mu] = r[site][mu] + beta * p[site][mu];
-			}
-		}
-		//p.updateHalo();
+		//p = r + beta*p
+		AlignedAlgebraUtils::xpay(soa_p, beta, soa_r);
 	}
 
 	lastSteps = maxSteps;
-	original_solution = solution;
+	lastError = norm_next;
 	if (isOutputProcess()) std::cout << "ConjugateGradient::Failure in finding convergence, last error: " << norm_next << std::endl;
 	return false;
 }
+#endif
 
 void ConjugateGradient::setPrecision(double _epsilon) {
 	epsilon = _epsilon;
@@ -2,6 +2,8 @@
 #define CONJUGATEGRADIENT_H_
 #include "Environment.h"
 #include "dirac_operators/DiracOperator.h"
+#include "dirac_operators/EvenOddDiracWilsonOperator.h"
+#include "algebra_utils/AlgebraUtils.h"
 
 namespace Update {
 
@@ -10,7 +12,43 @@ public:
 	ConjugateGradient();
 	~ConjugateGradient();
 
+	//The even-odd operator is solved on its Schur complement with the normal equations, the solution is reconstructed on the full lattice
 	bool solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess = 0);
+#ifdef ALIGNED_OPT
+	//Conjugate gradient on the split real/imaginary storage, no conversion of the vectors is done
+	bool solve(DiracOperator* dirac, const reduced_soa_dirac_vector_t& source, reduced_soa_dirac_vector_t& solution, reduced_soa_dirac_vector_t const* initial_guess = 0);
+#endif
+
+	/**
+	 * The conjugate gradient iterations on vectors of any precision real_type, shared by solve and by the single precision inner solves of MixedPrecisionSolver.
+	 * dirac->multiply(output,input) must apply an hermitian positive definite operator, r must contain the residual of the initial solution, p and tmp are workspace.
+	 * @return true if the squared norm of the residual is smaller than target within maxSteps steps, steps and error are those of the last iteration
+	 */
+	template<typename real_type, typename Operator, typename dirac_vector_t> static bool iterate(Operator* dirac, dirac_vector_t& solution, dirac_vector_t& r, dirac_vector_t& p, dirac_vector_t& tmp, long_real_t target, unsigned int maxSteps, unsigned int& steps, long_real_t& error) {
+		p = r;
+		long_real_t norm_next = AlgebraUtils::squaredNorm(r);
+
+		for (steps = 0; steps < maxSteps; ++steps) {
+			dirac->multiply(tmp,p);
+			long_real_t norm = norm_next;
+			std::complex<real_type> alpha = static_cast< std::complex<real_type> >(norm/AlgebraUtils::dot(p,tmp));
+
+			//solution = solution + alpha*p and r = r - alpha*tmp, with the norm of r in the same pass
+			norm_next = AlgebraUtils::axpyNorm(solution, alpha, p, r, -alpha, tmp);
+
+			if (norm_next < target) {
+				++steps;
+				error = norm_next;
+				return true;
+			}
+
+			//p = r + beta*p
+			AlgebraUtils::xpay(p, static_cast<real_type>(norm_next/norm), r);
+		}
+
+		error = norm_next;
+		return false;
+	}
 
 	void setPrecision(double _epsilon);
 	double getPrecision() const;
@@ -22,9 +60,16 @@ public:
 	unsigned int getMaximumSteps() const;
 
 private:
+	bool solveEvenOdd(EvenOddDiracWilsonOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess);
+
 	reduced_dirac_vector_t p;
 	reduced_dirac_vector_t r;
 	reduced_dirac_vector_t tmp;
+#ifdef ALIGNED_OPT
+	reduced_soa_dirac_vector_t soa_p;
+	reduced_soa_dirac_vector_t soa_r;
+	reduced_soa_dirac_vector_t soa_tmp;
+#endif
 
 	double epsilon;
 	double lastError;
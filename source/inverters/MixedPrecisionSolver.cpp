@@ -0,0 +1,153 @@
+#include "MixedPrecisionSolver.h"
+#include "ConjugateGradient.h"
+#include "BiConjugateGradient.h"
+#include "dirac_operators/DiracWilsonOperator.h"
+#include "dirac_operators/SquareDiracWilsonOperator.h"
+#include "algebra_utils/AlgebraUtils.h"
+//#define MIXEDLOG
+
+namespace Update {
+
+MixedPrecisionSolver::MixedPrecisionSolver(InnerSolver _innerSolver) : Solver("MixedPrecisionSolver"), innerSolver(_innerSolver), innerPrecision(0.000001), lastOuterSteps(0) { }
+
+MixedPrecisionSolver::~MixedPrecisionSolver() { }
+
+bool MixedPrecisionSolver::solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess) {
+	//The single precision kernel exists only for the Wilson operator and its square
+	bool squared;
+	if (dynamic_cast<SquareDiracWilsonOperator*>(dirac) != 0) squared = true;
+	else if (dynamic_cast<DiracWilsonOperator*>(dirac) != 0) squared = false;
+	else return this->fallbackSolve(dirac, source, solution, initial_guess);
+
+	//The single precision links are converted only when the configuration changes
+	singleDirac.setOperator(dirac, squared);
+
+	//Set the initial solution and the double precision residual
+	if (initial_guess == 0) {
+#pragma omp parallel for
+		for (int site = 0; site < solution.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				set_to_zero(solution[site][mu]);
+				residual[site][mu] = source[site][mu];
+			}
+		}
+	}
+	else {
+		solution = *initial_guess;
+		dirac->multiply(tmp,solution);
+#pragma omp parallel for
+		for (int site = 0; site < solution.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				residual[site][mu] = source[site][mu] - tmp[site][mu];
+			}
+		}
+	}
+
+	long_real_t norm = AlgebraUtils::squaredNorm(residual);
+	lastSteps = 0;
+	lastOuterSteps = 0;
+
+	while (norm >= precision) {
+		if (lastSteps >= maxSteps) {
+			lastError = norm;
+			if (isOutputProcess()) std::cout << "MixedPrecisionSolver::Failure in finding convergence after " << maxSteps << " inner steps, last error: " << lastError << std::endl;
+			return false;
+		}
+
+		//The residual is normalized before the conversion to avoid underflows in single precision
+		real_t scale = sqrt(static_cast<real_t>(norm));
+#pragma omp parallel for
+		for (int site = 0; site < solution.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				single_source[site][mu] = (residual[site][mu]/scale).cast<single_complex>();
+			}
+		}
+
+		//The inner solve starts from zero, the source is normalized to one
+#pragma omp parallel for
+		for (int site = 0; site < solution.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				set_to_zero(single_solution[site][mu]);
+				single_residual[site][mu] = single_source[site][mu];
+				single_residual_hat[site][mu] = single_source[site][mu];
+			}
+		}
+
+		unsigned int steps = 0;
+		long_real_t innerError;
+		if (innerSolver == ConjugateGradientSolver) ConjugateGradient::iterate<single_real_t>(&singleDirac, single_solution, single_residual, single_p, single_t, innerPrecision, maxSteps - lastSteps, steps, innerError);
+		else BiConjugateGradient::iterate<single_real_t>(&singleDirac, single_source, single_solution, single_residual, single_residual_hat, single_p, single_nu, single_s, single_t, innerPrecision, maxSteps - lastSteps, steps, innerError);
+		lastSteps += steps;
+		++lastOuterSteps;
+
+		//Defect correction in double precision
+#pragma omp parallel for
+		for (int site = 0; site < solution.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				solution[site][mu] += scale*single_solution[site][mu].cast<complex>();
+			}
+		}
+
+		dirac->multiply(tmp,solution);
+#pragma omp parallel for
+		for (int site = 0; site < solution.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				residual[site][mu] = source[site][mu] - tmp[site][mu];
+			}
+		}
+
+		long_real_t norm_next = AlgebraUtils::squaredNorm(residual);
+#ifdef MIXEDLOG
+		if (isOutputProcess()) std::cout << "MixedPrecisionSolver::Outer step " << lastOuterSteps << " (" << steps << " inner steps) - error norm: " << norm_next << std::endl;
+#endif
+		if (norm_next >= norm) {
+			lastError = norm_next;
+			if (isOutputProcess()) std::cout << "MixedPrecisionSolver::Defect correction stagnates after " << lastSteps << " inner steps, last error: " << lastError << std::endl;
+			return false;
+		}
+		norm = norm_next;
+	}
+
+	lastError = norm;
+	return true;
+}
+
+bool MixedPrecisionSolver::fallbackSolve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess) {
+	lastOuterSteps = 1;
+	if (innerSolver == ConjugateGradientSolver) {
+		ConjugateGradient conjugateGradient;
+		conjugateGradient.setPrecision(precision);
+		conjugateGradient.setMaximumSteps(maxSteps);
+		bool result = conjugateGradient.solve(dirac, source, solution, initial_guess);
+		lastSteps = conjugateGradient.getLastSteps();
+		lastError = conjugateGradient.getLastError();
+		return result;
+	}
+	else {
+		BiConjugateGradient biConjugateGradient;
+		biConjugateGradient.setPrecision(precision);
+		biConjugateGradient.setMaximumSteps(maxSteps);
+		bool result = biConjugateGradient.solve(dirac, source, solution, initial_guess);
+		lastSteps = biConjugateGradient.getLastSteps();
+		lastError = biConjugateGradient.getLastError();
+		return result;
+	}
+}
+
+void MixedPrecisionSolver::setInnerPrecision(real_t _innerPrecision) {
+	innerPrecision = _innerPrecision;
+}
+
+real_t MixedPrecisionSolver::getInnerPrecision() const {
+	return innerPrecision;
+}
+
+unsigned int MixedPrecisionSolver::getLastOuterSteps() const {
+	return lastOuterSteps;
+}
+
+bool MixedPrecisionSolver::requiresPositiveDefiniteOperator() const {
+	return innerSolver == ConjugateGradientSolver;
+}
+
+} /* namespace Update */
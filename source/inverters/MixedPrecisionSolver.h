@@ -0,0 +1,67 @@
+#ifndef MIXEDPRECISIONSOLVER_H_
+#define MIXEDPRECISIONSOLVER_H_
+#include "dirac_operators/DiracOperator.h"
+#include "dirac_operators/SingleDiracWilsonOperator.h"
+#include "Solver.h"
+
+namespace Update {
+
+/**
+ * Defect-correction solver: the residual r = source - D.solution is computed in double precision, the correction D.e = r
+ * is found in single precision with the iterations of ConjugateGradient or BiConjugateGradient and then added to the solution.
+ * The single precision inner iterations are available for DiracWilsonOperator and SquareDiracWilsonOperator, for the
+ * other operators the solver falls back to the double precision ConjugateGradient or BiConjugateGradient.
+ * The single precision links are kept between the solves and they are updated only when the configuration changes.
+ * The precision is the squared norm of the final residual, as in the double precision solvers.
+ */
+class MixedPrecisionSolver : public Solver {
+public:
+	enum InnerSolver {ConjugateGradientSolver, BiConjugateGradientSolver};
+
+	using Solver::solve;
+
+	MixedPrecisionSolver(InnerSolver _innerSolver = ConjugateGradientSolver);
+	~MixedPrecisionSolver();
+
+	virtual bool solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess = 0);
+
+	/**
+	 * This function sets the reduction of the squared norm of the residual required to every inner single precision solve
+	 * @param _innerPrecision
+	 */
+	void setInnerPrecision(real_t _innerPrecision);
+	real_t getInnerPrecision() const;
+
+	/**
+	 * This function returns back the number of defect corrections done in double precision in the last solve
+	 */
+	unsigned int getLastOuterSteps() const;
+
+	virtual bool requiresPositiveDefiniteOperator() const;
+
+private:
+	bool fallbackSolve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess);
+
+	InnerSolver innerSolver;
+	real_t innerPrecision;
+	unsigned int lastOuterSteps;
+
+	SingleDiracWilsonOperator singleDirac;
+
+	//Double precision residual
+	reduced_dirac_vector_t residual;
+	reduced_dirac_vector_t tmp;
+
+	//Single precision vectors of the inner iterations
+	single_reduced_dirac_vector_t single_source;
+	single_reduced_dirac_vector_t single_solution;
+	single_reduced_dirac_vector_t single_residual;
+	single_reduced_dirac_vector_t single_residual_hat;
+	single_reduced_dirac_vector_t single_p;
+	single_reduced_dirac_vector_t single_nu;
+	single_reduced_dirac_vector_t single_s;
+	single_reduced_dirac_vector_t single_t;
+};
+
+} /* namespace Update */
+#endif /* MIXEDPRECISIONSOLVER_H_ */
@@ -96,6 +96,7 @@ bool MultiGridMEMultishiftSolver::solve(DiracOperator* diracSquare, const extend
 	
 	//We solve the first linear equation
 	if (isOutputProcess()) std::cout << "MultiGridMEMultishiftSolver::Inverting shift " << *shift << std::endl;
+	//The local SAP reads the twist from twistedDirac, the block operators need it for the SAP of the operators it does not support
 	twistedDirac->setTwist(-sqrt(*shift));
 	redBlockDiracOperator->setTwist(-sqrt(*shift));
 	blackBlockDiracOperator->setTwist(-sqrt(*shift));
@@ -0,0 +1,32 @@
+#include "NormalEquationSolver.h"
+#include "algebra_utils/AlgebraUtils.h"
+
+namespace Update {
+
+NormalEquationSolver::NormalEquationSolver(Solver* _solver) : Solver("NormalEquationSolver"), solver(_solver) { }
+
+NormalEquationSolver::~NormalEquationSolver() {
+	delete solver;
+}
+
+bool NormalEquationSolver::solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess) {
+	//D x = b is Q x = gamma5 b, multiplied by Q
+	bool gamma5 = dirac->getGamma5();
+	gamma5Source = source;
+	if (!gamma5) AlgebraUtils::gamma5(gamma5Source);
+	dirac->setGamma5(true);
+	dirac->multiply(normalSource, gamma5Source);
+
+	DiracOperator* squareDirac = DiracOperator::getSquare(dirac);
+	solver->setPrecision(precision);
+	solver->setMaximumSteps(maxSteps);
+	bool result = solver->solve(squareDirac, normalSource, solution, initial_guess);
+	lastSteps = solver->getLastSteps();
+	lastError = solver->getLastError();
+
+	delete squareDirac;
+	dirac->setGamma5(gamma5);
+	return result;
+}
+
+} /* namespace Update */
@@ -0,0 +1,35 @@
+#ifndef NORMALEQUATIONSOLVER_H_
+#define NORMALEQUATIONSOLVER_H_
+#include "dirac_operators/DiracOperator.h"
+#include "Solver.h"
+
+namespace Update {
+
+/**
+ * Adapter of the solvers of hermitian positive definite systems to a generic Dirac operator D: D.solution = source is solved
+ * as Q^2 solution = Q gamma5 source, with the hermitian Q = gamma5 D. The precision is the squared norm of the residual of
+ * the normal equations.
+ */
+class NormalEquationSolver : public Solver {
+public:
+	using Solver::solve;
+
+	//The solver is owned by the adapter
+	NormalEquationSolver(Solver* _solver);
+	~NormalEquationSolver();
+
+	virtual bool solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess = 0);
+
+private:
+	//The solver cannot be shared
+	NormalEquationSolver(const NormalEquationSolver&);
+	NormalEquationSolver& operator=(const NormalEquationSolver&);
+
+	Solver* solver;
+
+	reduced_dirac_vector_t gamma5Source;
+	reduced_dirac_vector_t normalSource;
+};
+
+} /* namespace Update */
+#endif /* NORMALEQUATIONSOLVER_H_ */
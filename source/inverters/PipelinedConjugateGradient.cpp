@@ -0,0 +1,126 @@
+#include "PipelinedConjugateGradient.h"
+#include "algebra_utils/AlgebraUtils.h"
+
+namespace Update {
+
+PipelinedConjugateGradient::PipelinedConjugateGradient() : Solver("PipelinedConjugateGradient") {
+	precision = 0.00000000001;
+	maxSteps = 3000;
+}
+
+PipelinedConjugateGradient::~PipelinedConjugateGradient() { }
+
+inline void PipelinedConjugateGradient::update(int site, reduced_dirac_vector_t& solution, const std::complex<real_t>& alpha, real_t beta) {
+	for (unsigned int mu = 0; mu < 4; ++mu) {
+		z[site][mu] = q[site][mu] + beta*z[site][mu];
+		s[site][mu] = w[site][mu] + beta*s[site][mu];
+		p[site][mu] = r[site][mu] + beta*p[site][mu];
+		solution[site][mu] += alpha*p[site][mu];
+		r[site][mu] -= alpha*s[site][mu];
+		w[site][mu] -= alpha*z[site][mu];
+	}
+}
+
+bool PipelinedConjugateGradient::solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess) {
+	if (initial_guess == 0) {
+		solution = source;
+	} else {
+		solution = *initial_guess;
+	}
+
+	//r = source - A.solution, w = A.r
+	dirac->multiply(q,solution);
+#pragma omp parallel for
+	for (int site = 0; site < source.completesize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			r[site][mu] = source[site][mu] - q[site][mu];
+			set_to_zero(p[site][mu]);
+			set_to_zero(s[site][mu]);
+			set_to_zero(z[site][mu]);
+		}
+	}
+	dirac->multiply(w,r);
+
+	//gamma = (r,r) and delta = (r,w), reduced together
+	long_real_t reductions[3] = {0., 0., 0.};
+	{
+		long_real_t gamma = 0., delta_re = 0., delta_im = 0.;
+#pragma omp parallel for reduction(+:gamma,delta_re,delta_im)
+		for (int site = 0; site < source.localsize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				gamma += real(vector_dot(r[site][mu],r[site][mu]));
+				complex delta = vector_dot(r[site][mu],w[site][mu]);
+				delta_re += real(delta);
+				delta_im += imag(delta);
+			}
+		}
+		reductions[0] = gamma;
+		reductions[1] = delta_re;
+		reductions[2] = delta_im;
+	}
+
+	long_real_t gamma_prev = 1.;
+	std::complex<real_t> alpha_prev = 1.;
+
+	for (unsigned int step = 0; step < maxSteps; ++step) {
+		//The reduction is overlapped with q = A.w
+		reduce_request_t request;
+		startReduceAllSum(reductions, 3, request);
+		dirac->multiply(q,w);
+		waitReduceAllSum(request);
+
+		long_real_t gamma = reductions[0];
+		std::complex<real_t> delta(static_cast<real_t>(reductions[1]), static_cast<real_t>(reductions[2]));
+		if (gamma < precision) {
+			lastSteps = step;
+			lastError = gamma;
+			return true;
+		}
+
+		real_t beta = 0.;
+		std::complex<real_t> alpha;
+		if (step == 0) {
+			alpha = static_cast<real_t>(gamma)/delta;
+		}
+		else {
+			beta = static_cast<real_t>(gamma/gamma_prev);
+			alpha = static_cast<real_t>(gamma)/(delta - beta*static_cast<real_t>(gamma)/alpha_prev);
+		}
+
+		//All the updates in one pass, with the local part of the next dot products
+		long_real_t gamma_next = 0., delta_re = 0., delta_im = 0.;
+#pragma omp parallel for reduction(+:gamma_next,delta_re,delta_im)
+		for (int site = 0; site < source.localsize; ++site) {
+			this->update(site, solution, alpha, beta);
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				gamma_next += real(vector_dot(r[site][mu],r[site][mu]));
+				complex delta_next = vector_dot(r[site][mu],w[site][mu]);
+				delta_re += real(delta_next);
+				delta_im += imag(delta_next);
+			}
+		}
+		//The halo is updated without communications, w and q are outputs of the Dirac operator
+#pragma omp parallel for
+		for (int site = source.localsize; site < source.completesize; ++site) {
+			this->update(site, solution, alpha, beta);
+		}
+		reductions[0] = gamma_next;
+		reductions[1] = delta_re;
+		reductions[2] = delta_im;
+
+		gamma_prev = gamma;
+		alpha_prev = alpha;
+	}
+
+	reduceAllSum(reductions, 3);
+	lastSteps = maxSteps;
+	lastError = reductions[0];
+	if (isOutputProcess()) std::cout << "PipelinedConjugateGradient::Failure in finding convergence, last error: " << lastError << std::endl;
+	return false;
+}
+
+bool PipelinedConjugateGradient::requiresPositiveDefiniteOperator() const {
+	return true;
+}
+
+} /* namespace Update */
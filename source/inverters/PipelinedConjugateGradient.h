@@ -0,0 +1,37 @@
+#ifndef PIPELINEDCONJUGATEGRADIENT_H_
+#define PIPELINEDCONJUGATEGRADIENT_H_
+#include "dirac_operators/DiracOperator.h"
+#include "Solver.h"
+
+namespace Update {
+
+/**
+ * Pipelined conjugate gradient (Ghysels and Vanroose): the two dot products of every iteration are computed in the same pass
+ * of the vector updates and they are reduced with a non-blocking reduction overlapped with the application of the Dirac operator.
+ * It requires an hermitian positive definite operator, as ConjugateGradient. The precision is the squared norm of the residual.
+ */
+class PipelinedConjugateGradient : public Solver {
+public:
+	using Solver::solve;
+
+	PipelinedConjugateGradient();
+	~PipelinedConjugateGradient();
+
+	virtual bool solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess = 0);
+
+	virtual bool requiresPositiveDefiniteOperator() const;
+
+private:
+	//Update of all the vectors on a single site, as a function of the new coefficients alpha and beta
+	inline void update(int site, reduced_dirac_vector_t& solution, const std::complex<real_t>& alpha, real_t beta);
+
+	reduced_dirac_vector_t r;
+	reduced_dirac_vector_t w;
+	reduced_dirac_vector_t p;
+	reduced_dirac_vector_t s;
+	reduced_dirac_vector_t z;
+	reduced_dirac_vector_t q;
+};
+
+} /* namespace Update */
+#endif /* PIPELINEDCONJUGATEGRADIENT_H_ */
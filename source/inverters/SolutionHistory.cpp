@@ -0,0 +1,114 @@
+#include "SolutionHistory.h"
+#include "algebra_utils/AlgebraUtils.h"
+
+namespace Update {
+
+SolutionHistory::SolutionHistory(unsigned int _size) : size(_size), next(0), count(0) { }
+
+SolutionHistory::~SolutionHistory() { }
+
+void SolutionHistory::setSize(unsigned int _size) {
+	size = _size;
+	solutions.clear();
+	products.clear();
+	next = 0;
+	count = 0;
+}
+
+unsigned int SolutionHistory::getSize() const {
+	return size;
+}
+
+void SolutionHistory::clear() {
+	//The vectors are kept allocated for the next trajectory
+	next = 0;
+	count = 0;
+}
+
+void SolutionHistory::add(const reduced_dirac_vector_t& solution) {
+	if (size == 0) return;
+	if (solutions.size() < size) solutions.resize(size);
+	solutions[next] = solution;
+	next = (next + 1) % size;
+	if (count < size) ++count;
+}
+
+bool SolutionHistory::guess(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& guess, real_t shift) {
+	const int n = count;
+	if (n == 0) return false;
+	if (static_cast<int>(products.size()) < n) products.resize(n);
+
+	//The operator changes along the trajectory, the products are computed again for every guess
+	std::vector<reduced_dirac_vector_t*> outputs(n);
+	std::vector<const reduced_dirac_vector_t*> inputs(n);
+	for (int i = 0; i < n; ++i) {
+		outputs[i] = &products[i];
+		inputs[i] = &solutions[i];
+	}
+	dirac->multiplyBlock(outputs, inputs);
+	if (shift != 0.) {
+		for (int i = 0; i < n; ++i) {
+#pragma omp parallel for
+			for (int site = 0; site < source.completesize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					products[i][site][mu] += shift*solutions[i][site][mu];
+				}
+			}
+		}
+	}
+
+	//The minimum of the residual solves G c = v, with G_ij = (A x_i, A x_j) and v_i = (A x_i, source)
+	//The local parts of the upper triangle of G and of v are summed with a single reduction
+	std::vector<long_real_t> reductions(n*(n+1) + 2*n);
+	int index = 0;
+	for (int i = 0; i < n; ++i) {
+		for (int j = i; j <= n; ++j) {
+			const reduced_dirac_vector_t& second = (j == n) ? source : products[j];
+			long_real_t dot_re = 0., dot_im = 0.;
+#pragma omp parallel for reduction(+:dot_re, dot_im)
+			for (int site = 0; site < source.localsize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					complex partial = vector_dot(products[i][site][mu],second[site][mu]);
+					dot_re += real(partial);
+					dot_im += imag(partial);
+				}
+			}
+			reductions[index] = dot_re;
+			reductions[index+1] = dot_im;
+			index += 2;
+		}
+	}
+	reduceAllSum(&reductions[0], index);
+
+	matrix_t G(n,n);
+	vector_t v(n);
+	index = 0;
+	for (int i = 0; i < n; ++i) {
+		for (int j = i; j <= n; ++j) {
+			complex entry(static_cast<real_t>(reductions[index]), static_cast<real_t>(reductions[index+1]));
+			if (j == n) {
+				v(i) = entry;
+			}
+			else {
+				G(i,j) = entry;
+				G(j,i) = conj(entry);
+			}
+			index += 2;
+		}
+	}
+	//The stored solutions can be almost linearly dependent, a rank revealing decomposition is needed
+	vector_t c = G.colPivHouseholderQr().solve(v);
+
+#pragma omp parallel for
+	for (int site = 0; site < source.completesize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			guess[site][mu] = c(0)*solutions[0][site][mu];
+			for (int i = 1; i < n; ++i) {
+				guess[site][mu] += c(i)*solutions[i][site][mu];
+			}
+		}
+	}
+	return true;
+}
+
+} /* namespace Update */
@@ -0,0 +1,71 @@
+#ifndef SOLUTIONHISTORY_H_
+#define SOLUTIONHISTORY_H_
+#include "dirac_operators/DiracOperator.h"
+#include "MPILattice/LatticeWorkspace.h"
+#include <vector>
+
+namespace Update {
+
+/**
+ * The last solutions of a linear system solved along a molecular dynamics trajectory, used to extrapolate the initial guess
+ * of the next inversion (chronological inversion, Brower, Ivanenko, Levi, Orginos). The guess is the combination of the stored
+ * solutions that minimizes the residual of the new system, so it is never worse than any single stored solution.
+ * The history must be cleared when the source changes, i.e. at the beginning of every trajectory.
+ */
+class SolutionHistory {
+public:
+	SolutionHistory(unsigned int _size = 0);
+	~SolutionHistory();
+
+	//The maximum number of stored solutions, 0 disables the history
+	void setSize(unsigned int _size);
+	unsigned int getSize() const;
+
+	void clear();
+
+	//Stores a new solution, the oldest one is discarded when the history is full
+	void add(const reduced_dirac_vector_t& solution);
+
+	/**
+	 * This function computes the combination of the stored solutions x_i that minimizes |source - (dirac + shift) guess|
+	 * @param dirac
+	 * @param source
+	 * @param guess
+	 * @param shift
+	 * @return false if the history is empty and no guess is computed
+	 */
+	bool guess(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& guess, real_t shift = 0.);
+
+#ifdef ENABLE_MPI
+	void add(const extended_dirac_vector_t& solution) {
+		conversionBuffers[0] = solution;
+		this->add(conversionBuffers[0]);
+	}
+
+	bool guess(DiracOperator* dirac, const extended_dirac_vector_t& source, extended_dirac_vector_t& guess, real_t shift = 0.) {
+		//The conversions to the reduced layout are done in the cached buffers of the history
+		reduced_dirac_vector_t& red_source = conversionBuffers[0];
+		reduced_dirac_vector_t& red_guess = conversionBuffers[1];
+		red_source = source;
+		bool res = this->guess(dirac, red_source, red_guess, shift);
+		if (res) guess = red_guess;
+		return res;
+	}
+#endif
+
+private:
+	unsigned int size;
+	//The stored solutions, solutions[next] is overwritten by the next add and only the first count are valid
+	std::vector<reduced_dirac_vector_t> solutions;
+	unsigned int next;
+	unsigned int count;
+	//The stored solutions multiplied by the operator
+	std::vector<reduced_dirac_vector_t> products;
+
+#ifdef ENABLE_MPI
+	::Lattice::LatticeWorkspace<reduced_dirac_vector_t, 2> conversionBuffers;
+#endif
+};
+
+} /* namespace Update */
+#endif /* SOLUTIONHISTORY_H_ */
@@ -0,0 +1,32 @@
+#include "dirac_operators/DiracOperator.h"
+#include "Solver.h"
+#include "BiConjugateGradient.h"
+#include "PreconditionedBiCGStab.h"
+#include "MixedPrecisionSolver.h"
+#include "PipelinedConjugateGradient.h"
+
+namespace Update {
+
+Solver* Solver::getInstance(const std::string& name) {
+	if (name == "biconjugate_gradient") {
+		return new BiConjugateGradient();
+	}
+	else if (name == "preconditioned_biconjugate_gradient") {
+		return new PreconditionedBiCGStab();
+	}
+	else if (name == "mixed_precision_conjugate_gradient") {
+		return new MixedPrecisionSolver(MixedPrecisionSolver::ConjugateGradientSolver);
+	}
+	else if (name == "mixed_precision_biconjugate_gradient") {
+		return new MixedPrecisionSolver(MixedPrecisionSolver::BiConjugateGradientSolver);
+	}
+	else if (name == "pipelined_conjugate_gradient") {
+		return new PipelinedConjugateGradient();
+	}
+	else {
+		if (isOutputProcess()) std::cout << "Name " << name << " of solver is not recognized!" << std::endl;
+		exit(1);
+	}
+}
+
+} /* namespace Update */
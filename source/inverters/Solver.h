@@ -1,7 +1,9 @@
 #ifndef SOLVER_H
 #define SOLVER_H
 #include "Environment.h"
+#include "MPILattice/LatticeWorkspace.h"
 #include <string>
+#include <vector>
 
 namespace Update {
 
@@ -10,18 +12,42 @@ public:
 	Solver(const std::string& _name = "") : name(_name), precision(0.0000000001), maxSteps(1000) { }
 	virtual ~Solver() { }
 
+	//The solvers selected by the inverter options (biconjugate_gradient, preconditioned_biconjugate_gradient, mixed_precision_conjugate_gradient, mixed_precision_biconjugate_gradient, pipelined_conjugate_gradient)
+	static Solver* getInstance(const std::string& name);
+
+	//True for the solvers which converge only for hermitian positive definite operators, as the conjugate gradient
+	virtual bool requiresPositiveDefiniteOperator() const {
+		return false;
+	}
+
 	virtual bool solve(DiracOperator* , const reduced_dirac_vector_t& , reduced_dirac_vector_t&  , reduced_dirac_vector_t const* = 0) {
 		if (isOutputProcess()) std::cout << "Solver::Solver not implemented by this class " << name << std::endl;
 		return false;
 	}
 
+	//Solves the systems with several right hand sides, the default implementation solves them one after the other
+	virtual bool solve(DiracOperator* dirac, const std::vector<reduced_dirac_vector_t>& sources, std::vector<reduced_dirac_vector_t>& solutions) {
+		solutions.resize(sources.size());
+		bool res = true;
+		unsigned int totalSteps = 0;
+		for (unsigned int i = 0; i < sources.size(); ++i) {
+			res = this->solve(dirac, sources[i], solutions[i], 0) && res;
+			totalSteps += lastSteps;
+		}
+		lastSteps = totalSteps;
+		return res;
+	}
+
 #ifdef ENABLE_MPI
 	virtual bool solve(DiracOperator* dirac, const extended_dirac_vector_t& source, extended_dirac_vector_t& solution, extended_dirac_vector_t const* initial_guess = 0) {
-		reduced_dirac_vector_t red_source = source;
-		reduced_dirac_vector_t red_solution;
+		//The conversions to the reduced layout are done in the cached buffers of the solver
+		reduced_dirac_vector_t& red_source = conversionBuffers[0];
+		reduced_dirac_vector_t& red_solution = conversionBuffers[1];
+		red_source = source;
 		bool res = false;
 		if (initial_guess != 0) {
-			reduced_dirac_vector_t red_initial_guess = *initial_guess;
+			reduced_dirac_vector_t& red_initial_guess = conversionBuffers[2];
+			red_initial_guess = *initial_guess;
 			res = this->solve(dirac, red_source, red_solution, &red_initial_guess);
 		}
 		else {
@@ -64,6 +90,9 @@ protected:
 	real_t lastError;
 	unsigned int lastSteps;
 
+#ifdef ENABLE_MPI
+	::Lattice::LatticeWorkspace<reduced_dirac_vector_t, 3> conversionBuffers;
+#endif
 };
 
 }
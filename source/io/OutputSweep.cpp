@@ -1,7 +1,9 @@
 #include "OutputSweep.h"
 #include "Environment.h"
+#include "ParallelGaugeFile.h"
 #include "wilson_loops/Plaquette.h"
 #include "utils/ToString.h"
+#include "utils/CounterRandomGenerator.h"
 #include <fstream>
 #include <rpc/rpc.h>
 #include <rpc/xdr.h>
@@ -84,6 +86,19 @@ void OutputSweep::execute(environment_t& environment) {
 		}
 
 	}
+	else if (format_name == "leonard_parallel_format") {
+		std::string output_name = environment.configurations.get<std::string>("output_configuration_name");
+		std::string output_directory = environment.configurations.get<std::string>("output_directory_configurations");
+		int offset = environment.configurations.get<unsigned int>("output_offset");
+
+		std::string output_file = output_directory+output_name+"_"+toString(environment.sweep+offset)+".dat";
+		if (isOutputProcess()) std::cout << "OutputSweep::Writing configuration to file " << output_file << std::endl;
+
+		double plaquette = Plaquette::temporalPlaquette(environment.gaugeLinkConfiguration);
+		if (!ParallelGaugeFile::write(environment, output_file, plaquette)) {
+			if (isOutputProcess()) std::cout << "OutputSweep::Writing failed!" << std::endl;
+		}
+	}
 	else if (format_name == "muenster_format") {
 #if NUMCOLORS == 2
 		typedef extended_gauge_lattice_t::Layout Layout;
@@ -147,7 +162,7 @@ void OutputSweep::execute(environment_t& environment) {
 					for (int x = 0; x < Layout::glob_x; ) {
 						while (x < Layout::glob_x && rank == Layout::rankTable(x,y,z,t)) {
 							int globsite = Layout::getGlobalCoordinate(x,y,z,t);
-							int localsite = Layout::localIndex[globsite];
+							int localsite = Layout::getLocalIndex(globsite);
 							
 							if (localsite != -1 && localsite < Layout::localsize) {
 								for (unsigned int mu = 0; mu < 4; ++mu) {
@@ -347,7 +362,7 @@ void OutputSweep::execute(environment_t& environment) {
 					for (int x = 0; x < Layout::glob_x; ) {
 						while (x < Layout::glob_x && rank == Layout::rankTable(x,y,z,t)) {
 							int globsite = Layout::getGlobalCoordinate(x,y,z,t);
-							int localsite = Layout::localIndex[globsite];
+							int localsite = Layout::getLocalIndex(globsite);
 							
 							if (localsite != -1 && localsite < Layout::localsize) {
 								for (unsigned int mu = 0; mu < 4; ++mu) {
@@ -492,6 +507,19 @@ void OutputSweep::execute(environment_t& environment) {
 		fout.close();
 	}
 	
+	//Store the state of the counter based generator next to the configuration, a restart must not replay the random fields
+	if (isOutputProcess()) {
+		std::string output_name = environment.configurations.get<std::string>("output_configuration_name");
+		std::string output_directory = environment.configurations.get<std::string>("output_directory_configurations");
+		int offset = environment.configurations.get<unsigned int>("output_offset");
+
+		std::string rng_name = output_directory+output_name+"_"+toString(environment.sweep+offset)+".rng.txt";
+		std::fstream rng;
+		rng.open(rng_name.c_str(), std::fstream::out);
+		rng << CounterRandomGenerator::getSeed() << " " << CounterRandomGenerator::getStream() << std::endl;
+		rng.close();
+	}
+	
 	gettimeofday(&stop,NULL);
 	timersub(&stop,&start,&result);
 	if (isOutputProcess()) std::cout << "OutputSweep::Configuration written in: " << (double)result.tv_sec + result.tv_usec/1000000.0 << " sec" << std::endl;
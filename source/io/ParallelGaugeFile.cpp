@@ -0,0 +1,268 @@
+#include "ParallelGaugeFile.h"
+#include <cstring>
+#include <cstdio>
+#include <vector>
+
+namespace Update {
+
+namespace {
+
+const char parallelGaugeFileMagic[8] = {'L','E','O','N','A','R','D','1'};
+const int32_t parallelGaugeFileEndianness = 0x01020304;
+
+uint32_t crcTable[256];
+
+void initializeCrcTable() {
+	for (uint32_t i = 0; i < 256; ++i) {
+		uint32_t crc = i;
+		for (int k = 0; k < 8; ++k) crc = (crc & 1) ? (0xEDB88320u ^ (crc >> 1)) : (crc >> 1);
+		crcTable[i] = crc;
+	}
+}
+
+uint32_t crc32(const unsigned char* data, size_t length) {
+	uint32_t crc = 0xFFFFFFFFu;
+	for (size_t i = 0; i < length; ++i) crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return crc ^ 0xFFFFFFFFu;
+}
+
+uint32_t rotate(uint32_t value, int shift) {
+	return shift == 0 ? value : ((value << shift) | (value >> (32 - shift)));
+}
+
+}
+
+void ParallelGaugeFile::getLocalBox(int origin[4], int size[4]) {
+	typedef extended_gauge_lattice_t::Layout Layout;
+#ifdef ENABLE_MPI
+	for (int mu = 0; mu < 4; ++mu) origin[mu] = Layout::origin[mu];
+#endif
+#ifndef ENABLE_MPI
+	for (int mu = 0; mu < 4; ++mu) origin[mu] = 0;
+#endif
+	size[0] = Layout::loc_x;
+	size[1] = Layout::loc_y;
+	size[2] = Layout::loc_z;
+	size[3] = Layout::loc_t;
+}
+
+void ParallelGaugeFile::pack(const extended_gauge_lattice_t& lattice, double* buffer) {
+	typedef extended_gauge_lattice_t::Layout Layout;
+	int origin[4], size[4];
+	getLocalBox(origin, size);
+#pragma omp parallel for
+	for (int index = 0; index < Layout::localsize; ++index) {
+		int x = index % size[0];
+		int y = (index / size[0]) % size[1];
+		int z = (index / (size[0]*size[1])) % size[2];
+		int t = index / (size[0]*size[1]*size[2]);
+		int site = Layout::getLocalIndex(Layout::getGlobalCoordinate(origin[0] + x, origin[1] + y, origin[2] + z, origin[3] + t));
+		double* data = buffer + static_cast<size_t>(index)*siteSize;
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			for (int i = 0; i < numberColors; ++i) {
+				for (int j = 0; j < numberColors; ++j) {
+					*(data++) = real(lattice[site][mu].at(i,j));
+					*(data++) = imag(lattice[site][mu].at(i,j));
+				}
+			}
+		}
+	}
+}
+
+void ParallelGaugeFile::unpack(extended_gauge_lattice_t& lattice, const double* buffer) {
+	typedef extended_gauge_lattice_t::Layout Layout;
+	int origin[4], size[4];
+	getLocalBox(origin, size);
+#pragma omp parallel for
+	for (int index = 0; index < Layout::localsize; ++index) {
+		int x = index % size[0];
+		int y = (index / size[0]) % size[1];
+		int z = (index / (size[0]*size[1])) % size[2];
+		int t = index / (size[0]*size[1]*size[2]);
+		int site = Layout::getLocalIndex(Layout::getGlobalCoordinate(origin[0] + x, origin[1] + y, origin[2] + z, origin[3] + t));
+		const double* data = buffer + static_cast<size_t>(index)*siteSize;
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			for (int i = 0; i < numberColors; ++i) {
+				for (int j = 0; j < numberColors; ++j) {
+					lattice[site][mu].at(i,j) = std::complex<real_t>(data[0], data[1]);
+					data += 2;
+				}
+			}
+		}
+	}
+}
+
+void ParallelGaugeFile::checksum(const double* buffer, uint32_t result[2]) {
+	typedef extended_gauge_lattice_t::Layout Layout;
+	int origin[4], size[4];
+	getLocalBox(origin, size);
+	initializeCrcTable();
+	uint32_t suma = 0, sumb = 0;
+#pragma omp parallel for reduction(^:suma,sumb)
+	for (int index = 0; index < Layout::localsize; ++index) {
+		int x = index % size[0];
+		int y = (index / size[0]) % size[1];
+		int z = (index / (size[0]*size[1])) % size[2];
+		int t = index / (size[0]*size[1]*size[2]);
+		long globalIndex = ((static_cast<long>(origin[3] + t)*Layout::glob_z + origin[2] + z)*Layout::glob_y + origin[1] + y)*Layout::glob_x + origin[0] + x;
+		uint32_t crc = crc32(reinterpret_cast<const unsigned char*>(buffer + static_cast<size_t>(index)*siteSize), siteSize*sizeof(double));
+		suma ^= rotate(crc, globalIndex % 29);
+		sumb ^= rotate(crc, globalIndex % 31);
+	}
+#ifdef ENABLE_MPI
+	uint32_t local[2] = {suma, sumb};
+	MPI_Allreduce(local, result, 2, MPI_UNSIGNED, MPI_BXOR, MPI_COMM_WORLD);
+#endif
+#ifndef ENABLE_MPI
+	result[0] = suma;
+	result[1] = sumb;
+#endif
+}
+
+bool ParallelGaugeFile::write(const environment_t& environment, const std::string& filename, double plaquette) {
+	typedef extended_gauge_lattice_t::Layout Layout;
+	std::vector<double> buffer(static_cast<size_t>(Layout::localsize)*siteSize);
+	pack(environment.gaugeLinkConfiguration, &buffer[0]);
+
+	Header header;
+	memset(&header, 0, sizeof(Header));
+	memcpy(header.magic, parallelGaugeFileMagic, 8);
+	header.endianness = parallelGaugeFileEndianness;
+	header.numberColors = numberColors;
+	header.glob[0] = Layout::glob_x;
+	header.glob[1] = Layout::glob_y;
+	header.glob[2] = Layout::glob_z;
+	header.glob[3] = Layout::glob_t;
+	header.plaquette = plaquette;
+	checksum(&buffer[0], header.checksum);
+
+#ifdef ENABLE_MPI
+	MPI_File fh;
+	if (MPI_File_open(MPI_COMM_WORLD, const_cast<char*>(filename.c_str()), MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+		if (isOutputProcess()) std::cout << "ParallelGaugeFile::File " << filename << " not writable!" << std::endl;
+		return false;
+	}
+	MPI_File_set_size(fh, sizeof(Header) + static_cast<MPI_Offset>(Layout::globalVolume)*siteSize*sizeof(double));
+	if (isOutputProcess()) MPI_File_write_at(fh, 0, &header, sizeof(Header), MPI_BYTE, MPI_STATUS_IGNORE);
+
+	//Every processor writes its local box of the global lattice, t is the slowest index
+	MPI_Datatype siteType, boxType;
+	MPI_Type_contiguous(siteSize, MPI_DOUBLE, &siteType);
+	MPI_Type_commit(&siteType);
+	int sizes[4] = {Layout::glob_t, Layout::glob_z, Layout::glob_y, Layout::glob_x};
+	int subsizes[4] = {Layout::loc_t, Layout::loc_z, Layout::loc_y, Layout::loc_x};
+	int starts[4] = {Layout::origin[3], Layout::origin[2], Layout::origin[1], Layout::origin[0]};
+	MPI_Type_create_subarray(4, sizes, subsizes, starts, MPI_ORDER_C, siteType, &boxType);
+	MPI_Type_commit(&boxType);
+
+	MPI_File_set_view(fh, sizeof(Header), siteType, boxType, const_cast<char*>("native"), MPI_INFO_NULL);
+	int result = MPI_File_write_at_all(fh, 0, &buffer[0], Layout::localsize, siteType, MPI_STATUS_IGNORE);
+	MPI_File_close(&fh);
+	MPI_Type_free(&boxType);
+	MPI_Type_free(&siteType);
+	if (result != MPI_SUCCESS) {
+		if (isOutputProcess()) std::cout << "ParallelGaugeFile::Error in writing file " << filename << std::endl;
+		return false;
+	}
+#endif
+#ifndef ENABLE_MPI
+	FILE* fout = fopen(filename.c_str(), "wb");
+	if (!fout) {
+		std::cout << "ParallelGaugeFile::File " << filename << " not writable!" << std::endl;
+		return false;
+	}
+	bool success = (fwrite(&header, sizeof(Header), 1, fout) == 1) && (fwrite(&buffer[0], sizeof(double), buffer.size(), fout) == buffer.size());
+	fclose(fout);
+	if (!success) {
+		std::cout << "ParallelGaugeFile::Error in writing file " << filename << std::endl;
+		return false;
+	}
+#endif
+	return true;
+}
+
+bool ParallelGaugeFile::read(environment_t& environment, const std::string& filename, double& plaquette) {
+	typedef extended_gauge_lattice_t::Layout Layout;
+	std::vector<double> buffer(static_cast<size_t>(Layout::localsize)*siteSize);
+	Header header;
+
+#ifdef ENABLE_MPI
+	MPI_File fh;
+	if (MPI_File_open(MPI_COMM_WORLD, const_cast<char*>(filename.c_str()), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+		if (isOutputProcess()) std::cout << "ParallelGaugeFile::File " << filename << " not readable!" << std::endl;
+		return false;
+	}
+	if (isOutputProcess()) MPI_File_read_at(fh, 0, &header, sizeof(Header), MPI_BYTE, MPI_STATUS_IGNORE);
+	MPI_Bcast(&header, sizeof(Header), MPI_BYTE, 0, MPI_COMM_WORLD);
+#endif
+#ifndef ENABLE_MPI
+	FILE* fin = fopen(filename.c_str(), "rb");
+	if (!fin) {
+		std::cout << "ParallelGaugeFile::File " << filename << " not readable!" << std::endl;
+		return false;
+	}
+	if (fread(&header, sizeof(Header), 1, fin) != 1) memset(&header, 0, sizeof(Header));
+#endif
+
+	bool success = true;
+	if (memcmp(header.magic, parallelGaugeFileMagic, 8) != 0 || header.endianness != parallelGaugeFileEndianness) {
+		if (isOutputProcess()) std::cout << "ParallelGaugeFile::Wrong header or byte order in file " << filename << std::endl;
+		success = false;
+	}
+	else if (header.numberColors != numberColors || header.glob[0] != Layout::glob_x || header.glob[1] != Layout::glob_y || header.glob[2] != Layout::glob_z || header.glob[3] != Layout::glob_t) {
+		if (isOutputProcess()) {
+			std::cout << "ParallelGaugeFile::Different lattice in reading configuration!" << std::endl;
+			std::cout << "Configured: " << numberColors << " colors, " << Layout::glob_x << " " << Layout::glob_y << " " << Layout::glob_z << " " << Layout::glob_t << std::endl;
+			std::cout << "Readed: " << header.numberColors << " colors, " << header.glob[0] << " " << header.glob[1] << " " << header.glob[2] << " " << header.glob[3] << std::endl;
+		}
+		success = false;
+	}
+
+#ifdef ENABLE_MPI
+	if (success) {
+		MPI_Datatype siteType, boxType;
+		MPI_Type_contiguous(siteSize, MPI_DOUBLE, &siteType);
+		MPI_Type_commit(&siteType);
+		int sizes[4] = {Layout::glob_t, Layout::glob_z, Layout::glob_y, Layout::glob_x};
+		int subsizes[4] = {Layout::loc_t, Layout::loc_z, Layout::loc_y, Layout::loc_x};
+		int starts[4] = {Layout::origin[3], Layout::origin[2], Layout::origin[1], Layout::origin[0]};
+		MPI_Type_create_subarray(4, sizes, subsizes, starts, MPI_ORDER_C, siteType, &boxType);
+		MPI_Type_commit(&boxType);
+
+		MPI_File_set_view(fh, sizeof(Header), siteType, boxType, const_cast<char*>("native"), MPI_INFO_NULL);
+		int result = MPI_File_read_at_all(fh, 0, &buffer[0], Layout::localsize, siteType, MPI_STATUS_IGNORE);
+		MPI_Type_free(&boxType);
+		MPI_Type_free(&siteType);
+		if (result != MPI_SUCCESS) {
+			if (isOutputProcess()) std::cout << "ParallelGaugeFile::Error in reading file " << filename << std::endl;
+			success = false;
+		}
+	}
+	MPI_File_close(&fh);
+	//The processors must agree on the result of the reading
+	int localSuccess = success ? 1 : 0, globalSuccess = 0;
+	MPI_Allreduce(&localSuccess, &globalSuccess, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+	success = (globalSuccess == 1);
+#endif
+#ifndef ENABLE_MPI
+	if (success && fread(&buffer[0], sizeof(double), buffer.size(), fin) != buffer.size()) {
+		std::cout << "ParallelGaugeFile::Error in reading file " << filename << std::endl;
+		success = false;
+	}
+	fclose(fin);
+#endif
+	if (!success) return false;
+
+	uint32_t readChecksum[2];
+	checksum(&buffer[0], readChecksum);
+	if (readChecksum[0] != header.checksum[0] || readChecksum[1] != header.checksum[1]) {
+		if (isOutputProcess()) std::cout << "ParallelGaugeFile::Checksum mismatch in file " << filename << ": " << std::hex << readChecksum[0] << " " << readChecksum[1] << " instead of " << header.checksum[0] << " " << header.checksum[1] << std::dec << std::endl;
+		return false;
+	}
+
+	unpack(environment.gaugeLinkConfiguration, &buffer[0]);
+	plaquette = header.plaquette;
+	return true;
+}
+
+} /* namespace Update */
@@ -0,0 +1,61 @@
+#ifndef PARALLELGAUGEFILE_H_
+#define PARALLELGAUGEFILE_H_
+#include "Environment.h"
+#include <string>
+#include <stdint.h>
+
+namespace Update {
+
+/**
+ * Single file format for the gauge configurations (leonard_parallel_format): a binary header followed by the links of
+ * all the sites in lexicographic order (x fastest, then y, z and t) as native doubles. With MPI the file is written and
+ * read collectively with MPI-IO, every processor accessing its local box through a subarray datatype, so that the same
+ * file can be read back with any processor grid.
+ */
+class ParallelGaugeFile {
+public:
+	/**
+	 * This function writes the gauge configuration in a single file
+	 * @param environment
+	 * @param filename
+	 * @param plaquette the temporal plaquette stored in the header
+	 * @return true if the writing succeeds
+	 */
+	static bool write(const environment_t& environment, const std::string& filename, double plaquette);
+
+	/**
+	 * This function reads the gauge configuration, the lattice size and the checksum are checked
+	 * @param environment
+	 * @param filename
+	 * @param plaquette the temporal plaquette stored in the header
+	 * @return true if the reading succeeds
+	 */
+	static bool read(environment_t& environment, const std::string& filename, double& plaquette);
+
+private:
+	//The header is 64 bytes long, the endianness field detects files written on a machine with a different byte order
+	struct Header {
+		char magic[8];
+		int32_t endianness;
+		int32_t numberColors;
+		int32_t glob[4];
+		uint32_t checksum[2];
+		double plaquette;
+		char reserved[16];
+	};
+
+	//Number of doubles for the four links of a site
+	static const int siteSize = 4*numberColors*numberColors*2;
+
+	//Copy the links of the local box in lexicographic order to/from buffer
+	static void pack(const extended_gauge_lattice_t& lattice, double* buffer);
+	static void unpack(extended_gauge_lattice_t& lattice, const double* buffer);
+
+	//SciDAC-like checksum, the crc32 of every site combined with a rotation depending on its global lexicographic index
+	static void checksum(const double* buffer, uint32_t result[2]);
+
+	static void getLocalBox(int origin[4], int size[4]);
+};
+
+} /* namespace Update */
+#endif /* PARALLELGAUGEFILE_H_ */
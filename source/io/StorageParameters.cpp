@@ -111,6 +111,16 @@ template<> std::vector< unsigned int > get< std::vector< unsigned int > >(const
 	return ris;
 }
 
+template<> std::vector< int > get< std::vector< int > >(const boost::program_options::variables_map& vm, const std::string& nameOption) {
+	std::vector<std::string> tmp = get< std::vector<std::string> >(vm, nameOption);
+	std::vector< int > ris;
+	std::vector<std::string>::iterator i;
+	for (i = tmp.begin(); i != tmp.end(); ++i) {
+		ris.push_back(fromString< int >(*i));
+	}
+	return ris;
+}
+
 } /* namespace implement */
 
 } /* namespace Update */
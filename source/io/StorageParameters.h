@@ -45,6 +45,8 @@ template<> std::vector< double > get< std::vector< double > >(const boost::progr
 
 template<> std::vector< unsigned int > get< std::vector< unsigned int > >(const boost::program_options::variables_map& vm, const std::string& nameOption);
 
+template<> std::vector< int > get< std::vector< int > >(const boost::program_options::variables_map& vm, const std::string& nameOption);
+
 template<> std::vector<std::string> get< std::vector<std::string> >(const boost::program_options::variables_map& vm, const std::string& nameOption);
 
 }
@@ -2,6 +2,7 @@
 #include "io/StorageParameters.h"
 #include "MatrixTypedef.h"
 #include "utils/RandomSeed.h"
+#include "utils/CounterRandomGenerator.h"
 #include "utils/ToString.h"
 #include "Simulation.h"
 #include "LatticeSweep.h"
@@ -30,10 +31,16 @@ MPI_Datatype MpiType<Update::FundamentalGroup[4]>::type = MPI_DOUBLE;
 MPI_Datatype MpiType<Update::AdjointGroup[4]>::type = MPI_DOUBLE;
 MPI_Datatype MpiType<Update::FundamentalGroup[6]>::type = MPI_DOUBLE;
 MPI_Datatype MpiType<Update::AdjointGroup[6]>::type = MPI_DOUBLE;
+MPI_Datatype MpiType<Update::CompressedFundamentalGroup[4]>::type = MPI_DOUBLE;
 MPI_Datatype MpiType<Update::FundamentalVector[4]>::type = MPI_DOUBLE;
-MPI_Datatype MpiType<Update::AdjointVector[4]>::type = MPI_DOUBLE;
-MPI_Datatype MpiType<Update::AdjointVector>::type = MPI_DOUBLE;
+MPI_Datatype MpiType<Update::AdjointComplexVector[4]>::type = MPI_DOUBLE;
+MPI_Datatype MpiType<Update::AdjointComplexVector>::type = MPI_DOUBLE;
+MPI_Datatype MpiType<Update::AdjointRealVector>::type = MPI_DOUBLE;
 MPI_Datatype MpiType<Update::FundamentalVector>::type = MPI_DOUBLE;
+MPI_Datatype MpiType<Update::single_FundamentalVector[4]>::type = MPI_FLOAT;
+MPI_Datatype MpiType<Update::single_AdjointVector[4]>::type = MPI_FLOAT;
+MPI_Datatype MpiType<Update::single_FundamentalGroup[4]>::type = MPI_FLOAT;
+MPI_Datatype MpiType<Update::single_AdjointGroup[4]>::type = MPI_FLOAT;
 MPI_Datatype MpiType<Update::FundamentalGroup>::type = MPI_DOUBLE;
 MPI_Datatype MpiType<Update::AdjointGroup>::type = MPI_DOUBLE;
 #ifdef ADJOINT
@@ -41,6 +48,10 @@ MPI_Datatype MpiType<Update::FermionicForceMatrix[4]>::type = MPI_DOUBLE;
 #endif
 #endif
 
+#ifdef DEBUG_MEMORY_ALLOCATION
+long int Lattice::AllocationCounter::total = 0;
+#endif
+
 
 namespace po = boost::program_options;
 
@@ -96,9 +107,9 @@ int main(int ac, char* av[]) {
 		("input_number", po::value<unsigned int>(), "The number of the file of the input")
 		("output_configuration_name", po::value<std::string>(), "The name of the output of the field")
 		("output_offset", po::value<unsigned int>(), "The offset for the number of the output configurations")
-		("format_name", po::value<std::string>(), "leonard_format/muenster_format for reading and writing configurations")
-		("input_format_name", po::value<std::string>(), "leonard_format/muenster_format only for reading configurations")
-		("output_format_name", po::value<std::string>(), "leonard_format/muenster_format only for writing configurations")
+		("format_name", po::value<std::string>(), "leonard_format/leonard_parallel_format/muenster_format for reading and writing configurations")
+		("input_format_name", po::value<std::string>(), "leonard_format/leonard_parallel_format/muenster_format only for reading configurations")
+		("output_format_name", po::value<std::string>(), "leonard_format/leonard_parallel_format/muenster_format only for writing configurations")
 		("measurement_output_format", po::value<std::string>()->default_value("txt"), "output format for the measurements (xml/txt)")
 		
 		//Start, warm up and measurement specifications
@@ -107,6 +118,7 @@ int main(int ac, char* av[]) {
 		("start_configuration_number", po::value<unsigned int>(), "The beginning number of the output configuration written (zero as default)")
 		("number_warm_up_sweeps", po::value<unsigned int>(), "the number of warm-up sweeps")
 		("number_measurement_sweeps", po::value<unsigned int>(), "the number of measurement sweeps")
+		("random_seed", po::value<unsigned long long>(), "the 64 bit seed of the counter based generator of the random fields, the same fields are generated for any number of threads and processors (random as default)")
 		("warm_up_sweeps", po::value< std::string >(), "the vector of the warm up sweeps to do (example: {{PureGaugeCM,1,1},{Plaquette,1,1}} )")
 		("measurement_sweeps", po::value< std::string >(), "the vector of the measurement sweeps to do (example: {{PureGaugeCM,1,1},{Plaquette,1,1}} )")
 		
@@ -121,6 +133,8 @@ int main(int ac, char* av[]) {
 		
 		//RHMC options
 		("force_inverter_precision", po::value<Update::real_t>(), "The precision for the inverter in the force step")
+		("force_inverter", po::value<std::string>()->default_value("biconjugate_gradient"), "the inverter of the force of the two flavor HMC (biconjugate_gradient, preconditioned_biconjugate_gradient, mixed_precision_conjugate_gradient, mixed_precision_biconjugate_gradient, pipelined_conjugate_gradient)")
+		("force_inverter_history", po::value<unsigned int>()->default_value(0), "the number of previous solutions used to extrapolate the initial guesses of the force inversions (0 disables it)")
 		("metropolis_inverter_precision", po::value<Update::real_t>(), "The precision for the inverter in the metropolis step")
 		("metropolis_inverter_max_steps", po::value<unsigned int>(),"maximum level of steps used by the inverters for computing the energy of the metropolis step")
 		("force_inverter_max_steps", po::value<unsigned int>(),"maximum level of steps used by the inverters for computing the force")
@@ -294,6 +308,19 @@ int main(int ac, char* av[]) {
 #endif
 	}
 
+	//Set the seed of the counter based generator, it must be the same on all the processors
+	unsigned long long seed;
+	if (vm.count("random_seed")) seed = vm["random_seed"].as<unsigned long long>();
+	else {
+		//Both halves of the key of the generator are random
+		seed = (static_cast<unsigned long long>(static_cast<unsigned int>(Update::RandomSeed::randomSeed())) << 32) | static_cast<unsigned int>(Update::RandomSeed::randomSeed());
+#ifdef ENABLE_MPI
+		MPI_Bcast(&seed, 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
+#endif
+	}
+	Update::CounterRandomGenerator::setSeed(seed);
+	if (isOutputProcess()) std::cout << "Seed of the random fields: " << seed << std::endl;
+
 	//Set the output to format
 	Update::GlobalOutput* output = Update::GlobalOutput::getInstance();
 	output->setFormat(vm["measurement_output_format"].as<std::string>());
@@ -310,8 +337,13 @@ int main(int ac, char* av[]) {
 	output->print();
 	output->destroy();
 
+	//Report the memory used by the lattices
+	Lattice::LatticeMemoryPool& memoryPool = Lattice::LatticeMemoryPool::getInstance();
+	if (isOutputProcess()) std::cout << "Lattice memory in use: " << memoryPool.getCurrentUsage()/1048576. << " MB, peak: " << memoryPool.getPeakUsage()/1048576. << " MB, kept for reuse: " << memoryPool.getPooledMemory()/1048576. << " MB" << std::endl;
+
 	//destroy the environment
 	delete environment;
+	memoryPool.clear();
 
 #ifdef ENABLE_MPI
 	Lattice::MpiLayout<Lattice::ExtendedStencil>::destroy();
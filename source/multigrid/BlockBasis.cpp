@@ -31,13 +31,6 @@ void BlockBasis::setBasisDimension(int _basisDimension) {
 }
 
 void BlockBasis::orthogonalize(int index) {
-#ifndef MULTITHREADING
-	int numberProcessors = 1;
-#endif
-#ifdef MULTITHREADING
-	int numberProcessors = omp_get_max_threads();
-#endif
-
 	//We orthogonalize first the vector between the others to have a better projection to the low modes
 	for (int j = 0; j < multigrid_vector_t::Layout::basisDimension; ++j) {
 		if (j != index) {
@@ -55,79 +48,14 @@ void BlockBasis::orthogonalize(int index) {
 
 	//Now we perform a block orthogonalization of the local basis
 	for (int j = 0; j < multigrid_vector_t::Layout::basisDimension; ++j) {
-		if (j != index) {
-			std::complex<real_t> proj[multigrid_vector_t::Layout::totalNumberOfBlocks][numberProcessors];
-			for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) {
-				for (int p = 0; p < numberProcessors; ++p) proj[k][p] = 0.;
-			}
-#pragma omp parallel for
-			for (int site = 0; site < vectorspace[index].localsize; ++site) {
-				for (unsigned int mu = 0; mu < 4; ++mu) {
-					for (int c = 0; c < diracVectorLength; ++c) {
-#ifndef MULTITHREADING
-						proj[multigrid_vector_t::Layout::index(site)][0] += conj(vectorspace[j][site][mu][c])*vectorspace[index][site][mu][c];
-#endif
-#ifdef MULTITHREADING
-						proj[multigrid_vector_t::Layout::index(site)][omp_get_thread_num()] += conj(vectorspace[j][site][mu][c])*vectorspace[index][site][mu][c];
-#endif
-					}
-				}
-			}
-			for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) {
-				for (int p = 1; p < numberProcessors; ++p) proj[k][0] += proj[k][p];
-			}
-			//for (int k = 0; k < totalNumberOfBlocks; ++k) reduceAllSum(proj[k][0]);
-#pragma omp parallel for
-			for (int site = 0; site < vectorspace[index].localsize; ++site) {
-				for (unsigned int mu = 0; mu < 4; ++mu) {
-					vectorspace[index][site][mu] -= proj[multigrid_vector_t::Layout::index(site)][0]*vectorspace[j][site][mu];
-				}
-			}
-		}
+		if (j != index) this->blockOrthogonalize(index, j);
 
 		//Now we block normalize the vector
-		real_t norm[multigrid_vector_t::Layout::totalNumberOfBlocks][numberProcessors];
-		for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) {
-			for (int p = 0; p < numberProcessors; ++p) norm[k][p] = 0.;
-		}
-#pragma omp parallel for
-		for (int site = 0; site < vectorspace[index].localsize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				for (int c = 0; c < diracVectorLength; ++c) {
-#ifndef MULTITHREADING
-					norm[multigrid_vector_t::Layout::index(site)][0] += real(conj(vectorspace[index][site][mu][c])*vectorspace[index][site][mu][c]);
-#endif
-#ifdef MULTITHREADING
-					norm[multigrid_vector_t::Layout::index(site)][omp_get_thread_num()] += real(conj(vectorspace[index][site][mu][c])*vectorspace[index][site][mu][c]);
-#endif
-				}
-			}
-		}
-		for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) {
-			for (int p = 1; p < numberProcessors; ++p) norm[k][0] += norm[k][p];
-		}
-		//for (int k = 0; k < totalNumberOfBlocks; ++k) reduceAllSum(norm[k][0]);
-		for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) norm[k][0] = sqrt(norm[k][0]);
-#pragma omp parallel for
-		for (int site = 0; site < vectorspace[index].localsize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-				vectorspace[index][site][mu] = vectorspace[index][site][mu]/norm[multigrid_vector_t::Layout::index(site)][0];
-			}
-		}		
-
-		//TODO: is it needed?
-		vectorspace[index].updateHalo();
+		this->blockNormalize(index);
 	}			
 }
 
 void BlockBasis::orthogonalize() {
-#ifndef MULTITHREADING
-	int numberProcessors = 1;
-#endif
-#ifdef MULTITHREADING
-	int numberProcessors = omp_get_max_threads();
-#endif
-
 	//We orthogonalize first the vectors between themself to have a better projection to the low modes
 	for (int i = 0; i < basisDimension; ++i) {
 		for (int j = 0; j < i; ++j) {
@@ -145,70 +73,58 @@ void BlockBasis::orthogonalize() {
 
 	//Now we perform a block orthogonalization of the local basis
 	for (int i = 0; i < multigrid_vector_t::Layout::basisDimension; ++i) {
-		for (int j = 0; j < i; ++j) {
-			std::complex<real_t> proj[multigrid_vector_t::Layout::totalNumberOfBlocks][numberProcessors];
-			for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) {
-				for (int p = 0; p < numberProcessors; ++p) proj[k][p] = 0.;
-			}
-#pragma omp parallel for
-			for (int site = 0; site < vectorspace[i].localsize; ++site) {
-				for (unsigned int mu = 0; mu < 4; ++mu) {
-					for (int c = 0; c < diracVectorLength; ++c) {
-#ifndef MULTITHREADING
-						proj[multigrid_vector_t::Layout::index(site)][0] += conj(vectorspace[j][site][mu][c])*vectorspace[i][site][mu][c];
-#endif
-#ifdef MULTITHREADING
-						proj[multigrid_vector_t::Layout::index(site)][omp_get_thread_num()] += conj(vectorspace[j][site][mu][c])*vectorspace[i][site][mu][c];
-#endif
-					}
-				}
-			}
-			for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) {
-				for (int p = 1; p < numberProcessors; ++p) proj[k][0] += proj[k][p];
-			}
-			//for (int k = 0; k < totalNumberOfBlocks; ++k) reduceAllSum(proj[k][0]);
-#pragma omp parallel for
-			for (int site = 0; site < vectorspace[i].localsize; ++site) {
-				for (unsigned int mu = 0; mu < 4; ++mu) {
-					vectorspace[i][site][mu] -= proj[multigrid_vector_t::Layout::index(site)][0]*vectorspace[j][site][mu];
-				}
-			}
-		}
+		for (int j = 0; j < i; ++j) this->blockOrthogonalize(i, j);
 
 		//Now we block normalize the vector
-		real_t norm[multigrid_vector_t::Layout::totalNumberOfBlocks][numberProcessors];
-		for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) {
-			for (int p = 0; p < numberProcessors; ++p) norm[k][p] = 0.;
-		}
+		this->blockNormalize(i);
+	}
+}
+
+void BlockBasis::blockOrthogonalize(int i, int j) {
+	const int numberBlocks = multigrid_vector_t::Layout::totalNumberOfBlocks;
+	std::vector< std::complex<real_t> > proj(numberBlocks);
 #pragma omp parallel for
-		for (int site = 0; site < vectorspace[i].localsize; ++site) {
+	for (int block = 0; block < numberBlocks; ++block) {
+		std::complex<real_t> result = 0.;
+		for (int index = multigrid_vector_t::Layout::blockOffsets[block]; index < multigrid_vector_t::Layout::blockOffsets[block + 1]; ++index) {
+			int site = multigrid_vector_t::Layout::blockSites[index];
 			for (unsigned int mu = 0; mu < 4; ++mu) {
-				for (int c = 0; c < diracVectorLength; ++c) {
-#ifndef MULTITHREADING
-					norm[multigrid_vector_t::Layout::index(site)][0] += real(conj(vectorspace[i][site][mu][c])*vectorspace[i][site][mu][c]);
-#endif
-#ifdef MULTITHREADING
-					norm[multigrid_vector_t::Layout::index(site)][omp_get_thread_num()] += real(conj(vectorspace[i][site][mu][c])*vectorspace[i][site][mu][c]);
-#endif
-				}
+				result += vector_dot(vectorspace[j][site][mu],vectorspace[i][site][mu]);
 			}
 		}
-		for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) {
-			for (int p = 1; p < numberProcessors; ++p) norm[k][0] += norm[k][p];
+		proj[block] = result;
+	}
+#pragma omp parallel for
+	for (int site = 0; site < vectorspace[i].localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			vectorspace[i][site][mu] -= proj[multigrid_vector_t::Layout::index(site)]*vectorspace[j][site][mu];
 		}
-		//for (int k = 0; k < totalNumberOfBlocks; ++k) reduceAllSum(norm[k][0]);
-		for (int k = 0; k < multigrid_vector_t::Layout::totalNumberOfBlocks; ++k) norm[k][0] = sqrt(norm[k][0]);
+	}
+}
+
+void BlockBasis::blockNormalize(int i) {
+	const int numberBlocks = multigrid_vector_t::Layout::totalNumberOfBlocks;
+	std::vector<real_t> norm(numberBlocks);
 #pragma omp parallel for
-		for (int site = 0; site < vectorspace[i].localsize; ++site) {
+	for (int block = 0; block < numberBlocks; ++block) {
+		real_t result = 0.;
+		for (int index = multigrid_vector_t::Layout::blockOffsets[block]; index < multigrid_vector_t::Layout::blockOffsets[block + 1]; ++index) {
+			int site = multigrid_vector_t::Layout::blockSites[index];
 			for (unsigned int mu = 0; mu < 4; ++mu) {
-				vectorspace[i][site][mu] = vectorspace[i][site][mu]/norm[multigrid_vector_t::Layout::index(site)][0];
+				result += real(vector_dot(vectorspace[i][site][mu],vectorspace[i][site][mu]));
 			}
-		}		
-
-		//TODO: is it needed?
-		vectorspace[i].updateHalo();
+		}
+		norm[block] = sqrt(result);
+	}
+#pragma omp parallel for
+	for (int site = 0; site < vectorspace[i].localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			vectorspace[i][site][mu] = vectorspace[i][site][mu]/norm[multigrid_vector_t::Layout::index(site)];
+		}
 	}
-}
 
+	//TODO: is it needed?
+	vectorspace[i].updateHalo();
 }
 
+}
@@ -29,6 +29,11 @@ public:
 	void setBasisDimension(int _basisDimension);
 	
 private:
+	//Orthogonalizes the vector i to the vector j on every block
+	void blockOrthogonalize(int i, int j);
+	//Normalizes the vector i on every block
+	void blockNormalize(int i);
+
 	int basisDimension;
 	reduced_dirac_vector_t* vectorspace;
 };
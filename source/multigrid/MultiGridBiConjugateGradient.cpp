@@ -5,6 +5,14 @@ namespace Update {
 MultiGridBiConjugateGradientSolver::MultiGridBiConjugateGradientSolver() : precision(0.000001), maxSteps(300) { }
 
 bool MultiGridBiConjugateGradientSolver::solve(MultiGridOperator* multiGridOperator, const multigrid_vector_t& source, multigrid_vector_t& solution) {
+	//The layout could be changed after the creation of the solver
+	residual.update();
+	residual_hat.update();
+	p.update();
+	nu.update();
+	s.update();
+	t.update();
+
 	solution = source;
 	//Use p as temporary vector
 	multiGridOperator->multiply(p,solution);
@@ -25,21 +33,10 @@ bool MultiGridBiConjugateGradientSolver::solve(MultiGridOperator* multiGridOpera
 	unsigned int step = 0;
 	long_real_t norm_r = 0.;
 
-	while (step < maxSteps) {
-		//rho[k] = rhat.r[k-1]
-		long_real_t rho_next_re = 0.;
-		long_real_t rho_next_im = 0.;
-#pragma omp parallel for reduction(+:rho_next_re, rho_next_im)
-		for (int m = 0; m < multigrid_vector_t::Layout::size; ++m) {
-			complex partial = conj(residual_hat[m])*residual[m];
-			rho_next_re += real(partial);
-			rho_next_im += imag(partial);
-		}
-		reduceAllSum(rho_next_re);
-		reduceAllSum(rho_next_im);
-
-		std::complex<long_real_t> rho_next(rho_next_re,rho_next_im);
+	//rho[k] = rhat.r[k-1], computed at the end of every step together with the norm of the residual
+	std::complex<long_real_t> rho_next = multigrid_vector_t::dot(residual_hat, residual);
 
+	while (step < maxSteps) {
 		if (norm(rho_next) == 0.) {
 			if (isOutputProcess()) std::cout << "BiConjugateGradient::Fatal error in norm " << rho_next << " at step " << step << std::endl;
 			return false;//TODO
@@ -56,18 +53,7 @@ bool MultiGridBiConjugateGradientSolver::solve(MultiGridOperator* multiGridOpera
 		multiGridOperator->multiply(nu,p);
 
 		//alpha = rho[[k]]/(rhat[[1]].nu[[k]]);
-		long_real_t alphatmp_re = 0.;
-		long_real_t alphatmp_im = 0.;
-#pragma omp parallel for reduction(+:alphatmp_re, alphatmp_im)
-		for (int m = 0; m < multigrid_vector_t::Layout::size; ++m) {
-			complex partial = conj(residual_hat[m])*nu[m];
-			alphatmp_re += real(partial);
-			alphatmp_im += imag(partial);
-		}
-		reduceAllSum(alphatmp_re);
-		reduceAllSum(alphatmp_im);
-
-		std::complex<long_real_t> alphatmp(alphatmp_re,alphatmp_im);
+		std::complex<long_real_t> alphatmp = multigrid_vector_t::dot(residual_hat, nu);
 		alpha = static_cast< std::complex<real_t> >(rho_next/alphatmp);
 
 		//s = r[[k - 1]] - alpha*nu[[k]]
@@ -81,29 +67,12 @@ bool MultiGridBiConjugateGradientSolver::solve(MultiGridOperator* multiGridOpera
 		multiGridOperator->multiply(t,s);
 
 		//omega = (t.s)/(t.t)
-		long_real_t tmp1_re = 0., tmp1_im = 0., tmp2_re = 0., tmp2_im = 0.;
-#pragma omp parallel for reduction(+:tmp1_re, tmp1_im, tmp2_re, tmp2_im)
-		for (int m = 0; m < multigrid_vector_t::Layout::size; ++m) {
-			complex partial1 = conj(t[m])*s[m];
-			tmp1_re += real(partial1);
-			tmp1_im += imag(partial1);
-			complex partial2 = conj(t[m])*t[m];
-			tmp2_re += real(partial2);
-			tmp2_im += imag(partial2);
-		}
-		reduceAllSum(tmp1_re);
-		reduceAllSum(tmp1_im);
-		reduceAllSum(tmp2_re);
-		reduceAllSum(tmp2_im);
-
-		std::complex<long_real_t> tmp1(tmp1_re, tmp1_im), tmp2(tmp2_re, tmp2_im);
+		std::complex<long_real_t> tmp1, tmp2;
+		multigrid_vector_t::dots(tmp1, tmp2, t, s, t);
 		omega = static_cast< std::complex<real_t> >(tmp1/tmp2);
 
 		if (real(tmp2) == 0) {
-#pragma omp parallel for
-			for (int m = 0; m < multigrid_vector_t::Layout::size; ++m) {
-				solution[m] = source[m];
-			}
+			solution = source;
 			//solution.updateHalo();
 			return true;//TODO, identity only?
 		}
@@ -116,15 +85,20 @@ bool MultiGridBiConjugateGradientSolver::solve(MultiGridOperator* multiGridOpera
 		//solution.updateHalo();
 
 		//residual[[k]] = s - omega[[k]]*t
-		//norm = residual[[k]].residual[[k]]
+		//norm = residual[[k]].residual[[k]] and rho[[k + 1]] = rhat.residual[[k]] with a single reduction
+		long_real_t rho_next_re = 0., rho_next_im = 0.;
 		norm_r = 0.;
-#pragma omp parallel for reduction(+:norm_r)
+#pragma omp parallel for reduction(+:norm_r, rho_next_re, rho_next_im)
 		for (int m = 0; m < multigrid_vector_t::Layout::size; ++m) {
 			residual[m] = s[m] - omega*(t[m]);
 			norm_r += real(conj(residual[m])*residual[m]);
+			complex partial = conj(residual_hat[m])*residual[m];
+			rho_next_re += real(partial);
+			rho_next_im += imag(partial);
 		}
-		reduceAllSum(norm_r);
-
+		long_real_t result[3] = {norm_r, rho_next_re, rho_next_im};
+		reduceAllSum(result, 3);
+		norm_r = result[0];
 
 		if (norm_r < precision && step > 4) {
 			//lastSteps = step;
@@ -138,6 +112,7 @@ bool MultiGridBiConjugateGradientSolver::solve(MultiGridOperator* multiGridOpera
 		//#endif
 
 		rho = rho_next;
+		rho_next = std::complex<long_real_t>(result[1], result[2]);
 
 		++step;
 	}
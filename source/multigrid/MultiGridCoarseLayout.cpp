@@ -0,0 +1,272 @@
+#include "MultiGridCoarseLayout.h"
+
+namespace Update {
+
+MultiGridCoarseLayout::MultiGridCoarseLayout() : localsize(0), completesize(0), dofs(0), active(false), sourceLocalsize(0) {
+#ifdef ENABLE_MPI
+	communicator = MPI_COMM_NULL;
+	groupCommunicator = MPI_COMM_NULL;
+#endif
+}
+
+MultiGridCoarseLayout::~MultiGridCoarseLayout() {
+#ifdef ENABLE_MPI
+	//The solvers can be destroyed after MPI_Finalize, the communicators are then already released
+	int finalized = 0;
+	MPI_Finalized(&finalized);
+	if (finalized) return;
+	if (communicator != MPI_COMM_NULL) MPI_Comm_free(&communicator);
+	if (groupCommunicator != MPI_COMM_NULL) MPI_Comm_free(&groupCommunicator);
+#endif
+}
+
+void MultiGridCoarseLayout::initialize(const int _globalSize[4], int _dofs) {
+	typedef reduced_index_lattice_t::Layout LT;
+	processorGrid[0] = LT::pgrid_x;
+	processorGrid[1] = LT::pgrid_y;
+	processorGrid[2] = LT::pgrid_z;
+	processorGrid[3] = LT::pgrid_t;
+	//The same ordering of the processors of the fine lattice
+	int rank = LT::this_processor;
+	processorCoordinate[3] = rank % processorGrid[3];
+	processorCoordinate[2] = (rank / processorGrid[3]) % processorGrid[2];
+	processorCoordinate[1] = (rank / (processorGrid[3]*processorGrid[2])) % processorGrid[1];
+	processorCoordinate[0] = rank / (processorGrid[3]*processorGrid[2]*processorGrid[1]);
+
+	for (unsigned int mu = 0; mu < 4; ++mu) {
+		globalSize[mu] = _globalSize[mu];
+		localSize[mu] = globalSize[mu]/processorGrid[mu];
+		origin[mu] = processorCoordinate[mu]*localSize[mu];
+		sourceLocalSize[mu] = localSize[mu];
+	}
+	dofs = _dofs;
+	active = true;
+
+#ifdef ENABLE_MPI
+	if (communicator != MPI_COMM_NULL) MPI_Comm_free(&communicator);
+	if (groupCommunicator != MPI_COMM_NULL) MPI_Comm_free(&groupCommunicator);
+	MPI_Comm_dup(MPI_COMM_WORLD, &communicator);
+#endif
+	this->initializeHalo();
+	sourceLocalsize = localsize;
+}
+
+void MultiGridCoarseLayout::initializeAgglomerated(const MultiGridCoarseLayout& source, const int _stride[4]) {
+	active = true;
+	int groupSize = 1;
+	for (unsigned int mu = 0; mu < 4; ++mu) {
+		globalSize[mu] = source.globalSize[mu];
+		processorGrid[mu] = source.processorGrid[mu]/_stride[mu];
+		localSize[mu] = source.localSize[mu]*_stride[mu];
+		sourceLocalSize[mu] = source.localSize[mu];
+		if (source.processorCoordinate[mu] % _stride[mu] != 0) active = false;
+		processorCoordinate[mu] = source.processorCoordinate[mu]/_stride[mu];
+		origin[mu] = processorCoordinate[mu]*localSize[mu];
+		groupSize *= _stride[mu];
+	}
+	dofs = source.dofs;
+	sourceLocalsize = source.localsize;
+
+	//The processors of a group are ordered as the processors of the fine lattice, the active one is the first
+	groupOrigins.resize(4*groupSize);
+	for (int member = 0; member < groupSize; ++member) {
+		groupOrigins[4*member + 3] = (member % _stride[3])*sourceLocalSize[3];
+		groupOrigins[4*member + 2] = ((member / _stride[3]) % _stride[2])*sourceLocalSize[2];
+		groupOrigins[4*member + 1] = ((member / (_stride[3]*_stride[2])) % _stride[1])*sourceLocalSize[1];
+		groupOrigins[4*member + 0] = (member / (_stride[3]*_stride[2]*_stride[1]))*sourceLocalSize[0];
+	}
+
+#ifdef ENABLE_MPI
+	if (communicator != MPI_COMM_NULL) MPI_Comm_free(&communicator);
+	if (groupCommunicator != MPI_COMM_NULL) MPI_Comm_free(&groupCommunicator);
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	int group = processorGrid[3]*(processorGrid[2]*(processorGrid[1]*processorCoordinate[0] + processorCoordinate[1]) + processorCoordinate[2]) + processorCoordinate[3];
+	MPI_Comm_split(MPI_COMM_WORLD, active ? 0 : MPI_UNDEFINED, rank, &communicator);
+	MPI_Comm_split(MPI_COMM_WORLD, group, rank, &groupCommunicator);
+#endif
+
+	if (active) this->initializeHalo();
+	else {
+		localsize = 0;
+		completesize = 0;
+	}
+}
+
+void MultiGridCoarseLayout::initializeHalo() {
+	stride[3] = 1;
+	stride[2] = localSize[3];
+	stride[1] = localSize[3]*localSize[2];
+	stride[0] = localSize[3]*localSize[2]*localSize[1];
+	localsize = localSize[0]*localSize[1]*localSize[2]*localSize[3];
+
+	//The halo is needed only in the directions distributed on more processors
+	completesize = localsize;
+	for (unsigned int direction = 0; direction < 8; ++direction) {
+		int mu = direction % 4;
+		faceSites[direction].clear();
+		haloOffset[direction] = -1;
+		if (processorGrid[mu] > 1) {
+			int faceCoordinate = (direction < 4) ? 0 : localSize[mu] - 1;
+			for (int site = 0; site < localsize; ++site) {
+				if (this->localCoordinate(site, mu) == faceCoordinate) faceSites[direction].push_back(site);
+			}
+			haloOffset[direction] = completesize;
+			completesize += localsize/localSize[mu];
+		}
+	}
+
+	neighbours.resize(8*localsize);
+	for (int site = 0; site < localsize; ++site) {
+		for (unsigned int direction = 0; direction < 8; ++direction) {
+			int mu = direction % 4;
+			int coordinate[4];
+			for (unsigned int nu = 0; nu < 4; ++nu) coordinate[nu] = this->localCoordinate(site, nu);
+			coordinate[mu] += (direction < 4) ? 1 : -1;
+			if (coordinate[mu] >= 0 && coordinate[mu] < localSize[mu]) {
+				neighbours[8*site + direction] = stride[0]*coordinate[0] + stride[1]*coordinate[1] + stride[2]*coordinate[2] + coordinate[3];
+			}
+			else if (processorGrid[mu] == 1) {
+				coordinate[mu] = (coordinate[mu] + localSize[mu]) % localSize[mu];
+				neighbours[8*site + direction] = stride[0]*coordinate[0] + stride[1]*coordinate[1] + stride[2]*coordinate[2] + coordinate[3];
+			}
+			else {
+				//Position in the face, lexicographic in the other directions as faceSites
+				int position = 0;
+				for (unsigned int nu = 0; nu < 4; ++nu) {
+					if (nu != static_cast<unsigned int>(mu)) position = position*localSize[nu] + coordinate[nu];
+				}
+				neighbours[8*site + direction] = haloOffset[direction] + position;
+			}
+		}
+	}
+
+#ifdef ENABLE_MPI
+	for (unsigned int direction = 0; direction < 8; ++direction) {
+		int mu = direction % 4;
+		int coordinate[4];
+		for (unsigned int nu = 0; nu < 4; ++nu) coordinate[nu] = processorCoordinate[nu];
+		coordinate[mu] = (coordinate[mu] + ((direction < 4) ? 1 : -1) + processorGrid[mu]) % processorGrid[mu];
+		neighbourRanks[direction] = processorGrid[3]*(processorGrid[2]*(processorGrid[1]*coordinate[0] + coordinate[1]) + coordinate[2]) + coordinate[3];
+	}
+#endif
+}
+
+void MultiGridCoarseLayout::updateHalo(coarse_vector_t& vector) const {
+	this->updateHalo(&vector[0], dofs);
+}
+
+void MultiGridCoarseLayout::updateHalo(std::complex<real_t>* vector, int siteDofs) const {
+#ifdef ENABLE_MPI
+	if (!active) return;
+	std::vector< std::complex<real_t> > buffer;
+	for (unsigned int direction = 0; direction < 8; ++direction) {
+		int mu = direction % 4;
+		if (processorGrid[mu] == 1) continue;
+		int faceSize = faceSites[direction].size();
+		buffer.resize(faceSize*siteDofs);
+		for (int index = 0; index < faceSize; ++index) {
+			for (int i = 0; i < siteDofs; ++i) buffer[index*siteDofs + i] = vector[faceSites[direction][index]*siteDofs + i];
+		}
+		//The face x_mu = 0 fills the forward halo of the backward processor and the face x_mu = L - 1 the backward halo of the forward one
+		int destination = (direction < 4) ? neighbourRanks[direction + 4] : neighbourRanks[direction - 4];
+		int source = neighbourRanks[direction];
+		MPI_Sendrecv(&buffer[0], faceSize*siteDofs*sizeof(std::complex<real_t>), MPI_BYTE, destination, direction, &vector[haloOffset[direction]*siteDofs], faceSize*siteDofs*sizeof(std::complex<real_t>), MPI_BYTE, source, direction, communicator, MPI_STATUS_IGNORE);
+	}
+#endif
+#ifndef ENABLE_MPI
+	(void)vector;
+	(void)siteDofs;
+#endif
+}
+
+void MultiGridCoarseLayout::gather(std::complex<real_t>* output, const std::complex<real_t>* input, int siteDofs) const {
+#ifdef ENABLE_MPI
+	int groupSize;
+	MPI_Comm_size(groupCommunicator, &groupSize);
+	std::vector< std::complex<real_t> > buffer(active ? groupSize*sourceLocalsize*siteDofs : 0);
+	MPI_Gather(const_cast< std::complex<real_t>* >(input), sourceLocalsize*siteDofs*sizeof(std::complex<real_t>), MPI_BYTE, active ? &buffer[0] : 0, sourceLocalsize*siteDofs*sizeof(std::complex<real_t>), MPI_BYTE, 0, groupCommunicator);
+	if (!active) return;
+	for (int member = 0; member < groupSize; ++member) {
+		for (int site = 0; site < sourceLocalsize; ++site) {
+			int x = site / (sourceLocalSize[3]*sourceLocalSize[2]*sourceLocalSize[1]) + groupOrigins[4*member + 0];
+			int y = (site / (sourceLocalSize[3]*sourceLocalSize[2])) % sourceLocalSize[1] + groupOrigins[4*member + 1];
+			int z = (site / sourceLocalSize[3]) % sourceLocalSize[2] + groupOrigins[4*member + 2];
+			int t = site % sourceLocalSize[3] + groupOrigins[4*member + 3];
+			int target = stride[0]*x + stride[1]*y + stride[2]*z + t;
+			for (int i = 0; i < siteDofs; ++i) output[target*siteDofs + i] = buffer[(member*sourceLocalsize + site)*siteDofs + i];
+		}
+	}
+#endif
+#ifndef ENABLE_MPI
+	for (int i = 0; i < sourceLocalsize*siteDofs; ++i) output[i] = input[i];
+#endif
+}
+
+void MultiGridCoarseLayout::scatter(std::complex<real_t>* output, const std::complex<real_t>* input, int siteDofs) const {
+#ifdef ENABLE_MPI
+	int groupSize;
+	MPI_Comm_size(groupCommunicator, &groupSize);
+	std::vector< std::complex<real_t> > buffer(active ? groupSize*sourceLocalsize*siteDofs : 0);
+	if (active) {
+		for (int member = 0; member < groupSize; ++member) {
+			for (int site = 0; site < sourceLocalsize; ++site) {
+				int x = site / (sourceLocalSize[3]*sourceLocalSize[2]*sourceLocalSize[1]) + groupOrigins[4*member + 0];
+				int y = (site / (sourceLocalSize[3]*sourceLocalSize[2])) % sourceLocalSize[1] + groupOrigins[4*member + 1];
+				int z = (site / sourceLocalSize[3]) % sourceLocalSize[2] + groupOrigins[4*member + 2];
+				int t = site % sourceLocalSize[3] + groupOrigins[4*member + 3];
+				int target = stride[0]*x + stride[1]*y + stride[2]*z + t;
+				for (int i = 0; i < siteDofs; ++i) buffer[(member*sourceLocalsize + site)*siteDofs + i] = input[target*siteDofs + i];
+			}
+		}
+	}
+	MPI_Scatter(active ? &buffer[0] : 0, sourceLocalsize*siteDofs*sizeof(std::complex<real_t>), MPI_BYTE, output, sourceLocalsize*siteDofs*sizeof(std::complex<real_t>), MPI_BYTE, 0, groupCommunicator);
+#endif
+#ifndef ENABLE_MPI
+	for (int i = 0; i < sourceLocalsize*siteDofs; ++i) output[i] = input[i];
+#endif
+}
+
+void MultiGridCoarseLayout::reduceSum(long_real_t* values, int size) const {
+#ifdef ENABLE_MPI
+	//The coarse levels do not need the extended precision in the communications
+	std::vector<double> buffer(values, values + size);
+	MPI_Allreduce(MPI_IN_PLACE, &buffer[0], size, MPI_DOUBLE, MPI_SUM, communicator);
+	for (int i = 0; i < size; ++i) values[i] = buffer[i];
+#endif
+#ifndef ENABLE_MPI
+	(void)values;
+	(void)size;
+#endif
+}
+
+std::complex<long_real_t> MultiGridCoarseLayout::dot(const coarse_vector_t& first, const coarse_vector_t& second) const {
+	long_real_t result[2] = {0., 0.};
+	long_real_t result_re = 0., result_im = 0.;
+#pragma omp parallel for reduction(+:result_re, result_im)
+	for (int i = 0; i < localsize*dofs; ++i) {
+		std::complex<real_t> partial = conj(first[i])*second[i];
+		result_re += real(partial);
+		result_im += imag(partial);
+	}
+	result[0] = result_re;
+	result[1] = result_im;
+	this->reduceSum(result, 2);
+	return std::complex<long_real_t>(result[0], result[1]);
+}
+
+long_real_t MultiGridCoarseLayout::squaredNorm(const coarse_vector_t& vector) const {
+	long_real_t result = 0.;
+#pragma omp parallel for reduction(+:result)
+	for (int i = 0; i < localsize*dofs; ++i) {
+		result += norm(vector[i]);
+	}
+	this->reduceSum(&result, 1);
+	return result;
+}
+
+void MultiGridCoarseLayout::allocate(coarse_vector_t& vector) const {
+	vector.assign(completesize*dofs, std::complex<real_t>(0.,0.));
+}
+
+}
@@ -0,0 +1,114 @@
+#ifndef MULTIGRIDCOARSELAYOUT_H
+#define MULTIGRIDCOARSELAYOUT_H
+#include "Environment.h"
+#include <vector>
+
+namespace Update {
+
+//The vectors of the coarse levels, dofs complex numbers for every local and halo site of the layout
+typedef std::vector< std::complex<real_t> > coarse_vector_t;
+
+/**
+ * Layout of a coarse level of the multigrid hierarchy: a periodic four dimensional grid of sites, with dofs complex numbers
+ * each, distributed on a grid of processors. Differently from MultiGridVectorLayout every level has its own layout object.
+ * The local sites are ordered lexicographically with t running fastest, as the blocks of MultiGridVectorLayout,
+ * and they are followed by the halo of the eight faces of the local box.
+ * The layout can be agglomerated on a subset of the processors: only the active processors take part to the halo
+ * exchanges and to the reductions, gather and scatter move the vectors between the layout and its agglomeration.
+ */
+class MultiGridCoarseLayout {
+public:
+	MultiGridCoarseLayout();
+	~MultiGridCoarseLayout();
+
+	/**
+	 * This function distributes the grid of size globalSize on the processor grid of the fine lattice
+	 * @param _globalSize
+	 * @param _dofs
+	 */
+	void initialize(const int _globalSize[4], int _dofs);
+
+	/**
+	 * This function distributes the grid of source on the processors whose coordinates are multiple of stride,
+	 * every active processor owns the sites of stride[0]*stride[1]*stride[2]*stride[3] processors of source
+	 * @param source
+	 * @param _stride
+	 */
+	void initializeAgglomerated(const MultiGridCoarseLayout& source, const int _stride[4]);
+
+	//Moves the local sites of source (the layout this one is agglomerated from) to the active processors, dofs can differ from the dofs of the layout
+	void gather(std::complex<real_t>* output, const std::complex<real_t>* input, int siteDofs) const;
+	//Inverse of gather
+	void scatter(std::complex<real_t>* output, const std::complex<real_t>* input, int siteDofs) const;
+
+	//Fills the halo of vector, it must be called by all the active processors
+	void updateHalo(coarse_vector_t& vector) const;
+	void updateHalo(std::complex<real_t>* vector, int siteDofs) const;
+
+	//Sum of values over the active processors
+	void reduceSum(long_real_t* values, int size) const;
+
+	std::complex<long_real_t> dot(const coarse_vector_t& first, const coarse_vector_t& second) const;
+	long_real_t squaredNorm(const coarse_vector_t& vector) const;
+
+	//A vector of the layout, set to zero
+	void allocate(coarse_vector_t& vector) const;
+
+	//Index of the neighbour of a local site, forward for direction < 4 and backward for direction >= 4
+	int neighbour(int site, int direction) const {
+		return neighbours[8*site + direction];
+	}
+
+	int globalCoordinate(int site, int mu) const {
+		return origin[mu] + localCoordinate(site, mu);
+	}
+
+	int localCoordinate(int site, int mu) const {
+		return (site / stride[mu]) % localSize[mu];
+	}
+
+	bool isActive() const {
+		return active;
+	}
+
+	int globalSize[4];
+	int localSize[4];
+	int processorGrid[4];
+	//The number of sites of the local box, localsize, and with the halo, completesize
+	int localsize;
+	int completesize;
+	int dofs;
+
+private:
+	MultiGridCoarseLayout(const MultiGridCoarseLayout&);
+	MultiGridCoarseLayout& operator=(const MultiGridCoarseLayout&);
+
+	//Builds the neighbours and the faces, processorCoordinate and the communicators must be already set
+	void initializeHalo();
+
+	bool active;
+	int processorCoordinate[4];
+	int origin[4];
+	int stride[4];
+
+	std::vector<int> neighbours;
+	//The local sites sent to the processor in the direction opposite to the face, they fill its halo in the given direction
+	std::vector<int> faceSites[8];
+	int haloOffset[8];
+
+	//Agglomeration: the local sizes of the source layout and the positions of the processors of the group in the local box
+	int sourceLocalSize[4];
+	int sourceLocalsize;
+	std::vector<int> groupOrigins;
+
+#ifdef ENABLE_MPI
+	//The active processors and the processors whose sites are agglomerated on the same active processor
+	MPI_Comm communicator;
+	MPI_Comm groupCommunicator;
+	int neighbourRanks[8];
+#endif
+};
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include "MultiGridCoarseOperator.h"
+
+namespace Update {
+
+MultiGridCoarseOperator::MultiGridCoarseOperator(const MultiGridCoarseLayout* _layout) : layout(_layout), links(9*_layout->localsize*_layout->dofs*_layout->dofs) { }
+
+void MultiGridCoarseOperator::multiply(coarse_vector_t& output, coarse_vector_t& input) const {
+	const int dofs = layout->dofs;
+	layout->updateHalo(input);
+#pragma omp parallel for
+	for (int site = 0; site < layout->localsize; ++site) {
+		for (int i = 0; i < dofs; ++i) output[site*dofs + i] = 0.;
+		for (unsigned int direction = 0; direction < 9; ++direction) {
+			const std::complex<real_t>* matrix = this->link(site, direction);
+			const std::complex<real_t>* vector = &input[((direction == 8) ? site : layout->neighbour(site, direction))*dofs];
+			for (int i = 0; i < dofs; ++i) {
+				std::complex<real_t> result = 0.;
+				for (int j = 0; j < dofs; ++j) result += matrix[i*dofs + j]*vector[j];
+				output[site*dofs + i] += result;
+			}
+		}
+	}
+}
+
+void MultiGridCoarseOperator::setToZero() {
+	links.assign(links.size(), std::complex<real_t>(0.,0.));
+}
+
+void MultiGridCoarseOperator::computeDiagonalInverse() {
+	const int dofs = layout->dofs;
+	diagonalInverse.resize(layout->localsize*dofs*dofs);
+#pragma omp parallel for
+	for (int site = 0; site < layout->localsize; ++site) {
+		const std::complex<real_t>* matrix = this->link(site, 8);
+		matrix_t diagonal(dofs, dofs);
+		for (int i = 0; i < dofs; ++i) {
+			for (int j = 0; j < dofs; ++j) diagonal(i,j) = matrix[i*dofs + j];
+		}
+		matrix_t inverted = inverse(diagonal);
+		for (int i = 0; i < dofs; ++i) {
+			for (int j = 0; j < dofs; ++j) diagonalInverse[(site*dofs + i)*dofs + j] = inverted(i,j);
+		}
+	}
+}
+
+void MultiGridCoarseOperator::multiplyDiagonalInverse(coarse_vector_t& output, const coarse_vector_t& input) const {
+	const int dofs = layout->dofs;
+#pragma omp parallel for
+	for (int site = 0; site < layout->localsize; ++site) {
+		const std::complex<real_t>* matrix = &diagonalInverse[site*dofs*dofs];
+		for (int i = 0; i < dofs; ++i) {
+			std::complex<real_t> result = 0.;
+			for (int j = 0; j < dofs; ++j) result += matrix[i*dofs + j]*input[site*dofs + j];
+			output[site*dofs + i] = result;
+		}
+	}
+}
+
+void MultiGridCoarseOperator::gather(const MultiGridCoarseOperator& source) {
+	const int dofs = layout->dofs;
+	layout->gather(layout->isActive() ? &links[0] : 0, &source.links[0], 9*dofs*dofs);
+}
+
+}
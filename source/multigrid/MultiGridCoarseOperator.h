@@ -0,0 +1,52 @@
+#ifndef MULTIGRIDCOARSEOPERATOR_H
+#define MULTIGRIDCOARSEOPERATOR_H
+#include "MultiGridCoarseLayout.h"
+
+namespace Update {
+
+/**
+ * Nearest neighbour operator of a coarse level, stored explicitly: for every local site a dofs x dofs matrix
+ * for the site itself and one for each of the eight neighbours. Differently from MultiGridOperator the fine
+ * Dirac operator is not applied, the operator can be applied and coarsened again without the fine lattice.
+ */
+class MultiGridCoarseOperator {
+public:
+	MultiGridCoarseOperator(const MultiGridCoarseLayout* _layout);
+
+	//output = A input, the halo of input is updated
+	void multiply(coarse_vector_t& output, coarse_vector_t& input) const;
+
+	//The coupling of site with its neighbour in direction, the site itself for direction = 8
+	std::complex<real_t>* link(int site, int direction) {
+		return &links[(9*site + direction)*layout->dofs*layout->dofs];
+	}
+
+	const std::complex<real_t>* link(int site, int direction) const {
+		return &links[(9*site + direction)*layout->dofs*layout->dofs];
+	}
+
+	void setToZero();
+
+	//Inverts the couplings of the sites with themselves, needed by multiplyDiagonalInverse
+	void computeDiagonalInverse();
+
+	//output = A_site^-1 input, the block Jacobi preconditioner
+	void multiplyDiagonalInverse(coarse_vector_t& output, const coarse_vector_t& input) const;
+
+	//Copies the operator of source on the layout agglomerated from the layout of source
+	void gather(const MultiGridCoarseOperator& source);
+
+	const MultiGridCoarseLayout* getLayout() const {
+		return layout;
+	}
+
+private:
+	const MultiGridCoarseLayout* layout;
+	//The matrices are stored row major
+	std::vector< std::complex<real_t> > links;
+	std::vector< std::complex<real_t> > diagonalInverse;
+};
+
+}
+
+#endif
@@ -5,6 +5,11 @@ namespace Update {
 MultiGridConjugateGradientSolver::MultiGridConjugateGradientSolver() : precision(0.000001), maxSteps(300) { }
 
 bool MultiGridConjugateGradientSolver::solve(MultiGridOperator* multiGridOperator, const multigrid_vector_t& source_hat, multigrid_vector_t& solution_hat) {
+	//The layout could be changed after the creation of the solver
+	r_hat.update();
+	p_hat.update();
+	tmp_hat.update();
+
 	solution_hat = source_hat;
 	multiGridOperator->multiply(tmp_hat,solution_hat);
 
@@ -14,28 +19,14 @@ bool MultiGridConjugateGradientSolver::solve(MultiGridOperator* multiGridOperato
 		p_hat[m] = r_hat[m];
 	}
 
-	long_real_t norm = 0.;
-#pragma omp parallel for reduction(+:norm)
-	for (int m = 0; m < multigrid_vector_t::Layout::size; ++m) {
-		norm += real(conj(r_hat[m])*r_hat[m]);
-	}
-	reduceAllSum(norm);
+	long_real_t norm = multigrid_vector_t::squaredNorm(r_hat);
 	long_real_t norm_next = norm;
 
 	for (int innerStep = 0; innerStep < maxSteps; ++innerStep) {
 		multiGridOperator->multiply(tmp_hat,p_hat);
 		norm = norm_next;
-		long_real_t gammaRe = 0;
-		long_real_t gammaIm = 0;
-#pragma omp parallel for reduction(+:gammaRe,gammaIm)
-		for (int m = 0; m < multigrid_vector_t::Layout::size; ++m) {
-			std::complex<real_t> result = conj(p_hat[m])*tmp_hat[m];
-			gammaRe += real(result);
-			gammaIm += imag(result);
-		}
-		reduceAllSum(gammaRe);
-		reduceAllSum(gammaIm);
-		std::complex<real_t> alpha = static_cast<real_t>(norm)/std::complex<real_t>(gammaRe,gammaIm);
+		std::complex<real_t> gamma = static_cast< std::complex<real_t> >(multigrid_vector_t::dot(p_hat, tmp_hat));
+		std::complex<real_t> alpha = static_cast<real_t>(norm)/gamma;
 
 
 #pragma omp parallel for
@@ -44,11 +35,7 @@ bool MultiGridConjugateGradientSolver::solve(MultiGridOperator* multiGridOperato
 			r_hat[m] = r_hat[m] - alpha * tmp_hat[m];
 		}
 
-		norm_next = 0.;
-#pragma omp parallel for reduction(+:norm_next)
-		for (int m = 0; m < multigrid_vector_t::Layout::size; ++m) {
-			norm_next += real(conj(r_hat[m])*r_hat[m]);
-		}
+		norm_next = multigrid_vector_t::squaredNorm(r_hat);
 		//Check for convergence
 		if (norm_next < precision && innerStep > 5) {
 			if (isOutputProcess()) std::cout << "Inner convergence in " << innerStep << " steps."<< std::endl;
@@ -61,10 +48,7 @@ bool MultiGridConjugateGradientSolver::solve(MultiGridOperator* multiGridOperato
 
 		real_t beta = static_cast<real_t>(norm_next/norm);
 
-#pragma omp parallel for
-		for (int m = 0; m < multigrid_vector_t::Layout::size; ++m) {
-			p_hat[m] = r_hat[m] + beta * p_hat[m];
-		}
+		p_hat.xpay(r_hat, beta);
 	}
 
 	return true;
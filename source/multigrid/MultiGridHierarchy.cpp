@@ -0,0 +1,805 @@
+#include "MultiGridHierarchy.h"
+#include "MultiGridVectorLayout.h"
+#include "utils/RandomSeed.h"
+#include "dirac_operators/TwistedDiracOperator.h"
+
+namespace Update {
+
+//Number of directions kept by the GCR of the coarse levels before the restart
+static const int coarseRestart = 10;
+
+MultiGridHierarchy::Level::Level(MultiGridCoarseLayout* _layout) : layout(_layout), coarseOperator(new MultiGridCoarseOperator(_layout)) { }
+
+MultiGridHierarchy::Level::~Level() {
+	delete coarseOperator;
+	delete layout;
+}
+
+MultiGridHierarchy::MultiGridHierarchy() : numberLevels(2), blockSize(4, 2), basisDimension(24), steps(10), precision(0.1), coarsestSteps(50), smoothingSteps(2), setupSteps(20), agglomerationSize(16), initialized(false), basesValid(false), layoutFailed(false), operatorValid(false), operatorFailed(false), kappa(0.), diracGamma5(false), twist(0.), agglomerated(0) { }
+
+MultiGridHierarchy::MultiGridHierarchy(const MultiGridHierarchy& toCopy) : numberLevels(toCopy.numberLevels), blockSize(toCopy.blockSize), basisDimension(toCopy.basisDimension), steps(toCopy.steps), precision(toCopy.precision), coarsestSteps(toCopy.coarsestSteps), smoothingSteps(toCopy.smoothingSteps), setupSteps(toCopy.setupSteps), agglomerationSize(toCopy.agglomerationSize), initialized(false), basesValid(false), layoutFailed(false), operatorValid(false), operatorFailed(false), kappa(0.), diracGamma5(false), twist(0.), agglomerated(0) { }
+
+MultiGridHierarchy& MultiGridHierarchy::operator=(const MultiGridHierarchy& toCopy) {
+	if (this != &toCopy) {
+		this->clear();
+		numberLevels = toCopy.numberLevels;
+		blockSize = toCopy.blockSize;
+		basisDimension = toCopy.basisDimension;
+		steps = toCopy.steps;
+		precision = toCopy.precision;
+		coarsestSteps = toCopy.coarsestSteps;
+		smoothingSteps = toCopy.smoothingSteps;
+		setupSteps = toCopy.setupSteps;
+		agglomerationSize = toCopy.agglomerationSize;
+	}
+	return *this;
+}
+
+MultiGridHierarchy::~MultiGridHierarchy() {
+	this->clear();
+}
+
+bool MultiGridHierarchy::initialize(int fineBasisDimension) {
+	typedef reduced_index_lattice_t::Layout LT;
+	if (layoutFailed) return false;
+	this->clear();
+	if (numberLevels < 3) return false;
+
+	//The blocks of the same parity are probed together, so every direction must have one block or an even number of them
+	int blocks[4] = {static_cast<int>(MultiGridVectorLayout::xBlockSize), static_cast<int>(MultiGridVectorLayout::yBlockSize), static_cast<int>(MultiGridVectorLayout::zBlockSize), static_cast<int>(MultiGridVectorLayout::tBlockSize)};
+	int local[4] = {LT::loc_x, LT::loc_y, LT::loc_z, LT::loc_t};
+	int global[4] = {LT::glob_x, LT::glob_y, LT::glob_z, LT::glob_t};
+	int coarseSize[4];
+	for (unsigned int mu = 0; mu < 4; ++mu) {
+		coarseSize[mu] = global[mu]/blocks[mu];
+		if (local[mu] % blocks[mu] != 0 || (coarseSize[mu] != 1 && coarseSize[mu] % 2 != 0) || (blocks[mu] == 1 && coarseSize[mu] > 2)) {
+			if (isOutputProcess()) std::cout << "MultiGridHierarchy::Warning, the number of blocks in the direction " << mu << " must be one or even and the blocks must match the processor grid, the two level multigrid is used" << std::endl;
+			layoutFailed = true;
+			return false;
+		}
+	}
+
+	MultiGridCoarseLayout* layout = new MultiGridCoarseLayout();
+	layout->initialize(coarseSize, fineBasisDimension);
+	levels.push_back(new Level(layout));
+	for (int index = 1; index < numberLevels - 1; ++index) {
+		const MultiGridCoarseLayout* previous = levels.back()->layout;
+		int size[4];
+		bool divisible = true;
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			if (blockSize[mu] == 0 || previous->localSize[mu] % blockSize[mu] != 0) divisible = false;
+			else size[mu] = previous->globalSize[mu]/blockSize[mu];
+		}
+		if (!divisible) {
+			if (isOutputProcess()) std::cout << "MultiGridHierarchy::Warning, the local lattice of the level " << index << " cannot be aggregated, only " << index + 1 << " levels are used" << std::endl;
+			break;
+		}
+		layout = new MultiGridCoarseLayout();
+		layout->initialize(size, basisDimension);
+		levels.push_back(new Level(layout));
+	}
+
+	//The aggregates of every level, ordered as the sites of the next one
+	for (unsigned int index = 0; index + 1 < levels.size(); ++index) {
+		Level* level = levels[index];
+		const MultiGridCoarseLayout* next = levels[index + 1]->layout;
+		level->aggregate.resize(level->layout->localsize);
+		level->aggregateOffsets.assign(next->localsize + 1, 0);
+		for (int site = 0; site < level->layout->localsize; ++site) {
+			int aggregate = 0;
+			for (unsigned int mu = 0; mu < 4; ++mu) aggregate = aggregate*next->localSize[mu] + level->layout->localCoordinate(site, mu)/blockSize[mu];
+			level->aggregate[site] = aggregate;
+			++level->aggregateOffsets[aggregate + 1];
+		}
+		for (int aggregate = 0; aggregate < next->localsize; ++aggregate) level->aggregateOffsets[aggregate + 1] += level->aggregateOffsets[aggregate];
+		level->aggregateSites.resize(level->layout->localsize);
+		std::vector<int> position(level->aggregateOffsets.begin(), level->aggregateOffsets.end() - 1);
+		for (int site = 0; site < level->layout->localsize; ++site) level->aggregateSites[position[level->aggregate[site]]++] = site;
+	}
+
+#ifdef ENABLE_MPI
+	//The coarsest level is moved on fewer processors halving the largest even direction of the processor grid
+	const MultiGridCoarseLayout* coarsest = levels.back()->layout;
+	int stride[4] = {1, 1, 1, 1};
+	int sites = coarsest->localsize;
+	bool agglomerate = false;
+	while (sites < agglomerationSize) {
+		int direction = -1;
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			int processors = coarsest->processorGrid[mu]/stride[mu];
+			if (processors % 2 == 0 && (direction < 0 || processors > coarsest->processorGrid[direction]/stride[direction])) direction = mu;
+		}
+		if (direction < 0) break;
+		stride[direction] *= 2;
+		sites *= 2;
+		agglomerate = true;
+	}
+	if (agglomerate) {
+		layout = new MultiGridCoarseLayout();
+		layout->initializeAgglomerated(*coarsest, stride);
+		agglomerated = new Level(layout);
+		if (isOutputProcess()) std::cout << "MultiGridHierarchy::The coarsest level is agglomerated on the processor grid (" << layout->processorGrid[0] << "," << layout->processorGrid[1] << "," << layout->processorGrid[2] << "," << layout->processorGrid[3] << ")" << std::endl;
+	}
+#endif
+
+	//Workspace of the solvers
+	for (unsigned int index = 0; index <= levels.size(); ++index) {
+		Level* level = (index < levels.size()) ? levels[index] : agglomerated;
+		if (level == 0) continue;
+		level->u.resize(coarseRestart);
+		level->c.resize(coarseRestart);
+		for (int i = 0; i < coarseRestart; ++i) {
+			level->layout->allocate(level->u[i]);
+			level->layout->allocate(level->c[i]);
+		}
+		level->layout->allocate(level->residual);
+		level->layout->allocate(level->correction);
+		level->layout->allocate(level->product);
+		level->layout->allocate(level->smootherResidual);
+		level->layout->allocate(level->smootherCorrection);
+		level->layout->allocate(level->jacobi);
+		//The agglomerated level keeps its source and solution in restricted and coarseSolution
+		const MultiGridCoarseLayout* next = (index + 1 < levels.size()) ? levels[index + 1]->layout : level->layout;
+		next->allocate(level->restricted);
+		next->allocate(level->coarseSolution);
+	}
+
+	//The parity of the blocks and the faces of the blocks on which the fine sites lie
+	int numberBlocks = MultiGridVectorLayout::totalNumberOfBlocks;
+	blockParity.assign(numberBlocks, 0);
+	siteFaces.resize(LT::localsize);
+	for (int site = 0; site < LT::localsize; ++site) {
+		int block = MultiGridVectorLayout::index(site);
+		int faces = 0, parity = 0;
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			int coordinate = LT::globalIndex(site, mu);
+			if (coordinate % blocks[mu] == blocks[mu] - 1) faces |= 1 << mu;
+			if (coordinate % blocks[mu] == 0) faces |= 1 << (mu + 4);
+			parity |= ((coordinate/blocks[mu]) % 2) << mu;
+		}
+		siteFaces[site] = faces;
+		blockParity[block] = parity;
+	}
+
+	if (isOutputProcess()) {
+		std::cout << "MultiGridHierarchy::Multigrid with " << levels.size() + 1 << " levels, coarse lattices:";
+		for (unsigned int index = 0; index < levels.size(); ++index) std::cout << " (" << levels[index]->layout->globalSize[0] << "," << levels[index]->layout->globalSize[1] << "," << levels[index]->layout->globalSize[2] << "," << levels[index]->layout->globalSize[3] << ")x" << levels[index]->layout->dofs;
+		std::cout << std::endl;
+	}
+
+	initialized = true;
+	basesValid = false;
+	return true;
+}
+
+bool MultiGridHierarchy::isInitialized() const {
+	return initialized;
+}
+
+void MultiGridHierarchy::clear() {
+	for (unsigned int index = 0; index < levels.size(); ++index) delete levels[index];
+	levels.clear();
+	delete agglomerated;
+	agglomerated = 0;
+	initialized = false;
+	basesValid = false;
+	layoutFailed = false;
+	operatorValid = false;
+	operatorFailed = false;
+}
+
+void MultiGridHierarchy::invalidateBases() {
+	basesValid = false;
+	operatorValid = false;
+	operatorFailed = false;
+}
+
+bool MultiGridHierarchy::setOperator(DiracOperator* dirac, const BlockBasis& basis) {
+	if (!initialized) return false;
+
+	//The twist of TwistedDiracOperator is added to the coarse operators of its Dirac operator
+	real_t newTwist = 0.;
+	TwistedDiracOperator* twistedDiracOperator = dynamic_cast<TwistedDiracOperator*>(dirac);
+	if (twistedDiracOperator != 0) {
+		newTwist = twistedDiracOperator->getTwist();
+		dirac = twistedDiracOperator->getDiracOperator();
+	}
+
+	if (this->isNewOperator(dirac)) {
+		operatorValid = false;
+		operatorFailed = false;
+	}
+	if (operatorFailed) return false;
+
+	if (!operatorValid) {
+		struct timespec start, finish;
+		double elapsed;
+		clock_gettime(CLOCK_REALTIME, &start);
+
+		this->assembleOperator(dirac, basis);
+		if (!this->checkOperator(dirac, basis)) {
+			if (isOutputProcess()) std::cout << "MultiGridHierarchy::The two level multigrid is used until the lattice or the basis change" << std::endl;
+			operatorFailed = true;
+			return false;
+		}
+		this->assembleGamma5(basis);
+		levels[0]->coarseOperator->computeDiagonalInverse();
+
+		for (unsigned int index = 0; index + 1 < levels.size(); ++index) {
+			if (!basesValid) this->setupBasis(index);
+			this->coarsen(index);
+		}
+		basesValid = true;
+		operatorValid = true;
+		twist = 0.;
+
+		if (agglomerated != 0) {
+			agglomerated->coarseOperator->gather(*levels.back()->coarseOperator);
+			if (agglomerated->layout->isActive()) agglomerated->coarseOperator->computeDiagonalInverse();
+		}
+
+		clock_gettime(CLOCK_REALTIME, &finish);
+		elapsed = (finish.tv_sec - start.tv_sec);
+		elapsed += (finish.tv_nsec - start.tv_nsec) / 1000000000.0;
+
+		if (isOutputProcess()) std::cout << "MultiGridHierarchy::Coarse operators constructed in: " << (elapsed) << " s."<< std::endl;
+	}
+
+	if (newTwist != twist) this->setTwist(newTwist);
+	return true;
+}
+
+bool MultiGridHierarchy::isNewOperator(DiracOperator* dirac) {
+	const reduced_fermion_lattice_t& diracLinks = *dirac->getLattice();
+	int changed = (dirac->getKappa() != kappa || dirac->getGamma5() != diracGamma5) ? 1 : 0;
+#pragma omp parallel for reduction(+:changed)
+	for (int site = 0; site < links.localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			for (int i = 0; i < diracVectorLength; ++i) {
+				for (int j = 0; j < diracVectorLength; ++j) {
+					if (diracLinks[site][mu].at(i,j) != links[site][mu].at(i,j)) changed += 1;
+				}
+			}
+		}
+	}
+	reduceAllSum(changed);
+	if (changed == 0) return false;
+
+	links = diracLinks;
+	kappa = dirac->getKappa();
+	diracGamma5 = dirac->getGamma5();
+	return true;
+}
+
+void MultiGridHierarchy::setTwist(real_t _twist) {
+	twist = _twist;
+	const std::complex<real_t> factor(0., twist);
+	for (unsigned int index = 0; index < levels.size(); ++index) {
+		Level* level = levels[index];
+		const int size = level->layout->dofs*level->layout->dofs;
+#pragma omp parallel for
+		for (int site = 0; site < level->layout->localsize; ++site) {
+			std::complex<real_t>* matrix = level->coarseOperator->link(site, 8);
+			for (int i = 0; i < size; ++i) matrix[i] = level->diagonal[site*size + i] + factor*level->gamma5[site*size + i];
+		}
+		level->coarseOperator->computeDiagonalInverse();
+	}
+
+	if (agglomerated != 0) {
+		agglomerated->coarseOperator->gather(*levels.back()->coarseOperator);
+		if (agglomerated->layout->isActive()) agglomerated->coarseOperator->computeDiagonalInverse();
+	}
+}
+
+void MultiGridHierarchy::assembleOperator(DiracOperator* dirac, const BlockBasis& basis) {
+	MultiGridCoarseOperator* coarseOperator = levels[0]->coarseOperator;
+	const MultiGridCoarseLayout* layout = levels[0]->layout;
+	const int dofs = layout->dofs;
+	coarseOperator->setToZero();
+
+	//The basis vectors restricted to the blocks of one parity: every block sees only itself and its neighbours of a different parity
+	for (int parity = 0; parity < 16; ++parity) {
+		bool empty = false;
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			if ((parity & (1 << mu)) && layout->globalSize[mu] == 1) empty = true;
+		}
+		if (empty) continue;
+		for (int j = 0; j < dofs; ++j) {
+#pragma omp parallel for
+			for (int site = 0; site < probe.localsize; ++site) {
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					if (blockParity[MultiGridVectorLayout::index(site)] == parity) probe[site][mu] = basis[j][site][mu];
+					else set_to_zero(probe[site][mu]);
+				}
+			}
+			probe.updateHalo();
+			dirac->multiply(image, probe);
+
+#pragma omp parallel for
+			for (int block = 0; block < layout->localsize; ++block) {
+				int relation = blockParity[block] ^ parity;
+				int direction = -1;
+				for (unsigned int mu = 0; mu < 4; ++mu) {
+					if (relation == (1 << mu)) direction = mu;
+				}
+				if (relation != 0 && direction < 0) continue;
+				for (int index = MultiGridVectorLayout::blockOffsets[block]; index < MultiGridVectorLayout::blockOffsets[block + 1]; ++index) {
+					int site = MultiGridVectorLayout::blockSites[index];
+					int target = 8;
+					if (relation != 0) {
+						//The sites on the forward face see the forward neighbour, the ones on the backward face the backward neighbour
+						if (siteFaces[site] & (1 << direction)) target = direction;
+						else if (siteFaces[site] & (1 << (direction + 4))) target = direction + 4;
+						else continue;
+					}
+					std::complex<real_t>* matrix = coarseOperator->link(block, target);
+					for (int i = 0; i < dofs; ++i) {
+						std::complex<real_t> entry = 0.;
+						for (unsigned int mu = 0; mu < 4; ++mu) entry += vector_dot(basis[i][site][mu], image[site][mu]);
+						matrix[i*dofs + j] += entry;
+					}
+				}
+			}
+		}
+	}
+}
+
+void MultiGridHierarchy::assembleGamma5(const BlockBasis& basis) {
+	Level* level = levels[0];
+	const int dofs = level->layout->dofs;
+	level->diagonal.resize(level->layout->localsize*dofs*dofs);
+	level->gamma5.resize(level->layout->localsize*dofs*dofs);
+
+	//gamma5 is diagonal in the chiral basis, +1 on the first two spinor components and -1 on the last two
+#pragma omp parallel for
+	for (int block = 0; block < level->layout->localsize; ++block) {
+		const std::complex<real_t>* matrix = level->coarseOperator->link(block, 8);
+		for (int i = 0; i < dofs; ++i) {
+			for (int j = 0; j < dofs; ++j) {
+				std::complex<real_t> entry = 0.;
+				for (int index = MultiGridVectorLayout::blockOffsets[block]; index < MultiGridVectorLayout::blockOffsets[block + 1]; ++index) {
+					int site = MultiGridVectorLayout::blockSites[index];
+					entry += vector_dot(basis[i][site][0], basis[j][site][0]) + vector_dot(basis[i][site][1], basis[j][site][1]);
+					entry -= vector_dot(basis[i][site][2], basis[j][site][2]) + vector_dot(basis[i][site][3], basis[j][site][3]);
+				}
+				level->gamma5[(block*dofs + i)*dofs + j] = entry;
+				level->diagonal[(block*dofs + i)*dofs + j] = matrix[i*dofs + j];
+			}
+		}
+	}
+}
+
+bool MultiGridHierarchy::checkOperator(DiracOperator* dirac, const BlockBasis& basis) {
+	const MultiGridCoarseLayout* layout = levels[0]->layout;
+	coarse_vector_t vector, projected, result;
+	this->generateRandomVector(layout, vector);
+	layout->allocate(result);
+	this->prolongVector(probe, vector, basis);
+	dirac->multiply(image, probe);
+	this->restrictVector(projected, image, basis);
+	levels[0]->coarseOperator->multiply(result, vector);
+	for (int i = 0; i < layout->localsize*layout->dofs; ++i) result[i] -= projected[i];
+	long_real_t difference = layout->squaredNorm(result)/layout->squaredNorm(projected);
+	if (difference > 1e-16) {
+		if (isOutputProcess()) std::cout << "MultiGridHierarchy::Warning, the coarse operator does not reproduce the Dirac operator (relative difference " << sqrt(difference) << "), it must couple only nearest neighbours" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void MultiGridHierarchy::setupBasis(int index) {
+	Level* level = levels[index];
+	const MultiGridCoarseLayout* layout = level->layout;
+	const int dofs = layout->dofs;
+	const int nextDofs = levels[index + 1]->layout->dofs;
+
+	struct timespec start, finish;
+	double elapsed;
+	clock_gettime(CLOCK_REALTIME, &start);
+
+	//As for the fine basis: the homogeneous system is solved from a random vector and the result is used as source
+	std::vector<coarse_vector_t> vectors(nextDofs);
+	coarse_vector_t zeroVector, smoothed;
+	layout->allocate(zeroVector);
+	for (int k = 0; k < nextDofs; ++k) {
+		this->generateRandomVector(layout, smoothed);
+		this->gcr(level, index, smoothed, zeroVector, setupSteps, 0., false, true);
+		layout->allocate(vectors[k]);
+		this->gcr(level, index, vectors[k], smoothed, setupSteps, 0., false, false);
+	}
+
+	//Orthonormalization in every aggregate, repeated for stability
+	const int numberAggregates = level->aggregateOffsets.size() - 1;
+#pragma omp parallel for
+	for (int aggregate = 0; aggregate < numberAggregates; ++aggregate) {
+		for (int pass = 0; pass < 2; ++pass) {
+			for (int k = 0; k < nextDofs; ++k) {
+				for (int l = 0; l < k; ++l) {
+					std::complex<real_t> projection = 0.;
+					for (int position = level->aggregateOffsets[aggregate]; position < level->aggregateOffsets[aggregate + 1]; ++position) {
+						int site = level->aggregateSites[position];
+						for (int i = 0; i < dofs; ++i) projection += conj(vectors[l][site*dofs + i])*vectors[k][site*dofs + i];
+					}
+					for (int position = level->aggregateOffsets[aggregate]; position < level->aggregateOffsets[aggregate + 1]; ++position) {
+						int site = level->aggregateSites[position];
+						for (int i = 0; i < dofs; ++i) vectors[k][site*dofs + i] -= projection*vectors[l][site*dofs + i];
+					}
+				}
+				real_t norm = 0.;
+				for (int position = level->aggregateOffsets[aggregate]; position < level->aggregateOffsets[aggregate + 1]; ++position) {
+					int site = level->aggregateSites[position];
+					for (int i = 0; i < dofs; ++i) norm += std::norm(vectors[k][site*dofs + i]);
+				}
+				norm = sqrt(norm);
+				for (int position = level->aggregateOffsets[aggregate]; position < level->aggregateOffsets[aggregate + 1]; ++position) {
+					int site = level->aggregateSites[position];
+					for (int i = 0; i < dofs; ++i) vectors[k][site*dofs + i] /= norm;
+				}
+			}
+		}
+	}
+
+	level->basis.assign(layout->completesize*dofs*nextDofs, std::complex<real_t>(0.,0.));
+#pragma omp parallel for
+	for (int site = 0; site < layout->localsize; ++site) {
+		for (int i = 0; i < dofs; ++i) {
+			for (int k = 0; k < nextDofs; ++k) level->basis[(site*dofs + i)*nextDofs + k] = vectors[k][site*dofs + i];
+		}
+	}
+	//The basis on the halo is needed by the couplings between the aggregates of different processors
+	layout->updateHalo(&level->basis[0], dofs*nextDofs);
+
+	clock_gettime(CLOCK_REALTIME, &finish);
+	elapsed = (finish.tv_sec - start.tv_sec);
+	elapsed += (finish.tv_nsec - start.tv_nsec) / 1000000000.0;
+
+	if (isOutputProcess()) std::cout << "MultiGridHierarchy::Basis of the level " << index + 1 << " constructed in: " << (elapsed) << " s."<< std::endl;
+}
+
+void MultiGridHierarchy::coarsen(int index) {
+	Level* level = levels[index];
+	Level* next = levels[index + 1];
+	const int dofs = level->layout->dofs;
+	const int nextDofs = next->layout->dofs;
+	next->coarseOperator->setToZero();
+	next->diagonal.resize(next->layout->localsize*nextDofs*nextDofs);
+	next->gamma5.assign(next->layout->localsize*nextDofs*nextDofs, std::complex<real_t>(0.,0.));
+
+	//A_next(X,Y) = sum_x in X, y in Y V(x)^dag A(x,y) V(y), the couplings inside an aggregate go to the site itself
+#pragma omp parallel for
+	for (int aggregate = 0; aggregate < next->layout->localsize; ++aggregate) {
+		std::vector< std::complex<real_t> > product(dofs*nextDofs);
+		for (int position = level->aggregateOffsets[aggregate]; position < level->aggregateOffsets[aggregate + 1]; ++position) {
+			int site = level->aggregateSites[position];
+			const std::complex<real_t>* left = &level->basis[site*dofs*nextDofs];
+			for (unsigned int direction = 0; direction < 9; ++direction) {
+				int neighbour = (direction == 8) ? site : level->layout->neighbour(site, direction);
+				int target = (direction == 8 || (neighbour < level->layout->localsize && level->aggregate[neighbour] == aggregate)) ? 8 : direction;
+				const std::complex<real_t>* matrix = level->coarseOperator->link(site, direction);
+				const std::complex<real_t>* right = &level->basis[neighbour*dofs*nextDofs];
+				for (int i = 0; i < dofs; ++i) {
+					for (int k = 0; k < nextDofs; ++k) {
+						std::complex<real_t> entry = 0.;
+						for (int j = 0; j < dofs; ++j) entry += matrix[i*dofs + j]*right[j*nextDofs + k];
+						product[i*nextDofs + k] = entry;
+					}
+				}
+				std::complex<real_t>* result = next->coarseOperator->link(aggregate, target);
+				for (int k = 0; k < nextDofs; ++k) {
+					for (int l = 0; l < nextDofs; ++l) {
+						std::complex<real_t> entry = 0.;
+						for (int i = 0; i < dofs; ++i) entry += conj(left[i*nextDofs + k])*product[i*nextDofs + l];
+						result[k*nextDofs + l] += entry;
+					}
+				}
+			}
+
+			//gamma5 couples only the sites with themselves, also on the next level
+			const std::complex<real_t>* gamma5 = &level->gamma5[site*dofs*dofs];
+			for (int i = 0; i < dofs; ++i) {
+				for (int k = 0; k < nextDofs; ++k) {
+					std::complex<real_t> entry = 0.;
+					for (int j = 0; j < dofs; ++j) entry += gamma5[i*dofs + j]*left[j*nextDofs + k];
+					product[i*nextDofs + k] = entry;
+				}
+			}
+			std::complex<real_t>* result = &next->gamma5[aggregate*nextDofs*nextDofs];
+			for (int k = 0; k < nextDofs; ++k) {
+				for (int l = 0; l < nextDofs; ++l) {
+					std::complex<real_t> entry = 0.;
+					for (int i = 0; i < dofs; ++i) entry += conj(left[i*nextDofs + k])*product[i*nextDofs + l];
+					result[k*nextDofs + l] += entry;
+				}
+			}
+		}
+
+		const std::complex<real_t>* matrix = next->coarseOperator->link(aggregate, 8);
+		for (int k = 0; k < nextDofs*nextDofs; ++k) next->diagonal[aggregate*nextDofs*nextDofs + k] = matrix[k];
+	}
+	next->coarseOperator->computeDiagonalInverse();
+}
+
+void MultiGridHierarchy::restrictVector(coarse_vector_t& output, const reduced_dirac_vector_t& input, const BlockBasis& basis) const {
+	const MultiGridCoarseLayout* layout = levels[0]->layout;
+	const int dofs = layout->dofs;
+	if (output.size() != static_cast<unsigned int>(layout->completesize*dofs)) layout->allocate(output);
+#pragma omp parallel for
+	for (int block = 0; block < layout->localsize; ++block) {
+		for (int i = 0; i < dofs; ++i) {
+			std::complex<real_t> projection = 0.;
+			for (int index = MultiGridVectorLayout::blockOffsets[block]; index < MultiGridVectorLayout::blockOffsets[block + 1]; ++index) {
+				int site = MultiGridVectorLayout::blockSites[index];
+				for (unsigned int mu = 0; mu < 4; ++mu) projection += vector_dot(basis[i][site][mu], input[site][mu]);
+			}
+			output[block*dofs + i] = projection;
+		}
+	}
+}
+
+void MultiGridHierarchy::prolongVector(reduced_dirac_vector_t& output, const coarse_vector_t& input, const BlockBasis& basis) const {
+	const int dofs = levels[0]->layout->dofs;
+#pragma omp parallel for
+	for (int site = 0; site < output.localsize; ++site) {
+		int block = MultiGridVectorLayout::index(site);
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			set_to_zero(output[site][mu]);
+			for (int i = 0; i < dofs; ++i) output[site][mu] += input[block*dofs + i]*basis[i][site][mu];
+		}
+	}
+	output.updateHalo();
+}
+
+void MultiGridHierarchy::restrictLevel(int index, coarse_vector_t& output, const coarse_vector_t& input) const {
+	const Level* level = levels[index];
+	const int dofs = level->layout->dofs;
+	const int nextDofs = levels[index + 1]->layout->dofs;
+#pragma omp parallel for
+	for (int aggregate = 0; aggregate < levels[index + 1]->layout->localsize; ++aggregate) {
+		for (int k = 0; k < nextDofs; ++k) output[aggregate*nextDofs + k] = 0.;
+		for (int position = level->aggregateOffsets[aggregate]; position < level->aggregateOffsets[aggregate + 1]; ++position) {
+			int site = level->aggregateSites[position];
+			for (int i = 0; i < dofs; ++i) {
+				const std::complex<real_t>* vectors = &level->basis[(site*dofs + i)*nextDofs];
+				for (int k = 0; k < nextDofs; ++k) output[aggregate*nextDofs + k] += conj(vectors[k])*input[site*dofs + i];
+			}
+		}
+	}
+}
+
+void MultiGridHierarchy::prolongLevel(int index, coarse_vector_t& output, const coarse_vector_t& input) const {
+	const Level* level = levels[index];
+	const int dofs = level->layout->dofs;
+	const int nextDofs = levels[index + 1]->layout->dofs;
+#pragma omp parallel for
+	for (int site = 0; site < level->layout->localsize; ++site) {
+		const std::complex<real_t>* coarse = &input[level->aggregate[site]*nextDofs];
+		for (int i = 0; i < dofs; ++i) {
+			const std::complex<real_t>* vectors = &level->basis[(site*dofs + i)*nextDofs];
+			std::complex<real_t> result = 0.;
+			for (int k = 0; k < nextDofs; ++k) result += vectors[k]*coarse[k];
+			output[site*dofs + i] = result;
+		}
+	}
+}
+
+void MultiGridHierarchy::solve(coarse_vector_t& solution, const coarse_vector_t& source) {
+	if (solution.size() != source.size()) levels[0]->layout->allocate(solution);
+	this->solveLevel(0, solution, source);
+}
+
+void MultiGridHierarchy::solveLevel(int index, coarse_vector_t& solution, const coarse_vector_t& source) {
+	if (index + 1 < static_cast<int>(levels.size())) {
+		this->gcr(levels[index], index, solution, source, steps, precision, true, false);
+	}
+	else if (agglomerated != 0) {
+		const MultiGridCoarseLayout* layout = agglomerated->layout;
+		layout->gather(layout->isActive() ? &agglomerated->restricted[0] : 0, &source[0], layout->dofs);
+		if (layout->isActive()) this->gcr(agglomerated, index, agglomerated->coarseSolution, agglomerated->restricted, coarsestSteps, precision, false, false);
+		layout->scatter(&solution[0], layout->isActive() ? &agglomerated->coarseSolution[0] : 0, layout->dofs);
+	}
+	else {
+		this->gcr(levels[index], index, solution, source, coarsestSteps, precision, false, false);
+	}
+}
+
+void MultiGridHierarchy::gcr(Level* level, int index, coarse_vector_t& solution, const coarse_vector_t& source, int maxSteps, real_t relativePrecision, bool recursive, bool useGuess) {
+	const MultiGridCoarseLayout* layout = level->layout;
+	const MultiGridCoarseOperator* coarseOperator = level->coarseOperator;
+	const int size = layout->localsize*layout->dofs;
+	coarse_vector_t& residual = level->residual;
+
+	long_real_t normSource = layout->squaredNorm(source);
+	if (useGuess) {
+		coarseOperator->multiply(residual, solution);
+#pragma omp parallel for
+		for (int i = 0; i < size; ++i) residual[i] = source[i] - residual[i];
+	}
+	else {
+#pragma omp parallel for
+		for (int i = 0; i < size; ++i) {
+			solution[i] = 0.;
+			residual[i] = source[i];
+		}
+		if (normSource == 0.) return;
+	}
+
+	std::vector<long_real_t> projections(2*coarseRestart);
+	for (int step = 0; step < maxSteps; ++step) {
+		const int current = step % coarseRestart;
+		coarse_vector_t& u = level->u[current];
+		coarse_vector_t& c = level->c[current];
+		if (recursive) this->precondition(index, u, residual);
+		else coarseOperator->multiplyDiagonalInverse(u, residual);
+		coarseOperator->multiply(c, u);
+
+		//Classical Gram-Schmidt against the directions of the current cycle, with a single reduction
+		if (current > 0) {
+			for (int k = 0; k < current; ++k) {
+				long_real_t result_re = 0., result_im = 0.;
+#pragma omp parallel for reduction(+:result_re, result_im)
+				for (int i = 0; i < size; ++i) {
+					std::complex<real_t> partial = conj(level->c[k][i])*c[i];
+					result_re += real(partial);
+					result_im += imag(partial);
+				}
+				projections[2*k] = result_re;
+				projections[2*k + 1] = result_im;
+			}
+			layout->reduceSum(&projections[0], 2*current);
+#pragma omp parallel for
+			for (int i = 0; i < size; ++i) {
+				for (int k = 0; k < current; ++k) {
+					std::complex<real_t> alpha(projections[2*k], projections[2*k + 1]);
+					c[i] -= alpha*level->c[k][i];
+					u[i] -= alpha*level->u[k][i];
+				}
+			}
+		}
+
+		real_t norm = sqrt(layout->squaredNorm(c));
+		if (norm == 0.) break;
+#pragma omp parallel for
+		for (int i = 0; i < size; ++i) {
+			c[i] /= norm;
+			u[i] /= norm;
+		}
+
+		std::complex<real_t> alpha = static_cast< std::complex<real_t> >(layout->dot(c, residual));
+#pragma omp parallel for
+		for (int i = 0; i < size; ++i) {
+			solution[i] += alpha*u[i];
+			residual[i] -= alpha*c[i];
+		}
+
+		long_real_t error = layout->squaredNorm(residual);
+		if (error < relativePrecision*relativePrecision*normSource) break;
+	}
+}
+
+void MultiGridHierarchy::precondition(int index, coarse_vector_t& output, const coarse_vector_t& input) {
+	Level* level = levels[index];
+	const MultiGridCoarseOperator* coarseOperator = level->coarseOperator;
+	const int size = level->layout->localsize*level->layout->dofs;
+
+	//Coarse correction with the next level
+	this->restrictLevel(index, level->restricted, input);
+	this->solveLevel(index + 1, level->coarseSolution, level->restricted);
+	this->prolongLevel(index, level->correction, level->coarseSolution);
+
+	//Minimal residual smoothing with block Jacobi of the residual left by the coarse correction
+	coarseOperator->multiply(level->product, level->correction);
+#pragma omp parallel for
+	for (int i = 0; i < size; ++i) {
+		level->smootherResidual[i] = input[i] - level->product[i];
+		level->smootherCorrection[i] = 0.;
+	}
+	for (int step = 0; step < smoothingSteps; ++step) {
+		coarseOperator->multiplyDiagonalInverse(level->jacobi, level->smootherResidual);
+		coarseOperator->multiply(level->product, level->jacobi);
+		long_real_t result_re = 0., result_im = 0., result_norm = 0.;
+#pragma omp parallel for reduction(+:result_re, result_im, result_norm)
+		for (int i = 0; i < size; ++i) {
+			std::complex<real_t> partial = conj(level->product[i])*level->smootherResidual[i];
+			result_re += real(partial);
+			result_im += imag(partial);
+			result_norm += norm(level->product[i]);
+		}
+		long_real_t values[3] = {result_re, result_im, result_norm};
+		level->layout->reduceSum(values, 3);
+		if (values[2] == 0.) break;
+		std::complex<real_t> omega(values[0]/values[2], values[1]/values[2]);
+#pragma omp parallel for
+		for (int i = 0; i < size; ++i) {
+			level->smootherCorrection[i] += omega*level->jacobi[i];
+			level->smootherResidual[i] -= omega*level->product[i];
+		}
+	}
+
+#pragma omp parallel for
+	for (int i = 0; i < size; ++i) output[i] = level->correction[i] + level->smootherCorrection[i];
+}
+
+void MultiGridHierarchy::generateRandomVector(const MultiGridCoarseLayout* layout, coarse_vector_t& vector) const {
+	random_generator_t rng(RandomSeed::randomSeed());
+	random_uniform_generator_t randomUniform(RandomSeed::getRandomNumberGenerator(rng));
+	layout->allocate(vector);
+	for (int i = 0; i < layout->localsize*layout->dofs; ++i) vector[i] = std::complex<real_t>(randomUniform(), randomUniform());
+}
+
+void MultiGridHierarchy::setNumberLevels(int _numberLevels) {
+	if (_numberLevels != numberLevels) this->clear();
+	numberLevels = _numberLevels;
+}
+
+int MultiGridHierarchy::getNumberLevels() const {
+	return numberLevels;
+}
+
+void MultiGridHierarchy::setBlockSize(const std::vector<unsigned int>& _blockSize) {
+	this->clear();
+	blockSize = _blockSize;
+}
+
+const std::vector<unsigned int>& MultiGridHierarchy::getBlockSize() const {
+	return blockSize;
+}
+
+void MultiGridHierarchy::setBasisDimension(int _basisDimension) {
+	if (_basisDimension != basisDimension) this->clear();
+	basisDimension = _basisDimension;
+}
+
+int MultiGridHierarchy::getBasisDimension() const {
+	return basisDimension;
+}
+
+void MultiGridHierarchy::setSteps(int _steps) {
+	steps = _steps;
+}
+
+int MultiGridHierarchy::getSteps() const {
+	return steps;
+}
+
+void MultiGridHierarchy::setPrecision(real_t _precision) {
+	precision = _precision;
+}
+
+real_t MultiGridHierarchy::getPrecision() const {
+	return precision;
+}
+
+void MultiGridHierarchy::setCoarsestSteps(int _coarsestSteps) {
+	coarsestSteps = _coarsestSteps;
+}
+
+int MultiGridHierarchy::getCoarsestSteps() const {
+	return coarsestSteps;
+}
+
+void MultiGridHierarchy::setSmoothingSteps(int _smoothingSteps) {
+	smoothingSteps = _smoothingSteps;
+}
+
+int MultiGridHierarchy::getSmoothingSteps() const {
+	return smoothingSteps;
+}
+
+void MultiGridHierarchy::setSetupSteps(int _setupSteps) {
+	setupSteps = _setupSteps;
+}
+
+int MultiGridHierarchy::getSetupSteps() const {
+	return setupSteps;
+}
+
+void MultiGridHierarchy::setAgglomerationSize(int _agglomerationSize) {
+	if (_agglomerationSize != agglomerationSize) this->clear();
+	agglomerationSize = _agglomerationSize;
+}
+
+int MultiGridHierarchy::getAgglomerationSize() const {
+	return agglomerationSize;
+}
+
+}
@@ -0,0 +1,175 @@
+#ifndef MULTIGRIDHIERARCHY_H
+#define MULTIGRIDHIERARCHY_H
+#include "BlockBasis.h"
+#include "MultiGridCoarseOperator.h"
+#include "dirac_operators/DiracOperator.h"
+#include <vector>
+
+namespace Update {
+
+/**
+ * The coarse levels of a multigrid solver with more than two levels. The first coarse level is the one of the blocks and of the
+ * basis of MultiGridSolver, its operator is stored explicitly and it is built probing the fine Dirac operator with the basis
+ * vectors restricted to the blocks of the same parity, so the fine operator must couple only nearest neighbours and the number
+ * of blocks in every direction must be one or even. Every further level aggregates blockSize sites of the previous one, it has
+ * its own basis built from the previous coarse operator and its operator is the Galerkin product R A P. The levels are solved
+ * with a K-cycle: a flexible GCR preconditioned by the next level and by a block Jacobi minimal residual smoother. The coarsest
+ * level is solved by a block Jacobi preconditioned GCR, agglomerated on fewer processors when its local volume is too small.
+ * The operators are probed and coarsened only when the links, kappa or the basis change. The twisted mass of TwistedDiracOperator
+ * is not probed: every level stores the site-diagonal term R gamma5 P, and a new twist changes only the couplings of the sites
+ * with themselves.
+ */
+class MultiGridHierarchy {
+public:
+	MultiGridHierarchy();
+	//Only the parameters are copied, the levels are built again by initialize
+	MultiGridHierarchy(const MultiGridHierarchy& toCopy);
+	MultiGridHierarchy& operator=(const MultiGridHierarchy& toCopy);
+	~MultiGridHierarchy();
+
+	/**
+	 * This function builds the layouts of the coarse levels for the blocks of MultiGridVectorLayout
+	 * @param fineBasisDimension the dimension of the basis of MultiGridSolver
+	 * @return false if the fine blocks cannot be probed, the hierarchy is then not used
+	 */
+	bool initialize(int fineBasisDimension);
+	bool isInitialized() const;
+	//Deletes the levels, initialize must be called again
+	void clear();
+
+	//The bases of the coarse levels are built again by the next setOperator, to be called when the basis of MultiGridSolver changes
+	void invalidateBases();
+
+	/**
+	 * This function builds the operators of all the levels for the fine operator dirac, and their bases if they are not valid.
+	 * The operators are built again only for a new lattice or basis, otherwise only the twist is updated
+	 * @param dirac
+	 * @param basis the basis of MultiGridSolver
+	 * @return false if the probed operator does not reproduce R dirac P, i.e. dirac is not a nearest neighbour operator,
+	 * the hierarchy is then not used until the lattice or the basis change
+	 */
+	bool setOperator(DiracOperator* dirac, const BlockBasis& basis);
+
+	//output = R input and output = P input, between the fine lattice and the first coarse level
+	void restrictVector(coarse_vector_t& output, const reduced_dirac_vector_t& input, const BlockBasis& basis) const;
+	void prolongVector(reduced_dirac_vector_t& output, const coarse_vector_t& input, const BlockBasis& basis) const;
+
+	//Approximate solution of the first coarse level
+	void solve(coarse_vector_t& solution, const coarse_vector_t& source);
+
+	//The total number of levels, the fine one included
+	void setNumberLevels(int _numberLevels);
+	int getNumberLevels() const;
+
+	//The number of sites of a level aggregated in a site of the next one
+	void setBlockSize(const std::vector<unsigned int>& _blockSize);
+	const std::vector<unsigned int>& getBlockSize() const;
+
+	void setBasisDimension(int _basisDimension);
+	int getBasisDimension() const;
+
+	//GCR steps and relative precision of the K-cycle on the coarse levels
+	void setSteps(int _steps);
+	int getSteps() const;
+
+	void setPrecision(real_t _precision);
+	real_t getPrecision() const;
+
+	void setCoarsestSteps(int _coarsestSteps);
+	int getCoarsestSteps() const;
+
+	void setSmoothingSteps(int _smoothingSteps);
+	int getSmoothingSteps() const;
+
+	//GCR steps used to build every vector of the bases of the coarse levels
+	void setSetupSteps(int _setupSteps);
+	int getSetupSteps() const;
+
+	//The coarsest level is agglomerated on fewer processors when its local sites are less than agglomerationSize
+	void setAgglomerationSize(int _agglomerationSize);
+	int getAgglomerationSize() const;
+
+private:
+	struct Level {
+		Level(MultiGridCoarseLayout* _layout);
+		~Level();
+
+		MultiGridCoarseLayout* layout;
+		MultiGridCoarseOperator* coarseOperator;
+		//The couplings of the sites with themselves without the twist and the term R gamma5 P, dofs x dofs row major for every site
+		std::vector< std::complex<real_t> > diagonal;
+		std::vector< std::complex<real_t> > gamma5;
+		//The basis used to build the next level, the component i of the vector k on the site x is basis[(x*dofs + i)*nextDofs + k]
+		coarse_vector_t basis;
+		//The aggregate of the next level of every local site and the local sites of every aggregate
+		std::vector<int> aggregate;
+		std::vector<int> aggregateOffsets;
+		std::vector<int> aggregateSites;
+
+		//Workspace of the solvers, restricted and coarseSolution live on the next level
+		std::vector<coarse_vector_t> u;
+		std::vector<coarse_vector_t> c;
+		coarse_vector_t residual, correction, product, smootherResidual, smootherCorrection, jacobi;
+		coarse_vector_t restricted, coarseSolution;
+	};
+
+	//Builds the operator of the first coarse level from dirac
+	void assembleOperator(DiracOperator* dirac, const BlockBasis& basis);
+	//Builds R gamma5 P on the first coarse level
+	void assembleGamma5(const BlockBasis& basis);
+	//Checks the operator of the first coarse level against R dirac P on a random vector
+	bool checkOperator(DiracOperator* dirac, const BlockBasis& basis);
+	//True if the links or kappa of dirac are not the ones of the last assembled operator, the links are then stored
+	bool isNewOperator(DiracOperator* dirac);
+	//The couplings of the sites with themselves of all the levels for the new twist
+	void setTwist(real_t _twist);
+	//Builds the basis of the level index from its operator
+	void setupBasis(int index);
+	//Operator and gamma5 term of the level index + 1 from the ones of the level index, without the twist
+	void coarsen(int index);
+
+	void restrictLevel(int index, coarse_vector_t& output, const coarse_vector_t& input) const;
+	void prolongLevel(int index, coarse_vector_t& output, const coarse_vector_t& input) const;
+
+	void solveLevel(int index, coarse_vector_t& solution, const coarse_vector_t& source);
+	//Flexible GCR on level, preconditioned by the level index + 1 and the smoother when recursive, by block Jacobi otherwise
+	void gcr(Level* level, int index, coarse_vector_t& solution, const coarse_vector_t& source, int maxSteps, real_t relativePrecision, bool recursive, bool useGuess);
+	void precondition(int index, coarse_vector_t& output, const coarse_vector_t& input);
+
+	void generateRandomVector(const MultiGridCoarseLayout* layout, coarse_vector_t& vector) const;
+
+	int numberLevels;
+	std::vector<unsigned int> blockSize;
+	int basisDimension;
+	int steps;
+	real_t precision;
+	int coarsestSteps;
+	int smoothingSteps;
+	int setupSteps;
+	int agglomerationSize;
+
+	bool initialized;
+	bool basesValid;
+	//The blocks of MultiGridVectorLayout cannot be probed, initialize fails until clear is called
+	bool layoutFailed;
+	//The operators are built for the stored links and kappa, operatorFailed if they did not pass checkOperator
+	bool operatorValid;
+	bool operatorFailed;
+	reduced_fermion_lattice_t links;
+	real_t kappa;
+	bool diracGamma5;
+	real_t twist;
+	std::vector<Level*> levels;
+	//The coarsest level agglomerated on fewer processors, 0 if it is not agglomerated
+	Level* agglomerated;
+
+	//The parity of the blocks and the faces of the block on which the fine sites lie
+	std::vector<int> blockParity;
+	std::vector<int> siteFaces;
+	reduced_dirac_vector_t probe;
+	reduced_dirac_vector_t image;
+};
+
+}
+
+#endif
@@ -32,6 +32,11 @@ public:
 	matrix_t asMatrix();
 
 protected:
+	//output = P input, from the blocks to the fine lattice
+	void prolongVector(reduced_dirac_vector_t& output, const multigrid_vector_t& input);
+	//output = R input, the projections of input on the basis vectors restricted to the blocks
+	void restrictVector(multigrid_vector_t& output, const reduced_dirac_vector_t& input);
+
 	std::vector<reduced_dirac_vector_t const*> vectorspace;
 	DiracOperator* dirac;
 
@@ -2,27 +2,27 @@
 #include "MultiGridProjector.h"
 #include "algebra_utils/AlgebraUtils.h"
 #include "inverters/GMRESR.h"
+#include "dirac_operators/SAPPreconditioner.h"
+#include "dirac_operators/TwistedDiracOperator.h"
 
 namespace Update {
 
-MultiGridSolver::MultiGridSolver(int basisDimension, const std::vector<unsigned int>& _blockSize, BlockDiracOperator* _blackBlockDiracOperator, BlockDiracOperator* _redBlockDiracOperator) : Solver("MultiGridSolver"), blockBasis(basisDimension), blockSize(_blockSize), blackBlockDiracOperator(_blackBlockDiracOperator), redBlockDiracOperator(_redBlockDiracOperator), biMgSolver(new MultiGridBiConjugateGradientSolver()), SAPIterantions(7), SAPMaxSteps(100), SAPPrecision(0.00001), GMRESIterations(300), GMRESPrecision(0.0000000001), BiMGIterations(35), BiMGPrecision(0.00000000001) { }
+MultiGridSolver::MultiGridSolver(int basisDimension, const std::vector<unsigned int>& _blockSize, BlockDiracOperator* _blackBlockDiracOperator, BlockDiracOperator* _redBlockDiracOperator) : Solver("MultiGridSolver"), blockBasis(basisDimension), blockSize(_blockSize), blackBlockDiracOperator(_blackBlockDiracOperator), redBlockDiracOperator(_redBlockDiracOperator), complementBlockDiracOperator(0), localSAPPreconditioner(0), biMgSolver(new MultiGridBiConjugateGradientSolver()), SAPIterantions(7), SAPMaxSteps(100), SAPPrecision(0.00001), GMRESIterations(300), GMRESPrecision(0.0000000001), BiMGIterations(35), BiMGPrecision(0.00000000001), basisUpdateIterations(61), rebuildThreshold(1.5), basisInitialized(false), referenceSteps(0.), setupSteps(0), setupSolves(0) { }
 
-bool MultiGridSolver::solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess) {
-	blackBlockDiracOperator->setLattice(*dirac->getLattice());
-	blackBlockDiracOperator->setGamma5(false);
-	//blackBlockDiracOperator->setBlockSize(blockSize);
-		
-	redBlockDiracOperator->setLattice(*dirac->getLattice());
-	redBlockDiracOperator->setGamma5(false);
-	//redBlockDiracOperator->setBlockSize(blockSize);
-	
-	ComplementBlockDiracOperator* K = new ComplementBlockDiracOperator(dirac, redBlockDiracOperator, blackBlockDiracOperator);
-	K->setMaximumSteps(SAPMaxSteps);
-	K->setBlockSize(blockSize);
+MultiGridSolver::~MultiGridSolver() {
+	if (localSAPPreconditioner != 0) delete localSAPPreconditioner;
+}
 
-	SAPPreconditioner *preconditioner = new SAPPreconditioner(dirac,K);
-	preconditioner->setSteps(SAPIterantions);
-	preconditioner->setPrecision(SAPPrecision);
+bool MultiGridSolver::solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess) {
+	DiracOperator* preconditioner = this->getSAPPreconditioner(dirac);
+
+	//The explicit coarse operators are built again only for a new lattice or basis, when they cannot be built
+	//the two level multigrid is used for this configuration
+	bool useHierarchy = false;
+	if (hierarchy.getNumberLevels() > 2) {
+		if (!hierarchy.isInitialized()) hierarchy.initialize(blockBasis.size());
+		useHierarchy = hierarchy.setOperator(dirac, blockBasis);
+	}
 
 	MultiGridOperator* multiGridOperator = new MultiGridOperator();
 	MultiGridProjector* multiGridProjector = new MultiGridProjector();
@@ -64,12 +64,20 @@ bool MultiGridSolver::solve(DiracOperator* dirac, const reduced_dirac_vector_t&
 	double elapsed;
 	clock_gettime(CLOCK_REALTIME, &start);
 
+	lastSteps = maxSteps;
 	for (unsigned int k = 0; k < maxSteps; ++k) {
 		{
-			multiGridProjector->apply(source_hat,r);
-			biMgSolver->solve(multiGridOperator, source_hat, solution_hat);
+			if (useHierarchy) {
+				hierarchy.restrictVector(coarse_source, r, blockBasis);
+				hierarchy.solve(coarse_solution, coarse_source);
+				hierarchy.prolongVector(mg_inverse, coarse_solution, blockBasis);
+			}
+			else {
+				multiGridProjector->apply(source_hat,r);
+				biMgSolver->solve(multiGridOperator, source_hat, solution_hat);
 
-			multiGridProjector->apply(mg_inverse,solution_hat);
+				multiGridProjector->apply(mg_inverse,solution_hat);
+			}
 
 			dirac->multiply(source_sap,mg_inverse);
 #pragma omp parallel for
@@ -125,7 +133,7 @@ bool MultiGridSolver::solve(DiracOperator* dirac, const reduced_dirac_vector_t&
 		long_real_t error = AlgebraUtils::squaredNorm(r);
 		lastError = error;
 		if (error < precision) {
-			maxSteps = k;
+			lastSteps = k + 1;
 			break;
 		}
 		else if (isOutputProcess()) {
@@ -139,9 +147,10 @@ bool MultiGridSolver::solve(DiracOperator* dirac, const reduced_dirac_vector_t&
 	elapsed += (finish.tv_nsec - start.tv_nsec) / 1000000000.0;
 
 	if (isOutputProcess()) std::cout << "MultiGridSolver::Multigrid inversion done in: " << (elapsed) << " s."<< std::endl;
+	setupSteps += lastSteps;
+	++setupSolves;
 
-	delete K;
-	delete preconditioner;
+	this->deleteSAPPreconditioner(preconditioner);
 	delete multiGridOperator;
 	delete multiGridProjector;
 
@@ -165,21 +174,7 @@ void MultiGridSolver::initializeBasis(DiracOperator* dirac) {
 	gmres_inverter->setPrecision(GMRESPrecision);
 	gmres_inverter->setMaximumSteps(GMRESIterations);
 
-	blackBlockDiracOperator->setLattice(*dirac->getLattice());
-	blackBlockDiracOperator->setGamma5(false);
-	blackBlockDiracOperator->setBlockSize(blockSize);
-	
-	redBlockDiracOperator->setLattice(*dirac->getLattice());
-	redBlockDiracOperator->setGamma5(false);
-	redBlockDiracOperator->setBlockSize(blockSize);
-	
-	ComplementBlockDiracOperator* K = new ComplementBlockDiracOperator(dirac, redBlockDiracOperator, blackBlockDiracOperator);
-	K->setMaximumSteps(SAPMaxSteps);
-	K->setBlockSize(blockSize);
-
-	SAPPreconditioner *preconditioner = new SAPPreconditioner(dirac,K);
-	preconditioner->setSteps(SAPIterantions);
-	preconditioner->setPrecision(SAPPrecision);
+	DiracOperator* preconditioner = this->getSAPPreconditioner(dirac);
 
 	struct timespec start, finish;
 	double elapsed;
@@ -203,6 +198,8 @@ void MultiGridSolver::initializeBasis(DiracOperator* dirac) {
 	}
 
 	blockBasis.orthogonalize();
+	//The blocks could be changed, the coarse levels are built again
+	hierarchy.clear();
 
 	clock_gettime(CLOCK_REALTIME, &finish);
 	elapsed = (finish.tv_sec - start.tv_sec);
@@ -210,9 +207,14 @@ void MultiGridSolver::initializeBasis(DiracOperator* dirac) {
 
 	if (isOutputProcess()) std::cout << "MultiGridSolver::Multigrid basis constructed in: " << (elapsed) << " s."<< std::endl;
 
+	//The reference number of iterations is measured again with the new basis
+	basisInitialized = true;
+	referenceSteps = 0.;
+	setupSteps = 0;
+	setupSolves = 0;
+
 	delete gmres_inverter;
-	delete K;
-	delete preconditioner;
+	this->deleteSAPPreconditioner(preconditioner);
 }
 
 void MultiGridSolver::updateBasis(DiracOperator* dirac) {
@@ -221,23 +223,9 @@ void MultiGridSolver::updateBasis(DiracOperator* dirac) {
 	reduced_dirac_vector_t randomVector;
 	GMRESR* gmres_inverter = new GMRESR();
 	gmres_inverter->setPrecision(GMRESPrecision);
-	gmres_inverter->setMaximumSteps(GMRESIterations/5+1);
-
-	blackBlockDiracOperator->setLattice(*dirac->getLattice());
-	blackBlockDiracOperator->setGamma5(false);
-	blackBlockDiracOperator->setBlockSize(blockSize);
-		
-	redBlockDiracOperator->setLattice(*dirac->getLattice());
-	redBlockDiracOperator->setGamma5(false);
-	redBlockDiracOperator->setBlockSize(blockSize);
-	
-	ComplementBlockDiracOperator* K = new ComplementBlockDiracOperator(dirac, redBlockDiracOperator, blackBlockDiracOperator);
-	K->setMaximumSteps(SAPMaxSteps);
-	K->setBlockSize(blockSize);
+	gmres_inverter->setMaximumSteps(basisUpdateIterations);
 
-	SAPPreconditioner *preconditioner = new SAPPreconditioner(dirac,K);
-	preconditioner->setSteps(SAPIterantions);
-	preconditioner->setPrecision(SAPPrecision);
+	DiracOperator* preconditioner = this->getSAPPreconditioner(dirac);
 
 	struct timespec start, finish;
 	double elapsed;
@@ -257,6 +245,7 @@ void MultiGridSolver::updateBasis(DiracOperator* dirac) {
 	}
 
 	blockBasis.orthogonalize();
+	hierarchy.invalidateBases();
 
 	clock_gettime(CLOCK_REALTIME, &finish);
 	elapsed = (finish.tv_sec - start.tv_sec);
@@ -265,8 +254,80 @@ void MultiGridSolver::updateBasis(DiracOperator* dirac) {
 	if (isOutputProcess()) std::cout << "MultiGridSolver::Multigrid basis constructed in: " << (elapsed) << " s."<< std::endl;
 
 	delete gmres_inverter;
-	delete K;
-	delete preconditioner;
+	this->deleteSAPPreconditioner(preconditioner);
+}
+
+void MultiGridSolver::refreshBasis(DiracOperator* dirac) {
+	if (!basisInitialized) {
+		this->initializeBasis(dirac);
+		return;
+	}
+
+	if (setupSolves != 0) {
+		real_t averageSteps = static_cast<real_t>(setupSteps)/setupSolves;
+		if (referenceSteps == 0.) {
+			//First inversions after a full setup
+			referenceSteps = averageSteps;
+		}
+		else if (averageSteps > rebuildThreshold*referenceSteps) {
+			if (isOutputProcess()) std::cout << "MultiGridSolver::Average multigrid iterations " << averageSteps << " against " << referenceSteps << " after the setup, the basis is built again" << std::endl;
+			this->initializeBasis(dirac);
+			return;
+		}
+	}
+	setupSteps = 0;
+	setupSolves = 0;
+
+	this->updateBasis(dirac);
+}
+
+DiracOperator* MultiGridSolver::getSAPPreconditioner(DiracOperator* dirac) {
+	if (LocalSAPPreconditioner::isSupported(dirac)) {
+		if (localSAPPreconditioner == 0) {
+			localSAPPreconditioner = new LocalSAPPreconditioner(dirac);
+			localSAPPreconditioner->setBlockSize(blockSize);
+		}
+		else {
+			localSAPPreconditioner->setDiracOperator(dirac);
+		}
+		localSAPPreconditioner->setSteps(SAPIterantions);
+		localSAPPreconditioner->setBlockSteps(SAPMaxSteps);
+		localSAPPreconditioner->setPrecision(SAPPrecision);
+		return localSAPPreconditioner;
+	}
+
+	if (blackBlockDiracOperator == 0 || redBlockDiracOperator == 0) {
+		if (isOutputProcess()) std::cout << "MultiGridSolver::Fatal error, no block operators for the SAP of " << dirac->getName() << std::endl;
+		exit(1);
+	}
+	//The links of a TwistedDiracOperator are those of its Dirac operator, the twist of the block operators is set by the caller
+	TwistedDiracOperator* twistedDiracOperator = dynamic_cast<TwistedDiracOperator*>(dirac);
+	const reduced_fermion_lattice_t& lattice = (twistedDiracOperator != 0) ? *twistedDiracOperator->getDiracOperator()->getLattice() : *dirac->getLattice();
+	blackBlockDiracOperator->setLattice(lattice);
+	blackBlockDiracOperator->setGamma5(false);
+	blackBlockDiracOperator->setBlockSize(blockSize);
+
+	redBlockDiracOperator->setLattice(lattice);
+	redBlockDiracOperator->setGamma5(false);
+	redBlockDiracOperator->setBlockSize(blockSize);
+
+	if (complementBlockDiracOperator != 0) delete complementBlockDiracOperator;
+	complementBlockDiracOperator = new ComplementBlockDiracOperator(dirac, redBlockDiracOperator, blackBlockDiracOperator);
+	complementBlockDiracOperator->setMaximumSteps(SAPMaxSteps);
+	complementBlockDiracOperator->setBlockSize(blockSize);
+
+	SAPPreconditioner* preconditioner = new SAPPreconditioner(dirac, complementBlockDiracOperator);
+	preconditioner->setSteps(SAPIterantions);
+	preconditioner->setPrecision(SAPPrecision);
+	return preconditioner;
+}
+
+void MultiGridSolver::deleteSAPPreconditioner(DiracOperator* preconditioner) {
+	if (preconditioner != localSAPPreconditioner) delete preconditioner;
+	if (complementBlockDiracOperator != 0) {
+		delete complementBlockDiracOperator;
+		complementBlockDiracOperator = 0;
+	}
 }
 
 void MultiGridSolver::setSAPIterations(int _SAPIterantions) {
@@ -309,13 +370,43 @@ real_t MultiGridSolver::getGMRESPrecision() const {
 	return GMRESPrecision;
 }
 
+void MultiGridSolver::setBasisUpdateIterations(int _basisUpdateIterations) {
+	basisUpdateIterations = _basisUpdateIterations;
+}
+
+int MultiGridSolver::getBasisUpdateIterations() const {
+	return basisUpdateIterations;
+}
+
+void MultiGridSolver::setRebuildThreshold(real_t _rebuildThreshold) {
+	rebuildThreshold = _rebuildThreshold;
+}
+
+real_t MultiGridSolver::getRebuildThreshold() const {
+	return rebuildThreshold;
+}
+
 void MultiGridSolver::setBasisDimension(unsigned int dim) {
 	blockBasis.setBasisDimension(dim);
+	basisInitialized = false;
+	hierarchy.clear();
 }
 
 unsigned int MultiGridSolver::getBasisDimension() const {
 	return blockBasis.size();
 }
+
+void MultiGridSolver::setNumberLevels(int _numberLevels) {
+	hierarchy.setNumberLevels(_numberLevels);
+}
+
+int MultiGridSolver::getNumberLevels() const {
+	return hierarchy.getNumberLevels();
+}
+
+MultiGridHierarchy* MultiGridSolver::getHierarchy() {
+	return &hierarchy;
+}
 	
 BlockBasis* MultiGridSolver::getBasis() {
 	return &blockBasis;
@@ -2,7 +2,10 @@
 #define MULTIGRIDSOLVER_H
 #include "BlockBasis.h"
 #include "MultiGridBiConjugateGradient.h"
-#include "dirac_operators/SAPPreconditioner.h"
+#include "MultiGridHierarchy.h"
+#include "dirac_operators/BlockDiracOperator.h"
+#include "dirac_operators/LocalSAPPreconditioner.h"
+#include "dirac_operators/ComplementBlockDiracOperator.h"
 #include "inverters/Solver.h"
 #include <vector>
 
@@ -13,15 +16,32 @@ class MultiGridSolver : public Solver {
 		using Solver::solve;
 
 		MultiGridSolver(int basisDimension, const std::vector<unsigned int>& _blockSize, BlockDiracOperator* _blackBlockDiracOperator, BlockDiracOperator* _redBlockDiracOperator);
+		~MultiGridSolver();
 		
 		bool solve(DiracOperator* dirac, const reduced_dirac_vector_t& source, reduced_dirac_vector_t& solution, reduced_dirac_vector_t const* initial_guess = 0);
 		
 		void initializeBasis(DiracOperator* dirac);
 		void updateBasis(DiracOperator* dirac);
 
+		/**
+		 * This function prepares the basis for a new gauge configuration. The basis is built from scratch the first time
+		 * and when the average number of multigrid iterations since the last full setup grows above rebuildThreshold times
+		 * its value after the setup, otherwise the previous basis is only smoothed with updateBasis
+		 * @param dirac
+		 */
+		void refreshBasis(DiracOperator* dirac);
+
+		//Maximum number of GMRES iterations used by updateBasis to smooth every basis vector
+		void setBasisUpdateIterations(int _basisUpdateIterations);
+		int getBasisUpdateIterations() const;
+
+		void setRebuildThreshold(real_t _rebuildThreshold);
+		real_t getRebuildThreshold() const;
+
 		void setSAPIterations(int _SAPIterantions);
 		int getSAPIterations() const;
 
+		//Maximum number of the minimal residual iterations of the SAP block solves
 		void setSAPMaxSteps(int _SAPIterantions);
 		int getSAPMaxSteps() const;
 
@@ -36,19 +56,35 @@ class MultiGridSolver : public Solver {
 		
 		void setBasisDimension(unsigned int dim);
 		unsigned int getBasisDimension() const;
+
+		//The total number of levels, with more than two the coarse correction is done by the hierarchy of the coarse levels
+		void setNumberLevels(int _numberLevels);
+		int getNumberLevels() const;
+
+		//The parameters of the levels after the first coarse one
+		MultiGridHierarchy* getHierarchy();
 	
 		BlockBasis* getBasis();
 
 		void setBlockDiracOperators(BlockDiracOperator* _blackBlockDiracOperator, BlockDiracOperator* _redBlockDiracOperator);
 
 	protected:
+		//SAP with local block solves, the block size of the multigrid basis is used for the SAP blocks. The operators not supported
+		//by LocalSAPPreconditioner use SAPPreconditioner with the block inversions of the black and red block operators
+		DiracOperator* getSAPPreconditioner(DiracOperator* dirac);
+		void deleteSAPPreconditioner(DiracOperator* preconditioner);
+
 		BlockBasis blockBasis;
 		std::vector<unsigned int> blockSize;
 
 		BlockDiracOperator* blackBlockDiracOperator;
 		BlockDiracOperator* redBlockDiracOperator;
+		ComplementBlockDiracOperator* complementBlockDiracOperator;
+		//Kept between the solves, its block operator is copied again only for new links or kappa
+		LocalSAPPreconditioner* localSAPPreconditioner;
 
 		MultiGridBiConjugateGradientSolver* biMgSolver;
+		MultiGridHierarchy hierarchy;
 
 		int SAPIterantions;
 		int SAPMaxSteps;
@@ -60,11 +96,22 @@ class MultiGridSolver : public Solver {
 		int BiMGIterations;
 		real_t BiMGPrecision;
 
+		int basisUpdateIterations;
+		real_t rebuildThreshold;
+
+		//The multigrid iterations since the last setup, used to decide if the basis must be built again
+		bool basisInitialized;
+		real_t referenceSteps;
+		unsigned int setupSteps;
+		unsigned int setupSolves;
+
 		reduced_dirac_vector_t r;
 		reduced_dirac_vector_t c[15];
 		reduced_dirac_vector_t u[15];
 		reduced_dirac_vector_t mg_inverse;
 		reduced_dirac_vector_t source_sap;
+		coarse_vector_t coarse_source;
+		coarse_vector_t coarse_solution;
 };
 
 }
@@ -16,14 +16,13 @@ MultiGridStochasticEstimator::~MultiGridStochasticEstimator() {
 void MultiGridStochasticEstimator::getMultigridVectors(DiracOperator* dirac, extended_dirac_vector_t& mg_source, extended_dirac_vector_t& inverse_mg_source) {
 	multigrid_vector_t mg_sr, mg_sol;
 
+	//The coarse components are local to the processor, the noise depends on the number of processors but not on the threads
+	boost::uint32_t stream = CounterRandomGenerator::nextStream();
+	boost::uint64_t offset = static_cast<boost::uint64_t>(extended_dirac_vector_t::Layout::this_processor)*multigrid_vector_t::Layout::size;
 #pragma omp parallel for
 	for (int i = 0; i < multigrid_vector_t::Layout::size; ++i) {
-#ifndef MULTITHREADING
-		real_t realPart = (randomInteger() == 0 ? -1 : 1);
-#endif
-#ifdef MULTITHREADING
-		real_t realPart = ((*randomInteger[omp_get_thread_num()])() == 0 ? -1 : 1);
-#endif
+		CounterRandomGenerator generator(stream, offset + i);
+		real_t realPart = generator.z2();
 		mg_sr[i] = std::complex<real_t>(realPart,0.);
 	}
 
@@ -1,30 +1,59 @@
 #ifndef MULTIGRIDVECTOR_H
 #define MULTIGRIDVECTOR_H
 #include "MultiGridVectorLayout.h"
+#include <cstdlib>
+#include <new>
 
 namespace Update {
 
+/**
+ * Vector of the coarse space of the multigrid, the component of the basis vector i on the block k is stored in data[i*totalNumberOfBlocks + k].
+ * The storage is contiguous and aligned to 64 bytes, it is reallocated only when the size of the layout changes and all the
+ * operations on the components are parallelized with OpenMP. The vectors are local to the processor, the reductions across
+ * the processors are done by the functions dot, squaredNorm and dots.
+ */
 template<typename T,typename TLayout> class MultiGridVector {
 public:
-	MultiGridVector() : data(new T[TLayout::size]) {
+	typedef TLayout Layout;
+
+	MultiGridVector() : data(0), length(0) {
 		++TLayout::instances;
+		this->allocate(TLayout::size);
+#pragma omp parallel for
+		for (int i = 0; i < length; ++i) data[i] = 0.;
 	}
-	MultiGridVector(const MultiGridVector& snd) : data(new T[TLayout::size]) {
+	MultiGridVector(const MultiGridVector& snd) : data(0), length(0) {
 		++TLayout::instances;
-		for (int i = 0; i < Layout::size; ++i) data[i] = snd.data[i];
+		this->allocate(snd.length);
+#pragma omp parallel for
+		for (int i = 0; i < length; ++i) data[i] = snd.data[i];
 	}
 	~MultiGridVector() {
 		--TLayout::instances;
-		delete[] data;
+		free(data);
 	}
 
 	MultiGridVector& operator=(const MultiGridVector& snd) {
-		delete[] data;
-		data = new T[TLayout::size];
-		for (int i = 0; i < Layout::size; ++i) data[i] = snd.data[i];
+		if (this == &snd) return *this;
+		if (length != snd.length) this->allocate(snd.length);
+#pragma omp parallel for
+		for (int i = 0; i < length; ++i) data[i] = snd.data[i];
 		return *this;
 	}
 
+	//Reallocates the vector if the size of the layout changed after its creation, the content is then set to zero
+	void update() {
+		if (length != TLayout::size) {
+			this->allocate(TLayout::size);
+#pragma omp parallel for
+			for (int i = 0; i < length; ++i) data[i] = 0.;
+		}
+	}
+
+	int size() const {
+		return length;
+	}
+
 	T& operator[](int index) {
 		return data[index];
 	}
@@ -40,19 +69,107 @@ public:
 	const T& operator()(int vector, int site) const {
 		return data[Layout::totalNumberOfBlocks*vector + Layout::index(site)];
 	}
-	
-	typedef TLayout Layout;
 
-	vector_t asVector() {
-		vector_t result(Layout::size);
-		for (int i = 0; i < Layout::size; ++i) {
+#ifdef EIGEN
+	//A view of the local components as an Eigen vector, no copy is done
+	Eigen::Map<vector_t, Eigen::Aligned> asVector() {
+		return Eigen::Map<vector_t, Eigen::Aligned>(data, length);
+	}
+
+	Eigen::Map<const vector_t, Eigen::Aligned> asVector() const {
+		return Eigen::Map<const vector_t, Eigen::Aligned>(data, length);
+	}
+#endif
+#ifndef EIGEN
+	vector_t asVector() const {
+		vector_t result(length);
+		for (int i = 0; i < length; ++i) {
 			result[i] = data[i];
 		}
 		return result;
 	}
+#endif
+
+	void setToZero() {
+#pragma omp parallel for
+		for (int i = 0; i < length; ++i) data[i] = 0.;
+	}
+
+	//this = this + alpha*x
+	void axpy(const T& alpha, const MultiGridVector& x) {
+#pragma omp parallel for
+		for (int i = 0; i < length; ++i) data[i] += alpha*x.data[i];
+	}
+
+	//this = x + alpha*this
+	void xpay(const MultiGridVector& x, const T& alpha) {
+#pragma omp parallel for
+		for (int i = 0; i < length; ++i) data[i] = x.data[i] + alpha*data[i];
+	}
+
+	//Returns x.y summed over all the processors
+	static std::complex<long_real_t> dot(const MultiGridVector& x, const MultiGridVector& y) {
+		long_real_t result_re = 0., result_im = 0.;
+#pragma omp parallel for reduction(+:result_re, result_im)
+		for (int i = 0; i < x.length; ++i) {
+			T partial = conj(x.data[i])*y.data[i];
+			result_re += real(partial);
+			result_im += imag(partial);
+		}
+		long_real_t result[2] = {result_re, result_im};
+		reduceAllSum(result, 2);
+		return std::complex<long_real_t>(result[0], result[1]);
+	}
+
+	static long_real_t squaredNorm(const MultiGridVector& x) {
+		long_real_t result = 0.;
+#pragma omp parallel for reduction(+:result)
+		for (int i = 0; i < x.length; ++i) {
+			result += real(conj(x.data[i])*x.data[i]);
+		}
+		reduceAllSum(result);
+		return result;
+	}
+
+	/**
+	 * This function computes x.y and x.z with a single pass over the vectors and a single reduction over the processors
+	 * @param xy the result x.y
+	 * @param xz the result x.z
+	 */
+	static void dots(std::complex<long_real_t>& xy, std::complex<long_real_t>& xz, const MultiGridVector& x, const MultiGridVector& y, const MultiGridVector& z) {
+		long_real_t xy_re = 0., xy_im = 0., xz_re = 0., xz_im = 0.;
+#pragma omp parallel for reduction(+:xy_re, xy_im, xz_re, xz_im)
+		for (int i = 0; i < x.length; ++i) {
+			T partial1 = conj(x.data[i])*y.data[i];
+			xy_re += real(partial1);
+			xy_im += imag(partial1);
+			T partial2 = conj(x.data[i])*z.data[i];
+			xz_re += real(partial2);
+			xz_im += imag(partial2);
+		}
+		long_real_t result[4] = {xy_re, xy_im, xz_re, xz_im};
+		reduceAllSum(result, 4);
+		xy = std::complex<long_real_t>(result[0], result[1]);
+		xz = std::complex<long_real_t>(result[2], result[3]);
+	}
 
 private:
+	void allocate(int _length) {
+		free(data);
+		data = 0;
+		length = _length;
+		if (length > 0) {
+			void* buffer = 0;
+			if (posix_memalign(&buffer, 64, length*sizeof(T)) != 0) {
+				length = 0;
+				throw std::bad_alloc();
+			}
+			data = static_cast<T*>(buffer);
+		}
+	}
+
 	T* data;
+	int length;
 };
 
 typedef MultiGridVector< std::complex<real_t> , MultiGridVectorLayout > multigrid_vector_t;
@@ -60,4 +177,3 @@ typedef MultiGridVector< std::complex<real_t> , MultiGridVectorLayout > multigri
 }
 
 #endif
-
@@ -12,8 +12,11 @@ unsigned int MultiGridVectorLayout::instances = 0;
 int MultiGridVectorLayout::totalNumberOfBlocks;
 int MultiGridVectorLayout::basisDimension = 40;
 int MultiGridVectorLayout::size;
+
+std::vector<int> MultiGridVectorLayout::blockOffsets;
+std::vector<int> MultiGridVectorLayout::blockSites;
 	
-reduced_index_lattice_t* MultiGridVectorLayout::blockIndex;
+reduced_index_lattice_t* MultiGridVectorLayout::blockIndex = 0;
 
 void MultiGridVectorLayout::initialize() {
 	if (instances != 0 && isOutputProcess()) std::cout << "MultiGridVectorLayout::Warning, there are " << instances << " MultiGridVector classes created, they will not work properly!" << std::endl; 
@@ -32,6 +35,7 @@ void MultiGridVectorLayout::initialize() {
 	totalNumberOfBlocks = numberBX*numberBY*numberBZ*numberBT;
 	size = totalNumberOfBlocks*basisDimension;
 
+	delete blockIndex;
 	blockIndex = new reduced_index_lattice_t;
 	
 	for (int site = 0; site < blockIndex->localsize; ++site) {
@@ -43,6 +47,14 @@ void MultiGridVectorLayout::initialize() {
 		(*blockIndex)[site] = numberBT*(numberBZ*(numberBY*x + y) + z) + t;
 	}
 	blockIndex->updateHalo();
+
+	//The sites are sorted by block, so that the projections on the blocks can be parallelized over the blocks
+	blockOffsets.assign(totalNumberOfBlocks + 1, 0);
+	for (int site = 0; site < blockIndex->localsize; ++site) ++blockOffsets[(*blockIndex)[site] + 1];
+	for (int block = 0; block < totalNumberOfBlocks; ++block) blockOffsets[block + 1] += blockOffsets[block];
+	blockSites.resize(blockIndex->localsize);
+	std::vector<int> position(blockOffsets.begin(), blockOffsets.end() - 1);
+	for (int site = 0; site < blockIndex->localsize; ++site) blockSites[position[(*blockIndex)[site]]++] = site;
 }
 
 void MultiGridVectorLayout::setBasisDimension(int _basisDimension) {
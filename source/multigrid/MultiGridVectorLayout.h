@@ -1,6 +1,7 @@
 #ifndef MULTIGRIDVECTORLAYOUT_H
 #define MULTIGRIDVECTORLAYOUT_H
 #include "Environment.h"
+#include <vector>
 
 namespace Update {
 
@@ -22,6 +23,10 @@ public:
 		return (*blockIndex)[site];
 	}
 
+	//The local sites of the block b are blockSites[blockOffsets[b]], ..., blockSites[blockOffsets[b + 1] - 1]
+	static std::vector<int> blockOffsets;
+	static std::vector<int> blockSites;
+
 	static unsigned int instances;
 private:
 	
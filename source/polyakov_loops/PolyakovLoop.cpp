@@ -151,7 +151,7 @@ void PolyakovLoop::write_polyakov_loop_config(const extended_gauge_lattice_t& po
 			for (int x = 0; x < Layout::glob_x; ) {
 				while (x < Layout::glob_x && rank == Layout::rankTable(x,y,z,0)) {
 					int globsite = Layout::getGlobalCoordinate(x,y,z,0);
-					int localsite = Layout::localIndex[globsite];
+					int localsite = Layout::getLocalIndex(globsite);
 							
 					if (localsite != -1 && localsite < Layout::localsize) {
 						GaugeGroup tmp = polyakov[localsite][3];
@@ -1,6 +1,7 @@
 #include "PolyakovLoopCorrelator.h"
 #include "io/GlobalOutput.h"
 #include "utils/StoutSmearing.h"
+#include "MPILattice/LatticeFourierTransform.h"
 
 namespace Update {
 
@@ -10,9 +11,6 @@ PolyakovLoopCorrelator::~PolyakovLoopCorrelator() { }
 
 void PolyakovLoopCorrelator::execute(environment_t& environment) {
 	typedef extended_gauge_lattice_t::Layout Layout;
-	typedef extended_gauge_lattice_t LT;
-	long_real_t polyakovLoopCorrelatorRe = 0;
-	long_real_t polyakovLoopCorrelatorIm = 0;
 
 	extended_gauge_lattice_t tmp = environment.gaugeLinkConfiguration;
 	extended_gauge_lattice_t swap;
@@ -31,7 +29,66 @@ void PolyakovLoopCorrelator::execute(environment_t& environment) {
 	}
 	
 	extended_gauge_lattice_t polyakov;
-	extended_gauge_lattice_t polyakov_translated;
+	this->computePolyakovLoops(tmp, polyakov);
+
+	if (environment.configurations.get<std::string>("PolyakovCorrelator::all_distances") == "true") {
+		std::vector<long_real_t> correlator = this->allDistancesCorrelator(polyakov);
+
+		if (environment.measurement && isOutputProcess()) {
+			GlobalOutput* output = GlobalOutput::getInstance();
+			output->push("polyakov_correlator_distances");
+
+			const int maxY = Layout::glob_y/2 + 1, maxZ = Layout::glob_z/2 + 1;
+			for (int dx = 0; dx <= Layout::glob_x/2; ++dx) {
+				for (int dy = 0; dy < maxY; ++dy) {
+					for (int dz = 0; dz < maxZ; ++dz) {
+						int index = (dx*maxY + dy)*maxZ + dz;
+
+						std::cout << "PolyakovLoopCorrelator::Correlator at (" << dx << "," << dy << "," << dz << ") " << correlator[2*index] << " +I*" << correlator[2*index + 1] << std::endl;
+
+						output->push("polyakov_correlator_distances");
+						output->write("polyakov_correlator_distances", dx);
+						output->write("polyakov_correlator_distances", dy);
+						output->write("polyakov_correlator_distances", dz);
+						output->write("polyakov_correlator_distances", correlator[2*index]);
+						output->write("polyakov_correlator_distances", correlator[2*index + 1]);
+						output->pop("polyakov_correlator_distances");
+					}
+				}
+			}
+
+			output->pop("polyakov_correlator_distances");
+		}
+		return;
+	}
+
+	std::vector<long_real_t> correlator = this->translationCorrelator(polyakov);
+
+	if (environment.measurement && isOutputProcess()) {
+		GlobalOutput* output = GlobalOutput::getInstance();
+		output->push("polyakov_correlator");
+
+		for (int l = 0; l < Layout::glob_x/2; ++l) {
+			output->push("polyakov_correlator");
+
+			std::cout << "PolyakovLoopCorrelator::Correlator at " << l << " " << correlator[2*l] << " +I*" << correlator[2*l + 1] << std::endl;
+
+			output->write("polyakov_correlator", correlator[2*l]);
+			output->write("polyakov_correlator", correlator[2*l + 1]);
+			
+			output->pop("polyakov_correlator");
+		}
+
+		output->pop("polyakov_correlator");
+	}
+}
+
+void PolyakovLoopCorrelator::computePolyakovLoops(const extended_gauge_lattice_t& lattice, extended_gauge_lattice_t& polyakov) const {
+	typedef extended_gauge_lattice_t::Layout Layout;
+	typedef extended_gauge_lattice_t LT;
+
+	extended_gauge_lattice_t tmp = lattice;
+	extended_gauge_lattice_t swap;
 
 #pragma omp parallel for
 	for (int site = 0; site < Layout::localsize; ++site) {
@@ -59,17 +116,20 @@ void PolyakovLoopCorrelator::execute(environment_t& environment) {
 		}
 		tmp.updateHalo();
 	}
+}
 
-	if (environment.measurement && isOutputProcess()) {
-		GlobalOutput* output = GlobalOutput::getInstance();
-		output->push("polyakov_correlator");
-	}
-	
-	polyakov_translated = polyakov;
-	
+std::vector<long_real_t> PolyakovLoopCorrelator::translationCorrelator(const extended_gauge_lattice_t& polyakov) const {
+	typedef extended_gauge_lattice_t::Layout Layout;
+	typedef extended_gauge_lattice_t LT;
+
+	extended_gauge_lattice_t polyakov_translated = polyakov;
+	extended_gauge_lattice_t swap;
+	unsigned int spatialVolume = Layout::glob_spatial_volume;
+
+	std::vector<long_real_t> result(2*(Layout::glob_x/2));
 	for (int l = 0; l < Layout::glob_x/2; ++l) {
-		polyakovLoopCorrelatorRe = 0;
-		polyakovLoopCorrelatorIm = 0;
+		long_real_t polyakovLoopCorrelatorRe = 0;
+		long_real_t polyakovLoopCorrelatorIm = 0;
 
 		swap = polyakov_translated;
 #pragma omp parallel for
@@ -92,32 +152,62 @@ void PolyakovLoopCorrelator::execute(environment_t& environment) {
 		reduceAllSum(polyakovLoopCorrelatorRe);
 		reduceAllSum(polyakovLoopCorrelatorIm);
 
-		unsigned int spatialVolume = Layout::glob_spatial_volume;
+		result[2*l] = polyakovLoopCorrelatorRe/(numberColors*spatialVolume);
+		result[2*l + 1] = polyakovLoopCorrelatorIm/(numberColors*spatialVolume);
+	}
+	return result;
+}
 
-		if (environment.measurement && isOutputProcess()) {
-			GlobalOutput* output = GlobalOutput::getInstance();
-			output->push("polyakov_correlator");
+std::vector<long_real_t> PolyakovLoopCorrelator::allDistancesCorrelator(const extended_gauge_lattice_t& polyakov) const {
+	typedef extended_gauge_lattice_t::Layout Layout;
 
-			std::cout << "PolyakovLoopCorrelator::Correlator at " << l << " " << polyakovLoopCorrelatorRe/(numberColors*spatialVolume) << " +I*" << polyakovLoopCorrelatorIm/(numberColors*spatialVolume) << std::endl;
+	//The traced loops on the slice t = 0, the transforms are done only on this slice
+	std::vector< std::complex<double> > field(Layout::localsize, std::complex<double>(0.,0.));
+#pragma omp parallel for
+	for (int site = 0; site < Layout::localsize; ++site) {
+		if (Layout::globalIndexT(site) == 0) field[site] = trace(polyakov[site][3]);
+	}
 
-			output->write("polyakov_correlator", polyakovLoopCorrelatorRe/(numberColors*spatialVolume));
-			output->write("polyakov_correlator", polyakovLoopCorrelatorIm/(numberColors*spatialVolume));
-			
-			output->pop("polyakov_correlator");
+	//C(r) = sum_x conj(P(x)) P(x + r) = 1/V sum_k exp(i k.r) |P(k)|^2, with P(k) = sum_x exp(-i k.x) P(x)
+	Lattice::LatticeFourierTransform<Layout> fourierTransform(1, 3, 0);
+	fourierTransform.transform(field, -1);
+#pragma omp parallel for
+	for (int site = 0; site < Layout::localsize; ++site) {
+		field[site] = std::norm(field[site]);
+	}
+	fourierTransform.transform(field, 1);
+
+	//The separations are collected by (|dx|,|dy|,|dz|), with the minimal distances on the periodic lattice
+	const int maxX = Layout::glob_x/2 + 1, maxY = Layout::glob_y/2 + 1, maxZ = Layout::glob_z/2 + 1;
+	std::vector<long_real_t> correlator(3*maxX*maxY*maxZ, 0.);
+	for (int site = 0; site < Layout::localsize; ++site) {
+		if (Layout::globalIndexT(site) == 0) {
+			int dx = std::min(Layout::globalIndexX(site), Layout::glob_x - Layout::globalIndexX(site));
+			int dy = std::min(Layout::globalIndexY(site), Layout::glob_y - Layout::globalIndexY(site));
+			int dz = std::min(Layout::globalIndexZ(site), Layout::glob_z - Layout::globalIndexZ(site));
+			int index = (dx*maxY + dy)*maxZ + dz;
+			correlator[3*index] += real(field[site]);
+			correlator[3*index + 1] += imag(field[site]);
+			correlator[3*index + 2] += 1.;
 		}
-	
 	}
-	
-	if (environment.measurement && isOutputProcess()) {
-		GlobalOutput* output = GlobalOutput::getInstance();
-		output->pop("polyakov_correlator");
+	reduceAllSum(&correlator[0], correlator.size());
+
+	//The transforms are not normalized, field is V sum_x conj(P(x)) P(x + r)
+	long_real_t norm = static_cast<long_real_t>(numberColors)*Layout::glob_spatial_volume*Layout::glob_spatial_volume;
+	std::vector<long_real_t> result(2*maxX*maxY*maxZ);
+	for (int index = 0; index < maxX*maxY*maxZ; ++index) {
+		result[2*index] = correlator[3*index]/(correlator[3*index + 2]*norm);
+		result[2*index + 1] = correlator[3*index + 1]/(correlator[3*index + 2]*norm);
 	}
+	return result;
 }
 
 void PolyakovLoopCorrelator::registerParameters(po::options_description& desc) {
 	desc.add_options()
 		("PolyakovCorrelator::level_stout_smearing", po::value<unsigned int>()->default_value(10), "Number of levels of the stout smearing")
-		("PolyakovCorrelator::rho_stout_smearing", po::value<double>()->default_value(0.05), "Rho stout smearing");
+		("PolyakovCorrelator::rho_stout_smearing", po::value<double>()->default_value(0.05), "Rho stout smearing")
+		("PolyakovCorrelator::all_distances", po::value<std::string>()->default_value("false"), "Compute the correlator for all the spatial separations with Fourier transforms? (true/false)");
 }
 
 } /* namespace Update */
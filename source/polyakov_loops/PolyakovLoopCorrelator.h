@@ -2,6 +2,7 @@
 #define POLYAKOVLOOPCORRELATOR_H_
 
 #include "LatticeSweep.h"
+#include <vector>
 
 namespace Update {
 
@@ -13,6 +14,19 @@ public:
 	virtual void execute(environment_t& environment);
 
 	static void registerParameters(po::options_description&);
+
+	//The Polyakov loops polyakov[x][3] on the sites of the slice t = 0
+	void computePolyakovLoops(const extended_gauge_lattice_t& lattice, extended_gauge_lattice_t& polyakov) const;
+
+	//The correlator at the distances l + 1 in the x direction, real and imaginary parts in result[2*l] and result[2*l + 1]
+	std::vector<long_real_t> translationCorrelator(const extended_gauge_lattice_t& polyakov) const;
+
+	/**
+	 * The correlator for all the spatial separations, from the Fourier transform of the traced loops on the slice t = 0
+	 * @return the average over the separations (|dx|,|dy|,|dz|), real and imaginary parts in result[2*index] and result[2*index + 1],
+	 * with index = (|dx|*(glob_y/2 + 1) + |dy|)*(glob_z/2 + 1) + |dz|
+	 */
+	std::vector<long_real_t> allDistancesCorrelator(const extended_gauge_lattice_t& polyakov) const;
 };
 
 } /* namespace Update */
@@ -64,65 +64,33 @@ PureGaugeOverrelaxation::~PureGaugeOverrelaxation() {
 #endif
 
 void PureGaugeOverrelaxation::execute(environment_t& environment) {
-	typedef extended_gauge_lattice_t::Layout Layout;
 	//Get the gauge action
 	GaugeAction* gaugeAction = GaugeAction::getInstance(environment.configurations.get<std::string>("name_action"),environment.configurations.get<real_t>("beta"));
 
 #ifdef MULTITHREADING
 	Checkerboard* checkerboard = Checkerboard::getInstance();
-#endif
-
-#ifndef ENABLE_MPI
-#ifdef MULTITHREADING
+	std::vector<Site>* siteColorList = checkerboard->getSiteColorList();
+	//The links of a color do not enter in the staples of each other, also across the processors:
+	//all the processors update the same color at the same time and exchange the halos before the next one
 	for (int color = 0; color < checkerboard->getNumberLoops(); ++color) {
-#endif
-#pragma omp parallel for //shared(environment, color) firstprivate(gaugeAction, checkerboard) default(none) schedule(dynamic)
-		for (int site = 0; site < environment.gaugeLinkConfiguration.localsize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-#ifdef MULTITHREADING
-				if (checkerboard->getColor(site,mu) == color) {
-#endif
-					this->updateLink(environment.gaugeLinkConfiguration,site,mu,gaugeAction);
-#ifdef MULTITHREADING
-				}
-#endif
-			}
+		const std::vector<Site>& sites = siteColorList[color];
+		const int numberSites = sites.size();
+#pragma omp parallel for
+		for (int i = 0; i < numberSites; ++i) {
+			this->updateLink(environment.gaugeLinkConfiguration, sites[i].site, sites[i].mu, gaugeAction);
 		}
 		environment.gaugeLinkConfiguration.updateHalo();
-#ifdef MULTITHREADING
 	}
 #endif
-#endif
-
-	//We suppose that always MPI+MTH
-#ifdef ENABLE_MPI
-	for (int processor = 0; processor < Layout::numberProcessors; ++processor) {
-		for (int color = 0; color < checkerboard->getNumberLoops(); ++color) {
-			if (processor == Layout::this_processor) {
-#pragma omp parallel for //shared(beta, color, environment) firstprivate(action, checkerboard) default(none) schedule(dynamic)
-				for (int site = 0; site < environment.gaugeLinkConfiguration.localsize; ++site) {
-					for (unsigned int mu = 0; mu < 4; ++mu) {
-						if (checkerboard->getColor(site,mu) == color) {
-							this->updateLink(environment.gaugeLinkConfiguration, site, mu, gaugeAction);
-						}
-					}
-				}
-			}
-			else {
-#pragma omp parallel for //shared(beta, color, environment) firstprivate(action, checkerboard) default(none) schedule(dynamic)
-				for (int site = environment.gaugeLinkConfiguration.sharedsize; site < environment.gaugeLinkConfiguration.localsize; ++site) {
-					for (unsigned int mu = 0; mu < 4; ++mu) {
-						if (checkerboard->getColor(site,mu) == color) {
-							this->updateLink(environment.gaugeLinkConfiguration, site, mu, gaugeAction);
-						}
-					}
-				}
-			}
+#ifndef MULTITHREADING
+	for (int site = 0; site < environment.gaugeLinkConfiguration.localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			this->updateLink(environment.gaugeLinkConfiguration, site, mu, gaugeAction);
 		}
-		environment.gaugeLinkConfiguration.updateHalo();
 	}
+	environment.gaugeLinkConfiguration.updateHalo();
 #endif
-	
+
 	environment.synchronize();
 	delete gaugeAction;
 
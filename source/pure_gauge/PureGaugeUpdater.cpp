@@ -1,172 +1,80 @@
 #include "PureGaugeUpdater.h"
 #include "MatrixTypedef.h"
 #include "Checkerboard.h"
-#include "utils/RandomSeed.h"
 
 namespace Update {
 
-#ifdef MULTITHREADING
-PureGaugeUpdater::PureGaugeUpdater() {
-	randomGenerator = new random_generator_t*[omp_get_max_threads()];
-	randomUniform = new random_uniform_generator_t*[omp_get_max_threads()];
-	for (int i = 0; i < omp_get_max_threads(); ++i) {
-		randomGenerator[i] = new random_generator_t(RandomSeed::randomSeed());
-		randomUniform[i] = new random_uniform_generator_t(RandomSeed::getRandomNumberGenerator(*randomGenerator[i]));
-	}
-}
-#endif
-#ifndef MULTITHREADING
-PureGaugeUpdater::PureGaugeUpdater() : randomGenerator(RandomSeed::randomSeed()), randomUniform(RandomSeed::getRandomNumberGenerator(randomGenerator)) { }
-#endif
+PureGaugeUpdater::PureGaugeUpdater() : stream(0) { }
 
-#ifdef MULTITHREADING
-PureGaugeUpdater::PureGaugeUpdater(const PureGaugeUpdater& copy) : LatticeSweep(copy) {
-	randomGenerator = new random_generator_t*[omp_get_max_threads()];
-	randomUniform = new random_uniform_generator_t*[omp_get_max_threads()];
-	for (int i = 0; i < omp_get_max_threads(); ++i) {
-		randomGenerator[i] = new random_generator_t(RandomSeed::randomSeed());
-		randomUniform[i] = new random_uniform_generator_t(RandomSeed::getRandomNumberGenerator(*randomGenerator[i]));
-	}
-}
-#endif
-#ifndef MULTITHREADING
-PureGaugeUpdater::PureGaugeUpdater(const PureGaugeUpdater& copy) : randomGenerator(RandomSeed::randomSeed()), randomUniform(RandomSeed::getRandomNumberGenerator(randomGenerator)) { }
-#endif
+PureGaugeUpdater::PureGaugeUpdater(const PureGaugeUpdater& copy) : LatticeSweep(copy), stream(0) { }
 
-#ifdef MULTITHREADING
-PureGaugeUpdater::~PureGaugeUpdater() {
-	for (int i = 0; i < omp_get_max_threads(); ++i) {
-		delete randomGenerator[i];
-		delete randomUniform[i];
-	}
-	delete[] randomGenerator;
-	delete[] randomUniform;
-}
-#endif
-#ifndef MULTITHREADING
 PureGaugeUpdater::~PureGaugeUpdater() { }
-#endif
+
+void PureGaugeUpdater::startSweep() {
+	stream = CounterRandomGenerator::nextStream();
+}
 
 void PureGaugeUpdater::execute(environment_t & environment) {
-	typedef extended_gauge_lattice_t::Layout Layout;
 	real_t beta = environment.configurations.get<real_t>("beta");
 
 	//Get the gauge action
 	GaugeAction* action = GaugeAction::getInstance(environment.configurations.get<std::string>("name_action"),environment.configurations.get<real_t>("beta"));
 
+	this->startSweep();
 	
 #ifdef MULTITHREADING
 	Checkerboard* checkerboard = Checkerboard::getInstance();
-#endif
-
-#ifndef ENABLE_MPI
-#ifdef MULTITHREADING
+	std::vector<Site>* siteColorList = checkerboard->getSiteColorList();
+	//The links of a color do not enter in the staples of each other, also across the processors:
+	//all the processors update the same color at the same time and exchange the halos before the next one
 	for (int color = 0; color < checkerboard->getNumberLoops(); ++color) {
-#endif
+		const std::vector<Site>& sites = siteColorList[color];
+		const int numberSites = sites.size();
 #pragma omp parallel for
-		for (int site = 0; site < environment.gaugeLinkConfiguration.localsize; ++site) {
-			for (unsigned int mu = 0; mu < 4; ++mu) {
-#ifdef MULTITHREADING
-				if (checkerboard->getColor(site,mu) == color) {
-#endif
-					this->updateLink(environment.gaugeLinkConfiguration, site, mu, action, beta);
-#ifdef MULTITHREADING
-				}
-#endif
-			}
+		for (int i = 0; i < numberSites; ++i) {
+			this->updateLink(environment.gaugeLinkConfiguration, sites[i].site, sites[i].mu, action, beta);
 		}
 		environment.gaugeLinkConfiguration.updateHalo();
-#ifdef MULTITHREADING
 	}
 #endif
-#endif
-
-	//We suppose that always MPI+MTH
-#ifdef ENABLE_MPI
-	for (int processor = 0; processor < Layout::numberProcessors; ++processor) {
-		for (int color = 0; color < checkerboard->getNumberLoops(); ++color) {
-			if (processor == Layout::this_processor) {
-#pragma omp parallel for
-				for (int site = 0; site < environment.gaugeLinkConfiguration.localsize; ++site) {
-					for (unsigned int mu = 0; mu < 4; ++mu) {
-						if (checkerboard->getColor(site,mu) == color) {
-							this->updateLink(environment.gaugeLinkConfiguration, site, mu, action, beta);
-						}
-					}
-				}
-			}
-			else {
-#pragma omp parallel for 
-				for (int site = environment.gaugeLinkConfiguration.sharedsize; site < environment.gaugeLinkConfiguration.localsize; ++site) {
-					for (unsigned int mu = 0; mu < 4; ++mu) {
-						if (checkerboard->getColor(site,mu) == color) {
-							this->updateLink(environment.gaugeLinkConfiguration, site, mu, action, beta);
-						}
-					}
-				}
-			}
+#ifndef MULTITHREADING
+	for (int site = 0; site < environment.gaugeLinkConfiguration.localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			this->updateLink(environment.gaugeLinkConfiguration, site, mu, action, beta);
 		}
-		environment.gaugeLinkConfiguration.updateHalo();
 	}
+	environment.gaugeLinkConfiguration.updateHalo();
 #endif
 
 	environment.synchronize();
 	delete action;
 }
 
-#ifdef MULTITHREADING
-real_t PureGaugeUpdater::generate_radius(real_t b) {
-	real_t x1 = log((*randomUniform[omp_get_thread_num()])()), x2 = log((*randomUniform[omp_get_thread_num()])()), x3 = pow(cos(2.*PI*(*randomUniform[omp_get_thread_num()])()), 2.);
-	real_t s = 1. + b*(x1+x2*x3);
-	real_t r = (*randomUniform[omp_get_thread_num()])();
-	while ((1.+s-2.*r*r) < 0) {
-		x1 = log((*randomUniform[omp_get_thread_num()])());
-		x2 = log((*randomUniform[omp_get_thread_num()])());
-		x3 = pow(cos(2.*PI*(*randomUniform[omp_get_thread_num()])()), 2.);
-		s = 1. + b*(x1+x2*x3);
-		r = (*randomUniform[omp_get_thread_num()])();
-	}
-	return s;
-}
-#endif
-#ifndef MULTITHREADING
-real_t PureGaugeUpdater::generate_radius(real_t b) {
-	real_t x1 = log(randomUniform()), x2 = log(randomUniform()), x3 = pow(cos(2.*PI*randomUniform()), 2.);
+real_t PureGaugeUpdater::generate_radius(real_t b, CounterRandomGenerator& generator) {
+	real_t x1 = log(generator.uniform()), x2 = log(generator.uniform()), x3 = pow(cos(2.*PI*generator.uniform()), 2.);
 	real_t s = 1. + b*(x1+x2*x3);
-	real_t r = randomUniform();
+	real_t r = generator.uniform();
 	while ((1.+s-2.*r*r) < 0) {
-		x1 = log(randomUniform());
-		x2 = log(randomUniform());
-		x3 = pow(cos(2.*PI*randomUniform()), 2.);
+		x1 = log(generator.uniform());
+		x2 = log(generator.uniform());
+		x3 = pow(cos(2.*PI*generator.uniform()), 2.);
 		s = 1. + b*(x1+x2*x3);
-		r = randomUniform();
+		r = generator.uniform();
 	}
 	return s;
 }
-#endif
 
-#ifdef MULTITHREADING
-void PureGaugeUpdater::generate_vector(real_t radius, real_t& u1, real_t& u2, real_t& u3) {
-	real_t phi = 2.*PI*(*randomUniform[omp_get_thread_num()])();
-	real_t theta = acos(2.*(*randomUniform[omp_get_thread_num()])()-1.);
-	u1 = radius*sin(theta)*cos(phi);
-	u2 = radius*sin(theta)*sin(phi);
-	u3 = radius*cos(theta);
-}
-#endif
-#ifndef MULTITHREADING
-void PureGaugeUpdater::generate_vector(real_t radius, real_t& u1, real_t& u2, real_t& u3) {
-	real_t phi = 2.*PI*randomUniform();
-	real_t theta = acos(2.*randomUniform()-1.);
+void PureGaugeUpdater::generate_vector(real_t radius, real_t& u1, real_t& u2, real_t& u3, CounterRandomGenerator& generator) {
+	real_t phi = 2.*PI*generator.uniform();
+	real_t theta = acos(2.*generator.uniform()-1.);
 	u1 = radius*sin(theta)*cos(phi);
 	u2 = radius*sin(theta)*sin(phi);
 	u3 = radius*cos(theta);
 }
-#endif
-
 
 void PureGaugeUpdater::updateLink(extended_gauge_lattice_t& lattice, int site, int mu, GaugeAction* action, double beta) {
 	GaugeGroup staple = action->staple(lattice, site, mu);
+	CounterRandomGenerator generator(stream, 4*CounterRandomGenerator::globalIndex<extended_gauge_lattice_t::Layout>(site) + mu);
 #if NUMCOLORS > 2
 	//take the plaquette
 	GaugeGroup plaquette = lattice[site][mu]*(staple);
@@ -181,8 +89,8 @@ void PureGaugeUpdater::updateLink(extended_gauge_lattice_t& lattice, int site, i
 			real_t b = numberColors/(2.*beta*sqrt(detStaple));
 			//Use the standard Kennedy-Pendleton algorithm for su2
 			real_t u0, u1, u2, u3;
-			u0 = generate_radius(b);
-			generate_vector(sqrt(1.-u0*u0), u1, u2, u3);
+			u0 = generate_radius(b, generator);
+			generate_vector(sqrt(1.-u0*u0), u1, u2, u3, generator);
 			//Calculate the su2 update matrix
 			matrix2x2_t subupdate;
 			subupdate.at(0,0) = std::complex<real_t>(u0, u3);
@@ -215,8 +123,8 @@ void PureGaugeUpdater::updateLink(extended_gauge_lattice_t& lattice, int site, i
 	real_t detStaple = abs(det(staple));
 	real_t b = 1./(beta*sqrt(detStaple));
 	real_t u0, u1, u2, u3;
-	u0 = generate_radius(b);
-	generate_vector(sqrt(1.-u0*u0), u1, u2, u3);
+	u0 = generate_radius(b, generator);
+	generate_vector(sqrt(1.-u0*u0), u1, u2, u3, generator);
 	//update the matrix
 	lattice[site][mu].at(0,0) = std::complex<real_t>(u0, u3);
 	lattice[site][mu].at(0,1) = std::complex<real_t>(u2, u1);
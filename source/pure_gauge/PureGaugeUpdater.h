@@ -2,7 +2,7 @@
 #define PUREGAUGEUPDATER_H_
 
 #include "LatticeSweep.h"
-#include "utils/RandomSeed.h"
+#include "utils/CounterRandomGenerator.h"
 #include "actions/GaugeAction.h"
 
 namespace Update {
@@ -19,28 +19,25 @@ public:
 	void execute(environment_t& environment);
 
 public:
+	/**
+	 * This function takes a new stream of random numbers for the next sweep, every link draws its own numbers from the stream
+	 * so that the sweep does not depend on the number of threads. It must be called by all the processors before every sweep.
+	 */
+	void startSweep();
+
 	void updateLink(extended_gauge_lattice_t& lattice, int site, int mu, GaugeAction* action, double beta);
 
 private:
-#ifdef MULTITHREADING
-	//The generator of random numbers
-	random_generator_t** randomGenerator;
-	//The generator of random numbers, uniform distribution [0,1]
-	random_uniform_generator_t** randomUniform;
-#endif
-#ifndef MULTITHREADING
-	//The generator of random numbers
-	random_generator_t randomGenerator;
-	//The generator of random numbers, uniform distribution [0,1]
-	random_uniform_generator_t randomUniform;
-#endif
+	//The stream of the random numbers of the current sweep
+	boost::uint32_t stream;
 
 	/**
 	 * This function generates the radius of the SU(2) heatbath matrix using the Kennedy-Pendleton algorithm
 	 * \param b the inverse of beta (Read)
+	 * \param generator the random numbers of the link (Read/Write)
 	 * \return the radius r
 	 */
-	real_t generate_radius(real_t b);
+	real_t generate_radius(real_t b, CounterRandomGenerator& generator);
 
 	/**
 	 * This function generates a random vector uniformly distributed on a sphere of radius radius.
@@ -48,8 +45,9 @@ private:
 	 * \param u1 the first component of the vector (Write)
 	 * \param u2 the second component of the vector (Write)
 	 * \param u3 the third component of the vector (Write)
+	 * \param generator the random numbers of the link (Read/Write)
 	 */
-	void generate_vector(real_t radius, real_t& u1, real_t& u2, real_t& u3);
+	void generate_vector(real_t radius, real_t& u1, real_t& u2, real_t& u3, CounterRandomGenerator& generator);
 };
 
 } /* namespace Update */
@@ -24,13 +24,13 @@ class TwoLinkOperator {
 			}
 		}
 
+		//twoLink[a][b][c][d] += U1(a,b) U2(c,d)^*, so that the product of the operators is the one of the two lines
 		void add(const GaugeGroup& U1, const GaugeGroup& U2) {
-			GaugeGroup hU2 = htrans(U2);
 			for (int a = 0; a < numberColors; ++a) {
 				for (int b = 0; b < numberColors; ++b) {
 					for (int c = 0; c < numberColors; ++c) {
 						for (int d = 0; d < numberColors; ++d) {
-							twoLink[a][b][c][d] += U1.at(a,b)*hU2.at(c,d);
+							twoLink[a][b][c][d] += U1.at(a,b)*conj(U2.at(c,d));
 						}
 					}
 				}
@@ -79,13 +79,31 @@ class TwoLinkOperator {
 		std::complex<real_t> twoLink[numberColors][numberColors][numberColors][numberColors];
 };
 
-PureGaugeWilsonLoops::PureGaugeWilsonLoops() : LatticeSweep(), wilsonLoops(0), results(0), pureGaugeUpdater(new PureGaugeUpdater()), pureGaugeOverrelaxation(new PureGaugeOverrelaxation()) { }
+//Multiply the line by one path from position, which is moved to the end of the path, the steps are in the directions x, z, t
+static void multiplyPath(GaugeGroup& line, int position[4], const std::vector<int>& path, const extended_gauge_lattice_t& lattice) {
+	typedef extended_gauge_lattice_t::Layout LT;
+	const int directions[3] = {0, 2, 3};
+	for (int i = 0; i < 3; ++i) {
+		const int mu = directions[i];
+		for (int step = 0; step < abs(path[i]); ++step) {
+			if (path[i] > 0) {
+				line = line*lattice[LT::getGlobalCoordinate((position[0] % LT::glob_x + LT::glob_x) % LT::glob_x, position[1], (position[2] % LT::glob_z + LT::glob_z) % LT::glob_z, (position[3] % LT::glob_t + LT::glob_t) % LT::glob_t)][mu];
+				++position[mu];
+			}
+			else {
+				--position[mu];
+				line = line*htrans(lattice[LT::getGlobalCoordinate((position[0] % LT::glob_x + LT::glob_x) % LT::glob_x, position[1], (position[2] % LT::glob_z + LT::glob_z) % LT::glob_z, (position[3] % LT::glob_t + LT::glob_t) % LT::glob_t)][mu]);
+			}
+		}
+	}
+}
 
-PureGaugeWilsonLoops::PureGaugeWilsonLoops(const PureGaugeWilsonLoops& toCopy) : LatticeSweep(toCopy), wilsonLoops(0), results(0), pureGaugeUpdater(new PureGaugeUpdater()), pureGaugeOverrelaxation(new PureGaugeOverrelaxation()) { }
+PureGaugeWilsonLoops::PureGaugeWilsonLoops() : LatticeSweep(), wilsonLoopEngine(0), pureGaugeUpdater(new PureGaugeUpdater()), pureGaugeOverrelaxation(new PureGaugeOverrelaxation()) { }
+
+PureGaugeWilsonLoops::PureGaugeWilsonLoops(const PureGaugeWilsonLoops& toCopy) : LatticeSweep(toCopy), wilsonLoopEngine(0), pureGaugeUpdater(new PureGaugeUpdater()), pureGaugeOverrelaxation(new PureGaugeOverrelaxation()) { }
 
 PureGaugeWilsonLoops::~PureGaugeWilsonLoops() {
-	if (results) delete[] results;
-	if (wilsonLoops) delete[] wilsonLoops;
+	if (wilsonLoopEngine) delete wilsonLoopEngine;
 	delete pureGaugeUpdater;
 	delete pureGaugeOverrelaxation;
 }
@@ -93,63 +111,49 @@ PureGaugeWilsonLoops::~PureGaugeWilsonLoops() {
 void PureGaugeWilsonLoops::execute(environment_t& environment) {
 	typedef extended_gauge_lattice_t::Layout LT;
 
-#ifndef ENABLE_MPI
-
 	int RMax = environment.configurations.get<unsigned int>("PureGaugeWilsonLoops::max_r");
 	int RMin = 2;
 	int TMax = environment.configurations.get<unsigned int>("PureGaugeWilsonLoops::max_t");
 	int TMin = 2;
 
-	//Collect together all the wilson loop that should be measured
-	if (wilsonLoops == 0) {
-		wilsonLoops = new std::vector<SpatialWilsonLoop>[(RMax-RMin+1)*(TMax-TMin+1)];
-		results = new real_t[(RMax-RMin+1)*(TMax-TMin+1)];
-		int index = 0;
-		for (int R = RMin; R <= RMax; ++R) {
-			for (int T = TMin; T <= TMax; ++T) {
-				for (int x = 0; x < LT::glob_x; x += 2) {
-					for (int y = 0; y < LT::glob_y; y += 2) {
-						for (int z = 0; z < LT::glob_z; z += 2) {
-							for (int t = 0; t < LT::glob_t; t += 2) {
-								wilsonLoops[index].push_back(SpatialWilsonLoop(x,y,z,t,R,T));
-							}
-						}
-					}
-				}
-				++index;
-			}
-		}
+	std::vector< std::vector<int> > paths = WilsonLoopEngine::readPaths(environment.configurations.get< std::vector<int> >("PureGaugeWilsonLoops::paths"));
+
+	//The loops in the planes of the y direction, the paths are in the directions x, z, t
+	if (wilsonLoopEngine == 0) wilsonLoopEngine = new WilsonLoopEngine(1);
+	reduced_gauge_lattice_t lattice = environment.gaugeLinkConfiguration;
+
+	if (environment.measurement && isOutputProcess()) {
+		GlobalOutput* output = GlobalOutput::getInstance();
+		output->push("wilson_loops");
 	}
 
-	//measure them
-	for (int index = 0; index < (RMax-RMin+1)*(TMax-TMin+1); ++index) {
-		int numberLoops = wilsonLoops[index].size();
+	for (unsigned int i = 0; i < paths.size(); ++i) {
+		std::vector<long_real_t> results = wilsonLoopEngine->measure(lattice, paths[i], RMax, TMax);
+		real_t pathLength = sqrt(static_cast<real_t>(paths[i][0]*paths[i][0] + paths[i][1]*paths[i][1] + paths[i][2]*paths[i][2]));
 
-		long_real_t result = 0.;
+		if (environment.measurement && isOutputProcess()) {
+			GlobalOutput* output = GlobalOutput::getInstance();
 
-#pragma omp parallel for reduction(+:result)
-		for (int loop = 0; loop < numberLoops; ++loop) {
-			result += real(trace(wilsonLoops[index][loop].measure(environment.gaugeLinkConfiguration)));
+			for (int R = RMin; R <= RMax; ++R) {
+				for (int T = TMin; T <= TMax; ++T) {
+					std::cout << "Spatial Wilson loop (" << R*pathLength << "," << T << ") along {" << paths[i][0] << "," << paths[i][1] << "," << paths[i][2] << "}: " << results[(R - 1)*TMax + T - 1] << std::endl;
+					output->push("wilson_loops");
+					output->write("wilson_loops", R*pathLength);
+					output->write("wilson_loops", T);
+					output->write("wilson_loops", results[(R - 1)*TMax + T - 1]);
+					output->pop("wilson_loops");
+				}
+			}
 		}
-
-		results[index] = result/(numberLoops*numberColors);
 	}
 
 	if (environment.measurement && isOutputProcess()) {
 		GlobalOutput* output = GlobalOutput::getInstance();
-
-		output->push("wilson_loops");
-		for (int index = 0; index < (RMax-RMin+1)*(TMax-TMin+1); ++index) {
-			std::cout << "Spatial Wilson loop (" << wilsonLoops[index][0].getR() << "," << wilsonLoops[index][0].getT() << "): " << results[index] << std::endl;
-			output->push("wilson_loops");
-			output->write("wilson_loops", wilsonLoops[index][0].getR());
-			output->write("wilson_loops", wilsonLoops[index][0].getT());
-			output->write("wilson_loops", results[index]);
-			output->pop("wilson_loops");
-		}
 		output->pop("wilson_loops");
 	}
 
+	//The multilevel algorithm works only in multithreading mode
+#ifndef ENABLE_MPI
 	int numberSubSweeps = environment.configurations.get<unsigned int>("PureGaugeWilsonLoops::number_subsweeps_luescher");
 	int sliceSize = environment.configurations.get<unsigned int>("PureGaugeWilsonLoops::size_slice_luescher");
 	if (isOutputProcess() && (LT::glob_y % sliceSize) != 0) std::cout << "PureGaugeWilsonLoops::Warning, the Polyakov loop correlator will not work with these settings, sliceSize is not a multiple of LT::glob_y!" << std::endl;
@@ -157,7 +161,7 @@ void PureGaugeWilsonLoops::execute(environment_t& environment) {
 	//Get the gauge action
 	GaugeAction* action = GaugeAction::getInstance(environment.configurations.get<std::string>("name_action"), environment.configurations.get<double>("beta"));
 
-	boost::multi_array<GaugeGroup,5> wilsonLineT(boost::extents[numberSubSweeps][LT::glob_x][LT::glob_y][LT::glob_t][LT::glob_y/sliceSize]);
+	boost::multi_array<GaugeGroup,5> wilsonLineT(boost::extents[numberSubSweeps][LT::glob_x][LT::glob_z][LT::glob_t][LT::glob_y/sliceSize]);
 
 	for (int numSweep = 0; numSweep < numberSubSweeps; ++numSweep) {
 #pragma omp parallel for
@@ -183,52 +187,116 @@ void PureGaugeWilsonLoops::execute(environment_t& environment) {
 	if (environment.measurement && isOutputProcess()) {
 		GlobalOutput* output = GlobalOutput::getInstance();
 		output->push("polyakov_loop_correlator");
+		output->push("multilevel_wilson_loops");
 	}
+
+	//The Wilson loops of extent T = m sliceSize are closed with the spatial lines on the boundaries of the slices, which are kept fixed by the subsweeps
+	const int numberSlices = LT::glob_y/sliceSize;
+	const int maxSlices = std::min(numberSlices, TMax/sliceSize);
 	
-	for (int R = RMin; R <= RMax; ++R) {
-		long_real_t result = 0.;
-		//Now we close the wilson loop
-#pragma omp parallel for reduction(+:result)
+	for (unsigned int i = 0; i < paths.size(); ++i) {
+		//The spatial lines of R paths from (x,slice*sliceSize,z,t), built incrementally in R
+		boost::multi_array<GaugeGroup,4> spatialLine(boost::extents[LT::glob_x][LT::glob_z][LT::glob_t][numberSlices]);
+#pragma omp parallel for
 		for (int x = 0; x < LT::glob_x; ++x) {
 			for (int z = 0; z < LT::glob_z; ++z) {
 				for (int t = 0; t < LT::glob_t; ++t) {
-					TwoLinkOperator twoLinkOperator[LT::glob_y/sliceSize];
-					for (int slice = 0; slice < LT::glob_y/sliceSize; ++slice) {
-						twoLinkOperator[slice].setToZero();
-						for (int numSweep = 0; numSweep < numberSubSweeps; ++numSweep) {
-							twoLinkOperator[slice].add(wilsonLineT[numSweep][x][z][t][slice],wilsonLineT[numSweep][(x+R)%LT::glob_x][z][t][slice]);
-						}
+					for (int slice = 0; slice < numberSlices; ++slice) {
+						set_to_identity(spatialLine[x][z][t][slice]);
 					}
+				}
+			}
+		}
 
-					for (int slice = 0; slice < LT::glob_y/sliceSize; ++slice) {
-						twoLinkOperator[slice].normalize(numberSubSweeps);
-					}
+		for (int R = 1; R <= RMax; ++R) {
+			//The separation R d in the directions x, z, t
+			int dx = R*paths[i][0], dz = R*paths[i][1], dt = R*paths[i][2];
+			long_real_t result = 0.;
+			std::vector<long_real_t> loops(LT::glob_x*maxSlices, 0.);
+			//Now we close the wilson loop
+#pragma omp parallel for reduction(+:result)
+			for (int x = 0; x < LT::glob_x; ++x) {
+				for (int z = 0; z < LT::glob_z; ++z) {
+					for (int t = 0; t < LT::glob_t; ++t) {
+						for (int slice = 0; slice < numberSlices; ++slice) {
+							int position[4] = {x + dx - paths[i][0], slice*sliceSize, z + dz - paths[i][1], t + dt - paths[i][2]};
+							multiplyPath(spatialLine[x][z][t][slice], position, paths[i], environment.gaugeLinkConfiguration);
+						}
+						if (R < RMin) continue;
+
+						TwoLinkOperator twoLinkOperator[LT::glob_y/sliceSize];
+						for (int slice = 0; slice < LT::glob_y/sliceSize; ++slice) {
+							twoLinkOperator[slice].setToZero();
+							for (int numSweep = 0; numSweep < numberSubSweeps; ++numSweep) {
+								twoLinkOperator[slice].add(wilsonLineT[numSweep][x][z][t][slice],wilsonLineT[numSweep][((x+dx)%LT::glob_x + LT::glob_x)%LT::glob_x][((z+dz)%LT::glob_z + LT::glob_z)%LT::glob_z][((t+dt)%LT::glob_t + LT::glob_t)%LT::glob_t][slice]);
+							}
+						}
+
+						for (int slice = 0; slice < LT::glob_y/sliceSize; ++slice) {
+							twoLinkOperator[slice].normalize(numberSubSweeps);
+						}
 					
-					TwoLinkOperator twoLinkResults = twoLinkOperator[0];
-					for (int slice = 1; slice < LT::glob_y/sliceSize; ++slice) {
-						twoLinkResults = twoLinkResults*twoLinkOperator[slice];
-					}
+						TwoLinkOperator twoLinkResults = twoLinkOperator[0];
+						for (int slice = 1; slice < LT::glob_y/sliceSize; ++slice) {
+							twoLinkResults = twoLinkResults*twoLinkOperator[slice];
+						}
+
+						for (int a = 0; a < numberColors; ++a) {
+							for (int b = 0; b < numberColors; ++b) {
+								result += real(twoLinkResults.at(a,a,b,b));
+							}
+						}
 
-					for (int a = 0; a < numberColors; ++a) {
-						for (int b = 0; b < numberColors; ++b) {
-							result += real(twoLinkResults.at(a,a,b,b));
+						//W = tr L(x) S(x,y + T) L(x + R d)^dagger S(x,y)^dagger, with the averaged time lines of the slices from y
+						for (int first = 0; first < numberSlices; ++first) {
+							TwoLinkOperator product = twoLinkOperator[first];
+							for (int m = 1; m <= maxSlices; ++m) {
+								if (m > 1) product = product*twoLinkOperator[(first + m - 1) % numberSlices];
+								const GaugeGroup& start = spatialLine[x][z][t][first];
+								const GaugeGroup& end = spatialLine[x][z][t][(first + m) % numberSlices];
+								long_real_t loop = 0.;
+								for (int a = 0; a < numberColors; ++a) {
+									for (int b = 0; b < numberColors; ++b) {
+										for (int c = 0; c < numberColors; ++c) {
+											for (int d = 0; d < numberColors; ++d) {
+												loop += real(product.at(a,b,d,c)*end.at(b,c)*conj(start.at(a,d)));
+											}
+										}
+									}
+								}
+								loops[x*maxSlices + m - 1] += loop;
+							}
 						}
 					}
 				}
 			}
+			if (R < RMin) continue;
+
+			if (environment.measurement && isOutputProcess()) {
+				GlobalOutput* output = GlobalOutput::getInstance();
+				output->write("polyakov_loop_correlator", result/(numberColors*numberColors*LT::glob_x*LT::glob_z*LT::glob_t));
+				std::cout << "PolyakovCorrelator::Value at distance " << R*sqrt(static_cast<real_t>(paths[i][0]*paths[i][0] + paths[i][1]*paths[i][1] + paths[i][2]*paths[i][2])) << " along {" << paths[i][0] << "," << paths[i][1] << "," << paths[i][2] << "}: " << result/(numberColors*numberColors*LT::glob_x*LT::glob_z*LT::glob_t) << std::endl;
+
+				real_t pathLength = sqrt(static_cast<real_t>(paths[i][0]*paths[i][0] + paths[i][1]*paths[i][1] + paths[i][2]*paths[i][2]));
+				for (int m = 1; m <= maxSlices; ++m) {
+					long_real_t loop = 0.;
+					for (int x = 0; x < LT::glob_x; ++x) loop += loops[x*maxSlices + m - 1];
+					loop = loop/static_cast<long_real_t>(numberColors*LT::glob_x*LT::glob_z*LT::glob_t*numberSlices);
+					std::cout << "Multilevel Wilson loop (" << R*pathLength << "," << m*sliceSize << ") along {" << paths[i][0] << "," << paths[i][1] << "," << paths[i][2] << "}: " << loop << std::endl;
+					output->push("multilevel_wilson_loops");
+					output->write("multilevel_wilson_loops", R*pathLength);
+					output->write("multilevel_wilson_loops", m*sliceSize);
+					output->write("multilevel_wilson_loops", loop);
+					output->pop("multilevel_wilson_loops");
+				}
+			}
 		}
-
-		if (environment.measurement && isOutputProcess()) {
-			GlobalOutput* output = GlobalOutput::getInstance();
-			output->write("polyakov_loop_correlator", result/(numberColors*numberColors*LT::glob_x*LT::glob_z*LT::glob_t));
-			std::cout << "PolyakovCorrelator::Value at distance " << R << ": " << result/(numberColors*numberColors*LT::glob_x*LT::glob_z*LT::glob_t) << std::endl;
-		}
-		
 	}
 
 	if (environment.measurement && isOutputProcess()) {
 		GlobalOutput* output = GlobalOutput::getInstance();
 		output->pop("polyakov_loop_correlator");
+		output->pop("multilevel_wilson_loops");
 	}
 
 	delete action;
@@ -245,6 +313,7 @@ void PureGaugeWilsonLoops::updateSlices(environment_t& environment, GaugeAction*
 
 
 	//Now we update, first pure gauge heatbath
+	pureGaugeUpdater->startSweep();
 #ifdef MULTITHREADING
 	for (int color = 0; color < checkerboard->getNumberLoops(); ++color) {
 #pragma omp parallel for //shared(beta, color, environment) firstprivate(action, checkerboard) default(none) schedule(dynamic)
@@ -276,7 +345,8 @@ void PureGaugeWilsonLoops::updateSlices(environment_t& environment, GaugeAction*
 void PureGaugeWilsonLoops::registerParameters(po::options_description& desc) {
 	desc.add_options()
 		("PureGaugeWilsonLoops::max_r", po::value<unsigned int>(), "The maximal R to be measured")
-		("PureGaugeWilsonLoops::max_r", po::value<unsigned int>(), "The maximal T to be measured")
+		("PureGaugeWilsonLoops::max_t", po::value<unsigned int>(), "The maximal T to be measured")
+		("PureGaugeWilsonLoops::paths", po::value<std::string>()->default_value("{1,0,0}"), "The steps of the spatial paths in the directions x, z, t, negative steps go backwards (syntax: {dx1,dz1,dt1,dx2,dz2,dt2,...})")
 		("PureGaugeWilsonLoops::number_subsweeps_luescher", po::value<unsigned int>(), "Number of subsweeps of the luescher algorithm")
 		("PureGaugeWilsonLoops::size_slice_luescher", po::value<unsigned int>(), "The size of a slice of the luescher algorithm")
 		;
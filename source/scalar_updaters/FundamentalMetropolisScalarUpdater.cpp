@@ -1,58 +1,14 @@
 #include "FundamentalMetropolisScalarUpdater.h"
-#include "utils/RandomSeed.h"
+#include "utils/CounterRandomGenerator.h"
 #include "actions/FundamentalScalarAction.h"
-#include <omp.h>
 
 namespace Update {
 
-FundamentalMetropolisScalarUpdater::FundamentalMetropolisScalarUpdater()
-#ifndef MULTITHREADING
-: LatticeSweep(), randomGenerator(RandomSeed::randomSeed()), randomNormal(RandomSeed::getNormalNumberGenerator(randomGenerator,sqrt(0.5))), randomUniform(RandomSeed::getRandomNumberGenerator(randomGenerator)) { }
-#endif
-#ifdef MULTITHREADING
-: LatticeSweep()
-{
-	randomGenerator = new random_generator_t*[omp_get_max_threads()];
-	randomNormal = new random_normal_generator_t*[omp_get_max_threads()];
-	randomUniform = new random_uniform_generator_t*[omp_get_max_threads()];
-	for (int i = 0; i < omp_get_max_threads(); ++i) {
-		randomGenerator[i] = new random_generator_t(RandomSeed::randomSeed());
-		randomNormal[i] = new random_normal_generator_t(RandomSeed::getNormalNumberGenerator(*randomGenerator[i],sqrt(0.5)));
-		randomUniform[i] = new random_uniform_generator_t(RandomSeed::getRandomNumberGenerator(*randomGenerator[i]));
-	}
-}
-#endif
-
-FundamentalMetropolisScalarUpdater::FundamentalMetropolisScalarUpdater(const FundamentalMetropolisScalarUpdater& toCopy)
-#ifndef MULTITHREADING
-: LatticeSweep(toCopy), randomGenerator(RandomSeed::randomSeed()), randomNormal(RandomSeed::getNormalNumberGenerator(randomGenerator,sqrt(0.5))), randomUniform(RandomSeed::getRandomNumberGenerator(randomGenerator)) { }
-#endif
-#ifdef MULTITHREADING
-: LatticeSweep(toCopy) 
-{
-        randomGenerator = new random_generator_t*[omp_get_max_threads()];
-        randomNormal = new random_normal_generator_t*[omp_get_max_threads()];
-        randomUniform = new random_uniform_generator_t*[omp_get_max_threads()];
-        for (int i = 0; i < omp_get_max_threads(); ++i) {
-                randomGenerator[i] = new random_generator_t(RandomSeed::randomSeed());
-                randomNormal[i] = new random_normal_generator_t(RandomSeed::getNormalNumberGenerator(*randomGenerator[i],sqrt(0.5)));
-                randomUniform[i] = new random_uniform_generator_t(RandomSeed::getRandomNumberGenerator(*randomGenerator[i]));
-        }
-}
-#endif
-
-FundamentalMetropolisScalarUpdater::~FundamentalMetropolisScalarUpdater() {
-#ifdef MULTITHREADING
-	for (int i = 0; i < omp_get_max_threads(); ++i) {
-		delete randomGenerator[i];
-		delete randomNormal[i];
-		delete randomUniform[i];
-	}
-	delete[] randomGenerator;
-	delete[] randomNormal;
-	delete[] randomUniform;
-#endif
-}
+FundamentalMetropolisScalarUpdater::FundamentalMetropolisScalarUpdater() : LatticeSweep() { }
+
+FundamentalMetropolisScalarUpdater::FundamentalMetropolisScalarUpdater(const FundamentalMetropolisScalarUpdater& toCopy) : LatticeSweep(toCopy) { }
+
+FundamentalMetropolisScalarUpdater::~FundamentalMetropolisScalarUpdater() { }
 
 void FundamentalMetropolisScalarUpdater::execute(environment_t& environment) {
 	unsigned int nf = environment.configurations.get<unsigned int>("fundamental_nf_scalars");
@@ -90,20 +46,17 @@ void FundamentalMetropolisScalarUpdater::execute(environment_t& environment) {
 
         for (scalar_field = environment.fundamental_scalar_fields.begin(); scalar_field < environment.fundamental_scalar_fields.end(); ++scalar_field) { 
 		for (int block = 0; block < 2; ++block) {
+			boost::uint32_t stream = CounterRandomGenerator::nextStream();
 #pragma omp parallel for reduction(+:acceptance)
 			for (int site = 0; site < scalar_field->localsize; ++site) {
 				//White/Black partitioning
 				if ((Layout::globalIndexX(site) + Layout::globalIndexY(site) + Layout::globalIndexZ(site) + Layout::globalIndexT(site)) % 2 == block) {
+					CounterRandomGenerator generator(stream, CounterRandomGenerator::globalIndex<Layout>(site));
 					FundamentalVector kinetic_coupling = action->getKineticCoupling(environment.getFundamentalLattice(), *scalar_field, site);
 					for (unsigned int trial = 0; trial < trials; ++trial) {
 						FundamentalVector proposal = (*scalar_field)[site];
 						for (unsigned int c = 0; c < numberColors; ++c) {
-#ifndef MULTITHREADING
-							proposal[c] += epsilon*std::complex<real_t>(randomNormal(), randomNormal());
-#endif
-#ifdef MULTITHREADING
-							proposal[c] += epsilon*std::complex<real_t>((*randomNormal[omp_get_thread_num()])(), (*randomNormal[omp_get_thread_num()])());
-#endif
+							proposal[c] += epsilon*sqrt(0.5)*std::complex<real_t>(generator.normal(), generator.normal());
 						}
 						real_t delta = action->deltaEnergy(kinetic_coupling, (*scalar_field)[site], proposal);
 						//Do the accept/reject metropolis
@@ -111,12 +64,7 @@ void FundamentalMetropolisScalarUpdater::execute(environment_t& environment) {
 					                ++acceptance;
 					                (*scalar_field)[site] = proposal;
        						 }
-#ifndef MULTITHREADING
-        					else if (randomUniform() < exp(-delta)) {
-#endif
-#ifdef MULTITHREADING
-        					else if ((*randomUniform[omp_get_thread_num()])() < exp(-delta)) {
-#endif
+        					else if (generator.uniform() < exp(-delta)) {
                 					++acceptance;
                 					(*scalar_field)[site] = proposal;
         					}
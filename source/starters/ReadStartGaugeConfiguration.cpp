@@ -1,5 +1,6 @@
 #include "ReadStartGaugeConfiguration.h"
 #include "wilson_loops/Plaquette.h"
+#include "io/ParallelGaugeFile.h"
 #include <string>
 #include <fstream>
 #ifdef __APPLE__
@@ -13,6 +14,7 @@ typedef unsigned long long u_quad_t;
 #endif
 #include <rpc/xdr.h>
 #include "utils/ToString.h"
+#include "utils/CounterRandomGenerator.h"
 
 namespace Update {
 
@@ -29,6 +31,27 @@ void ReadStartGaugeConfiguration::execute(environment_t& environment) {
 		if (isOutputProcess()) std::cout << "ReadStartGaugeConfiguration::Reading failed!" << std::endl;
 		exit(49);
 	}
+
+	//Restore the state of the counter based generator stored with the configuration, otherwise the restarted run replays the random fields
+	std::string input_name = environment.configurations.get<std::string>("input_name");
+	std::string directory = environment.configurations.get<std::string>("input_directory_configurations");
+	std::string rng_name = directory+input_name+"_"+toString(numberfile)+".rng.txt";
+	std::fstream rng;
+	rng.open(rng_name.c_str(), std::fstream::in);
+	boost::uint64_t seed;
+	boost::uint32_t stream;
+	if (rng.is_open() && (rng >> seed >> stream)) {
+		//An explicit random_seed of the restarted run takes precedence
+		try {
+			environment.configurations.get<unsigned long long>("random_seed");
+		}
+		catch (NotFoundOption& ex) {
+			CounterRandomGenerator::setSeed(seed);
+		}
+		CounterRandomGenerator::setStream(stream);
+		if (isOutputProcess()) std::cout << "ReadStartGaugeConfiguration::Random generator restored from file " << rng_name << ", stream " << stream << std::endl;
+	}
+	else if (isOutputProcess()) std::cout << "ReadStartGaugeConfiguration::Warning, no random generator state in " << rng_name << ", the random fields restart from the first stream" << std::endl;
 }
 
 bool ReadStartGaugeConfiguration::readConfiguration(environment_t& environment, int numberfile) {
@@ -95,7 +118,7 @@ bool ReadStartGaugeConfiguration::readConfiguration(environment_t& environment,
 				xdr_int(&xin, &y);
 				xdr_int(&xin, &z);
 				xdr_int(&xin, &t);
-				int site = LT::localIndex[LT::getGlobalCoordinate(x,y,z,t)];
+				int site = LT::getLocalIndex(LT::getGlobalCoordinate(x,y,z,t));
 				if (site != -1) {
 					for (unsigned int mu = 0; mu < 4; ++mu) {
 						for (int i = 0; i < numberColors; ++i) {
@@ -127,6 +150,15 @@ bool ReadStartGaugeConfiguration::readConfiguration(environment_t& environment,
 			fclose(fin);
 		}
 	}
+	else if (format_name == "leonard_parallel_format") {
+		std::string directory = environment.configurations.get<std::string>("input_directory_configurations");
+		std::string input_name = environment.configurations.get<std::string>("input_name");
+		std::string input_file = directory+input_name+"_"+toString(numberfile)+".dat";
+
+		if (isOutputProcess()) std::cout << "ReadStartGaugeConfiguration::Reading configuration from file " << input_file << std::endl;
+
+		if (!ParallelGaugeFile::read(environment, input_file, read_plaquette)) return false;
+	}
 	else if (format_name == "muenster_format") {
 #if NUMCOLORS == 2
 		std::string directory = environment.configurations.get<std::string>("input_directory_configurations");
@@ -170,7 +202,7 @@ bool ReadStartGaugeConfiguration::readConfiguration(environment_t& environment,
 						}
 #endif
 #ifdef ENABLE_MPI
-						int localsite = Layout::localIndex[globsite];
+						int localsite = Layout::getLocalIndex(globsite);
 						if (localsite != -1) {
 							for (size_t mu = 0; mu < 4; ++mu) {
 								for (size_t ii = 0; ii < 2; ++ii) {
@@ -369,7 +401,7 @@ bool ReadStartGaugeConfiguration::readConfiguration(environment_t& environment,
 						}
 #endif
 #ifdef ENABLE_MPI
-						int localsite = Layout::localIndex[globsite];
+						int localsite = Layout::getLocalIndex(globsite);
 						if (localsite != -1) {
 							GaugeGroup mt;
 							for (size_t mu = 0; mu < 4; ++mu) {
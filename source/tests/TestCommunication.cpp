@@ -3,6 +3,52 @@
 
 namespace Update {
 
+#ifdef ENABLE_MPI
+//Halo exchange creating a new set of non-blocking requests at every call, the reference for the persistent requests of Lattice::updateHalo
+template<typename TLattice> void updateHaloWithoutPlan(TLattice& lattice) {
+	typedef typename TLattice::TData T;
+	typedef typename TLattice::Layout Layout;
+	int packsize = sizeof(T)/MpiType<T>::size;
+	std::vector<MPI_Request*> requests;
+	for (int i = 0; i < Layout::numberChunks; ++i) {
+		const Lattice::LatticeChunk& chunk = Layout::latticeChunks[i];
+		for (unsigned int j = 0; j < chunk.sharers.size(); ++j) {
+			if (chunk.owner == Layout::this_processor) {
+				MPI_Request* request = new MPI_Request;
+				MPI_Isend((void*)(&lattice[chunk.offset]),packsize*chunk.size,MpiType<T>::type,chunk.sharers[j],chunk.tags[j],MPI_COMM_WORLD,request);
+				requests.push_back(request);
+			}
+			else if (chunk.sharers[j] == Layout::this_processor) {
+				MPI_Request* request = new MPI_Request;
+				MPI_Irecv((void*)(&lattice[chunk.offset]),packsize*chunk.size,MpiType<T>::type,chunk.owner,chunk.tags[j],MPI_COMM_WORLD,request);
+				requests.push_back(request);
+			}
+		}
+	}
+	for (unsigned int i = 0; i < requests.size(); ++i) {
+		MPI_Wait(requests[i],MPI_STATUS_IGNORE);
+		delete requests[i];
+	}
+}
+
+template<typename TLattice> void testHaloLatency(TLattice& lattice, const std::string& name, int numberTests) {
+	MPI_Barrier(MPI_COMM_WORLD);
+	double start = MPI_Wtime();
+	for (int i = 0; i < numberTests; ++i) updateHaloWithoutPlan(lattice);
+	double withoutPlan = (MPI_Wtime() - start)/numberTests;
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	start = MPI_Wtime();
+	for (int i = 0; i < numberTests; ++i) lattice.updateHalo();
+	double withPlan = (MPI_Wtime() - start)/numberTests;
+
+	reduceAllSum(withoutPlan);
+	reduceAllSum(withPlan);
+	int numberProcessors = TLattice::Layout::numberProcessors;
+	if (isOutputProcess()) std::cout << "TestCommunication::Halo latency for " << name << ": " << (withoutPlan*1000)/numberProcessors << " ms without persistent requests, " << (withPlan*1000)/numberProcessors << " ms with persistent requests" << std::endl;
+}
+#endif
+
 TestCommunication::TestCommunication() { }
 
 TestCommunication::~TestCommunication() { }
@@ -163,6 +209,13 @@ void TestCommunication::execute(environment_t& environment) {
 	long_real_t after2 = AlgebraUtils::squaredNorm(test3);
 
 	if (isOutputProcess()) std::cout << "TestCommunication::Test communication dirac vector: " << before - after1 << " " << before - after2 << std::endl;
+
+#ifdef ENABLE_MPI
+	//Finally we compare the latency of the halo exchange with and without the persistent requests
+	int numberTests = 100;
+	testHaloLatency(lattice, "extended gauge lattice", numberTests);
+	testHaloLatency(test1, "reduced dirac vector", numberTests);
+#endif
 }
 
 } /* namespace Update */
@@ -0,0 +1,110 @@
+#include "TestLayout.h"
+#include "MPILattice/MPILayout.h"
+#include "MPILattice/ExtendedStencil.h"
+#include <sys/resource.h>
+#include <time.h>
+
+namespace Update {
+
+#ifdef ENABLE_MPI
+//A copy of the extended stencil, so that the benchmark layouts do not touch the layouts of the simulation
+class BenchmarkStencil {
+	public:
+		static std::vector<Lattice::Site> neighbourSites;
+		static const int id;
+};
+
+std::vector<Lattice::Site> BenchmarkStencil::neighbourSites;
+const int BenchmarkStencil::id = 100;
+
+typedef Lattice::MpiLayout<BenchmarkStencil> BenchmarkLayout;
+
+//Peak resident set size of this process in MB
+double peakResidentSize() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss/1024.;
+}
+
+//Check that the sup/down tables of the layout are consistent with the global coordinates of the sites
+int checkLayout() {
+	int errors = 0;
+	for (int site = 0; site < BenchmarkLayout::localsize; ++site) {
+		for (unsigned int mu = 0; mu < 4; ++mu) {
+			int up = BenchmarkLayout::sup_table[site][mu];
+			int down = BenchmarkLayout::down_table[site][mu];
+			Lattice::Site delta(mu == 0, mu == 1, mu == 2, mu == 3);
+			if (up == -1 || BenchmarkLayout::getGlobalCoordinate(BenchmarkLayout::globalCoordinate[up]) != BenchmarkLayout::getGlobalCoordinate(BenchmarkLayout::globalCoordinate[site] + delta)) ++errors;
+			if (down == -1 || BenchmarkLayout::getGlobalCoordinate(BenchmarkLayout::globalCoordinate[down]) != BenchmarkLayout::getGlobalCoordinate(BenchmarkLayout::globalCoordinate[site] - delta)) ++errors;
+		}
+	}
+	for (int site = 0; site < BenchmarkLayout::completesize; ++site) {
+		if (BenchmarkLayout::getLocalIndex(BenchmarkLayout::getGlobalCoordinate(BenchmarkLayout::globalCoordinate[site])) != site) ++errors;
+	}
+	return errors;
+}
+#endif
+
+TestLayout::TestLayout() { }
+
+TestLayout::~TestLayout() { }
+
+#ifdef ENABLE_MPI
+void TestLayout::execute(environment_t& environment) {
+	typedef extended_gauge_lattice_t::Layout Layout;
+	int maxScale = 2;
+	try {
+		maxScale = environment.configurations.get<unsigned int>("TestLayout::max_scale");
+	} catch (NotFoundOption& e) {
+		if (isOutputProcess()) std::cout << "TestLayout::max_scale not found, using default " << maxScale << std::endl;
+	}
+
+	BenchmarkStencil::neighbourSites = Lattice::ExtendedStencil::neighbourSites;
+	BenchmarkLayout::pgrid_x = Layout::pgrid_x;
+	BenchmarkLayout::pgrid_y = Layout::pgrid_y;
+	BenchmarkLayout::pgrid_z = Layout::pgrid_z;
+	BenchmarkLayout::pgrid_t = Layout::pgrid_t;
+
+	//The layout of the simulation is scaled in every direction, the peak memory is a high-water mark so the volumes grow
+	for (int scale = 1; scale <= maxScale; ++scale) {
+		BenchmarkLayout::glob_x = scale*Layout::glob_x;
+		BenchmarkLayout::glob_y = scale*Layout::glob_y;
+		BenchmarkLayout::glob_z = scale*Layout::glob_z;
+		BenchmarkLayout::glob_t = scale*Layout::glob_t;
+
+		MPI_Barrier(MPI_COMM_WORLD);
+		double start = MPI_Wtime();
+		BenchmarkLayout::initialize();
+		double elapsed = MPI_Wtime() - start;
+		double peak = peakResidentSize();
+
+		double maxElapsed = 0., maxPeak = 0.;
+		MPI_Reduce(&elapsed, &maxElapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+		MPI_Reduce(&peak, &maxPeak, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+		int errors = checkLayout();
+		int totalErrors = 0;
+		MPI_Reduce(&errors, &totalErrors, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+		if (isOutputProcess()) {
+			std::cout << "TestLayout::Lattice " << BenchmarkLayout::glob_x << "x" << BenchmarkLayout::glob_y << "x" << BenchmarkLayout::glob_z << "x" << BenchmarkLayout::glob_t;
+			std::cout << " (local " << BenchmarkLayout::localsize << ", complete " << BenchmarkLayout::completesize << ", chunks " << BenchmarkLayout::numberChunks << ")";
+			std::cout << ": initialization " << maxElapsed << " s, peak RSS " << maxPeak << " MB, errors " << totalErrors << std::endl;
+		}
+
+		BenchmarkLayout::destroy();
+	}
+}
+#endif
+#ifndef ENABLE_MPI
+void TestLayout::execute(environment_t&) {
+	if (isOutputProcess()) std::cout << "TestLayout::The layout benchmark needs MPI to be activated at compile time!" << std::endl;
+}
+#endif
+
+void TestLayout::registerParameters(po::options_description& desc) {
+	desc.add_options()
+		("TestLayout::max_scale", po::value<unsigned int>(), "The benchmark layouts are the lattice scaled by 1,...,max_scale in every direction")
+		;
+}
+
+} /* namespace Update */
@@ -0,0 +1,18 @@
+#ifndef TESTLAYOUT_H_
+#define TESTLAYOUT_H_
+#include "LatticeSweep.h"
+
+namespace Update {
+
+class TestLayout : public LatticeSweep {
+public:
+	TestLayout();
+	~TestLayout();
+
+	virtual void execute(environment_t& environment);
+
+	static void registerParameters(po::options_description& desc);
+};
+
+} /* namespace Update */
+#endif /* TESTLAYOUT_H_ */
@@ -1,6 +1,11 @@
 #include "TestLinearAlgebra.h"
 #include "inverters/BiConjugateGradient.h"
 #include "inverters/GMRESR.h"
+#include "inverters/ConjugateGradient.h"
+#include "inverters/PipelinedConjugateGradient.h"
+#include "inverters/MixedPrecisionSolver.h"
+#include "inverters/NormalEquationSolver.h"
+#include "inverters/SolutionHistory.h"
 #include "algebra_utils/AlgebraUtils.h"
 #include "dirac_operators/SquareDiracWilsonOperator.h"
 #include "dirac_operators/SquareImprovedDiracWilsonOperator.h"
@@ -15,12 +20,27 @@
 #include "dirac_operators/SquareComplementBlockDiracOperator.h"
 #include "dirac_operators/SquareTwistedDiracOperator.h"
 #include "dirac_operators/TwistedDiracOperator.h"
+#include "dirac_operators/EvenOddDiracWilsonOperator.h"
 #include "dirac_operators/SAPPreconditioner.h"
+#include "dirac_operators/SingleDiracWilsonOperator.h"
 #include "multigrid/MultiGridOperator.h"
+#include "multigrid/MultiGridProjector.h"
+#include "multigrid/MultiGridBiConjugateGradient.h"
+#include "multigrid/MultiGridHierarchy.h"
+#include "multigrid/MultiGridVectorLayout.h"
 #include "inverters/DeflationInverter.h"
 #include "dirac_functions/Polynomial.h"
 #include "utils/ToString.h"
+#include "utils/CounterRandomGenerator.h"
+#include "MPILattice/LatticeFourierTransform.h"
+#include "wilson_loops/WilsonLoopEngine.h"
+#include "polyakov_loops/PolyakovLoopCorrelator.h"
+#include "utils/MatrixExponential.h"
+#include "hmc_forces/SmearingForce.h"
+#include "io/ParallelGaugeFile.h"
+#include "wilson_loops/Plaquette.h"
 #include <vector>
+#include <cstdio>
 
 
 namespace Update {
@@ -33,6 +53,218 @@ void TestLinearAlgebra::execute(environment_t& environment) {
 	environment.gaugeLinkConfiguration.updateHalo();
 	environment.synchronize();
 
+	//Test of the counter based generator against the known answers of Philox4x32-10 and of the reproducibility of the random fields
+	{
+		const boost::uint32_t zero[4] = {0, 0, 0, 0}, zeroKey[2] = {0, 0};
+		const boost::uint32_t expected[4] = {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u};
+		boost::uint32_t result[4];
+		CounterRandomGenerator::philox(result, zero, zeroKey);
+		bool known = (result[0] == expected[0] && result[1] == expected[1] && result[2] == expected[2] && result[3] == expected[3]);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Known answer test of CounterRandomGenerator: " << (known ? "passed" : "failed") << std::endl;
+
+		reduced_dirac_vector_t first, second;
+		boost::uint32_t stream = CounterRandomGenerator::getStream();
+		AlgebraUtils::generateRandomGaussianVector(first);
+		CounterRandomGenerator::setStream(stream);
+		AlgebraUtils::generateRandomGaussianVector(second);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Reproducibility test of the random fields (zero): " << AlgebraUtils::differenceNorm(first, second) << std::endl;
+	}
+
+	//Test of the distributed Fourier transform against the direct sum for the momentum n = (1,1,0,1)
+	{
+		typedef reduced_dirac_vector_t::Layout Layout;
+		reduced_dirac_vector_t field;
+		AlgebraUtils::generateRandomGaussianVector(field);
+		const int numberComponents = 4*diracVectorLength;
+		std::vector< std::complex<real_t> > data(field.localsize*numberComponents);
+		for (int site = 0; site < field.localsize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				for (int i = 0; i < diracVectorLength; ++i) data[site*numberComponents + mu*diracVectorLength + i] = field[site][mu][i];
+			}
+		}
+		std::vector<real_t> direct(2*numberComponents, 0.), transformed(2*numberComponents, 0.);
+		for (int site = 0; site < field.localsize; ++site) {
+			real_t phase = 2.*PI*(Layout::globalIndexX(site)/static_cast<real_t>(Layout::glob_x) + Layout::globalIndexY(site)/static_cast<real_t>(Layout::glob_y) + Layout::globalIndexT(site)/static_cast<real_t>(Layout::glob_t));
+			for (int c = 0; c < numberComponents; ++c) {
+				std::complex<real_t> value = std::complex<real_t>(cos(phase), sin(phase))*data[site*numberComponents + c];
+				direct[2*c] += real(value);
+				direct[2*c + 1] += imag(value);
+			}
+		}
+		Lattice::LatticeFourierTransform<Layout> fourierTransform(numberComponents);
+		fourierTransform.transform(data, 1);
+		int site = Layout::getLocalIndex(Layout::getGlobalCoordinate(1, 1, 0, 1));
+		if (site >= 0 && site < field.localsize) {
+			for (int c = 0; c < numberComponents; ++c) {
+				transformed[2*c] = real(data[site*numberComponents + c]);
+				transformed[2*c + 1] = imag(data[site*numberComponents + c]);
+			}
+		}
+		reduceAllSum(&direct[0], direct.size());
+		reduceAllSum(&transformed[0], transformed.size());
+		real_t difference = 0.;
+		for (int c = 0; c < 2*numberComponents; ++c) difference += (direct[c] - transformed[c])*(direct[c] - transformed[c]);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Test of LatticeFourierTransform against the direct sum (zero): " << sqrt(difference) << std::endl;
+	}
+
+	//Test of the Fourier transform correlator of the Polyakov loops against the translations, at the distance 1 in the x direction
+	{
+		PolyakovLoopCorrelator polyakovLoopCorrelator;
+		extended_gauge_lattice_t polyakov;
+		polyakovLoopCorrelator.computePolyakovLoops(environment.gaugeLinkConfiguration, polyakov);
+		std::vector<long_real_t> translated = polyakovLoopCorrelator.translationCorrelator(polyakov);
+		std::vector<long_real_t> transformed = polyakovLoopCorrelator.allDistancesCorrelator(polyakov);
+		//The separations x and -x are averaged, only the real part is the same
+		const int index = (extended_gauge_lattice_t::Layout::glob_y/2 + 1)*(extended_gauge_lattice_t::Layout::glob_z/2 + 1);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Test of the Fourier transform Polyakov loop correlator against the translations (zero): " << fabs(transformed[2*index] - translated[0]) << std::endl;
+	}
+
+	//Test of the Wilson loop (1,1) of WilsonLoopEngine against the plaquette in the plane x-t
+	{
+		typedef extended_gauge_lattice_t LT;
+		const extended_gauge_lattice_t& lattice = environment.gaugeLinkConfiguration;
+		long_real_t plaquette = 0.;
+#pragma omp parallel for reduction(+:plaquette)
+		for (int site = 0; site < lattice.localsize; ++site) {
+			plaquette += real(trace(lattice[site][0]*lattice[LT::sup(site,0)][3]*htrans(lattice[LT::sup(site,3)][0])*htrans(lattice[site][3])));
+		}
+		reduceAllSum(plaquette);
+		plaquette = plaquette/static_cast<long_real_t>(numberColors*LT::Layout::globalVolume);
+
+		WilsonLoopEngine wilsonLoopEngine(3);
+		std::vector<int> path(3, 0);
+		path[0] = 1;
+		std::vector<long_real_t> loops = wilsonLoopEngine.measure(environment.gaugeLinkConfiguration, path, 1, 1);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Test of WilsonLoopEngine against the plaquette (zero): " << fabs(loops[0] - plaquette) << std::endl;
+		path[0] = -1;
+		loops = wilsonLoopEngine.measure(environment.gaugeLinkConfiguration, path, 1, 1);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Test of WilsonLoopEngine with a backward path against the plaquette (zero): " << fabs(loops[0] - plaquette) << std::endl;
+	}
+
+	//Test of SmearingForce against the central finite difference of S = Re tr(D V) along exp(i eps T^a) U on a few links, F = sum_a i T^a dS/dw_a
+	{
+		typedef extended_fermion_force_lattice_t::Layout Layout;
+		extended_fermion_force_lattice_t actionDerivative;
+		boost::uint32_t stream = CounterRandomGenerator::nextStream();
+#pragma omp parallel for
+		for (int site = 0; site < actionDerivative.localsize; ++site) {
+			CounterRandomGenerator generator(stream, CounterRandomGenerator::globalIndex<Layout>(site));
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				for (int i = 0; i < diracVectorLength; ++i) {
+					for (int j = 0; j < diracVectorLength; ++j) actionDerivative[site][mu].at(i,j) = std::complex<real_t>(generator.normal(), generator.normal());
+				}
+			}
+		}
+		actionDerivative.updateHalo();
+
+		SmearingForce smearingForce;
+		LieGenerator<GaugeGroup> generators;
+		const real_t rho = 0.1, epsilon = 0.0001;
+		const int sites[2] = {0, environment.gaugeLinkConfiguration.localsize/3};
+		for (int levels = 1; levels <= 2; ++levels) {
+			extended_gauge_lattice_t force;
+			smearingForce.force(actionDerivative, environment.gaugeLinkConfiguration, force, rho, levels);
+
+			real_t difference = 0.;
+			for (int k = 0; k < 2; ++k) {
+				const unsigned int mu = 3*k;
+				const int a = k*(numberColors*numberColors - 2);
+				long_real_t action[2];
+				for (int sign = 0; sign < 2; ++sign) {
+					//Only the output process moves its link, all the processors compute the action
+					extended_gauge_lattice_t lattice = environment.gaugeLinkConfiguration;
+					GaugeGroup X = std::complex<real_t>(0., (sign == 0) ? epsilon : -epsilon)*generators.get(a);
+					if (isOutputProcess()) lattice[sites[k]][mu] = exponential(X)*lattice[sites[k]][mu];
+					lattice.updateHalo();
+
+					extended_gauge_lattice_t smeared = lattice, swap;
+					for (int level = 0; level < levels; ++level) {
+						smearingForce.smearing(smeared, swap, rho);
+						smeared = swap;
+					}
+					long_real_t value = 0.;
+#pragma omp parallel for reduction(+:value)
+					for (int site = 0; site < smeared.localsize; ++site) {
+						for (unsigned int nu = 0; nu < 4; ++nu) {
+#ifdef ADJOINT
+							FermionicGroup link;
+							ConvertLattice<extended_fermion_lattice_t,extended_gauge_lattice_t>::toAdjoint(smeared[site][nu], link);
+#endif
+#ifndef ADJOINT
+							const FermionicGroup& link = smeared[site][nu];
+#endif
+							for (int i = 0; i < diracVectorLength; ++i) {
+								for (int j = 0; j < diracVectorLength; ++j) value += real(actionDerivative[site][nu].at(i,j)*link.at(j,i));
+							}
+						}
+					}
+					reduceAllSum(value);
+					action[sign] = value;
+				}
+				//dS/dw_a = 2 tr(-i T^a F)
+				real_t numerical = (action[0] - action[1])/(2.*epsilon);
+				real_t analytic = 2.*imag(trace(generators.get(a)*force[sites[k]][mu]));
+				difference = std::max(difference, static_cast<real_t>(fabs(numerical - analytic)));
+			}
+			if (isOutputProcess()) std::cout << "TestLinearAlgebra::Test of SmearingForce with " << levels << " levels against the finite difference (zero): " << difference << std::endl;
+		}
+	}
+
+	//Test of ParallelGaugeFile: write, read back and compare the links bit by bit, then check that a corrupted file is rejected by the checksum
+	{
+		const std::string filename = "TestLinearAlgebra_parallel_gauge_file.dat";
+		extended_gauge_lattice_t original = environment.gaugeLinkConfiguration;
+		double plaquette = Plaquette::temporalPlaquette(environment.gaugeLinkConfiguration);
+		bool written = ParallelGaugeFile::write(environment, filename, plaquette);
+
+		//Scramble the links so that a reading that does nothing cannot pass
+#pragma omp parallel for
+		for (int site = 0; site < environment.gaugeLinkConfiguration.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) set_to_zero(environment.gaugeLinkConfiguration[site][mu]);
+		}
+		double readPlaquette = 0.;
+		bool readed = written && ParallelGaugeFile::read(environment, filename, readPlaquette);
+		environment.gaugeLinkConfiguration.updateHalo();
+		int mismatches = 0;
+#pragma omp parallel for reduction(+:mismatches)
+		for (int site = 0; site < original.localsize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				for (int i = 0; i < numberColors; ++i) {
+					for (int j = 0; j < numberColors; ++j) {
+						if (real(original[site][mu].at(i,j)) != real(environment.gaugeLinkConfiguration[site][mu].at(i,j)) || imag(original[site][mu].at(i,j)) != imag(environment.gaugeLinkConfiguration[site][mu].at(i,j))) ++mismatches;
+					}
+				}
+			}
+		}
+		reduceAllSum(mismatches);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Test of ParallelGaugeFile writing and reading (zero): " << ((written && readed) ? mismatches : -1) << std::endl;
+		//The header stores the plaquette of the written links, it must be the one of the links read
+		double recomputedPlaquette = Plaquette::temporalPlaquette(environment.gaugeLinkConfiguration);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Test of ParallelGaugeFile plaquette in the header (zero): " << fabs(readPlaquette - plaquette) + fabs(readPlaquette - recomputedPlaquette) << std::endl;
+
+		//Flip one bit of the last link in the file, the checksum stored in the header must not match anymore
+#ifdef ENABLE_MPI
+		MPI_Barrier(MPI_COMM_WORLD);
+#endif
+		if (isOutputProcess()) {
+			FILE* file = fopen(filename.c_str(), "r+b");
+			if (file) {
+				fseek(file, -1, SEEK_END);
+				int byte = fgetc(file);
+				fseek(file, -1, SEEK_END);
+				fputc(byte ^ 0x01, file);
+				fclose(file);
+			}
+		}
+#ifdef ENABLE_MPI
+		MPI_Barrier(MPI_COMM_WORLD);
+#endif
+		bool corrupted = ParallelGaugeFile::read(environment, filename, readPlaquette);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Test of ParallelGaugeFile checksum of a corrupted file (zero): " << (corrupted ? 1 : 0) << std::endl;
+		if (isOutputProcess()) remove(filename.c_str());
+		environment.gaugeLinkConfiguration = original;
+	}
+
 	//Hermitian test
 	{
 		reduced_dirac_vector_t test1, test2, test3, test4;
@@ -153,6 +385,198 @@ void TestLinearAlgebra::execute(environment_t& environment) {
 		delete basicDiracWilsonOperator;
 	}
 
+	//Mixed precision test
+	{
+		reduced_dirac_vector_t source, test1, test2;
+		AlgebraUtils::generateRandomVector(source);
+		DiracWilsonOperator* diracWilsonOperator = new DiracWilsonOperator();
+		diracWilsonOperator->setKappa(environment.configurations.get<double>("kappa"));
+		diracWilsonOperator->setLattice(environment.getFermionLattice());
+		SquareDiracWilsonOperator* squareDiracWilsonOperator = new SquareDiracWilsonOperator();
+		squareDiracWilsonOperator->setKappa(environment.configurations.get<double>("kappa"));
+		squareDiracWilsonOperator->setLattice(environment.getFermionLattice());
+
+		//The single precision kernel must agree with the double precision one up to rounding errors
+		SingleDiracWilsonOperator singleDiracWilsonOperator;
+		singleDiracWilsonOperator.setOperator(diracWilsonOperator, false);
+		single_reduced_dirac_vector_t single_input, single_output;
+		for (int site = 0; site < source.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) single_input[site][mu] = source[site][mu].cast<single_complex>();
+		}
+		singleDiracWilsonOperator.multiply(single_output, single_input);
+		diracWilsonOperator->multiply(test1, source);
+		for (int site = 0; site < source.completesize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) test2[site][mu] = single_output[site][mu].cast<complex>();
+		}
+		long_real_t difference = AlgebraUtils::differenceNorm(test1,test2)/AlgebraUtils::squaredNorm(test1);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Relative squared difference of SingleDiracWilsonOperator: " << difference << std::endl;
+
+		ConjugateGradient conjugateGradient;
+		conjugateGradient.setPrecision(0.00000000001);
+		conjugateGradient.setMaximumSteps(10000);
+		conjugateGradient.solve(squareDiracWilsonOperator, source, test1);
+		MixedPrecisionSolver mixedPrecisionSolver(MixedPrecisionSolver::ConjugateGradientSolver);
+		mixedPrecisionSolver.setPrecision(0.00000000001);
+		mixedPrecisionSolver.setMaximumSteps(10000);
+		mixedPrecisionSolver.solve(squareDiracWilsonOperator, source, test2);
+		difference = AlgebraUtils::differenceNorm(test1,test2);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Mixed precision ConjugateGradient on SquareDiracWilsonOperator: " << mixedPrecisionSolver.getLastSteps() << " steps (" << mixedPrecisionSolver.getLastOuterSteps() << " corrections) against " << conjugateGradient.getLastSteps() << ", difference: " << difference << std::endl;
+
+		PipelinedConjugateGradient pipelinedConjugateGradient;
+		pipelinedConjugateGradient.setPrecision(0.00000000001);
+		pipelinedConjugateGradient.setMaximumSteps(10000);
+		pipelinedConjugateGradient.solve(squareDiracWilsonOperator, source, test2);
+		difference = AlgebraUtils::differenceNorm(test1,test2);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::PipelinedConjugateGradient on SquareDiracWilsonOperator: " << pipelinedConjugateGradient.getLastSteps() << " steps against " << conjugateGradient.getLastSteps() << ", difference: " << difference << std::endl;
+
+#ifdef ALIGNED_OPT
+		{
+			//The conjugate gradient entirely on the split real/imaginary storage
+			reduced_soa_dirac_vector_t soa_source = source, soa_solution;
+			conjugateGradient.solve(squareDiracWilsonOperator, soa_source, soa_solution);
+			soa_solution.copy_to(test2);
+			difference = AlgebraUtils::differenceNorm(test1,test2);
+			if (isOutputProcess()) std::cout << "TestLinearAlgebra::ConjugateGradient on SoA vectors: " << conjugateGradient.getLastSteps() << " steps, difference: " << difference << std::endl;
+		}
+#endif
+
+		BiConjugateGradient biConjugateGradient;
+		biConjugateGradient.setPrecision(0.00000000001);
+		biConjugateGradient.setMaximumSteps(10000);
+		biConjugateGradient.solve(diracWilsonOperator, source, test1);
+		MixedPrecisionSolver mixedPrecisionBiCGStab(MixedPrecisionSolver::BiConjugateGradientSolver);
+		mixedPrecisionBiCGStab.setPrecision(0.00000000001);
+		mixedPrecisionBiCGStab.setMaximumSteps(10000);
+		mixedPrecisionBiCGStab.solve(diracWilsonOperator, source, test2);
+		difference = AlgebraUtils::differenceNorm(test1,test2);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Mixed precision BiConjugateGradient on DiracWilsonOperator: " << mixedPrecisionBiCGStab.getLastSteps() << " steps (" << mixedPrecisionBiCGStab.getLastOuterSteps() << " corrections) against " << biConjugateGradient.getLastSteps() << ", difference: " << difference << std::endl;
+
+		//The solvers of hermitian positive definite operators invert the DiracWilson operator with the normal equations
+		NormalEquationSolver normalEquationSolver(Solver::getInstance("mixed_precision_conjugate_gradient"));
+		normalEquationSolver.setPrecision(0.00000000001);
+		normalEquationSolver.setMaximumSteps(10000);
+		normalEquationSolver.solve(diracWilsonOperator, source, test2);
+		difference = AlgebraUtils::differenceNorm(test1,test2);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Mixed precision ConjugateGradient on the normal equations of DiracWilsonOperator: " << normalEquationSolver.getLastSteps() << " steps, difference: " << difference << std::endl;
+		NormalEquationSolver pipelinedNormalEquationSolver(Solver::getInstance("pipelined_conjugate_gradient"));
+		pipelinedNormalEquationSolver.setPrecision(0.00000000001);
+		pipelinedNormalEquationSolver.setMaximumSteps(10000);
+		pipelinedNormalEquationSolver.solve(diracWilsonOperator, source, test2);
+		difference = AlgebraUtils::differenceNorm(test1,test2);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::PipelinedConjugateGradient on the normal equations of DiracWilsonOperator: " << pipelinedNormalEquationSolver.getLastSteps() << " steps, difference: " << difference << std::endl;
+
+		//The solve on the Schur complement must reconstruct the same solution of the DiracWilson operator
+		unsigned int fullSteps = conjugateGradient.getLastSteps();
+		EvenOddDiracWilsonOperator evenOddDiracWilsonOperator(environment.getFermionLattice(), environment.configurations.get<double>("kappa"));
+		conjugateGradient.solve(&evenOddDiracWilsonOperator, source, test2);
+		difference = AlgebraUtils::differenceNorm(test1,test2);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::ConjugateGradient on EvenOddDiracWilsonOperator: " << conjugateGradient.getLastSteps() << " steps against " << fullSteps << " on SquareDiracWilsonOperator, difference: " << difference << std::endl;
+
+		//The block solver must give the same solutions of the single right hand side solver
+		std::vector<reduced_dirac_vector_t> sources(4), solutions;
+		sources[0] = source;
+		for (unsigned int i = 1; i < sources.size(); ++i) AlgebraUtils::generateRandomVector(sources[i]);
+		biConjugateGradient.solve(diracWilsonOperator, sources, solutions);
+		difference = AlgebraUtils::differenceNorm(test1,solutions[0]);
+		diracWilsonOperator->multiply(test2, solutions[3]);
+		long_real_t residual = AlgebraUtils::differenceNorm(test2,sources[3]);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Block BiConjugateGradient on DiracWilsonOperator: " << biConjugateGradient.getLastSteps() << " steps for " << sources.size() << " sources, difference: " << difference << ", residual of the last source: " << residual << std::endl;
+
+		//The history contains the solution of the first source, its extrapolated guess must be almost exact
+		SolutionHistory history(3);
+		for (unsigned int i = 3; i > 0; --i) history.add(solutions[i - 1]);
+		history.guess(diracWilsonOperator, sources[0], test2);
+		diracWilsonOperator->multiply(test1, test2);
+		residual = AlgebraUtils::differenceNorm(test1,sources[0]);
+		biConjugateGradient.solve(diracWilsonOperator, sources[0], test1, &test2);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Chronological guess on DiracWilsonOperator, residual: " << residual << ", BiConjugateGradient steps from the guess: " << biConjugateGradient.getLastSteps() << std::endl;
+		delete diracWilsonOperator;
+		delete squareDiracWilsonOperator;
+	}
+
+	//Multigrid hierarchy test
+	{
+		//The probed coarse operator is checked against R D P by setOperator, the coarse solve must reach the requested precision
+		DiracWilsonOperator* diracWilsonOperator = new DiracWilsonOperator();
+		diracWilsonOperator->setLattice(environment.getFermionLattice());
+		diracWilsonOperator->setKappa(0.1);
+		MultiGridVectorLayout::xBlockSize = 2;
+		MultiGridVectorLayout::yBlockSize = 2;
+		MultiGridVectorLayout::zBlockSize = 2;
+		MultiGridVectorLayout::tBlockSize = 2;
+		MultiGridVectorLayout::initialize();
+		BlockBasis basis(4);
+		for (int i = 0; i < basis.size(); ++i) AlgebraUtils::generateRandomVector(basis[i]);
+		basis.orthogonalize();
+		MultiGridHierarchy hierarchy;
+		hierarchy.setNumberLevels(3);
+		hierarchy.setBasisDimension(4);
+		hierarchy.setSteps(50);
+		hierarchy.setPrecision(0.0001);
+		if (hierarchy.initialize(basis.size()) && hierarchy.setOperator(diracWilsonOperator, basis)) {
+			reduced_dirac_vector_t source, test1, test2;
+			AlgebraUtils::generateRandomVector(source);
+			coarse_vector_t coarseSource, coarseSolution, coarseTest;
+			hierarchy.restrictVector(coarseSource, source, basis);
+			hierarchy.solve(coarseSolution, coarseSource);
+			hierarchy.prolongVector(test1, coarseSolution, basis);
+			diracWilsonOperator->multiply(test2, test1);
+			hierarchy.restrictVector(coarseTest, test2, basis);
+			long_real_t difference = 0., normSource = 0.;
+			for (int i = 0; i < MultiGridVectorLayout::totalNumberOfBlocks*basis.size(); ++i) {
+				difference += norm(coarseTest[i] - coarseSource[i]);
+				normSource += norm(coarseSource[i]);
+			}
+			reduceAllSum(difference);
+			reduceAllSum(normSource);
+			if (isOutputProcess()) std::cout << "TestLinearAlgebra::Three level MultiGridHierarchy on DiracWilsonOperator, relative residual of the coarse solve: " << sqrt(difference/normSource) << std::endl;
+
+			//The same coarse system solved with the matrix free operator of two levels
+			MultiGridOperator multiGridOperator;
+			MultiGridProjector multiGridProjector;
+			multiGridOperator.setDiracOperator(diracWilsonOperator);
+			for (int i = 0; i < basis.size(); ++i) {
+				multiGridOperator.addVector(basis[i]);
+				multiGridProjector.addVector(basis[i]);
+			}
+			multigrid_vector_t mgSource, mgSolution, mgTest;
+			multiGridProjector.apply(mgSource, source);
+			MultiGridBiConjugateGradientSolver biMgSolver;
+			biMgSolver.setPrecision(0.00000000001);
+			biMgSolver.solve(&multiGridOperator, mgSource, mgSolution);
+			multiGridOperator.multiply(mgTest, mgSolution);
+			mgTest.axpy(-1., mgSource);
+			if (isOutputProcess()) std::cout << "TestLinearAlgebra::MultiGridBiConjugateGradientSolver on DiracWilsonOperator, relative residual of the coarse solve: " << sqrt(multigrid_vector_t::squaredNorm(mgTest)/multigrid_vector_t::squaredNorm(mgSource)) << std::endl;
+		}
+		else if (isOutputProcess()) std::cout << "TestLinearAlgebra::Proceeding without the test of MultiGridHierarchy" << std::endl;
+		delete diracWilsonOperator;
+	}
+
+	//Exponential test
+	{
+		//The closed forms must agree with the Taylor series on the traceless anti-hermitian part of the links
+		real_t difference = 0., unitarityDeviation = 0.;
+		for (int site = 0; site < environment.gaugeLinkConfiguration.localsize; ++site) {
+			for (unsigned int mu = 0; mu < 4; ++mu) {
+				const GaugeGroup& link = environment.gaugeLinkConfiguration[site][mu];
+				GaugeGroup X = 0.5*(link - htrans(link));
+				std::complex<real_t> trc = trace(X);
+				for (int i = 0; i < numberColors; ++i) X.at(i,i) -= trc/static_cast<real_t>(numberColors);
+				//Large arguments test the scaling and squaring
+				X = static_cast<real_t>(1 + (site % 4)*mu)*X;
+				GaugeGroup exact = exponential(X);
+				GaugeGroup series = taylorExponential<GaugeGroup, numberColors>(X);
+				GaugeGroup unitarity = exact*htrans(exact);
+				for (int i = 0; i < numberColors; ++i) unitarity.at(i,i) -= 1.;
+				difference += (exact - series).squaredNorm();
+				unitarityDeviation += unitarity.squaredNorm();
+			}
+		}
+		reduceAllSum(difference);
+		reduceAllSum(unitarityDeviation);
+		if (isOutputProcess()) std::cout << "TestLinearAlgebra::Exponential of su(N) matrices, squared difference from the Taylor series: " << difference << ", squared deviation from unitarity: " << unitarityDeviation << std::endl;
+	}
+
 	environment.gaugeLinkConfiguration.updateHalo();
 	environment.synchronize();
 }
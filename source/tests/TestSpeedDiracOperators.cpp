@@ -5,6 +5,7 @@
 #include "dirac_operators/DiracWilsonOperator.h"
 #include "dirac_operators/ImprovedDiracWilsonOperator.h"
 #include "dirac_operators/BasicDiracWilsonOperator.h"
+#include "dirac_operators/CompressedDiracWilsonOperator.h"
 #include "dirac_operators/SquareBlockDiracWilsonOperator.h"
 #include "dirac_operators/ComplementBlockDiracOperator.h"
 #include "dirac_operators/SquareComplementBlockDiracWilsonOperator.h"
@@ -12,8 +13,10 @@
 #include "dirac_operators/SquareTwistedDiracOperator.h"
 #include "dirac_operators/TwistedDiracOperator.h"
 #include "dirac_operators/SAPPreconditioner.h"
+#include "dirac_operators/LocalSAPPreconditioner.h"
 #include "utils/ToString.h"
 #include <vector>
+#include <algorithm>
 #ifdef TEST_PAPI_SPEED
 #include <papi.h>
 
@@ -52,6 +55,148 @@ double diffclock(clock_t clock1,clock_t clock2) {
 
 namespace Update {
 
+double elapsedSeconds(const struct timespec& start, const struct timespec& finish) {
+	double elapsed = (finish.tv_sec - start.tv_sec);
+	elapsed += (finish.tv_nsec - start.tv_nsec) / 1000000000.0;
+	return elapsed;
+}
+
+//Floating point operations per site of the Wilson operator (1320 for the fundamental representation of SU(3)), with the clover term of ImprovedDiracWilsonOperator
+double diracWilsonFlopsPerSite(bool clover) {
+	const double N = diracVectorLength;
+#ifdef ADJOINT
+	//Real links times complex vectors
+	const double matrixVector = 4*N*N - 2*N;
+#endif
+#ifndef ADJOINT
+	const double matrixVector = 8*N*N - 2*N;
+#endif
+	//Two matrix-vector products and two projections for each of the eight hoppings, then the sum of the eight contributions
+	double flops = 8*(2*matrixVector + 4*N) + 7*8*N;
+	//The two 2N x 2N chiral blocks of the clover term
+	if (clover) flops += 2*(8*(2*N)*(2*N) - 2*(2*N)) + 8*N;
+	return flops;
+}
+
+double gflopsPerCore(double seconds, double flopsPerSite, int localsize) {
+#ifdef MULTITHREADING
+	const int cores = omp_get_max_threads();
+#endif
+#ifndef MULTITHREADING
+	const int cores = 1;
+#endif
+	return (flopsPerSite*localsize)/(seconds*1000000000.*cores);
+}
+
+//Bytes read and written per site by the Wilson operator without cache reuse: the links of the eight hoppings, the eight neighbours, the input and the output
+double diracWilsonBytesPerSite(double linkBytesPerSite) {
+	return 2*linkBytesPerSite + 10*sizeof(GaugeVector[4]);
+}
+
+//Relative residual |input - D M input|/|input| of the preconditioner M of diracOperator
+long_real_t preconditionerResidual(DiracOperator* diracOperator, DiracOperator* preconditioner, const reduced_dirac_vector_t& input) {
+	reduced_dirac_vector_t output, product;
+	preconditioner->multiply(output, input);
+	diracOperator->multiply(product, output);
+	return sqrt(AlgebraUtils::differenceNorm(input, product)/AlgebraUtils::squaredNorm(input));
+}
+
+//Compare the SAP with the masked block inversions of ComplementBlockDiracOperator with the SAP with the local block solves, with the same number of cycles and block iterations
+void testSAPPreconditioners(const extended_fermion_lattice_t& lattice, const reduced_dirac_vector_t& input, int numberTests) {
+	const std::vector<unsigned int> blockSize(4, 4);
+	const int cycles = 4, blockSteps = 5;
+	struct timespec start, finish;
+	reduced_dirac_vector_t output;
+
+	DiracWilsonOperator* diracOperator = new DiracWilsonOperator(lattice, 0.1, false);
+	BlockDiracOperator* blockDiracOperators[2];
+	for (int color = 0; color < 2; ++color) {
+		blockDiracOperators[color] = new BlockDiracWilsonOperator(lattice, 0.1, (color == 0) ? Black : Red);
+		blockDiracOperators[color]->setGamma5(false);
+		blockDiracOperators[color]->setBlockSize(blockSize);
+	}
+	ComplementBlockDiracOperator* K = new ComplementBlockDiracOperator(diracOperator, blockDiracOperators[1], blockDiracOperators[0]);
+	K->setMaximumSteps(blockSteps);
+	K->setBlockSize(blockSize);
+	SAPPreconditioner* maskedSAP = new SAPPreconditioner(diracOperator, K);
+	maskedSAP->setSteps(cycles);
+	LocalSAPPreconditioner* localSAP = new LocalSAPPreconditioner(diracOperator);
+	localSAP->setBlockSize(blockSize);
+	localSAP->setSteps(cycles);
+	localSAP->setBlockSteps(blockSteps);
+
+	DiracOperator* preconditioners[2] = {maskedSAP, localSAP};
+	const std::string names[2] = {"SAPPreconditioner", "LocalSAPPreconditioner"};
+	double elapsed[2];
+	for (int k = 0; k < 2; ++k) {
+		clock_gettime(CLOCK_REALTIME, &start);
+		for (int i = 0; i < numberTests; ++i) {
+			preconditioners[k]->multiply(output, input);
+		}
+		clock_gettime(CLOCK_REALTIME, &finish);
+		elapsed[k] = elapsedSeconds(start, finish)/numberTests;
+		long_real_t residual = preconditionerResidual(diracOperator, preconditioners[k], input);
+		if (isOutputProcess()) std::cout << "Timing for " << names[k] << ": " << elapsed[k]*1000 << " ms, relative residual: " << residual << std::endl;
+	}
+	if (isOutputProcess()) std::cout << "Speedup of LocalSAPPreconditioner: " << elapsed[0]/elapsed[1] << std::endl;
+
+	delete localSAP;
+	delete maskedSAP;
+	delete K;
+	delete blockDiracOperators[0];
+	delete blockDiracOperators[1];
+	delete diracOperator;
+}
+
+//Compare the blocking halo update of the output with the split-phase mode, where the halo exchange is overlapped with the interior sites
+void testOverlapCommunication(DiracOperator* diracOperator, const std::string& name, reduced_dirac_vector_t& output, const reduced_dirac_vector_t& input, int numberTests) {
+	struct timespec start, finish;
+	bool overlapCommunication = diracOperator->getOverlapCommunication();
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (int i = 0; i < numberTests; ++i) {
+		output.updateHalo();
+	}
+	clock_gettime(CLOCK_REALTIME, &finish);
+	double communication = elapsedSeconds(start, finish)/numberTests;
+
+	//The boundary and the interior sites are timed by the operator itself
+	diracOperator->setRegionTiming(true);
+	diracOperator->resetRegionTimes();
+	diracOperator->setOverlapCommunication(false);
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (int i = 0; i < numberTests; ++i) {
+		diracOperator->multiply(output,input);
+	}
+	clock_gettime(CLOCK_REALTIME, &finish);
+	double blocking = elapsedSeconds(start, finish)/numberTests;
+	double boundary = diracOperator->getRegionTime(0)/numberTests;
+	double interior = diracOperator->getRegionTime(1)/numberTests;
+
+	diracOperator->resetRegionTimes();
+	diracOperator->setOverlapCommunication(true);
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (int i = 0; i < numberTests; ++i) {
+		diracOperator->multiply(output,input);
+	}
+	clock_gettime(CLOCK_REALTIME, &finish);
+	double overlapped = elapsedSeconds(start, finish)/numberTests;
+	double overlappedInterior = diracOperator->getRegionTime(1)/numberTests;
+
+	diracOperator->setRegionTiming(false);
+	diracOperator->setOverlapCommunication(overlapCommunication);
+
+	if (isOutputProcess()) {
+		std::cout << "Timing for " << name << " halo exchange: " << communication*1000 << " ms." << std::endl;
+		std::cout << "Timing for " << name << " boundary sites: " << boundary*1000 << " ms, interior sites: " << interior*1000 << " ms, interior sites during the halo exchange: " << overlappedInterior*1000 << " ms." << std::endl;
+		std::cout << "Timing for " << name << " blocking: " << blocking*1000 << " ms, overlapped: " << overlapped*1000 << " ms." << std::endl;
+		//At most min(interior, communication) can be hidden behind the interior sites
+		double hideable = std::min(interior, communication);
+		if (boundary + interior == 0.) std::cout << "Overlap efficiency for " << name << ": the operator does not time its sites" << std::endl;
+		else if (hideable > 0.) std::cout << "Overlap efficiency for " << name << ": " << std::max(0., std::min(1., (blocking - overlapped)/hideable))*100 << " %" << std::endl;
+	}
+}
+
 TestSpeedDiracOperators::TestSpeedDiracOperators() : LatticeSweep() { }
 
 TestSpeedDiracOperators::~TestSpeedDiracOperators() { }
@@ -105,6 +250,50 @@ void TestSpeedDiracOperators::execute(environment_t& environment) {
 	if (isOutputProcess()) std::cout << "MFLOPS for DiracWilsonOperator: " << mflops << " MFLOPS. " << std::endl;
 #endif
 	if (isOutputProcess()) std::cout << "Timing for DiracWilsonOperator: " << (elapsed*1000)/numberTests << " ms."<< std::endl;
+	if (isOutputProcess()) std::cout << "Performance for DiracWilsonOperator: " << gflopsPerCore(elapsed/numberTests, diracWilsonFlopsPerSite(false), test1.localsize) << " Gflop/s per core." << std::endl;
+	if (isOutputProcess()) std::cout << "Bandwidth for DiracWilsonOperator: " << (diracWilsonBytesPerSite(4*sizeof(FermionicGroup))*test1.localsize*numberTests)/(elapsed*1000000000.) << " GB/s (" << 4*sizeof(FermionicGroup) << " bytes of links per site)." << std::endl;
+
+	//The same operator reading the compressed links
+	{
+		CompressedDiracWilsonOperator* compressedDiracWilsonOperator = new CompressedDiracWilsonOperator();
+		compressedDiracWilsonOperator->setKappa(0.1);
+		compressedDiracWilsonOperator->setLattice(environment.getFermionLattice());
+		clock_gettime(CLOCK_REALTIME, &start);
+		for (int i = 0; i < numberTests; ++i) {
+			compressedDiracWilsonOperator->multiply(test4,test1);
+		}
+		clock_gettime(CLOCK_REALTIME, &finish);
+		double compressedElapsed = elapsedSeconds(start, finish);
+		if (isOutputProcess()) std::cout << "Timing for CompressedDiracWilsonOperator: " << (compressedElapsed*1000)/numberTests << " ms." << std::endl;
+		if (isOutputProcess()) std::cout << "Bandwidth for CompressedDiracWilsonOperator: " << (diracWilsonBytesPerSite(CompressedDiracWilsonOperator::linkBytesPerSite())*test1.localsize*numberTests)/(compressedElapsed*1000000000.) << " GB/s (" << CompressedDiracWilsonOperator::linkBytesPerSite() << " bytes of links per site)." << std::endl;
+		if (isOutputProcess()) std::cout << "Speedup of CompressedDiracWilsonOperator: " << elapsed/compressedElapsed << std::endl;
+		diracWilsonOperator->multiply(test2,test1);
+		long_real_t difference = AlgebraUtils::differenceNorm(test2,test4);
+		if (isOutputProcess()) std::cout << "Difference between DiracWilsonOperator and CompressedDiracWilsonOperator: " << difference << std::endl;
+		delete compressedDiracWilsonOperator;
+	}
+
+#ifdef ENABLE_MPI
+	//The multiplication of vectors in the extended layout, converted in the cached buffers of the operator
+	{
+		DiracOperator* diracOperator = diracWilsonOperator;
+		extended_dirac_vector_t extendedInput = test1, extendedOutput;
+		diracOperator->multiply(extendedOutput,extendedInput);
+#ifdef DEBUG_MEMORY_ALLOCATION
+		long int allocations = Lattice::AllocationCounter::total;
+#endif
+		clock_gettime(CLOCK_REALTIME, &start);
+		for (int i = 0; i < numberTests; ++i) {
+			diracOperator->multiply(extendedOutput,extendedInput);
+		}
+		clock_gettime(CLOCK_REALTIME, &finish);
+		double extendedElapsed = elapsedSeconds(start, finish);
+		if (isOutputProcess()) std::cout << "Timing for DiracWilsonOperator on extended vectors: " << (extendedElapsed*1000)/numberTests << " ms." << std::endl;
+#ifdef DEBUG_MEMORY_ALLOCATION
+		if (isOutputProcess()) std::cout << "Lattice allocations in the multiplications on extended vectors: " << Lattice::AllocationCounter::total - allocations << std::endl;
+#endif
+	}
+#endif
 	
 	clock_gettime(CLOCK_REALTIME, &start);
 	for (int i = 0; i < numberTests; ++i) {
@@ -140,6 +329,36 @@ void TestSpeedDiracOperators::execute(environment_t& environment) {
 	if (isOutputProcess()) std::cout << "MFLOPS for ImprovedDiracWilsonOperator: " << mflops << " MFLOPS. " << std::endl;
 #endif
 	if (isOutputProcess()) std::cout << "Timing for ImprovedDiracWilsonOperator: " << (elapsed*1000)/numberTests << " ms." << std::endl;
+	if (isOutputProcess()) std::cout << "Performance for ImprovedDiracWilsonOperator: " << gflopsPerCore(elapsed/numberTests, diracWilsonFlopsPerSite(true), test1.localsize) << " Gflop/s per core." << std::endl;
+
+#ifdef ALIGNED_OPT
+	//The vectorized kernels on the split real/imaginary storage, checked against the standard kernels
+	{
+		reduced_soa_dirac_vector_t soa_input = test1, soa_output;
+		DiracOperator* soaOperators[2] = {diracWilsonOperator, improvedDiracWilsonOperator};
+		const std::string soaNames[2] = {"DiracWilsonOperator", "ImprovedDiracWilsonOperator"};
+		for (int k = 0; k < 2; ++k) {
+			clock_gettime(CLOCK_REALTIME, &start);
+			for (int i = 0; i < numberTests; ++i) {
+				soaOperators[k]->multiply(soa_output,soa_input);
+			}
+			clock_gettime(CLOCK_REALTIME, &finish);
+			elapsed = elapsedSeconds(start, finish);
+
+			soaOperators[k]->multiply(test2,test1);
+			soa_output.copy_to(test4);
+			if (isOutputProcess()) std::cout << "Timing for " << soaNames[k] << " (SoA): " << (elapsed*1000)/numberTests << " ms." << std::endl;
+			if (isOutputProcess()) std::cout << "Performance for " << soaNames[k] << " (SoA): " << gflopsPerCore(elapsed/numberTests, diracWilsonFlopsPerSite(k == 1), test1.localsize) << " Gflop/s per core." << std::endl;
+			long_real_t difference = AlgebraUtils::differenceNorm(test2,test4);
+			if (isOutputProcess()) std::cout << "Difference between " << soaNames[k] << " and its SoA version: " << difference << std::endl;
+		}
+	}
+#endif
+
+	testOverlapCommunication(diracWilsonOperator, "DiracWilsonOperator", test2, test1, numberTests);
+	testOverlapCommunication(improvedDiracWilsonOperator, "ImprovedDiracWilsonOperator", test2, test1, numberTests);
+
+	testSAPPreconditioners(environment.getFermionLattice(), test1, std::max(1, numberTests/100));
 
 	std::complex<long_real_t> result_fast;
 #ifdef TEST_PAPI_SPEED
@@ -0,0 +1,76 @@
+#include "TestSpeedPureGauge.h"
+#include "pure_gauge/PureGaugeUpdater.h"
+#include "pure_gauge/PureGaugeOverrelaxation.h"
+#include "pure_gauge/Checkerboard.h"
+#include <time.h>
+
+namespace Update {
+
+TestSpeedPureGauge::TestSpeedPureGauge() : LatticeSweep() { }
+
+TestSpeedPureGauge::~TestSpeedPureGauge() { }
+
+void TestSpeedPureGauge::execute(environment_t& environment) {
+	typedef extended_gauge_lattice_t::Layout Layout;
+	int numberSweeps;
+	try {
+		numberSweeps = environment.configurations.get<unsigned int>("TestSpeedPureGauge::number_sweeps_test_speed");
+	} catch (NotFoundOption& e) {
+		numberSweeps = 10;
+	}
+
+	extended_gauge_lattice_t originalConfiguration = environment.gaugeLinkConfiguration;
+	PureGaugeUpdater heatBath;
+	PureGaugeOverrelaxation overrelaxation;
+	//The checkerboard is built before the timings
+	heatBath.execute(environment);
+	overrelaxation.execute(environment);
+
+	struct timespec start, finish;
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (int i = 0; i < numberSweeps; ++i) {
+		heatBath.execute(environment);
+	}
+	clock_gettime(CLOCK_REALTIME, &finish);
+	double heatBathTime = ((finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec)/1000000000.)/numberSweeps;
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (int i = 0; i < numberSweeps; ++i) {
+		overrelaxation.execute(environment);
+	}
+	clock_gettime(CLOCK_REALTIME, &finish);
+	double overrelaxationTime = ((finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec)/1000000000.)/numberSweeps;
+
+	//A sweep exchanges the halos once for every color of the checkerboard
+#ifdef MULTITHREADING
+	int numberHaloExchanges = Checkerboard::getInstance()->getNumberLoops();
+#endif
+#ifndef MULTITHREADING
+	int numberHaloExchanges = 1;
+#endif
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (int i = 0; i < numberSweeps*numberHaloExchanges; ++i) {
+		environment.gaugeLinkConfiguration.updateHalo();
+	}
+	clock_gettime(CLOCK_REALTIME, &finish);
+	double communicationTime = ((finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec)/1000000000.)/numberSweeps;
+
+	if (isOutputProcess()) {
+		const int localLinks = 4*environment.gaugeLinkConfiguration.localsize;
+		std::cout << "Pure gauge sweeps on " << Layout::numberProcessors << " processes, " << localLinks << " links per process" << std::endl;
+		std::cout << "Timing for the heat bath sweep: " << heatBathTime*1000 << " ms, " << (heatBathTime*1000000.)/localLinks << " us per link." << std::endl;
+		std::cout << "Timing for the overrelaxation sweep: " << overrelaxationTime*1000 << " ms, " << (overrelaxationTime*1000000.)/localLinks << " us per link." << std::endl;
+		std::cout << "Timing for the " << numberHaloExchanges << " halo exchanges of a sweep: " << communicationTime*1000 << " ms." << std::endl;
+	}
+
+	environment.gaugeLinkConfiguration = originalConfiguration;
+	environment.synchronize();
+}
+
+void TestSpeedPureGauge::registerParameters(po::options_description& desc) {
+	desc.add_options()
+		("TestSpeedPureGauge::number_sweeps_test_speed", po::value<unsigned int>(), "How many sweeps should I use in the tests?")
+		;
+}
+
+} /* namespace Update */
@@ -0,0 +1,23 @@
+#ifndef TESTSPEEDPUREGAUGE_H_
+#define TESTSPEEDPUREGAUGE_H_
+
+#include "LatticeSweep.h"
+
+namespace Update {
+
+/**
+ * Timing of the heat bath and overrelaxation sweeps of the pure gauge updaters, to be run at different numbers of processes
+ * for the scaling of the checkerboard update. The gauge configuration is restored at the end.
+ */
+class TestSpeedPureGauge : public Update::LatticeSweep {
+public:
+	TestSpeedPureGauge();
+	~TestSpeedPureGauge();
+
+	virtual void execute(environment_t& environment);
+
+	static void registerParameters(po::options_description& desc);
+};
+
+} /* namespace Update */
+#endif /* TESTSPEEDPUREGAUGE_H_ */
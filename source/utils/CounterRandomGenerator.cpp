@@ -0,0 +1,29 @@
+#include "CounterRandomGenerator.h"
+
+namespace Update {
+
+boost::uint32_t CounterRandomGenerator::key[2] = {0, 0};
+boost::uint32_t CounterRandomGenerator::stream = 0;
+
+void CounterRandomGenerator::setSeed(boost::uint64_t _seed) {
+	key[0] = static_cast<boost::uint32_t>(_seed);
+	key[1] = static_cast<boost::uint32_t>(_seed >> 32);
+}
+
+boost::uint64_t CounterRandomGenerator::getSeed() {
+	return (static_cast<boost::uint64_t>(key[1]) << 32) | key[0];
+}
+
+boost::uint32_t CounterRandomGenerator::nextStream() {
+	return stream++;
+}
+
+void CounterRandomGenerator::setStream(boost::uint32_t _stream) {
+	stream = _stream;
+}
+
+boost::uint32_t CounterRandomGenerator::getStream() {
+	return stream;
+}
+
+} /* namespace Update */
@@ -0,0 +1,105 @@
+#ifndef COUNTERRANDOMGENERATOR_H_
+#define COUNTERRANDOMGENERATOR_H_
+#include <boost/cstdint.hpp>
+#include <cmath>
+
+namespace Update {
+
+/**
+ * Counter based generator of random numbers, Philox4x32-10 of Salmon et al. "Parallel random numbers: as easy as 1, 2, 3".
+ * The numbers are a function only of the global seed, of the stream and of the index, usually the global index of a site:
+ * a lattice wide random field takes a new stream with nextStream() and builds a generator on every site, so the field
+ * does not depend on the number of threads and processors. All the processors must take the streams in the same order.
+ */
+class CounterRandomGenerator {
+public:
+	CounterRandomGenerator(boost::uint32_t stream, boost::uint64_t index) : position(4), hasNormal(false) {
+		counter[0] = 0;
+		counter[1] = static_cast<boost::uint32_t>(index);
+		counter[2] = static_cast<boost::uint32_t>(index >> 32);
+		counter[3] = stream;
+	}
+
+	//Uniform distribution in (0,1), with 53 random bits
+	double uniform() {
+		boost::uint32_t a = this->next() >> 5, b = this->next() >> 6;
+		return (a*67108864. + b + 0.5)*(1./9007199254740992.);
+	}
+
+	//Normal distribution with variance 1, the Box-Muller pairs are used both
+	double normal() {
+		if (hasNormal) {
+			hasNormal = false;
+			return nextNormal;
+		}
+		double radius = sqrt(-2.*log(this->uniform()));
+		double angle = 6.283185307179586476925286766559*this->uniform();
+		nextNormal = radius*sin(angle);
+		hasNormal = true;
+		return radius*cos(angle);
+	}
+
+	//Z2 noise, +1 or -1 with the same probability
+	double z2() {
+		return (this->next() & 1) ? 1. : -1.;
+	}
+
+	boost::uint32_t next() {
+		if (position == 4) {
+			philox(buffer, counter, key);
+			++counter[0];
+			position = 0;
+		}
+		return buffer[position++];
+	}
+
+	//The global seed, the same on all the processors
+	static void setSeed(boost::uint64_t _seed);
+	static boost::uint64_t getSeed();
+
+	//A new stream for a lattice wide draw, it must be called by all the processors out of the parallel regions
+	static boost::uint32_t nextStream();
+	//The streams taken so far, to continue the same sequence of streams
+	static void setStream(boost::uint32_t _stream);
+	static boost::uint32_t getStream();
+
+	//The global lexicographic index of a local site, independent on the decomposition of the lattice
+	template<typename TLayout> static boost::uint64_t globalIndex(int site) {
+		return ((static_cast<boost::uint64_t>(TLayout::globalIndexX(site))*TLayout::glob_y + TLayout::globalIndexY(site))*TLayout::glob_z + TLayout::globalIndexZ(site))*TLayout::glob_t + TLayout::globalIndexT(site);
+	}
+
+	static void philox(boost::uint32_t result[4], const boost::uint32_t input[4], const boost::uint32_t inputKey[2]) {
+		boost::uint32_t c0 = input[0], c1 = input[1], c2 = input[2], c3 = input[3];
+		boost::uint32_t k0 = inputKey[0], k1 = inputKey[1];
+		for (int round = 0; round < 10; ++round) {
+			boost::uint64_t product0 = static_cast<boost::uint64_t>(0xD2511F53u)*c0;
+			boost::uint64_t product1 = static_cast<boost::uint64_t>(0xCD9E8D57u)*c2;
+			boost::uint32_t hi0 = static_cast<boost::uint32_t>(product0 >> 32), lo0 = static_cast<boost::uint32_t>(product0);
+			boost::uint32_t hi1 = static_cast<boost::uint32_t>(product1 >> 32), lo1 = static_cast<boost::uint32_t>(product1);
+			c0 = hi1 ^ c1 ^ k0;
+			c1 = lo1;
+			c2 = hi0 ^ c3 ^ k1;
+			c3 = lo0;
+			k0 += 0x9E3779B9u;
+			k1 += 0xBB67AE85u;
+		}
+		result[0] = c0;
+		result[1] = c1;
+		result[2] = c2;
+		result[3] = c3;
+	}
+
+private:
+	boost::uint32_t counter[4];
+	boost::uint32_t buffer[4];
+	int position;
+	bool hasNormal;
+	double nextNormal;
+
+	static boost::uint32_t key[2];
+	static boost::uint32_t stream;
+};
+
+} /* namespace Update */
+
+#endif /* COUNTERRANDOMGENERATOR_H_ */
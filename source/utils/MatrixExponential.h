@@ -0,0 +1,156 @@
+#ifndef MATRIXEXPONENTIAL_H
+#define MATRIXEXPONENTIAL_H
+#include "MatrixTypedef.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Update {
+
+/**
+ * Exponential of a N x N matrix by scaling and squaring of the Taylor series: the matrix is divided by 2^s
+ * so that its norm is below 1/2, the series is summed with the Horner scheme and the result is squared s times.
+ */
+template<typename TMatrix, int N> TMatrix taylorExponential(const TMatrix& X) {
+	real_t norm = 0.;
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < N; ++j) {
+			norm += std::norm(X.at(i,j));
+		}
+	}
+	//norm < 2^e, the scaled matrix has norm < 1/2
+	int e;
+	frexp(sqrt(norm), &e);
+	const int s = std::max(0, e + 1);
+	TMatrix Y = ldexp(1., -s)*X;
+
+	TMatrix identity;
+	set_to_zero(identity);
+	for (int i = 0; i < N; ++i) identity.at(i,i) = 1.;
+	//The truncation error of the order 14 is below 0.5^15/15!, far below the precision of real_t
+	TMatrix result = identity;
+	for (int k = 14; k > 0; --k) {
+		result = identity + (Y*result)/static_cast<real_t>(k);
+	}
+	for (int i = 0; i < s; ++i) {
+		result = result*result;
+	}
+	return result;
+}
+
+/**
+ * Derivative of the exponential of a N x N matrix in the direction A, L = int_0^1 exp((1-s)X) A exp(sX) ds,
+ * so that tr(A d exp(X)) = tr(L dX). L is the upper right block of the exponential of ((X, A), (0, X)),
+ * A is normalized before the exponentiation since the result is linear in it.
+ */
+template<typename TMatrix, int N> TMatrix exponentialDerivative(const TMatrix& X, const TMatrix& A) {
+	typedef Eigen::Matrix< complex, 2*N, 2*N > BlockMatrix;
+	real_t norm = 0.;
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < N; ++j) {
+			norm += std::norm(A.at(i,j));
+		}
+	}
+	if (norm == 0.) return A;
+	norm = sqrt(norm);
+
+	BlockMatrix block;
+	set_to_zero(block);
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < N; ++j) {
+			block.at(i,j) = X.at(i,j);
+			block.at(i+N,j+N) = X.at(i,j);
+			block.at(i,j+N) = A.at(i,j)/norm;
+		}
+	}
+	BlockMatrix blockExponential = taylorExponential<BlockMatrix, 2*N>(block);
+
+	TMatrix result;
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < N; ++j) {
+			result.at(i,j) = norm*blockExponential.at(i,j+N);
+		}
+	}
+	return result;
+}
+
+/**
+ * Exponential of a traceless anti-hermitian N x N matrix, in closed form for N = 2 and N = 3
+ */
+template<typename TMatrix, int N> class MatrixExponential {
+public:
+	static TMatrix exp(const TMatrix& X) {
+		return taylorExponential<TMatrix, N>(X);
+	}
+};
+
+//exp(X) = cos(rho) + sin(rho)/rho X, with rho^2 = det(X)
+template<typename TMatrix> class MatrixExponential<TMatrix, 2> {
+public:
+	static TMatrix exp(const TMatrix& X) {
+		const real_t rho2 = 0.5*(std::norm(X.at(0,0)) + std::norm(X.at(0,1)) + std::norm(X.at(1,0)) + std::norm(X.at(1,1)));
+		const real_t rho = sqrt(rho2);
+		const real_t sinc = (rho < 0.05) ? 1. - (1./6.)*rho2*(1. - (1./20.)*rho2*(1. - (1./42.)*rho2)) : sin(rho)/rho;
+		const real_t c = cos(rho);
+		TMatrix result;
+		result.at(0,0) = c + sinc*X.at(0,0);
+		result.at(0,1) = sinc*X.at(0,1);
+		result.at(1,0) = sinc*X.at(1,0);
+		result.at(1,1) = c + sinc*X.at(1,1);
+		return result;
+	}
+};
+
+//Cayley-Hamilton form of Morningstar and Peardon, exp(iQ) = f0 + f1 Q + f2 Q^2 with X = iQ
+template<typename TMatrix> class MatrixExponential<TMatrix, 3> {
+public:
+	static TMatrix exp(const TMatrix& X) {
+		const std::complex<real_t> I(0.,1.);
+		const TMatrix Q = -I*X;
+		const TMatrix Q2 = Q*Q;
+		real_t c0 = 0.;
+		real_t c1 = 0.;
+		for (int i = 0; i < 3; ++i) {
+			c1 += 0.5*real(Q2.at(i,i));
+			for (int j = 0; j < 3; ++j) {
+				c0 += real(Q2.at(i,j)*Q.at(j,i))/3.;
+			}
+		}
+		//The coefficients for -c0 are related to the ones for c0 by f_j(-c0) = (-1)^j conj(f_j(c0))
+		const bool negative = (c0 < 0.);
+		c0 = fabs(c0);
+		//The formula is 0/0 for Q = 0, the lower bound on c1 gives the limit f0 = 1, f1 = i, f2 = -1/2
+		c1 = std::max(c1, static_cast<real_t>(1e-30));
+		const real_t c0max = 2.*(c1/3.)*sqrt(c1/3.);
+		const real_t theta = acos(std::min(c0/c0max, static_cast<real_t>(1.)));
+		const real_t u = sqrt(c1/3.)*cos(theta/3.);
+		const real_t w = sqrt(c1)*sin(theta/3.);
+		const real_t w2 = w*w;
+		const real_t xi = (fabs(w) < 0.05) ? 1. - (1./6.)*w2*(1. - (1./20.)*w2*(1. - (1./42.)*w2)) : sin(w)/w;
+		const real_t cw = cos(w);
+
+		const std::complex<real_t> exp2iu(cos(2.*u),sin(2.*u));
+		const std::complex<real_t> expmiu(cos(u),-sin(u));
+		const real_t denominator = 9.*u*u - w2;
+		std::complex<real_t> f0 = ((u*u - w2)*exp2iu + expmiu*std::complex<real_t>(8.*u*u*cw, 2.*u*(3.*u*u + w2)*xi))/denominator;
+		std::complex<real_t> f1 = (2.*u*exp2iu - expmiu*std::complex<real_t>(2.*u*cw, -(3.*u*u - w2)*xi))/denominator;
+		std::complex<real_t> f2 = (exp2iu - expmiu*std::complex<real_t>(cw, 3.*u*xi))/denominator;
+		f0 = negative ? conj(f0) : f0;
+		f1 = negative ? -conj(f1) : f1;
+		f2 = negative ? conj(f2) : f2;
+
+		TMatrix result = f1*Q + f2*Q2;
+		for (int i = 0; i < 3; ++i) result.at(i,i) += f0;
+		return result;
+	}
+};
+
+/**
+ * This function returns exp(X) for X in the algebra su(N) (traceless anti-hermitian)
+ */
+inline GaugeGroup exponential(const GaugeGroup& X) {
+	return MatrixExponential<GaugeGroup, numberColors>::exp(X);
+}
+
+}
+
+#endif
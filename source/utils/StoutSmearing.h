@@ -20,7 +20,6 @@ protected:
 	FermionicGroup smearLink(const extended_fermion_lattice_t& input, int site, unsigned int mu, real_t rho) const;
 #endif
 
-private:
 	WilsonGaugeAction wga;
 };
 
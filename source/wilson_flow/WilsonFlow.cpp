@@ -4,6 +4,7 @@
 #include "io/GlobalOutput.h"
 #include "wilson_loops/Plaquette.h"
 #include "utils/MultiThreadSummator.h"
+#include "utils/MatrixExponential.h"
 
 namespace Update {
 
@@ -137,39 +138,7 @@ void WilsonFlow::getForce(const extended_gauge_lattice_t& lattice, extended_gaug
 }
 
 GaugeGroup WilsonFlow::exponential(const GaugeGroup& link, const GaugeGroup& force, real_t epsilon) {
-#ifdef EIGEN
-	Eigen::ComplexEigenSolver<GaugeGroup> es(force);
-	GaugeGroup update;
-	update.zeros();
-	for (int i = 0; i < numberColors; ++i) {
-		update.at(i,i) = exp(epsilon*es.eigenvalues()[i]);
-	}
-	GaugeGroup m = es.eigenvectors();
-	GaugeGroup updatenew = m * update * htrans(m);
-#endif
-#ifdef ARMADILLO
-	FundamentalVector eigval;
-	GaugeGroup eigvec;
-	arma::eig_gen(eigval, eigvec, force);
-	GaugeGroup update;
-	set_to_zero(update);
-	for (unsigned int i = 0; i < numberColors; ++i) {
-		update.at(i,i) = exp(epsilon*eigval[i]);
-	}
-	GaugeGroup updatenew = eigvec * update * htrans(eigvec);
-#endif
-#ifdef MATRIXTOOLKIT
-	FundamentalVector eigval;
-	GaugeGroup eigvec;
-	matrix_toolkit::eigensystem(eigval, eigvec, force);
-	GaugeGroup update;
-	set_to_zero(update);
-	for (unsigned int i = 0; i < numberColors; ++i) {
-		update.at(i,i) = exp(epsilon*eigval[i]);
-	}
-	GaugeGroup updatenew = eigvec * update * htrans(eigvec);
-#endif
-	return updatenew*link;
+	return Update::exponential(epsilon*force)*link;
 }
 
 std::pair<long_real_t,long_real_t> WilsonFlow::measureEnergyAndTopologicalCharge(const extended_gauge_lattice_t& _lattice, int site) {
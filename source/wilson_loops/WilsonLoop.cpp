@@ -4,23 +4,12 @@
 
 namespace Update {
 
-WilsonLoop::WilsonLoop() : tWilsonLine(0), xWilsonLine(0) { }
+WilsonLoop::WilsonLoop() : wilsonLoopEngine(0) { }
 
-WilsonLoop::WilsonLoop(const WilsonLoop& toCopy) : LatticeSweep(toCopy), tWilsonLine(0), xWilsonLine(0) { }
+WilsonLoop::WilsonLoop(const WilsonLoop& toCopy) : LatticeSweep(toCopy), wilsonLoopEngine(0) { }
 
 WilsonLoop::~WilsonLoop() {
-	if (tWilsonLine != 0) {
-		for (int i = 0; i < TMax; ++i) {
-			delete[] tWilsonLine[i];
-		}
-		delete[] tWilsonLine;
-	}
-	if (xWilsonLine != 0) {
-		for (int i = 0; i < RMax; ++i) {
-			delete[] xWilsonLine[i];
-		}
-		delete[] xWilsonLine;
-	}
+	if (wilsonLoopEngine != 0) delete wilsonLoopEngine;
 }
 
 void WilsonLoop::execute(environment_t& environment) {
@@ -38,104 +27,37 @@ void WilsonLoop::execute(environment_t& environment) {
 		if (isOutputProcess()) std::cout << "WilsonLoop::No smearing options found, proceeding without!" << std::endl;
 	}
 
-	RMax = environment.configurations.get<unsigned int>("WilsonLoop::max_r");
-	TMax = environment.configurations.get<unsigned int>("WilsonLoop::max_t");
+	int RMax = environment.configurations.get<unsigned int>("WilsonLoop::max_r");
+	int TMax = environment.configurations.get<unsigned int>("WilsonLoop::max_t");
 
 	int t_dir = environment.configurations.get<unsigned int>("WilsonLoop::t_dir");
 
-	//tWilsonLine[T][R] contains the wilson line in the t-direction long T and shifted of R sites in the x-direction
-	if (tWilsonLine == 0) {
-		tWilsonLine = new reduced_matrix_lattice_t*[TMax];
-		for (int i = 0; i < TMax; ++i) {
-			tWilsonLine[i] = new reduced_matrix_lattice_t[RMax+1];
-		}
-	}
-	//xWilsonLine[R][T] contains the wilson line in the x-direction long R and shifted of T sites in the t-direction
-	if (xWilsonLine == 0){
-		xWilsonLine = new reduced_matrix_lattice_t*[RMax];
-		for (int i = 0; i < RMax; ++i) {
-			xWilsonLine[i] = new reduced_matrix_lattice_t[TMax+1];
-		}
-	}
+	std::vector< std::vector<int> > paths = WilsonLoopEngine::readPaths(environment.configurations.get< std::vector<int> >("WilsonLoop::paths"));
 
-	typedef reduced_matrix_lattice_t LT;
+	if (wilsonLoopEngine == 0) wilsonLoopEngine = new WilsonLoopEngine(t_dir);
 
 	if (environment.measurement && isOutputProcess()) {
 		GlobalOutput* output = GlobalOutput::getInstance();
 		output->push("wilson_loops");
 	}
 
-#pragma omp parallel for
-	for (int site = 0; site < originalLattice.localsize; ++site) {
-		tWilsonLine[0][0][site] =  originalLattice[site][t_dir];
-		xWilsonLine[0][0][site] =  originalLattice[site][0];
-	}
-	tWilsonLine[0][0].updateHalo();
-	xWilsonLine[0][0].updateHalo();
-
-	reduced_matrix_lattice_t shiftedLattice = tWilsonLine[0][0], swap;
-	for (int t = 1; t < TMax; ++t) {
-#pragma omp parallel for
-		for (int site = 0; site < originalLattice.localsize; ++site) {
-			tWilsonLine[t][0][site] = tWilsonLine[t-1][0][site]*shiftedLattice[LT::sup(site,t_dir)];
-			swap[site] = shiftedLattice[LT::sup(site,t_dir)];
-		}
-		swap.updateHalo();
-		shiftedLattice = swap;
-	}
-
-	shiftedLattice = xWilsonLine[0][0];
-	for (int r = 1; r < RMax; ++r) {
-#pragma omp parallel for
-		for (int site = 0; site < originalLattice.localsize; ++site) {
-			xWilsonLine[r][0][site] = xWilsonLine[r-1][0][site]*shiftedLattice[LT::sup(site,0)];
-			swap[site] = shiftedLattice[LT::sup(site,0)];
-		}
-		swap.updateHalo();
-		shiftedLattice = swap;
-	}
-
-	for (int r = 0; r < RMax; ++r) {
-		for (int t = 1; t < TMax + 1; ++t) {
-#pragma omp parallel for
-			for (int site = 0; site < originalLattice.localsize; ++site) {
-				xWilsonLine[r][t][site] = xWilsonLine[r][t-1][LT::sup(site,t_dir)];
-			}
-			xWilsonLine[r][t].updateHalo();
-		}
-	}
-
-	for (int t = 0; t < TMax; ++t) {
-		for (int r = 1; r < RMax + 1; ++r) {
-#pragma omp parallel for
-			for (int site = 0; site < originalLattice.localsize; ++site) {
-				tWilsonLine[t][r][site] = tWilsonLine[t][r-1][LT::sup(site,0)];
-			}
-			tWilsonLine[t][r].updateHalo();
-		}
-	}
-
-	//Now we can compute the wilson loops
-	for (int R = 0; R < RMax; ++R) {
-		for (int T = 0; T < TMax; ++T) {
-			long_real_t result = 0.;
-#pragma omp parallel for reduction(+:result)
-			for (int site = 0; site < originalLattice.localsize; ++site) {
-				result += real(trace(xWilsonLine[R][0][site]*tWilsonLine[T][R+1][site]*htrans(xWilsonLine[R][T+1][site])*htrans(tWilsonLine[T][0][site])));
-			}
-			reduceAllSum(result);
-
-			result = result/static_cast<long_real_t>(numberColors*reduced_matrix_lattice_t::Layout::globalVolume);
-
-			if (environment.measurement && isOutputProcess()) {
-				GlobalOutput* output = GlobalOutput::getInstance();
-
-				std::cout << "Temporal Wilson loop (" << R + 1 << "," << T + 1<< "): " << result << std::endl;
-				output->push("wilson_loops");
-				output->write("wilson_loops", R + 1);
-				output->write("wilson_loops", T + 1);
-				output->write("wilson_loops", result);
-				output->pop("wilson_loops");
+	for (unsigned int i = 0; i < paths.size(); ++i) {
+		//All the loops of the path, W(n,T) is result[(n - 1)*TMax + T - 1]
+		std::vector<long_real_t> result = wilsonLoopEngine->measure(originalLattice, paths[i], RMax, TMax);
+		real_t pathLength = sqrt(static_cast<real_t>(paths[i][0]*paths[i][0] + paths[i][1]*paths[i][1] + paths[i][2]*paths[i][2]));
+
+		for (int R = 1; R <= RMax; ++R) {
+			for (int T = 1; T <= TMax; ++T) {
+				if (environment.measurement && isOutputProcess()) {
+					GlobalOutput* output = GlobalOutput::getInstance();
+
+					std::cout << "Temporal Wilson loop (" << R*pathLength << "," << T << ") along {" << paths[i][0] << "," << paths[i][1] << "," << paths[i][2] << "}: " << result[(R - 1)*TMax + T - 1] << std::endl;
+					output->push("wilson_loops");
+					output->write("wilson_loops", R*pathLength);
+					output->write("wilson_loops", T);
+					output->write("wilson_loops", result[(R - 1)*TMax + T - 1]);
+					output->pop("wilson_loops");
+				}
 			}
 		}
 	}
@@ -151,6 +73,7 @@ void WilsonLoop::registerParameters(po::options_description& desc) {
 		("WilsonLoop::max_t", po::value<unsigned int>()->default_value(6), "The maximum dimension of the Wilson loop in the R direction")
 		("WilsonLoop::max_r", po::value<unsigned int>()->default_value(6), "The maximum dimension of the Wilson loop in the R direction")
 		("WilsonLoop::t_dir", po::value<unsigned int>()->default_value(3), "The time direction of the loops")
+		("WilsonLoop::paths", po::value<std::string>()->default_value("{1,0,0}"), "The steps of the spatial paths in the three spatial directions, negative steps go backwards (syntax: {dx1,dy1,dz1,dx2,dy2,dz2,...})")
 		("WilsonLoop::level_stout_smearing", po::value<unsigned int>()->default_value(10), "Number of levels of the stout smearing")
 		("WilsonLoop::rho_stout_smearing", po::value<double>()->default_value(0.05), "Rho stout smearing");
 }
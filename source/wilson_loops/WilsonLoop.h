@@ -1,6 +1,7 @@
 #ifndef WILSONLOOP_H_
 #define WILSONLOOP_H_
 #include "LatticeSweep.h"
+#include "WilsonLoopEngine.h"
 
 namespace Update {
 
@@ -14,10 +15,7 @@ public:
 
 	static void registerParameters(po::options_description& desc);
 private:
-	reduced_matrix_lattice_t** tWilsonLine;
-	reduced_matrix_lattice_t** xWilsonLine;
-	int RMax;
-	int TMax;
+	WilsonLoopEngine* wilsonLoopEngine;
 };
 
 } /* namespace Update */
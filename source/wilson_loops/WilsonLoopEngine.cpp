@@ -0,0 +1,256 @@
+#include "WilsonLoopEngine.h"
+
+namespace Update {
+
+WilsonLoopEngine::WilsonLoopEngine(int _tDirection) : tDirection(_tDirection) {
+	int pgrid[4] = {Layout::pgrid_x, Layout::pgrid_y, Layout::pgrid_z, Layout::pgrid_t};
+	int loc[4];
+	for (int mu = 0; mu < 4; ++mu) loc[mu] = Layout::glob[mu]/pgrid[mu];
+	for (int mu = 0, i = 0; mu < 4; ++mu) {
+		if (mu != tDirection) spatialDirections[i++] = mu;
+	}
+	timeLength = loc[tDirection];
+	processors = pgrid[tDirection];
+	numberSpatial = Layout::localsize/timeLength;
+
+	//The origin of the local box, the boxes of the processors do not wrap around the lattice
+	int origin[4] = {Layout::glob_x, Layout::glob_y, Layout::glob_z, Layout::glob_t};
+	for (int site = 0; site < Layout::localsize; ++site) {
+		for (int mu = 0; mu < 4; ++mu) origin[mu] = std::min(origin[mu], Layout::globalIndex(site, mu));
+	}
+	lineSite.resize(Layout::localsize);
+	for (int site = 0; site < Layout::localsize; ++site) {
+		int s = 0;
+		for (int i = 0; i < 3; ++i) s = s*loc[spatialDirections[i]] + Layout::globalIndex(site, spatialDirections[i]) - origin[spatialDirections[i]];
+		lineSite[s*timeLength + Layout::globalIndex(site, tDirection) - origin[tDirection]] = site;
+	}
+
+	groupRank = origin[tDirection]/timeLength;
+	start.resize(processors + 1);
+	for (int j = 0; j <= processors; ++j) start[j] = (numberSpatial/processors)*j + std::min(j, numberSpatial % processors);
+#ifdef ENABLE_MPI
+	//The processors with the same spatial coordinates, ordered with the time coordinate
+	int color = 0;
+	for (int i = 0; i < 3; ++i) color = color*pgrid[spatialDirections[i]] + origin[spatialDirections[i]]/loc[spatialDirections[i]];
+	MPI_Comm_split(MPI_COMM_WORLD, color, groupRank, &communicator);
+#endif
+}
+
+WilsonLoopEngine::~WilsonLoopEngine() {
+#ifdef ENABLE_MPI
+	int finalized = 0;
+	MPI_Finalized(&finalized);
+	if (!finalized) MPI_Comm_free(&communicator);
+#endif
+}
+
+std::vector<long_real_t> WilsonLoopEngine::measure(const reduced_gauge_lattice_t& lattice, const std::vector<int>& path, int RMax, int TMax) {
+	const int globalTime = Layout::glob[tDirection];
+	if (TMax > globalTime) {
+		if (isOutputProcess()) std::cout << "WilsonLoopEngine::Fatal error, loops of extent " << TMax << " on a lattice of extent " << globalTime << std::endl;
+		exit(71);
+	}
+	const int myNumber = start[groupRank + 1] - start[groupRank];
+
+	//The transporters from the slice t = 0 and the Polyakov loops, from the time lines of the links
+	reduced_matrix_lattice_t link, transporter, polyakov;
+#pragma omp parallel for
+	for (int site = 0; site < Layout::localsize; ++site) {
+		link[site] = lattice[site][tDirection];
+	}
+	lines_t links, transporterLines(boost::extents[myNumber][globalTime]), polyakovLines(boost::extents[myNumber][globalTime]);
+	this->toLines(links, link);
+#pragma omp parallel for
+	for (int s = 0; s < myNumber; ++s) {
+		GaugeGroup product;
+		set_to_identity(product);
+		for (int t = 0; t < globalTime; ++t) {
+			transporterLines[s][t] = product;
+			product = product*links[s][t];
+		}
+		for (int t = 0; t < globalTime; ++t) polyakovLines[s][t] = product;
+	}
+	this->fromLines(transporter, transporterLines);
+	this->fromLines(polyakov, polyakovLines);
+
+	//moving[x][0] is the path from x to x + d, the steps are done in the order of the directions, the backward steps with U^dagger(y - mu)
+	reduced_gauge_lattice_t shifted = lattice, moving;
+#pragma omp parallel for
+	for (int site = 0; site < Layout::localsize; ++site) {
+		set_to_identity(moving[site][0]);
+	}
+	for (int i = 0; i < 3; ++i) {
+		for (int step = 0; step < abs(path[i]); ++step) {
+			if (path[i] > 0) {
+#pragma omp parallel for
+				for (int site = 0; site < Layout::localsize; ++site) {
+					moving[site][0] = moving[site][0]*shifted[site][spatialDirections[i]];
+				}
+				this->shift(shifted, spatialDirections[i], true);
+			}
+			else {
+				this->shift(shifted, spatialDirections[i], false);
+#pragma omp parallel for
+				for (int site = 0; site < Layout::localsize; ++site) {
+					moving[site][0] = moving[site][0]*htrans(shifted[site][spatialDirections[i]]);
+				}
+			}
+		}
+	}
+	//moving[x][1] and moving[x][2] are the transporter and the Polyakov loop at the end of the spatial line
+#pragma omp parallel for
+	for (int site = 0; site < Layout::localsize; ++site) {
+		moving[site][1] = transporter[site];
+		moving[site][2] = polyakov[site];
+		set_to_identity(moving[site][3]);
+	}
+
+	reduced_matrix_lattice_t line, twisted, wrapped;
+#pragma omp parallel for
+	for (int site = 0; site < Layout::localsize; ++site) {
+		set_to_identity(line[site]);
+	}
+
+	std::vector<long_real_t> result(RMax*TMax, 0.);
+	lines_t twistedLines, wrappedLines;
+	for (int n = 1; n <= RMax; ++n) {
+		//S_n(x) = S_{n-1}(x) P(x + (n-1) d), the end of the line moves to x + n d
+#pragma omp parallel for
+		for (int site = 0; site < Layout::localsize; ++site) {
+			line[site] = line[site]*moving[site][0];
+		}
+		for (int i = 0; i < 3; ++i) {
+			for (int step = 0; step < abs(path[i]); ++step) this->shift(moving, spatialDirections[i], path[i] > 0);
+		}
+
+		//The lines transported to t = 0, and transported once more around the lattice for the loops crossing it
+#pragma omp parallel for
+		for (int site = 0; site < Layout::localsize; ++site) {
+			twisted[site] = transporter[site]*line[site]*htrans(moving[site][1]);
+			wrapped[site] = polyakov[site]*twisted[site]*htrans(moving[site][2]);
+		}
+		this->toLines(twistedLines, twisted);
+		this->toLines(wrappedLines, wrapped);
+
+		for (int T = 1; T <= TMax; ++T) {
+			long_real_t loop = 0.;
+#pragma omp parallel for reduction(+:loop)
+			for (int s = 0; s < myNumber; ++s) {
+				for (int t = 0; t < globalTime; ++t) {
+					if (t + T < globalTime) loop += real(trace(twistedLines[s][t]*htrans(twistedLines[s][t + T])));
+					else loop += real(trace(twistedLines[s][t]*htrans(wrappedLines[s][t + T - globalTime])));
+				}
+			}
+			result[(n - 1)*TMax + T - 1] = loop;
+		}
+	}
+
+	reduceAllSum(&result[0], result.size());
+	for (unsigned int i = 0; i < result.size(); ++i) {
+		result[i] = result[i]/static_cast<long_real_t>(numberColors*Layout::globalVolume);
+	}
+	return result;
+}
+
+int WilsonLoopEngine::getSpatialDirection(int i) const {
+	return spatialDirections[i];
+}
+
+std::vector< std::vector<int> > WilsonLoopEngine::readPaths(const std::vector<int>& list) {
+	std::vector< std::vector<int> > paths;
+	for (unsigned int i = 0; i + 2 < list.size(); i += 3) {
+		std::vector<int> path(list.begin() + i, list.begin() + i + 3);
+		if (path[0] == 0 && path[1] == 0 && path[2] == 0) {
+			if (isOutputProcess()) std::cout << "WilsonLoopEngine::Warning, the empty path is ignored" << std::endl;
+		}
+		else paths.push_back(path);
+	}
+	if (list.size() % 3 != 0 && isOutputProcess()) std::cout << "WilsonLoopEngine::Warning, the paths are not given as triples, the last steps are ignored" << std::endl;
+	return paths;
+}
+
+void WilsonLoopEngine::toLines(lines_t& lines, const reduced_matrix_lattice_t& field) const {
+	const int myNumber = start[groupRank + 1] - start[groupRank];
+	lines.resize(boost::extents[myNumber][processors*timeLength]);
+#ifdef ENABLE_MPI
+	if (processors > 1) {
+		//The pieces of the lines of this processor sent to the processor j, in the order of the spatial sites
+		const int packsize = sizeof(GaugeGroup)/MpiType<GaugeGroup>::size;
+		lines_t exchange(boost::extents[numberSpatial][timeLength]), received(boost::extents[processors*myNumber][timeLength]);
+#pragma omp parallel for
+		for (int s = 0; s < numberSpatial; ++s) {
+			for (int t = 0; t < timeLength; ++t) exchange[s][t] = field[lineSite[s*timeLength + t]];
+		}
+		std::vector<int> sendCounts(processors), sendOffsets(processors), receiveCounts(processors), receiveOffsets(processors);
+		for (int j = 0; j < processors; ++j) {
+			sendCounts[j] = packsize*(start[j + 1] - start[j])*timeLength;
+			sendOffsets[j] = packsize*start[j]*timeLength;
+			receiveCounts[j] = packsize*myNumber*timeLength;
+			receiveOffsets[j] = packsize*j*myNumber*timeLength;
+		}
+		MPI_Alltoallv(exchange.data(), &sendCounts[0], &sendOffsets[0], MpiType<GaugeGroup>::type, received.data(), &receiveCounts[0], &receiveOffsets[0], MpiType<GaugeGroup>::type, communicator);
+		//The piece of the processor j is the part j of the full line
+#pragma omp parallel for
+		for (int s = 0; s < myNumber; ++s) {
+			for (int j = 0; j < processors; ++j) {
+				for (int t = 0; t < timeLength; ++t) lines[s][j*timeLength + t] = received[j*myNumber + s][t];
+			}
+		}
+		return;
+	}
+#endif
+#pragma omp parallel for
+	for (int s = 0; s < numberSpatial; ++s) {
+		for (int t = 0; t < timeLength; ++t) lines[s][t] = field[lineSite[s*timeLength + t]];
+	}
+}
+
+void WilsonLoopEngine::fromLines(reduced_matrix_lattice_t& field, const lines_t& lines) const {
+#ifdef ENABLE_MPI
+	if (processors > 1) {
+		//The inverse of the transposition of toLines, the counts are exchanged
+		const int myNumber = start[groupRank + 1] - start[groupRank];
+		const int packsize = sizeof(GaugeGroup)/MpiType<GaugeGroup>::size;
+		lines_t exchange(boost::extents[numberSpatial][timeLength]), received(boost::extents[processors*myNumber][timeLength]);
+#pragma omp parallel for
+		for (int s = 0; s < myNumber; ++s) {
+			for (int j = 0; j < processors; ++j) {
+				for (int t = 0; t < timeLength; ++t) received[j*myNumber + s][t] = lines[s][j*timeLength + t];
+			}
+		}
+		std::vector<int> sendCounts(processors), sendOffsets(processors), receiveCounts(processors), receiveOffsets(processors);
+		for (int j = 0; j < processors; ++j) {
+			sendCounts[j] = packsize*(start[j + 1] - start[j])*timeLength;
+			sendOffsets[j] = packsize*start[j]*timeLength;
+			receiveCounts[j] = packsize*myNumber*timeLength;
+			receiveOffsets[j] = packsize*j*myNumber*timeLength;
+		}
+		MPI_Alltoallv(received.data(), &receiveCounts[0], &receiveOffsets[0], MpiType<GaugeGroup>::type, exchange.data(), &sendCounts[0], &sendOffsets[0], MpiType<GaugeGroup>::type, communicator);
+#pragma omp parallel for
+		for (int s = 0; s < numberSpatial; ++s) {
+			for (int t = 0; t < timeLength; ++t) field[lineSite[s*timeLength + t]] = exchange[s][t];
+		}
+		field.updateHalo();
+		return;
+	}
+#endif
+#pragma omp parallel for
+	for (int s = 0; s < numberSpatial; ++s) {
+		for (int t = 0; t < timeLength; ++t) field[lineSite[s*timeLength + t]] = lines[s][t];
+	}
+	field.updateHalo();
+}
+
+void WilsonLoopEngine::shift(reduced_gauge_lattice_t& field, int mu, bool forward) const {
+	field.updateHalo();
+	reduced_gauge_lattice_t swap = field;
+#pragma omp parallel for
+	for (int site = 0; site < Layout::localsize; ++site) {
+		int neighbour = forward ? reduced_gauge_lattice_t::sup(site,mu) : reduced_gauge_lattice_t::sdn(site,mu);
+		for (unsigned int nu = 0; nu < 4; ++nu) {
+			field[site][nu] = swap[neighbour][nu];
+		}
+	}
+}
+
+} /* namespace Update */
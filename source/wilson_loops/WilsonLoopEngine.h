@@ -0,0 +1,69 @@
+#ifndef WILSONLOOPENGINE_H_
+#define WILSONLOOPENGINE_H_
+#include "Environment.h"
+#include <boost/multi_array.hpp>
+#include <vector>
+
+namespace Update {
+
+/**
+ * Wilson loops of all the sizes (n,T), made by n repetitions of a spatial path and T steps in the time direction, averaged over
+ * the lattice. The spatial lines are built incrementally, the line of n + 1 paths is the one of n paths times the path moved by n
+ * steps. The temporal lines are not built: as in the temporal gauge, the spatial lines are transported to the slice t = 0 with
+ * L(x,t) = U_t(x,0)...U_t(x,t-1), S'(x,t) = L(x,t) S(x,t) L(x+r,t)^dagger, so that W(n,T) = tr S'(x,t) S'(x,t+T)^dagger, with the
+ * Polyakov loops when t + T wraps around the lattice. The products along the time direction are done on buffers of full time
+ * lines, the spatial sites of the processors with the same spatial coordinates are shared among them.
+ */
+class WilsonLoopEngine {
+public:
+	WilsonLoopEngine(int _tDirection);
+	~WilsonLoopEngine();
+
+	/**
+	 * This function measures the Wilson loops along a spatial path, it must be called by all the processors
+	 * @param lattice
+	 * @param path the steps of the path in the spatial directions, in increasing order of direction, negative steps go backwards
+	 * @param RMax the maximal number of repetitions of the path
+	 * @param TMax the maximal extent in the time direction, not larger than the lattice
+	 * @return the loops W[(n - 1)*TMax + T - 1], normalized with the volume and the number of colors
+	 */
+	std::vector<long_real_t> measure(const reduced_gauge_lattice_t& lattice, const std::vector<int>& path, int RMax, int TMax);
+
+	//The spatial direction i of the paths
+	int getSpatialDirection(int i) const;
+
+	//The paths given as a list of triples {dx1,dy1,dz1,dx2,dy2,dz2,...}, the steps can be negative
+	static std::vector< std::vector<int> > readPaths(const std::vector<int>& list);
+
+private:
+	//The communicator of the time lines cannot be copied
+	WilsonLoopEngine(const WilsonLoopEngine&);
+	WilsonLoopEngine& operator=(const WilsonLoopEngine&);
+
+	typedef reduced_matrix_lattice_t::Layout Layout;
+	typedef boost::multi_array<GaugeGroup,2> lines_t;
+
+	//The full time lines lines[s][t] of the spatial sites of this processor and back
+	void toLines(lines_t& lines, const reduced_matrix_lattice_t& field) const;
+	void fromLines(reduced_matrix_lattice_t& field, const lines_t& lines) const;
+
+	//field(x) = field(x + mu) forward, field(x) = field(x - mu) backward
+	void shift(reduced_gauge_lattice_t& field, int mu, bool forward) const;
+
+	int tDirection;
+	int spatialDirections[3];
+	int timeLength;
+	int processors;
+	int groupRank;
+	//The spatial sites of the local box, the processor j of the group has the time lines of the sites from start[j] to start[j + 1]
+	int numberSpatial;
+	std::vector<int> start;
+	//The local site of the local time tl of the spatial site s is lineSite[s*timeLength + tl]
+	std::vector<int> lineSite;
+#ifdef ENABLE_MPI
+	MPI_Comm communicator;
+#endif
+};
+
+} /* namespace Update */
+#endif /* WILSONLOOPENGINE_H_ */